@@ -0,0 +1,234 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsAPI.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "SMP/Common/vtkSMPToolsAPI.h"
+
+#include "vtkObject.h" // For vtkGenericWarningMacro
+
+#include <algorithm> // For std::transform
+#include <cctype>    // For std::toupper
+#include <cstdlib>   // For std::getenv
+#include <string>    // For std::string
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+//------------------------------------------------------------------------------
+vtkSMPToolsAPI::vtkSMPToolsAPI()
+{
+  this->SequentialBackend.reset(new vtkSMPToolsImpl<BackendType::Sequential>());
+#if VTK_SMP_ENABLE_STDTHREAD
+  this->STDThreadBackend.reset(new vtkSMPToolsImpl<BackendType::STDThread>());
+#endif
+#if VTK_SMP_ENABLE_TBB
+  this->TBBBackend.reset(new vtkSMPToolsImpl<BackendType::TBB>());
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+  this->OpenMPBackend.reset(new vtkSMPToolsImpl<BackendType::OpenMP>());
+#endif
+
+  const char* vtkSMPBackendInUse = std::getenv("VTK_SMP_BACKEND_IN_USE");
+  if (vtkSMPBackendInUse)
+  {
+    this->SetBackend(vtkSMPBackendInUse);
+  }
+
+  const char* vtkSMPMaxThreads = std::getenv("VTK_SMP_MAX_THREADS");
+  if (vtkSMPMaxThreads)
+  {
+    this->Initialize(std::atoi(vtkSMPMaxThreads));
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkSMPToolsAPI& vtkSMPToolsAPI::GetInstance()
+{
+  static vtkSMPToolsAPI instance;
+  return instance;
+}
+
+//------------------------------------------------------------------------------
+const char* vtkSMPToolsAPI::GetBackend()
+{
+  switch (this->ActivatedBackend)
+  {
+    case BackendType::Sequential:
+      return "Sequential";
+    case BackendType::STDThread:
+      return "STDThread";
+    case BackendType::TBB:
+      return "TBB";
+    case BackendType::OpenMP:
+      return "OpenMP";
+  }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPToolsAPI::SetBackend(const char* type)
+{
+  if (!type)
+  {
+    return false;
+  }
+  std::string backend(type);
+  std::transform(backend.cbegin(), backend.cend(), backend.begin(),
+    [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+  BackendType requested;
+  if (backend == "SEQUENTIAL")
+  {
+    requested = BackendType::Sequential;
+  }
+#if VTK_SMP_ENABLE_STDTHREAD
+  else if (backend == "STDTHREAD")
+  {
+    requested = BackendType::STDThread;
+  }
+#endif
+#if VTK_SMP_ENABLE_TBB
+  else if (backend == "TBB")
+  {
+    requested = BackendType::TBB;
+  }
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+  else if (backend == "OPENMP")
+  {
+    requested = BackendType::OpenMP;
+  }
+#endif
+  else
+  {
+    vtkGenericWarningMacro("SMP backend " << type << " is not available. Using "
+                                          << this->GetBackend() << " instead.");
+    return false;
+  }
+
+  if (requested != this->ActivatedBackend)
+  {
+    this->ActivatedBackend = requested;
+    // Carry the requested number of threads over to the new backend.
+    this->Initialize(this->DesiredNumberOfThread);
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPToolsAPI::Initialize(int numThreads)
+{
+  this->DesiredNumberOfThread = numThreads;
+  switch (this->ActivatedBackend)
+  {
+    case BackendType::Sequential:
+      this->SequentialBackend->Initialize(numThreads);
+      break;
+#if VTK_SMP_ENABLE_STDTHREAD
+    case BackendType::STDThread:
+      this->STDThreadBackend->Initialize(numThreads);
+      break;
+#endif
+#if VTK_SMP_ENABLE_TBB
+    case BackendType::TBB:
+      this->TBBBackend->Initialize(numThreads);
+      break;
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+    case BackendType::OpenMP:
+      this->OpenMPBackend->Initialize(numThreads);
+      break;
+#endif
+    default:
+      break;
+  }
+}
+
+//------------------------------------------------------------------------------
+int vtkSMPToolsAPI::GetEstimatedNumberOfThreads()
+{
+  switch (this->ActivatedBackend)
+  {
+    case BackendType::Sequential:
+      return this->SequentialBackend->GetEstimatedNumberOfThreads();
+#if VTK_SMP_ENABLE_STDTHREAD
+    case BackendType::STDThread:
+      return this->STDThreadBackend->GetEstimatedNumberOfThreads();
+#endif
+#if VTK_SMP_ENABLE_TBB
+    case BackendType::TBB:
+      return this->TBBBackend->GetEstimatedNumberOfThreads();
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+    case BackendType::OpenMP:
+      return this->OpenMPBackend->GetEstimatedNumberOfThreads();
+#endif
+    default:
+      return 1;
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPToolsAPI::SetNestedParallelism(bool isNested)
+{
+  // Set it on every backend so that it survives a backend switch.
+  this->SequentialBackend->SetNestedParallelism(isNested);
+#if VTK_SMP_ENABLE_STDTHREAD
+  this->STDThreadBackend->SetNestedParallelism(isNested);
+#endif
+#if VTK_SMP_ENABLE_TBB
+  this->TBBBackend->SetNestedParallelism(isNested);
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+  this->OpenMPBackend->SetNestedParallelism(isNested);
+#endif
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPToolsAPI::GetNestedParallelism()
+{
+  return this->SequentialBackend->GetNestedParallelism();
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPToolsAPI::IsParallelScope()
+{
+  switch (this->ActivatedBackend)
+  {
+    case BackendType::Sequential:
+      return this->SequentialBackend->IsParallelScope();
+#if VTK_SMP_ENABLE_STDTHREAD
+    case BackendType::STDThread:
+      return this->STDThreadBackend->IsParallelScope();
+#endif
+#if VTK_SMP_ENABLE_TBB
+    case BackendType::TBB:
+      return this->TBBBackend->IsParallelScope();
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+    case BackendType::OpenMP:
+      return this->OpenMPBackend->IsParallelScope();
+#endif
+    default:
+      return false;
+  }
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
@@ -0,0 +1,228 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsAPI.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// vtkSMPToolsAPI is the process wide dispatcher behind vtkSMPTools. It owns
+// one vtkSMPToolsImpl per backend enabled at configure time and forwards
+// every call to the backend selected at runtime, either through SetBackend
+// or through the VTK_SMP_BACKEND_IN_USE environment variable. The
+// VTK_SMP_MAX_THREADS environment variable sets the initial number of
+// threads.
+
+#ifndef vtkSMPToolsAPI_h
+#define vtkSMPToolsAPI_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkSMP.h"              // For VTK_SMP_ENABLE_*
+#include "vtkSystemIncludes.h"
+
+#include "SMP/Common/vtkSMPToolsImpl.h"
+#include "SMP/Sequential/vtkSMPToolsImpl.txx"
+#if VTK_SMP_ENABLE_STDTHREAD
+#include "SMP/STDThread/vtkSMPToolsImpl.txx"
+#endif
+#if VTK_SMP_ENABLE_TBB
+#include "SMP/TBB/vtkSMPToolsImpl.txx"
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+#include "SMP/OpenMP/vtkSMPToolsImpl.txx"
+#endif
+
+#include <atomic> // For std::atomic
+#include <memory> // For std::unique_ptr
+
+#ifndef __VTK_WRAP__
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+class VTKCOMMONCORE_EXPORT vtkSMPToolsAPI
+{
+public:
+  static vtkSMPToolsAPI& GetInstance();
+
+  BackendType GetBackendType() { return this->ActivatedBackend; }
+
+  const char* GetBackend();
+
+  /**
+   * Select the backend by name (Sequential, STDThread, TBB or OpenMP, case
+   * insensitive). Returns false and keeps the current backend if the
+   * requested one was not enabled at configure time.
+   */
+  bool SetBackend(const char* type);
+
+  void Initialize(int numThreads = 0);
+
+  int GetEstimatedNumberOfThreads();
+
+  void SetNestedParallelism(bool isNested);
+
+  bool GetNestedParallelism();
+
+  bool IsParallelScope();
+
+  /**
+   * Number of threads last requested through Initialize, 0 for the default.
+   */
+  int GetInternalDesiredNumberOfThread() { return this->DesiredNumberOfThread; }
+
+  /**
+   * Apply config (thread count, backend and nested parallelism), run
+   * lambda, and restore the previous configuration.
+   */
+  template <typename Config, typename T>
+  void LocalScope(Config const& config, T&& lambda)
+  {
+    const Config oldConfig(*this);
+    this->ApplyConfig(config);
+    try
+    {
+      lambda();
+    }
+    catch (...)
+    {
+      this->ApplyConfig(oldConfig);
+      throw;
+    }
+    this->ApplyConfig(oldConfig);
+  }
+
+  template <typename FunctorInternal>
+  void For(vtkIdType first, vtkIdType last, vtkIdType grain, FunctorInternal& fi)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        this->SequentialBackend->For(first, last, grain, fi);
+        break;
+#if VTK_SMP_ENABLE_STDTHREAD
+      case BackendType::STDThread:
+        this->STDThreadBackend->For(first, last, grain, fi);
+        break;
+#endif
+#if VTK_SMP_ENABLE_TBB
+      case BackendType::TBB:
+        this->TBBBackend->For(first, last, grain, fi);
+        break;
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+      case BackendType::OpenMP:
+        this->OpenMPBackend->For(first, last, grain, fi);
+        break;
+#endif
+      default:
+        break;
+    }
+  }
+
+  template <typename RandomAccessIterator>
+  void Sort(RandomAccessIterator begin, RandomAccessIterator end)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        this->SequentialBackend->Sort(begin, end);
+        break;
+#if VTK_SMP_ENABLE_STDTHREAD
+      case BackendType::STDThread:
+        this->STDThreadBackend->Sort(begin, end);
+        break;
+#endif
+#if VTK_SMP_ENABLE_TBB
+      case BackendType::TBB:
+        this->TBBBackend->Sort(begin, end);
+        break;
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+      case BackendType::OpenMP:
+        this->OpenMPBackend->Sort(begin, end);
+        break;
+#endif
+      default:
+        break;
+    }
+  }
+
+  template <typename RandomAccessIterator, typename Compare>
+  void Sort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        this->SequentialBackend->Sort(begin, end, comp);
+        break;
+#if VTK_SMP_ENABLE_STDTHREAD
+      case BackendType::STDThread:
+        this->STDThreadBackend->Sort(begin, end, comp);
+        break;
+#endif
+#if VTK_SMP_ENABLE_TBB
+      case BackendType::TBB:
+        this->TBBBackend->Sort(begin, end, comp);
+        break;
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+      case BackendType::OpenMP:
+        this->OpenMPBackend->Sort(begin, end, comp);
+        break;
+#endif
+      default:
+        break;
+    }
+  }
+
+  // disable copying
+  vtkSMPToolsAPI(vtkSMPToolsAPI const&) = delete;
+  void operator=(vtkSMPToolsAPI const&) = delete;
+
+private:
+  vtkSMPToolsAPI();
+
+  template <typename Config>
+  void ApplyConfig(Config const& config)
+  {
+    this->SetBackend(config.Backend.c_str());
+    this->Initialize(config.MaxNumberOfThreads);
+    this->SetNestedParallelism(config.NestedParallelism);
+  }
+
+  // Atomic as they are read by the threads of parallel sections, e.g. by
+  // vtkSMPThreadLocal, while another thread may select the backend.
+  std::atomic<BackendType> ActivatedBackend{ DefaultBackend };
+
+  std::atomic<int> DesiredNumberOfThread{ 0 };
+
+  std::unique_ptr<vtkSMPToolsImpl<BackendType::Sequential> > SequentialBackend;
+#if VTK_SMP_ENABLE_STDTHREAD
+  std::unique_ptr<vtkSMPToolsImpl<BackendType::STDThread> > STDThreadBackend;
+#endif
+#if VTK_SMP_ENABLE_TBB
+  std::unique_ptr<vtkSMPToolsImpl<BackendType::TBB> > TBBBackend;
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+  std::unique_ptr<vtkSMPToolsImpl<BackendType::OpenMP> > OpenMPBackend;
+#endif
+};
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // __VTK_WRAP__
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPToolsAPI.h
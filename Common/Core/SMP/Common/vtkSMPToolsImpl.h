@@ -0,0 +1,124 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// vtkSMPToolsImpl is the interface every vtkSMPTools backend implements.
+// Each backend provides explicit specializations of the members below in
+// SMP/<Backend>/vtkSMPToolsImpl.txx (templates) and
+// SMP/<Backend>/vtkSMPToolsImpl.cxx (everything else). vtkSMPToolsAPI owns
+// one instance per backend enabled at configure time and forwards the calls
+// to the one selected at runtime.
+
+#ifndef vtkSMPToolsImpl_h
+#define vtkSMPToolsImpl_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkSMP.h"              // For VTK_SMP_DEFAULT_IMPLEMENTATION_*
+#include "vtkSystemIncludes.h"
+
+#include <atomic> // For std::atomic
+
+#ifndef __VTK_WRAP__
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+enum class BackendType
+{
+  Sequential = 0,
+  STDThread = 1,
+  TBB = 2,
+  OpenMP = 3
+};
+
+#if VTK_SMP_DEFAULT_IMPLEMENTATION_SEQUENTIAL
+const BackendType DefaultBackend = BackendType::Sequential;
+#elif VTK_SMP_DEFAULT_IMPLEMENTATION_STDTHREAD
+const BackendType DefaultBackend = BackendType::STDThread;
+#elif VTK_SMP_DEFAULT_IMPLEMENTATION_TBB
+const BackendType DefaultBackend = BackendType::TBB;
+#elif VTK_SMP_DEFAULT_IMPLEMENTATION_OPENMP
+const BackendType DefaultBackend = BackendType::OpenMP;
+#endif
+
+template <BackendType Backend>
+class VTKCOMMONCORE_EXPORT vtkSMPToolsImpl
+{
+public:
+  /**
+   * Set the number of threads used by parallel sections. numThreads <= 0
+   * restores the backend default.
+   */
+  void Initialize(int numThreads = 0);
+
+  /**
+   * Number of threads a parallel section is expected to use.
+   */
+  int GetEstimatedNumberOfThreads();
+
+  /**
+   * When nested parallelism is off (the default), a For called from within
+   * another parallel section runs sequentially on the calling thread.
+   */
+  void SetNestedParallelism(bool isNested) { this->NestedActivated = isNested; }
+  bool GetNestedParallelism() { return this->NestedActivated; }
+
+  /**
+   * Returns true when called from within a parallel section.
+   */
+  bool IsParallelScope();
+
+  template <typename FunctorInternal>
+  void For(vtkIdType first, vtkIdType last, vtkIdType grain, FunctorInternal& fi);
+
+  template <typename RandomAccessIterator>
+  void Sort(RandomAccessIterator begin, RandomAccessIterator end);
+
+  template <typename RandomAccessIterator, typename Compare>
+  void Sort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp);
+
+private:
+  bool NestedActivated = false;
+  // Used by the backends that cannot query their runtime for it.
+  std::atomic<bool> IsParallel{ false };
+};
+
+//--------------------------------------------------------------------------------
+typedef void (*ExecuteFunctorPtrType)(void*, vtkIdType, vtkIdType, vtkIdType);
+
+// Type erased execution of one chunk [from, min(from + grain, last)) of a
+// parallel for, so that the backends can run the loop in a compiled function.
+template <typename FunctorInternal>
+void ExecuteFunctor(void* functor, vtkIdType from, vtkIdType grain, vtkIdType last)
+{
+  vtkIdType to = from + grain;
+  if (to > last)
+  {
+    to = last;
+  }
+
+  FunctorInternal& fi = *reinterpret_cast<FunctorInternal*>(functor);
+  fi.Execute(from, to);
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // __VTK_WRAP__
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPToolsImpl.h
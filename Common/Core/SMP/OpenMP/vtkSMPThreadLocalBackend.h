@@ -1,7 +1,7 @@
 /*=========================================================================
 
   Program:   Visualization Toolkit
-  Module:    vtkSMPThreadLocalImpl.h
+  Module:    vtkSMPThreadLocalBackend.h
 
   Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
   All rights reserved.
@@ -29,19 +29,27 @@
 // safe and only blocks when a new array needs to be allocated, which should be
 // rare.
 
-#ifndef vtkSMPThreadLocalImpl_h
-#define vtkSMPThreadLocalImpl_h
+#ifndef OpenMPvtkSMPThreadLocalBackend_h
+#define OpenMPvtkSMPThreadLocalBackend_h
 
 #include "vtkCommonCoreModule.h" // For export macro
-#include "vtkConfigure.h"
 #include "vtkSystemIncludes.h"
 
 #include <atomic>
 #include <omp.h>
 
-
+namespace vtk
+{
 namespace detail
 {
+namespace smp
+{
+namespace OpenMP
+{
+
+// Number of threads a parallel section of this backend uses, used to size
+// the hash table.
+int VTKCOMMONCORE_EXPORT GetNumberOfThreads();
 
 typedef void* ThreadIdType;
 typedef vtkTypeUInt32 HashType;
@@ -182,7 +190,10 @@ private:
   size_t CurrentSlot;
 };
 
-} // detail;
+} // namespace OpenMP
+} // namespace smp
+} // namespace detail
+} // namespace vtk
 
 #endif
-// VTK-HeaderTest-Exclude: vtkSMPThreadLocalImpl.h
+// VTK-HeaderTest-Exclude: vtkSMPThreadLocalBackend.h
@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "SMP/OpenMP/vtkSMPToolsImpl.txx"
+
+#include <omp.h>
+
+namespace
+{
+int vtkSMPNumberOfSpecifiedThreads = 0;
+}
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+//------------------------------------------------------------------------------
+int OpenMP::GetNumberOfThreads()
+{
+  return vtkSMPNumberOfSpecifiedThreads ? vtkSMPNumberOfSpecifiedThreads : omp_get_max_threads();
+}
+
+//------------------------------------------------------------------------------
+void OpenMP::vtkSMPToolsImplForOpenMP(vtkIdType first, vtkIdType last, vtkIdType grain,
+  ExecuteFunctorPtrType functorExecuter, void* functor, bool nestedActivated)
+{
+  const int numThreads = OpenMP::GetNumberOfThreads();
+  if (grain <= 0)
+  {
+    vtkIdType estimateGrain = (last - first) / (numThreads * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+
+  // The number of active levels is a property of the outermost region, so
+  // only set it when starting one.
+  if (omp_get_level() == 0)
+  {
+    omp_set_max_active_levels(nestedActivated ? VTK_INT_MAX : 1);
+  }
+
+#pragma omp parallel for schedule(runtime) num_threads(numThreads)
+  for (vtkIdType from = first; from < last; from += grain)
+  {
+    functorExecuter(functor, from, grain, last);
+  }
+}
+
+//------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::OpenMP>::Initialize(int numThreads)
+{
+  vtkSMPNumberOfSpecifiedThreads = numThreads > 0 ? numThreads : 0;
+  if (numThreads > 0)
+  {
+    omp_set_num_threads(numThreads);
+  }
+}
+
+//------------------------------------------------------------------------------
+template <>
+int vtkSMPToolsImpl<BackendType::OpenMP>::GetEstimatedNumberOfThreads()
+{
+  return OpenMP::GetNumberOfThreads();
+}
+
+//------------------------------------------------------------------------------
+template <>
+bool vtkSMPToolsImpl<BackendType::OpenMP>::IsParallelScope()
+{
+  // omp_in_parallel() is false in a team of a single thread.
+  return omp_get_level() > 0;
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
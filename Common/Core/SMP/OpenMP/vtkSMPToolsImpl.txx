@@ -0,0 +1,94 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef OpenMPvtkSMPToolsImpl_txx
+#define OpenMPvtkSMPToolsImpl_txx
+
+#include "SMP/Common/vtkSMPToolsImpl.h"
+
+#include <algorithm> //for std::sort()
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+namespace OpenMP
+{
+int VTKCOMMONCORE_EXPORT GetNumberOfThreads();
+
+void VTKCOMMONCORE_EXPORT vtkSMPToolsImplForOpenMP(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void* functor, bool nestedActivated);
+} // namespace OpenMP
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename FunctorInternal>
+void vtkSMPToolsImpl<BackendType::OpenMP>::For(
+  vtkIdType first, vtkIdType last, vtkIdType grain, FunctorInternal& fi)
+{
+  vtkIdType n = last - first;
+  if (n <= 0)
+  {
+    return;
+  }
+
+  if (grain >= n || (!this->NestedActivated && this->IsParallelScope()))
+  {
+    fi.Execute(first, last);
+  }
+  else
+  {
+    OpenMP::vtkSMPToolsImplForOpenMP(
+      first, last, grain, ExecuteFunctor<FunctorInternal>, &fi, this->NestedActivated);
+  }
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator>
+void vtkSMPToolsImpl<BackendType::OpenMP>::Sort(
+  RandomAccessIterator begin, RandomAccessIterator end)
+{
+  std::sort(begin, end);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator, typename Compare>
+void vtkSMPToolsImpl<BackendType::OpenMP>::Sort(
+  RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+{
+  std::sort(begin, end, comp);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::OpenMP>::Initialize(int);
+
+//--------------------------------------------------------------------------------
+template <>
+int vtkSMPToolsImpl<BackendType::OpenMP>::GetEstimatedNumberOfThreads();
+
+//--------------------------------------------------------------------------------
+template <>
+bool vtkSMPToolsImpl<BackendType::OpenMP>::IsParallelScope();
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+
+#endif
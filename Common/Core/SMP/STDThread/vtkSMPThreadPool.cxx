@@ -0,0 +1,330 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPThreadPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "SMP/STDThread/vtkSMPThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Set for the lifetime of the workers and for any other thread while it
+// takes part in a parallel section.
+thread_local bool vtkSMPThreadPoolInParallelScope = false;
+
+// Range of chunk indices owned by one thread. The owner pops chunks from
+// the front, idle threads steal the back half of what is left.
+struct WorkDeque
+{
+  std::mutex Lock;
+  vtkIdType Begin = 0;
+  vtkIdType End = 0;
+
+  void Assign(vtkIdType begin, vtkIdType end)
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    this->Begin = begin;
+    this->End = end;
+  }
+
+  bool PopFront(vtkIdType& chunk)
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    if (this->Begin >= this->End)
+    {
+      return false;
+    }
+    chunk = this->Begin++;
+    return true;
+  }
+
+  bool StealBack(vtkIdType& begin, vtkIdType& end)
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    vtkIdType remaining = this->End - this->Begin;
+    if (remaining <= 0)
+    {
+      return false;
+    }
+    end = this->End;
+    begin = end - (remaining + 1) / 2;
+    this->End = begin;
+    return true;
+  }
+};
+
+// One parallel section. It lives on the stack of the thread that started
+// it, which only returns once every chunk ran and no worker uses it anymore.
+struct Job
+{
+  vtk::detail::smp::ExecuteFunctorPtrType FunctorExecuter;
+  void* Functor;
+  vtkIdType First;
+  vtkIdType Last;
+  vtkIdType Grain;
+
+  // One deque per participant slot, slot 0 belongs to the owner.
+  std::vector<WorkDeque> Deques;
+  int NextSlot = 1;                // protected by the pool mutex
+  int Users = 0;                   // workers inside the job, pool mutex
+  std::atomic<vtkIdType> Remaining; // chunks not executed yet
+
+  Job(vtk::detail::smp::ExecuteFunctorPtrType functorExecuter, void* functor, vtkIdType first,
+    vtkIdType last, vtkIdType grain, int numberOfSlots)
+    : FunctorExecuter(functorExecuter)
+    , Functor(functor)
+    , First(first)
+    , Last(last)
+    , Grain(grain)
+    , Deques(numberOfSlots)
+  {
+    const vtkIdType numChunks = (last - first + grain - 1) / grain;
+    this->Remaining = numChunks;
+    for (int i = 0; i < numberOfSlots; ++i)
+    {
+      this->Deques[i].Assign(numChunks * i / numberOfSlots, numChunks * (i + 1) / numberOfSlots);
+    }
+  }
+
+  bool AcceptsWorkers() const
+  {
+    return this->NextSlot < static_cast<int>(this->Deques.size()) && this->Remaining > 0;
+  }
+};
+}
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+struct vtkSMPThreadPool::Internals
+{
+  // Protects everything below but NumberOfThreads.
+  std::mutex Mutex;
+  std::condition_variable WakeUp;
+  std::condition_variable Done;
+  std::vector<std::thread> Workers;
+  std::vector<Job*> Jobs;
+  bool Stop = false;
+
+  std::atomic<int> NumberOfThreads{ 0 };
+
+  // Called with Mutex held. Makes sure numThreads - 1 workers exist.
+  void EnsureWorkers(int numThreads)
+  {
+    for (int i = static_cast<int>(this->Workers.size()) + 1; i < numThreads; ++i)
+    {
+      this->Workers.emplace_back(&Internals::WorkerMain, this);
+    }
+  }
+
+  // Called with Mutex held. Returns a job that still needs threads and
+  // reserves a slot in it.
+  Job* Acquire(int& slot)
+  {
+    for (Job* job : this->Jobs)
+    {
+      if (job->AcceptsWorkers())
+      {
+        slot = job->NextSlot++;
+        ++job->Users;
+        return job;
+      }
+    }
+    return nullptr;
+  }
+
+  void Release(Job& job)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (--job.Users == 0)
+    {
+      this->Done.notify_all();
+    }
+  }
+
+  void WorkerMain()
+  {
+    vtkSMPThreadPoolInParallelScope = true;
+    for (;;)
+    {
+      Job* job = nullptr;
+      int slot = 0;
+      {
+        std::unique_lock<std::mutex> lock(this->Mutex);
+        this->WakeUp.wait(
+          lock, [&]() { return this->Stop || (job = this->Acquire(slot)) != nullptr; });
+        if (!job)
+        {
+          return;
+        }
+      }
+      this->Process(*job, slot);
+      this->Release(*job);
+    }
+  }
+
+  void Process(Job& job, int slot)
+  {
+    const int numSlots = static_cast<int>(job.Deques.size());
+    WorkDeque& own = job.Deques[slot];
+    for (;;)
+    {
+      vtkIdType chunk;
+      while (own.PopFront(chunk))
+      {
+        job.FunctorExecuter(job.Functor, job.First + chunk * job.Grain, job.Grain, job.Last);
+        if (--job.Remaining == 0)
+        {
+          std::lock_guard<std::mutex> lock(this->Mutex);
+          this->Done.notify_all();
+        }
+      }
+
+      // Out of local work: steal from the other slots, starting with the
+      // next one so that thieves spread over the victims.
+      bool stolen = false;
+      for (int i = 1; i < numSlots && !stolen; ++i)
+      {
+        vtkIdType begin, end;
+        if (job.Deques[(slot + i) % numSlots].StealBack(begin, end))
+        {
+          own.Assign(begin, end);
+          stolen = true;
+        }
+      }
+      if (!stolen)
+      {
+        return;
+      }
+    }
+  }
+};
+
+//------------------------------------------------------------------------------
+vtkSMPThreadPool& vtkSMPThreadPool::GetInstance()
+{
+  static vtkSMPThreadPool instance;
+  return instance;
+}
+
+//------------------------------------------------------------------------------
+vtkSMPThreadPool::vtkSMPThreadPool()
+  : Internal(new Internals)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkSMPThreadPool::~vtkSMPThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    this->Internal->Stop = true;
+  }
+  this->Internal->WakeUp.notify_all();
+  for (auto& worker : this->Internal->Workers)
+  {
+    worker.join();
+  }
+  delete this->Internal;
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::Initialize(int numThreads)
+{
+  if (numThreads <= 0)
+  {
+    numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    numThreads = numThreads > 0 ? numThreads : 1;
+  }
+  this->Internal->NumberOfThreads = numThreads;
+}
+
+//------------------------------------------------------------------------------
+int vtkSMPThreadPool::GetNumberOfThreads()
+{
+  if (!this->Internal->NumberOfThreads)
+  {
+    this->Initialize(0);
+  }
+  return this->Internal->NumberOfThreads;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPThreadPool::IsParallelScope()
+{
+  return vtkSMPThreadPoolInParallelScope;
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::Run(vtkIdType first, vtkIdType last, vtkIdType grain,
+  ExecuteFunctorPtrType functorExecuter, void* functor)
+{
+  const int numThreads = this->GetNumberOfThreads();
+  if (grain <= 0)
+  {
+    // Aim for several chunks per thread so that stealing has something to
+    // balance when the cost per index is irregular.
+    vtkIdType estimateGrain = (last - first) / (numThreads * 8);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+
+  const vtkIdType numChunks = (last - first + grain - 1) / grain;
+  const int numSlots = static_cast<int>(std::min<vtkIdType>(numThreads, numChunks));
+  if (numSlots <= 1)
+  {
+    // Run on the calling thread, which is still a parallel scope as with the
+    // other backends.
+    const bool wasInParallelScope = vtkSMPThreadPoolInParallelScope;
+    vtkSMPThreadPoolInParallelScope = true;
+    for (vtkIdType from = first; from < last; from += grain)
+    {
+      functorExecuter(functor, from, grain, last);
+    }
+    vtkSMPThreadPoolInParallelScope = wasInParallelScope;
+    return;
+  }
+
+  Internals& internal = *this->Internal;
+  Job job(functorExecuter, functor, first, last, grain, numSlots);
+  {
+    std::lock_guard<std::mutex> lock(internal.Mutex);
+    internal.EnsureWorkers(numThreads);
+    internal.Jobs.push_back(&job);
+  }
+  internal.WakeUp.notify_all();
+
+  const bool wasInParallelScope = vtkSMPThreadPoolInParallelScope;
+  vtkSMPThreadPoolInParallelScope = true;
+  internal.Process(job, 0);
+  vtkSMPThreadPoolInParallelScope = wasInParallelScope;
+
+  // Chunks still running on other threads have to finish, and the workers
+  // must be done looking at the job before it goes out of scope.
+  std::unique_lock<std::mutex> lock(internal.Mutex);
+  internal.Done.wait(lock, [&]() { return job.Remaining == 0 && job.Users == 0; });
+  internal.Jobs.erase(std::find(internal.Jobs.begin(), internal.Jobs.end(), &job));
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
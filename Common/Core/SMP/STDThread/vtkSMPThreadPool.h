@@ -0,0 +1,105 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPThreadPool.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// A persistent pool of std::thread workers used by the STDThread
+// vtkSMPTools backend. The pool is created lazily the first time it is
+// used and lives until the program exits, so that vtkSMPTools::For does
+// not pay for thread creation on every call.
+//
+// A parallel for is split into chunks of `grain` indices. The chunks are
+// distributed as contiguous ranges over one work-stealing deque per
+// participating thread (the calling thread always participates). A thread
+// processes chunks from the front of its own deque and, once it runs dry,
+// steals the back half of the remaining chunks of another thread. This keeps
+// the good locality of a static schedule when the work is regular while still
+// balancing the load when the cost per index varies a lot.
+//
+// Several parallel sections can be in flight at the same time, either
+// because they are started from different threads or because nested
+// parallelism is enabled and a chunk starts its own parallel section. Idle
+// workers join whichever section still has work, so nested sections reuse
+// the same threads instead of oversubscribing the cores.
+
+#ifndef STDThreadvtkSMPThreadPool_h
+#define STDThreadvtkSMPThreadPool_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkSystemIncludes.h"
+
+#include "SMP/Common/vtkSMPToolsImpl.h" // For ExecuteFunctorPtrType
+
+#ifndef __VTK_WRAP__
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+class VTKCOMMONCORE_EXPORT vtkSMPThreadPool
+{
+public:
+  /**
+   * Returns the process wide thread pool.
+   */
+  static vtkSMPThreadPool& GetInstance();
+
+  /**
+   * Set the number of threads (including the calling thread) that take part
+   * in the parallel sections started afterwards. If numThreads <= 0, the
+   * number of hardware threads is used. Worker threads are only created
+   * when a parallel section needs them and are never destroyed before exit.
+   */
+  void Initialize(int numThreads);
+
+  /**
+   * Number of threads (including the calling thread) that take part in a
+   * parallel section.
+   */
+  int GetNumberOfThreads();
+
+  /**
+   * Returns true if the calling thread is currently executing a chunk of a
+   * parallel section.
+   */
+  static bool IsParallelScope();
+
+  /**
+   * Execute functorExecuter(functor, from, grain, last) for every chunk
+   * start `from` in [first, last) using up to GetNumberOfThreads() threads.
+   * Returns once every chunk has been processed.
+   */
+  void Run(vtkIdType first, vtkIdType last, vtkIdType grain,
+    ExecuteFunctorPtrType functorExecuter, void* functor);
+
+  ~vtkSMPThreadPool();
+
+private:
+  vtkSMPThreadPool();
+
+  struct Internals;
+  Internals* Internal;
+
+  vtkSMPThreadPool(const vtkSMPThreadPool&) = delete;
+  void operator=(const vtkSMPThreadPool&) = delete;
+};
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // __VTK_WRAP__
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPThreadPool.h
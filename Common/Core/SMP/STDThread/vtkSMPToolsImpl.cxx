@@ -0,0 +1,54 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "SMP/STDThread/vtkSMPToolsImpl.txx"
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+//------------------------------------------------------------------------------
+int STDThread::GetNumberOfThreads()
+{
+  return vtkSMPThreadPool::GetInstance().GetNumberOfThreads();
+}
+
+//------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::STDThread>::Initialize(int numThreads)
+{
+  vtkSMPThreadPool::GetInstance().Initialize(numThreads);
+}
+
+//------------------------------------------------------------------------------
+template <>
+int vtkSMPToolsImpl<BackendType::STDThread>::GetEstimatedNumberOfThreads()
+{
+  return STDThread::GetNumberOfThreads();
+}
+
+//------------------------------------------------------------------------------
+template <>
+bool vtkSMPToolsImpl<BackendType::STDThread>::IsParallelScope()
+{
+  return vtkSMPThreadPool::IsParallelScope();
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef STDThreadvtkSMPToolsImpl_txx
+#define STDThreadvtkSMPToolsImpl_txx
+
+#include "SMP/Common/vtkSMPToolsImpl.h"
+#include "SMP/STDThread/vtkSMPThreadPool.h"
+
+#include <algorithm>  //for std::sort()
+#include <functional> //for std::less
+#include <iterator>   //for std::iterator_traits
+#include <vector>     //for std::vector
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+namespace STDThread
+{
+int VTKCOMMONCORE_EXPORT GetNumberOfThreads();
+
+//--------------------------------------------------------------------------------
+// Parallel sort: the range is cut into one block per thread, the blocks are
+// sorted concurrently and then merged pairwise in log2(#blocks) parallel passes.
+template <typename RandomAccessIterator, typename Compare>
+struct SortBlocks
+{
+  RandomAccessIterator Begin;
+  const std::vector<vtkIdType>& Bounds;
+  vtkIdType Width;
+  Compare Comp;
+
+  SortBlocks(RandomAccessIterator begin, const std::vector<vtkIdType>& bounds, Compare comp)
+    : Begin(begin)
+    , Bounds(bounds)
+    , Width(0)
+    , Comp(comp)
+  {
+  }
+
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    const vtkIdType numBlocks = static_cast<vtkIdType>(this->Bounds.size()) - 1;
+    for (vtkIdType i = first; i < last; ++i)
+    {
+      if (this->Width == 0)
+      {
+        std::sort(
+          this->Begin + this->Bounds[i], this->Begin + this->Bounds[i + 1], this->Comp);
+      }
+      else
+      {
+        // Merge the runs starting at blocks 2*i*Width and (2*i+1)*Width.
+        vtkIdType left = 2 * i * this->Width;
+        vtkIdType middle = std::min(left + this->Width, numBlocks);
+        vtkIdType right = std::min(left + 2 * this->Width, numBlocks);
+        std::inplace_merge(this->Begin + this->Bounds[left], this->Begin + this->Bounds[middle],
+          this->Begin + this->Bounds[right], this->Comp);
+      }
+    }
+  }
+};
+} // namespace STDThread
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename FunctorInternal>
+void vtkSMPToolsImpl<BackendType::STDThread>::For(
+  vtkIdType first, vtkIdType last, vtkIdType grain, FunctorInternal& fi)
+{
+  vtkIdType n = last - first;
+  if (n <= 0)
+  {
+    return;
+  }
+
+  if (!this->NestedActivated && vtkSMPThreadPool::IsParallelScope())
+  {
+    fi.Execute(first, last);
+  }
+  else
+  {
+    vtkSMPThreadPool::GetInstance().Run(
+      first, last, grain, ExecuteFunctor<FunctorInternal>, &fi);
+  }
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator, typename Compare>
+void vtkSMPToolsImpl<BackendType::STDThread>::Sort(
+  RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+{
+  // Below this size sorting is not worth waking up the pool.
+  const vtkIdType minimumSizePerBlock = 10000;
+
+  const vtkIdType size = static_cast<vtkIdType>(end - begin);
+  vtkIdType numBlocks = std::min(
+    static_cast<vtkIdType>(STDThread::GetNumberOfThreads()), size / minimumSizePerBlock);
+  if (numBlocks < 2 || (!this->NestedActivated && vtkSMPThreadPool::IsParallelScope()))
+  {
+    std::sort(begin, end, comp);
+    return;
+  }
+
+  std::vector<vtkIdType> bounds(numBlocks + 1);
+  for (vtkIdType i = 0; i <= numBlocks; ++i)
+  {
+    bounds[i] = size * i / numBlocks;
+  }
+
+  STDThread::SortBlocks<RandomAccessIterator, Compare> sorter(begin, bounds, comp);
+  this->For(0, numBlocks, 1, sorter);
+  for (sorter.Width = 1; sorter.Width < numBlocks; sorter.Width *= 2)
+  {
+    vtkIdType numMerges = (numBlocks + 2 * sorter.Width - 1) / (2 * sorter.Width);
+    this->For(0, numMerges, 1, sorter);
+  }
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator>
+void vtkSMPToolsImpl<BackendType::STDThread>::Sort(
+  RandomAccessIterator begin, RandomAccessIterator end)
+{
+  typedef typename std::iterator_traits<RandomAccessIterator>::value_type ValueType;
+  this->Sort(begin, end, std::less<ValueType>());
+}
+
+//--------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::STDThread>::Initialize(int);
+
+//--------------------------------------------------------------------------------
+template <>
+int vtkSMPToolsImpl<BackendType::STDThread>::GetEstimatedNumberOfThreads();
+
+//--------------------------------------------------------------------------------
+template <>
+bool vtkSMPToolsImpl<BackendType::STDThread>::IsParallelScope();
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+
+#endif
@@ -1,7 +1,7 @@
 /*=========================================================================
 
   Program:   Visualization Toolkit
-  Module:    vtkSMPTools.cxx
+  Module:    vtkSMPToolsImpl.cxx
 
   Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
   All rights reserved.
@@ -13,21 +13,35 @@
 
 =========================================================================*/
 
-#include "vtkSMPTools.h"
+#include "SMP/Sequential/vtkSMPToolsImpl.txx"
 
-#include "vtkSMP.h"
-
-// Simple implementation that runs everything sequentially.
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
 
-const char* vtkSMPTools::GetBackend()
+//------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::Sequential>::Initialize(int)
 {
-  return VTK_SMP_BACKEND;
 }
 
 //------------------------------------------------------------------------------
-void vtkSMPTools::Initialize(int) {}
-
-int vtkSMPTools::GetEstimatedNumberOfThreads()
+template <>
+int vtkSMPToolsImpl<BackendType::Sequential>::GetEstimatedNumberOfThreads()
 {
   return 1;
 }
+
+//------------------------------------------------------------------------------
+template <>
+bool vtkSMPToolsImpl<BackendType::Sequential>::IsParallelScope()
+{
+  return this->IsParallel;
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
@@ -0,0 +1,101 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef SequentialvtkSMPToolsImpl_txx
+#define SequentialvtkSMPToolsImpl_txx
+
+#include "SMP/Common/vtkSMPToolsImpl.h"
+
+#include <algorithm> //for std::sort()
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+//--------------------------------------------------------------------------------
+// Simple implementation that runs everything sequentially.
+template <>
+template <typename FunctorInternal>
+void vtkSMPToolsImpl<BackendType::Sequential>::For(
+  vtkIdType first, vtkIdType last, vtkIdType grain, FunctorInternal& fi)
+{
+  vtkIdType n = last - first;
+  if (n <= 0)
+  {
+    return;
+  }
+
+  bool fromParallelCode = this->IsParallel.exchange(true);
+
+  if (grain == 0 || grain >= n)
+  {
+    fi.Execute(first, last);
+  }
+  else
+  {
+    vtkIdType b = first;
+    while (b < last)
+    {
+      vtkIdType e = b + grain;
+      if (e > last)
+      {
+        e = last;
+      }
+      fi.Execute(b, e);
+      b = e;
+    }
+  }
+
+  this->IsParallel = fromParallelCode;
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator>
+void vtkSMPToolsImpl<BackendType::Sequential>::Sort(
+  RandomAccessIterator begin, RandomAccessIterator end)
+{
+  std::sort(begin, end);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator, typename Compare>
+void vtkSMPToolsImpl<BackendType::Sequential>::Sort(
+  RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+{
+  std::sort(begin, end, comp);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::Sequential>::Initialize(int);
+
+//--------------------------------------------------------------------------------
+template <>
+int vtkSMPToolsImpl<BackendType::Sequential>::GetEstimatedNumberOfThreads();
+
+//--------------------------------------------------------------------------------
+template <>
+bool vtkSMPToolsImpl<BackendType::Sequential>::IsParallelScope();
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+
+#endif
@@ -0,0 +1,111 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPThreadLocalImpl.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// A TBB based thread local storage implementation.
+
+#ifndef TBBvtkSMPThreadLocalImpl_h
+#define TBBvtkSMPThreadLocalImpl_h
+
+#include "SMP/Common/vtkSMPThreadLocalImplAbstract.h"
+
+#ifdef _MSC_VER
+#pragma push_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#define __TBB_NO_IMPLICIT_LINKAGE 1
+#endif
+
+#include <tbb/enumerable_thread_specific.h>
+
+#ifdef _MSC_VER
+#pragma pop_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#endif
+
+#include <iterator>
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+template <typename T>
+class vtkSMPThreadLocalImpl<BackendType::TBB, T> : public vtkSMPThreadLocalImplAbstract<T>
+{
+  typedef tbb::enumerable_thread_specific<T> TLS;
+  typedef typename TLS::iterator TLSIter;
+  typedef typename vtkSMPThreadLocalImplAbstract<T>::ItImpl ItImplAbstract;
+
+public:
+  vtkSMPThreadLocalImpl() = default;
+
+  explicit vtkSMPThreadLocalImpl(const T& exemplar)
+    : Internal(exemplar)
+  {
+  }
+
+  T& Local() override { return this->Internal.local(); }
+
+  size_t size() const override { return this->Internal.size(); }
+
+  class ItImpl : public ItImplAbstract
+  {
+  public:
+    void Increment() override { ++this->Iter; }
+
+    bool Compare(ItImplAbstract* other) override
+    {
+      return this->Iter == static_cast<ItImpl*>(other)->Iter;
+    }
+
+    T& GetContent() override { return *this->Iter; }
+
+    T* GetContentPtr() override { return &*this->Iter; }
+
+  protected:
+    ItImpl* CloneImpl() const override { return new ItImpl(*this); }
+
+  private:
+    TLSIter Iter;
+
+    friend class vtkSMPThreadLocalImpl<BackendType::TBB, T>;
+  };
+
+  std::unique_ptr<ItImplAbstract> begin() override
+  {
+    std::unique_ptr<ItImpl> iter(new ItImpl());
+    iter->Iter = this->Internal.begin();
+    return std::unique_ptr<ItImplAbstract>(iter.release());
+  }
+
+  std::unique_ptr<ItImplAbstract> end() override
+  {
+    std::unique_ptr<ItImpl> iter(new ItImpl());
+    iter->Iter = this->Internal.end();
+    return std::unique_ptr<ItImplAbstract>(iter.release());
+  }
+
+private:
+  TLS Internal;
+
+  // disable copying
+  vtkSMPThreadLocalImpl(const vtkSMPThreadLocalImpl&) = delete;
+  void operator=(const vtkSMPThreadLocalImpl&) = delete;
+};
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPThreadLocalImpl.h
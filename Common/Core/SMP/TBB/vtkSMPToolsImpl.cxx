@@ -0,0 +1,96 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "SMP/TBB/vtkSMPToolsImpl.txx"
+
+#ifdef _MSC_VER
+#pragma push_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#define __TBB_NO_IMPLICIT_LINKAGE 1
+#endif
+
+#include <tbb/task_arena.h>
+
+#ifdef _MSC_VER
+#pragma pop_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#endif
+
+#include <memory>
+#include <mutex>
+
+namespace
+{
+std::mutex vtkSMPToolsCS;
+// Only set when a number of threads was requested, otherwise the parallel
+// sections run in the implicit arena of the calling thread.
+std::unique_ptr<tbb::task_arena> vtkSMPToolsArena;
+int vtkTBBNumSpecifiedThreads = 0;
+}
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+//------------------------------------------------------------------------------
+void TBB::ExecuteInArena(void (*function)(void*), void* data)
+{
+  tbb::task_arena* arena = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(vtkSMPToolsCS);
+    arena = vtkSMPToolsArena.get();
+  }
+  if (arena)
+  {
+    arena->execute([&]() { function(data); });
+  }
+  else
+  {
+    function(data);
+  }
+}
+
+//------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::TBB>::Initialize(int numThreads)
+{
+  std::lock_guard<std::mutex> lock(vtkSMPToolsCS);
+  if (numThreads == vtkTBBNumSpecifiedThreads)
+  {
+    return;
+  }
+  vtkTBBNumSpecifiedThreads = numThreads > 0 ? numThreads : 0;
+  vtkSMPToolsArena.reset(numThreads > 0 ? new tbb::task_arena(numThreads) : nullptr);
+}
+
+//------------------------------------------------------------------------------
+template <>
+int vtkSMPToolsImpl<BackendType::TBB>::GetEstimatedNumberOfThreads()
+{
+  return vtkTBBNumSpecifiedThreads ? vtkTBBNumSpecifiedThreads
+                                   : tbb::this_task_arena::max_concurrency();
+}
+
+//------------------------------------------------------------------------------
+template <>
+bool vtkSMPToolsImpl<BackendType::TBB>::IsParallelScope()
+{
+  return this->IsParallel;
+}
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
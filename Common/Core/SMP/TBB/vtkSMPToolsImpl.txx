@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef TBBvtkSMPToolsImpl_txx
+#define TBBvtkSMPToolsImpl_txx
+
+#include "SMP/Common/vtkSMPToolsImpl.h"
+
+#ifdef _MSC_VER
+#pragma push_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#define __TBB_NO_IMPLICIT_LINKAGE 1
+#endif
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#ifdef _MSC_VER
+#pragma pop_macro("__TBB_NO_IMPLICIT_LINKAGE")
+#endif
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+namespace TBB
+{
+//--------------------------------------------------------------------------------
+template <typename T>
+class FuncCall
+{
+  T& o;
+
+  void operator=(const FuncCall&) = delete;
+
+public:
+  void operator()(const tbb::blocked_range<vtkIdType>& r) const { o.Execute(r.begin(), r.end()); }
+
+  FuncCall(T& _o)
+    : o(_o)
+  {
+  }
+};
+
+//--------------------------------------------------------------------------------
+template <typename FunctorInternal>
+void ParallelFor(vtkIdType first, vtkIdType last, vtkIdType grain, FunctorInternal& fi)
+{
+  vtkIdType range = last - first;
+  if (grain > 0)
+  {
+    tbb::parallel_for(
+      tbb::blocked_range<vtkIdType>(first, last, grain), FuncCall<FunctorInternal>(fi));
+  }
+  else
+  {
+    // When the grain is not specified, automatically calculate an appropriate grain size so
+    // most of the time will still be spent running the calculation and not task overhead.
+    const vtkIdType numberThreadsEstimate =
+      40; // Estimate of how many threads we might be able to run
+    const vtkIdType batchesPerThread =
+      5; // Plan for a few batches per thread so one busy core doesn't stall the whole system
+    const vtkIdType batches = numberThreadsEstimate * batchesPerThread;
+
+    if (range >= batches)
+    {
+      vtkIdType calculatedGrain =
+        ((range - 1) / batches) + 1; // std::ceil round up for systems without cmath
+      tbb::parallel_for(tbb::blocked_range<vtkIdType>(first, last, calculatedGrain),
+        FuncCall<FunctorInternal>(fi));
+    }
+    else
+    {
+      // Data is too small to generate a reasonable grain. Fallback to default so data still runs
+      // on as many threads as possible (Jan 2020: Default is one index per tbb task).
+      tbb::parallel_for(tbb::blocked_range<vtkIdType>(first, last), FuncCall<FunctorInternal>(fi));
+    }
+  }
+}
+
+// Runs the type erased parallel for inside the task arena holding the
+// number of threads requested through Initialize, if any.
+void VTKCOMMONCORE_EXPORT ExecuteInArena(void (*function)(void*), void* data);
+} // namespace TBB
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename FunctorInternal>
+void vtkSMPToolsImpl<BackendType::TBB>::For(
+  vtkIdType first, vtkIdType last, vtkIdType grain, FunctorInternal& fi)
+{
+  vtkIdType n = last - first;
+  if (n <= 0)
+  {
+    return;
+  }
+
+  // TBB does not tell whether a task runs inside a parallel_for, keep track
+  // of it ourselves to honor the nested parallelism setting.
+  if (!this->NestedActivated && this->IsParallel)
+  {
+    fi.Execute(first, last);
+    return;
+  }
+
+  struct Arguments
+  {
+    vtkIdType First;
+    vtkIdType Last;
+    vtkIdType Grain;
+    FunctorInternal* Functor;
+  } args = { first, last, grain, &fi };
+
+  bool fromParallelCode = this->IsParallel.exchange(true);
+  TBB::ExecuteInArena(
+    [](void* data) {
+      Arguments& a = *static_cast<Arguments*>(data);
+      TBB::ParallelFor(a.First, a.Last, a.Grain, *a.Functor);
+    },
+    &args);
+  this->IsParallel = fromParallelCode;
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator>
+void vtkSMPToolsImpl<BackendType::TBB>::Sort(RandomAccessIterator begin, RandomAccessIterator end)
+{
+  tbb::parallel_sort(begin, end);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator, typename Compare>
+void vtkSMPToolsImpl<BackendType::TBB>::Sort(
+  RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+{
+  tbb::parallel_sort(begin, end, comp);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::TBB>::Initialize(int);
+
+//--------------------------------------------------------------------------------
+template <>
+int vtkSMPToolsImpl<BackendType::TBB>::GetEstimatedNumberOfThreads();
+
+//--------------------------------------------------------------------------------
+template <>
+bool vtkSMPToolsImpl<BackendType::TBB>::IsParallelScope();
+
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+
+#endif
@@ -12,13 +12,18 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
+#include "vtkDataArrayRange.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkNew.h"
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
 #include "vtkSMPThreadLocal.h"
 #include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
+#include <algorithm>
 #include <functional>
+#include <numeric>
 #include <vector>
 
 static const int Target = 10000;
@@ -78,16 +83,58 @@ public:
   void Reduce() {}
 };
 
+class NestedFunctor
+{
+public:
+  vtkSMPThreadLocal<int> Counter;
+
+  NestedFunctor()
+    : Counter(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      // Irregular amount of nested work per index.
+      ARangeFunctor inner;
+      vtkSMPTools::For(0, i % 100, inner);
+      for (int value : inner.Counter)
+      {
+        this->Counter.Local() += value;
+      }
+    }
+  }
+};
+
+class ParallelScopeFunctor
+{
+public:
+  vtkSMPThreadLocal<int> OutOfScope;
+
+  ParallelScopeFunctor()
+    : OutOfScope(0)
+  {
+  }
+
+  void operator()(vtkIdType, vtkIdType)
+  {
+    if (!vtkSMPTools::IsParallelScope())
+    {
+      this->OutOfScope.Local()++;
+    }
+  }
+};
+
 // For sorting comparison
 bool myComp(double a, double b)
 {
   return (a < b);
 }
 
-int TestSMP(int, char*[])
+int doTestSMP()
 {
-  // vtkSMPTools::Initialize(8);
-
   ARangeFunctor functor1;
 
   vtkSMPTools::For(0, Target, functor1);
@@ -130,6 +177,48 @@ int TestSMP(int, char*[])
     return 1;
   }
 
+  // Test nested parallel for with an irregular workload, both with and
+  // without nested parallelism
+  int nestedTarget = 0;
+  for (int i = 0; i < Target; ++i)
+  {
+    nestedTarget += i % 100;
+  }
+  for (bool nested : { false, true })
+  {
+    NestedFunctor functor3;
+    vtkSMPTools::LocalScope(
+      vtkSMPTools::Config{ nested }, [&]() { vtkSMPTools::For(0, Target, 7, functor3); });
+    total = 0;
+    for (int value : functor3.Counter)
+    {
+      total += value;
+    }
+    if (total != nestedTarget)
+    {
+      cerr << "Error: NestedFunctor did not generate " << nestedTarget
+           << " with nested parallelism " << (nested ? "on" : "off") << endl;
+      return 1;
+    }
+  }
+
+  // Test parallel scope
+  if (vtkSMPTools::IsParallelScope())
+  {
+    cerr << "Error: IsParallelScope returned true outside of a parallel section" << endl;
+    return 1;
+  }
+  ParallelScopeFunctor functor4;
+  vtkSMPTools::For(0, Target, functor4);
+  for (int value : functor4.OutOfScope)
+  {
+    if (value != 0)
+    {
+      cerr << "Error: IsParallelScope returned false inside of a parallel section" << endl;
+      return 1;
+    }
+  }
+
   // Test sorting
   double data0[] = { 2, 1, 0, 3, 9, 6, 7, 3, 8, 4, 5 };
   std::vector<double> myvector(data0, data0 + 11);
@@ -157,5 +246,153 @@ int TestSMP(int, char*[])
     }
   }
 
+  // Large enough to be sorted in parallel by the threaded backends
+  std::vector<int> large(1000003);
+  for (size_t i = 0; i < large.size(); ++i)
+  {
+    large[i] = static_cast<int>((i * 7919) % large.size());
+  }
+  vtkSMPTools::Sort(large.begin(), large.end());
+  for (size_t i = 0; i < large.size(); ++i)
+  {
+    if (large[i] != static_cast<int>(i))
+    {
+      cerr << "Error: Bad large vector sort!" << endl;
+      return 1;
+    }
+  }
+
+  // Test the STL-like algorithms on data array ranges. The size is not a
+  // multiple of the block size used by Reduce and Scan.
+  const vtkIdType size = 100003;
+  vtkNew<vtkDoubleArray> doubles;
+  doubles->SetNumberOfValues(size);
+  auto doubleRange = vtk::DataArrayValueRange<1>(doubles);
+  vtkSMPTools::Fill(doubleRange.begin(), doubleRange.end(), 2.0);
+  for (double value : doubleRange)
+  {
+    if (value != 2.0)
+    {
+      cerr << "Error: Bad Fill!" << endl;
+      return 1;
+    }
+  }
+
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetNumberOfValues(size);
+  auto idRange = vtk::DataArrayValueRange<1>(ids);
+  std::iota(idRange.begin(), idRange.end(), 0);
+  vtkSMPTools::Transform(idRange.cbegin(), idRange.cend(), doubleRange.begin(),
+    [](vtkIdType id) { return static_cast<double>(id % 7); });
+  vtkSMPTools::Transform(doubleRange.cbegin(), doubleRange.cend(), idRange.cbegin(),
+    doubleRange.begin(), [](double x, vtkIdType id) { return x + id; });
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    if (doubleRange[i] != static_cast<double>(i % 7 + i))
+    {
+      cerr << "Error: Bad Transform!" << endl;
+      return 1;
+    }
+  }
+
+  const vtkIdType sum = vtkSMPTools::Reduce(idRange.cbegin(), idRange.cend(), vtkIdType(10));
+  if (sum != 10 + size * (size - 1) / 2)
+  {
+    cerr << "Error: Bad Reduce!" << endl;
+    return 1;
+  }
+  const vtkIdType maxId = vtkSMPTools::Reduce(idRange.cbegin(), idRange.cend(), vtkIdType(-1),
+    [](vtkIdType a, vtkIdType b) { return std::max(a, b); });
+  if (maxId != size - 1)
+  {
+    cerr << "Error: Bad Reduce with operation!" << endl;
+    return 1;
+  }
+  if (vtkSMPTools::Reduce(idRange.cbegin(), idRange.cbegin(), vtkIdType(3)) != 3)
+  {
+    cerr << "Error: Bad Reduce of an empty range!" << endl;
+    return 1;
+  }
+
+  std::vector<vtkIdType> counts(size);
+  std::vector<vtkIdType> expected(size);
+  std::vector<vtkIdType> scanned(size);
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    counts[i] = i % 5;
+  }
+
+  std::partial_sum(counts.begin(), counts.end(), expected.begin());
+  auto scanEnd = vtkSMPTools::InclusiveScan(counts.begin(), counts.end(), scanned.begin());
+  if (scanEnd != scanned.end() || scanned != expected)
+  {
+    cerr << "Error: Bad InclusiveScan!" << endl;
+    return 1;
+  }
+
+  vtkIdType acc = 3;
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    expected[i] = acc;
+    acc += counts[i];
+  }
+  // In place, into a data array range.
+  std::copy(counts.begin(), counts.end(), idRange.begin());
+  vtkSMPTools::ExclusiveScan(idRange.begin(), idRange.end(), idRange.begin(), vtkIdType(3));
+  if (!std::equal(idRange.cbegin(), idRange.cend(), expected.begin()))
+  {
+    cerr << "Error: Bad ExclusiveScan!" << endl;
+    return 1;
+  }
+
+  // Floating point reductions are reproducible.
+  vtkSMPTools::Transform(idRange.cbegin(), idRange.cend(), doubleRange.begin(),
+    [](vtkIdType id) { return 1.0 / (1.0 + id); });
+  const double fsum = vtkSMPTools::Reduce(doubleRange.cbegin(), doubleRange.cend(), 0.0);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 3 }, [&]() {
+    if (vtkSMPTools::Reduce(doubleRange.cbegin(), doubleRange.cend(), 0.0) != fsum)
+    {
+      cerr << "Error: Reduce depends on the number of threads!" << endl;
+      acc = -1;
+    }
+  });
+  if (acc < 0)
+  {
+    return 1;
+  }
+
+  return 0;
+}
+
+int TestSMP(int, char*[])
+{
+  const char* backends[] = { "Sequential", "STDThread", "TBB", "OpenMP" };
+  for (const char* backend : backends)
+  {
+    if (!vtkSMPTools::SetBackend(backend))
+    {
+      continue;
+    }
+    cout << "Testing backend " << vtkSMPTools::GetBackend() << endl;
+    if (doTestSMP())
+    {
+      return 1;
+    }
+
+    // Same with a local number of threads and nested parallelism
+    int result = 0;
+    vtkSMPTools::LocalScope(
+      vtkSMPTools::Config{ 2, backend, true }, [&]() { result = doTestSMP(); });
+    if (result)
+    {
+      return 1;
+    }
+    if (vtkSMPTools::GetNestedParallelism())
+    {
+      cerr << "Error: LocalScope did not restore the nested parallelism" << endl;
+      return 1;
+    }
+  }
+
   return 0;
 }
@@ -0,0 +1,213 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPToolsPerformance.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test speed of the vtkSMPTools algorithms.
+// .SECTION Description
+// Time vtkSMPTools::For, Fill, Transform, Reduce, ExclusiveScan and Sort on
+// every available backend and compare them with their sequential std
+// counterparts.
+
+#include "vtkDataArrayRange.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// How many times the tests are run to average the elapsed time.
+static const int STRESS_COUNT = 3;
+
+// Number of values processed by each algorithm.
+static const vtkIdType SIZE = 1 << 22;
+
+// Description:
+// Type of console outputs.
+// CDash writes perfs as <DartMeasurement ...> for unit test regression
+// Csv writes perfs as a table for easy plotting in spreadsheet apps
+enum VerboseType
+{
+  None = 0x0,
+  CDash = 0x1,
+  Csv = 0x2
+};
+
+static const int VERBOSE_MODE = CDash;
+
+//------------------------------------------------------------------------------
+template <typename Function>
+double TimeIt(const std::string& backend, const std::string& name, Function&& function)
+{
+  vtkNew<vtkTimerLog> timer;
+  double meanDuration = 0.0;
+  for (int i = 0; i < STRESS_COUNT; ++i)
+  {
+    timer->StartTimer();
+    function();
+    timer->StopTimer();
+    meanDuration += timer->GetElapsedTime();
+  }
+  meanDuration /= STRESS_COUNT;
+  if (VERBOSE_MODE & CDash)
+  {
+    std::cout << "<DartMeasurement name=\"" << name << "-" << backend
+              << "\" type=\"numeric/double\">" << meanDuration << "</DartMeasurement>"
+              << std::endl;
+  }
+  if (VERBOSE_MODE & Csv)
+  {
+    std::cout << backend << "," << name << "," << meanDuration << std::endl;
+  }
+  return meanDuration;
+}
+
+//------------------------------------------------------------------------------
+// Runs every algorithm on the active backend, or with the std algorithms if
+// backend is "std". Returns false if the results are wrong.
+bool RunAlgorithms(const std::string& backend)
+{
+  const bool useStd = backend == "std";
+
+  vtkNew<vtkDoubleArray> values;
+  values->SetNumberOfValues(SIZE);
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetNumberOfValues(SIZE);
+  auto valueRange = vtk::DataArrayValueRange<1>(values);
+  auto idRange = vtk::DataArrayValueRange<1>(ids);
+
+  TimeIt(backend, "Fill", [&]() {
+    if (useStd)
+    {
+      std::fill(idRange.begin(), idRange.end(), 1);
+    }
+    else
+    {
+      vtkSMPTools::Fill(idRange.begin(), idRange.end(), 1);
+    }
+  });
+
+  auto transform = [](vtkIdType id) { return std::sqrt(static_cast<double>(id)); };
+  TimeIt(backend, "Transform", [&]() {
+    if (useStd)
+    {
+      std::transform(idRange.cbegin(), idRange.cend(), valueRange.begin(), transform);
+    }
+    else
+    {
+      vtkSMPTools::Transform(idRange.cbegin(), idRange.cend(), valueRange.begin(), transform);
+    }
+  });
+
+  // A loop with an uneven cost per index.
+  TimeIt(backend, "For", [&]() {
+    auto work = [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        double x = valueRange[i];
+        for (vtkIdType j = 0; j < i % 16; ++j)
+        {
+          x = std::sin(x);
+        }
+        valueRange[i] = x;
+      }
+    };
+    if (useStd)
+    {
+      work(0, SIZE);
+    }
+    else
+    {
+      vtkSMPTools::For(0, SIZE, work);
+    }
+  });
+
+  vtkIdType sum = 0;
+  TimeIt(backend, "Reduce", [&]() {
+    sum = useStd ? std::accumulate(idRange.cbegin(), idRange.cend(), vtkIdType(0))
+                 : vtkSMPTools::Reduce(idRange.cbegin(), idRange.cend(), vtkIdType(0));
+  });
+  if (sum != SIZE)
+  {
+    std::cerr << "Error: Bad Reduce on " << backend << std::endl;
+    return false;
+  }
+
+  std::vector<vtkIdType> offsets(SIZE);
+  TimeIt(backend, "ExclusiveScan", [&]() {
+    if (useStd)
+    {
+      vtkIdType acc = 0;
+      auto out = offsets.begin();
+      for (vtkIdType count : idRange)
+      {
+        *out++ = acc;
+        acc += count;
+      }
+    }
+    else
+    {
+      vtkSMPTools::ExclusiveScan(idRange.cbegin(), idRange.cend(), offsets.begin(), vtkIdType(0));
+    }
+  });
+  if (offsets.back() != SIZE - 1)
+  {
+    std::cerr << "Error: Bad ExclusiveScan on " << backend << std::endl;
+    return false;
+  }
+
+  std::vector<vtkIdType> toSort(SIZE);
+  TimeIt(backend, "Sort", [&]() {
+    for (vtkIdType i = 0; i < SIZE; ++i)
+    {
+      toSort[i] = (i * 7919) % SIZE;
+    }
+    if (useStd)
+    {
+      std::sort(toSort.begin(), toSort.end());
+    }
+    else
+    {
+      vtkSMPTools::Sort(toSort.begin(), toSort.end());
+    }
+  });
+  if (!std::is_sorted(toSort.begin(), toSort.end()))
+  {
+    std::cerr << "Error: Bad Sort on " << backend << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+int TestSMPToolsPerformance(int, char*[])
+{
+  bool res = RunAlgorithms("std");
+
+  const char* backends[] = { "Sequential", "STDThread", "TBB", "OpenMP" };
+  for (const char* backend : backends)
+  {
+    if (vtkSMPTools::SetBackend(backend))
+    {
+      res &= RunAlgorithms(backend);
+    }
+  }
+  return res ? EXIT_SUCCESS : EXIT_FAILURE;
+}
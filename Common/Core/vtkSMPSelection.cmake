@@ -1,47 +1,82 @@
+# Every backend enabled here is compiled in; VTK_SMP_IMPLEMENTATION_TYPE only
+# selects the one used by default. vtkSMPTools::SetBackend and the
+# VTK_SMP_BACKEND_IN_USE environment variable switch backends at runtime.
 set(VTK_SMP_IMPLEMENTATION_TYPE "Sequential"
-  CACHE STRING "Which multi-threaded parallelism implementation to use. Options are Sequential, OpenMP or TBB")
+  CACHE STRING "Which multi-threaded parallelism implementation to use by default. Options are Sequential, STDThread, OpenMP or TBB")
 set_property(CACHE VTK_SMP_IMPLEMENTATION_TYPE
   PROPERTY
-    STRINGS Sequential OpenMP TBB)
+    STRINGS Sequential STDThread OpenMP TBB)
 
 if (NOT (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP" OR
-         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB"))
+         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB" OR
+         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "STDThread"))
   set_property(CACHE VTK_SMP_IMPLEMENTATION_TYPE
     PROPERTY
       VALUE "Sequential")
 endif ()
 
-set(vtk_smp_headers_to_configure)
-set(vtk_smp_defines)
+# The default backend is enabled by default.
+string(COMPARE EQUAL "${VTK_SMP_IMPLEMENTATION_TYPE}" "OpenMP" vtk_smp_default_is_openmp)
+string(COMPARE EQUAL "${VTK_SMP_IMPLEMENTATION_TYPE}" "TBB" vtk_smp_default_is_tbb)
+option(VTK_SMP_ENABLE_STDTHREAD "Enable the STDThread vtkSMPTools backend" ON)
+option(VTK_SMP_ENABLE_OPENMP "Enable the OpenMP vtkSMPTools backend" "${vtk_smp_default_is_openmp}")
+option(VTK_SMP_ENABLE_TBB "Enable the TBB vtkSMPTools backend" "${vtk_smp_default_is_tbb}")
+mark_as_advanced(
+  VTK_SMP_ENABLE_STDTHREAD
+  VTK_SMP_ENABLE_OPENMP
+  VTK_SMP_ENABLE_TBB)
+
+# The Sequential backend is always available and the default backend must
+# be enabled.
+set(VTK_SMP_ENABLE_SEQUENTIAL ON)
+string(TOUPPER "${VTK_SMP_IMPLEMENTATION_TYPE}" vtk_smp_default_upper)
+if (NOT VTK_SMP_ENABLE_${vtk_smp_default_upper})
+  message(FATAL_ERROR
+    "The default SMP backend ${VTK_SMP_IMPLEMENTATION_TYPE} is disabled. Set "
+    "VTK_SMP_ENABLE_${vtk_smp_default_upper} to ON or choose another "
+    "VTK_SMP_IMPLEMENTATION_TYPE.")
+endif ()
+set("VTK_SMP_DEFAULT_IMPLEMENTATION_${vtk_smp_default_upper}" ON)
+
+set(vtk_smp_backends)
 set(vtk_smp_use_default_atomics ON)
 
-if (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB")
+set(vtk_smp_Common_headers
+  vtkSMPThreadLocalAPI.h
+  vtkSMPThreadLocalImplAbstract.h
+  vtkSMPToolsAPI.h
+  vtkSMPToolsImpl.h)
+list(APPEND vtk_smp_sources
+  "${CMAKE_CURRENT_SOURCE_DIR}/vtkSMPTools.cxx"
+  "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Common/vtkSMPToolsAPI.cxx")
+
+if (VTK_SMP_ENABLE_TBB)
   vtk_module_find_package(PACKAGE TBB)
   list(APPEND vtk_smp_libraries
     TBB::tbb)
 
   set(vtk_smp_use_default_atomics OFF)
-  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/TBB")
+  list(APPEND vtk_smp_backends TBB)
   list(APPEND vtk_smp_sources
-    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx")
-  list(APPEND vtk_smp_headers_to_configure
-    vtkSMPToolsInternal.h
-    vtkSMPThreadLocal.h)
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/TBB/vtkSMPToolsImpl.cxx")
+  set(vtk_smp_TBB_headers
+    vtkSMPThreadLocalImpl.h
+    vtkSMPToolsImpl.txx)
+endif ()
 
-elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
+if (VTK_SMP_ENABLE_OPENMP)
   vtk_module_find_package(PACKAGE OpenMP)
-
   list(APPEND vtk_smp_libraries
     OpenMP::OpenMP_CXX)
 
-  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP")
+  list(APPEND vtk_smp_backends OpenMP)
   list(APPEND vtk_smp_sources
-    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx"
-    "${vtk_smp_implementation_dir}/vtkSMPThreadLocalImpl.cxx")
-  list(APPEND vtk_smp_headers_to_configure
-    vtkSMPThreadLocal.h
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP/vtkSMPToolsImpl.cxx"
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP/vtkSMPThreadLocalBackend.cxx")
+  set(vtk_smp_OpenMP_headers
+    vtkSMPThreadLocalBackend.h
     vtkSMPThreadLocalImpl.h
-    vtkSMPToolsInternal.h)
+    vtkSMPToolsImpl.txx)
 
   if (OpenMP_CXX_SPEC_DATE AND NOT "${OpenMP_CXX_SPEC_DATE}" LESS "201107")
     set(vtk_smp_use_default_atomics OFF)
@@ -50,15 +85,29 @@ elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
       "Required OpenMP version (3.1) for atomics not detected. Using default "
       "atomics implementation.")
   endif()
+endif ()
 
-elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "Sequential")
-  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Sequential")
+if (VTK_SMP_ENABLE_STDTHREAD)
+  # Threads::Threads is already a public dependency of CommonCore.
+  set(vtk_smp_use_default_atomics OFF)
+  list(APPEND vtk_smp_backends STDThread)
   list(APPEND vtk_smp_sources
-    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx")
-  list(APPEND vtk_smp_headers_to_configure
-    vtkSMPThreadLocal.h
-    vtkSMPToolsInternal.h)
-endif()
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/STDThread/vtkSMPToolsImpl.cxx"
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/STDThread/vtkSMPThreadLocalBackend.cxx"
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/STDThread/vtkSMPThreadPool.cxx")
+  set(vtk_smp_STDThread_headers
+    vtkSMPThreadLocalBackend.h
+    vtkSMPThreadLocalImpl.h
+    vtkSMPThreadPool.h
+    vtkSMPToolsImpl.txx)
+endif ()
+
+list(APPEND vtk_smp_backends Sequential)
+list(APPEND vtk_smp_sources
+  "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Sequential/vtkSMPToolsImpl.cxx")
+set(vtk_smp_Sequential_headers
+  vtkSMPThreadLocalImpl.h
+  vtkSMPToolsImpl.txx)
 
 if (vtk_smp_use_default_atomics)
   include(CheckSymbolExists)
@@ -68,15 +117,7 @@ if (vtk_smp_use_default_atomics)
   set(vtk_atomics_default_impl_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Sequential")
 endif()
 
-foreach (vtk_smp_header IN LISTS vtk_smp_headers_to_configure)
-  configure_file(
-    "${vtk_smp_implementation_dir}/${vtk_smp_header}.in"
-    "${CMAKE_CURRENT_BINARY_DIR}/${vtk_smp_header}"
-    COPYONLY)
-  list(APPEND vtk_smp_headers
-    "${CMAKE_CURRENT_BINARY_DIR}/${vtk_smp_header}")
-endforeach()
-
 list(APPEND vtk_smp_headers
   vtkSMPTools.h
+  vtkSMPThreadLocal.h
   vtkSMPThreadLocalObject.h)
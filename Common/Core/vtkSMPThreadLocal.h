@@ -12,8 +12,7 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
-// .NAME vtkSMPThreadLocal - A thread local storage implementation using
-// platform specific facilities.
+// .NAME vtkSMPThreadLocal - Thread local storage for vtkSMPTools.
 // .SECTION Description
 // A thread local object is one that maintains a copy of an object of the
 // template type for each thread that processes data. vtkSMPThreadLocal
@@ -30,14 +29,26 @@
 // write/accumulate data to local object when executing in parallel and
 // then having a sequential code block that iterates over the whole storage
 // using the iterators to do the final accumulation.
+//
+// The storage belongs to the backend that is active when Local() is
+// called. Objects created while one backend is active are not visible
+// after switching to another backend with vtkSMPTools::SetBackend.
+//
+// .SECTION Warning
+// There is absolutely no guarantee to the order in which the local objects
+// will be stored and hence the order in which they will be traversed when
+// using iterators. You should not even assume that two vtkSMPThreadLocal
+// populated in the same parallel section will be populated in the same
+// order. If you need to store values related to each other and iterate
+// over them together, use a struct or class to group them together and use
+// a thread local of that class.
 
 #ifndef vtkSMPThreadLocal_h
 #define vtkSMPThreadLocal_h
 
-#include "vtkSMPThreadLocalImpl.h"
-#include "vtkSMPToolsInternal.h"
+#include "SMP/Common/vtkSMPThreadLocalAPI.h"
 
-#include <iterator>
+#include <iterator> // For std::iterator
 
 template <typename T>
 class vtkSMPThreadLocal
@@ -45,29 +56,17 @@ class vtkSMPThreadLocal
 public:
   // Description:
   // Default constructor. Creates a default exemplar.
-  vtkSMPThreadLocal() : Backend(vtk::detail::smp::GetNumberOfThreads())
-  {
-  }
+  vtkSMPThreadLocal() = default;
 
   // Description:
   // Constructor that allows the specification of an exemplar object
   // which is used when constructing objects when Local() is first called.
   // Note that a copy of the exemplar is created using its copy constructor.
   explicit vtkSMPThreadLocal(const T& exemplar)
-    : Backend(vtk::detail::smp::GetNumberOfThreads()), Exemplar(exemplar)
+    : ThreadLocalAPI(exemplar)
   {
   }
 
-  ~vtkSMPThreadLocal()
-  {
-    detail::ThreadSpecificStorageIterator it;
-    it.SetThreadSpecificStorage(Backend);
-    for (it.SetToBegin(); !it.GetAtEnd(); it.Forward())
-    {
-      delete reinterpret_cast<T*>(it.GetStorage());
-    }
-  }
-
   // Description:
   // Returns an object of type T that is local to the current thread.
   // This needs to be called mainly within a threaded execution path.
@@ -76,23 +75,11 @@ public:
   // to the constructor (or a default object if no exemplar was provided)
   // the first time it is called. After the first time, it will return
   // the same object.
-  T& Local()
-  {
-    detail::StoragePointerType &ptr = this->Backend.GetStorage();
-    T *local = reinterpret_cast<T*>(ptr);
-    if (!ptr)
-    {
-       ptr = local = new T(this->Exemplar);
-    }
-    return *local;
-  }
+  T& Local() { return this->ThreadLocalAPI.Local(); }
 
   // Description:
   // Return the number of thread local objects that have been initialized
-  size_t size() const
-  {
-    return this->Backend.Size();
-  }
+  size_t size() const { return this->ThreadLocalAPI.size(); }
 
   // Description:
   // Subset of the standard iterator API.
@@ -102,78 +89,24 @@ public:
   // It is thread safe to iterate over the thread local containers
   // as long as each thread uses its own iterator and does not modify
   // objects in the container.
-  class iterator
-      : public std::iterator<std::forward_iterator_tag, T> // for iterator_traits
-  {
-  public:
-    iterator& operator++()
-    {
-      this->Impl.Forward();
-      return *this;
-    }
-
-    iterator operator++(int)
-    {
-      iterator copy = *this;
-      this->Impl.Forward();
-      return copy;
-    }
-
-    bool operator==(const iterator& other)
-    {
-      return this->Impl == other.Impl;
-    }
-
-    bool operator!=(const iterator& other)
-    {
-      return !(this->Impl == other.Impl);
-    }
-
-    T& operator*()
-    {
-      return *reinterpret_cast<T*>(this->Impl.GetStorage());
-    }
-
-    T* operator->()
-    {
-      return reinterpret_cast<T*>(this->Impl.GetStorage());
-    }
-
-  private:
-    detail::ThreadSpecificStorageIterator Impl;
-
-    friend class vtkSMPThreadLocal<T>;
-  };
+  typedef typename vtk::detail::smp::vtkSMPThreadLocalAPI<T>::iterator iterator;
 
   // Description:
   // Returns a new iterator pointing to the beginning of
   // the local storage container. Thread safe.
-  iterator begin()
-  {
-    iterator it;
-    it.Impl.SetThreadSpecificStorage(Backend);
-    it.Impl.SetToBegin();
-    return it;
-  }
+  iterator begin() { return this->ThreadLocalAPI.begin(); }
 
   // Description:
   // Returns a new iterator pointing to past the end of
   // the local storage container. Thread safe.
-  iterator end()
-  {
-    iterator it;
-    it.Impl.SetThreadSpecificStorage(Backend);
-    it.Impl.SetToEnd();
-    return it;
-  }
+  iterator end() { return this->ThreadLocalAPI.end(); }
 
 private:
-  detail::ThreadSpecific Backend;
-  T Exemplar;
+  vtk::detail::smp::vtkSMPThreadLocalAPI<T> ThreadLocalAPI;
 
   // disable copying
-  vtkSMPThreadLocal(const vtkSMPThreadLocal&);
-  void operator=(const vtkSMPThreadLocal&);
+  vtkSMPThreadLocal(const vtkSMPThreadLocal&) = delete;
+  void operator=(const vtkSMPThreadLocal&) = delete;
 };
 
 #endif
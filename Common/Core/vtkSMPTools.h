@@ -19,8 +19,10 @@
  * vtkSMPTools provides a set of utility functions that can
  * be used to parallelize parts of VTK code using multiple threads.
  * There are several back-end implementations of parallel functionality
- * (currently Sequential, TBB and X-Kaapi) that actual execution is
- * delegated to.
+ * (currently Sequential, STDThread, OpenMP and TBB) that actual execution is
+ * delegated to. Every backend enabled at configure time is compiled in and
+ * the one in use can be changed at runtime with SetBackend() or the
+ * VTK_SMP_BACKEND_IN_USE environment variable.
  */
 
 #ifndef vtkSMPTools_h
@@ -29,8 +31,14 @@
 #include "vtkCommonCoreModule.h" // For export macro
 #include "vtkObject.h"
 
-#include "vtkSMPThreadLocal.h" // For Initialized
-#include "vtkSMPToolsInternal.h"
+#include "SMP/Common/vtkSMPToolsAPI.h" // For SMPToolsAPI
+#include "vtkSMPThreadLocal.h"            // For Initialized
+
+#include <algorithm>  // For std::fill
+#include <functional> // For std::plus
+#include <iterator>   // For std::iterator_traits
+#include <string>     // For std::string
+#include <vector>     // For std::vector
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifndef __VTK_WRAP__
@@ -90,7 +98,8 @@ struct vtkSMPTools_FunctorInternal<Functor, false>
   void Execute(vtkIdType first, vtkIdType last) { this->F(first, last); }
   void For(vtkIdType first, vtkIdType last, vtkIdType grain)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+    auto& SMPToolsAPI = vtkSMPToolsAPI::GetInstance();
+    SMPToolsAPI.For(first, last, grain, *this);
   }
   vtkSMPTools_FunctorInternal<Functor, false>& operator=(
     const vtkSMPTools_FunctorInternal<Functor, false>&);
@@ -119,7 +128,8 @@ struct vtkSMPTools_FunctorInternal<Functor, true>
   }
   void For(vtkIdType first, vtkIdType last, vtkIdType grain)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_For(first, last, grain, *this);
+    auto& SMPToolsAPI = vtkSMPToolsAPI::GetInstance();
+    SMPToolsAPI.For(first, last, grain, *this);
     this->F.Reduce();
   }
   vtkSMPTools_FunctorInternal<Functor, true>& operator=(
@@ -144,6 +154,199 @@ class vtkSMPTools_Lookup_For<Functor const>
 public:
   typedef vtkSMPTools_FunctorInternal<Functor const, init> type;
 };
+
+//--------------------------------------------------------------------------------
+// Helpers of the STL-like algorithms of vtkSMPTools. They are plain functors
+// executed through vtkSMPTools::For, so every backend supports them.
+template <typename InputIt, typename OutputIt, typename Functor>
+struct vtkSMPTools_UnaryTransformCall
+{
+  InputIt In;
+  OutputIt Out;
+  Functor& Transform;
+
+  vtkSMPTools_UnaryTransformCall(InputIt in, OutputIt out, Functor& transform)
+    : In(in)
+    , Out(out)
+    , Transform(transform)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    InputIt it = this->In + begin;
+    OutputIt outIt = this->Out + begin;
+    for (vtkIdType i = begin; i < end; ++i, ++it, ++outIt)
+    {
+      *outIt = this->Transform(*it);
+    }
+  }
+};
+
+template <typename InputIt1, typename InputIt2, typename OutputIt, typename Functor>
+struct vtkSMPTools_BinaryTransformCall
+{
+  InputIt1 In1;
+  InputIt2 In2;
+  OutputIt Out;
+  Functor& Transform;
+
+  vtkSMPTools_BinaryTransformCall(InputIt1 in1, InputIt2 in2, OutputIt out, Functor& transform)
+    : In1(in1)
+    , In2(in2)
+    , Out(out)
+    , Transform(transform)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    InputIt1 it1 = this->In1 + begin;
+    InputIt2 it2 = this->In2 + begin;
+    OutputIt outIt = this->Out + begin;
+    for (vtkIdType i = begin; i < end; ++i, ++it1, ++it2, ++outIt)
+    {
+      *outIt = this->Transform(*it1, *it2);
+    }
+  }
+};
+
+template <typename Iterator, typename T>
+struct vtkSMPTools_FillFunctor
+{
+  Iterator Begin;
+  const T& Value;
+
+  vtkSMPTools_FillFunctor(Iterator begin, const T& value)
+    : Begin(begin)
+    , Value(value)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::fill(this->Begin + begin, this->Begin + end, this->Value);
+  }
+};
+
+// Reduce and Scan split the range into blocks that only depend on its size,
+// never on the backend or the number of threads, and combine the per block
+// results in block order. The results are therefore reproducible from run to
+// run, even for operations such as floating point additions that are only
+// approximately associative.
+struct vtkSMPTools_Blocks
+{
+  vtkIdType Size;
+  vtkIdType NumberOfBlocks;
+
+  explicit vtkSMPTools_Blocks(vtkIdType size)
+    : Size(size)
+  {
+    // Large enough blocks to amortize the scheduling, and enough of them to
+    // balance the load on many cores.
+    const vtkIdType minimumBlockSize = 1024;
+    const vtkIdType maximumNumberOfBlocks = 256;
+    this->NumberOfBlocks = std::min(size / minimumBlockSize, maximumNumberOfBlocks);
+    this->NumberOfBlocks = std::max(this->NumberOfBlocks, static_cast<vtkIdType>(1));
+  }
+
+  vtkIdType Begin(vtkIdType block) const { return this->Size * block / this->NumberOfBlocks; }
+};
+
+template <typename Iterator, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockReduceFunctor
+{
+  Iterator Begin;
+  const vtkSMPTools_Blocks& Blocks;
+  std::vector<T>& Partials;
+  BinaryOp& Op;
+
+  vtkSMPTools_BlockReduceFunctor(
+    Iterator begin, const vtkSMPTools_Blocks& blocks, std::vector<T>& partials, BinaryOp& op)
+    : Begin(begin)
+    , Blocks(blocks)
+    , Partials(partials)
+    , Op(op)
+  {
+  }
+
+  void operator()(vtkIdType firstBlock, vtkIdType lastBlock)
+  {
+    for (vtkIdType block = firstBlock; block < lastBlock; ++block)
+    {
+      Iterator it = this->Begin + this->Blocks.Begin(block);
+      Iterator end = this->Begin + this->Blocks.Begin(block + 1);
+      T acc = *it;
+      for (++it; it != end; ++it)
+      {
+        acc = this->Op(acc, *it);
+      }
+      this->Partials[block] = acc;
+    }
+  }
+};
+
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockScanFunctor
+{
+  InputIt In;
+  OutputIt Out;
+  const vtkSMPTools_Blocks& Blocks;
+  // Combination of everything before each block. Offsets[0] is only
+  // meaningful when HasInit is true.
+  const std::vector<T>& Offsets;
+  bool HasInit;
+  bool Inclusive;
+  BinaryOp& Op;
+
+  vtkSMPTools_BlockScanFunctor(InputIt in, OutputIt out, const vtkSMPTools_Blocks& blocks,
+    const std::vector<T>& offsets, bool hasInit, bool inclusive, BinaryOp& op)
+    : In(in)
+    , Out(out)
+    , Blocks(blocks)
+    , Offsets(offsets)
+    , HasInit(hasInit)
+    , Inclusive(inclusive)
+    , Op(op)
+  {
+  }
+
+  void operator()(vtkIdType firstBlock, vtkIdType lastBlock)
+  {
+    for (vtkIdType block = firstBlock; block < lastBlock; ++block)
+    {
+      const vtkIdType begin = this->Blocks.Begin(block);
+      const vtkIdType end = this->Blocks.Begin(block + 1);
+      InputIt it = this->In + begin;
+      OutputIt outIt = this->Out + begin;
+      vtkIdType i = begin;
+      T acc = this->Offsets[block];
+      if (block == 0 && !this->HasInit)
+      {
+        // Only an inclusive scan can start without an initial value.
+        acc = *it;
+        *outIt = acc;
+        ++i, ++it, ++outIt;
+      }
+      for (; i < end; ++i, ++it, ++outIt)
+      {
+        // Read the input before writing the output so that the scan can be
+        // done in place.
+        T value = *it;
+        if (this->Inclusive)
+        {
+          acc = this->Op(acc, value);
+          *outIt = acc;
+        }
+        else
+        {
+          *outIt = acc;
+          acc = this->Op(acc, value);
+        }
+      }
+    }
+  }
+};
 } // namespace smp
 } // namespace detail
 } // namespace vtk
@@ -224,15 +427,31 @@ public:
    */
   static const char* GetBackend();
 
+  /**
+   * Change the backend in use.
+   * The options can be: "Sequential", "STDThread", "TBB" or "OpenMP"
+   *
+   * VTK_SMP_BACKEND_IN_USE env variable can also be used to set the default SMPTools
+   * backend, in that case SetBackend() doesn't need to be called.
+   * The backend selected with SetBackend() have the priority over VTK_SMP_BACKEND_IN_USE.
+   *
+   * SetBackend() will return true if the backend was found and available.
+   */
+  static bool SetBackend(const char* backend);
+
   /**
    * Initialize the underlying libraries for execution. This is
-   * not required as it is automatically called before the first
-   * execution of any parallel code. However, it can be used to
-   * control the maximum number of threads used when the back-end
-   * supports it (currently Simple and TBB only). Make sure to call
-   * it before any other parallel operation.
-   * When using Kaapi, use the KAAPI_CPUCOUNT env. variable to control
-   * the number of threads used in the thread pool.
+   * not required as it is automatically defined by the libaries.
+   * However, it can be used to control the maximum number of thread used.
+   * Make sure to call it before the parallel operation.
+   *
+   * If Initialize is called without argument it will reset
+   * to the maximum number of threads or use the VTK_SMP_MAX_THREADS
+   * env variable if it is defined.
+   *
+   * Note: If VTK_SMP_MAX_THREADS env variable is defined the SMPTools will try
+   * to use it to set the maximum number of threads. Initialize() doesn't
+   * need to be called.
    */
   static void Initialize(int numThreads = 0);
 
@@ -244,6 +463,268 @@ public:
    */
   static int GetEstimatedNumberOfThreads();
 
+  /**
+   * Set/Get true if the SMPTools are allowed to run a parallel section from
+   * within another parallel section, false otherwise (the default). When it
+   * is false, a For called from within a For runs sequentially on the calling
+   * thread. The Sequential backend ignores it.
+   */
+  static void SetNestedParallelism(bool isNested);
+  static bool GetNestedParallelism();
+
+  /**
+   * Return true if it is called from a parallel scope.
+   */
+  static bool IsParallelScope();
+
+  /**
+   * Structure used to specify configuration for LocalScope() method.
+   * Backend and NestedParallelism keep the value currently in use when they
+   * are not given to the constructor. MaxNumberOfThreads does not: it is 0
+   * when not given, which resets the number of threads to the default of the
+   * backend for the scope.
+   *
+   * MaxNumberOfThreads: the maximum number of threads, 0 for the default.
+   * Backend: the backend name as passed to SetBackend().
+   * NestedParallelism: whether nested parallelism is allowed.
+   */
+  struct Config
+  {
+    int MaxNumberOfThreads = 0;
+    std::string Backend = vtk::detail::smp::vtkSMPToolsAPI::GetInstance().GetBackend();
+    bool NestedParallelism = vtk::detail::smp::vtkSMPToolsAPI::GetInstance().GetNestedParallelism();
+
+    Config() {}
+    Config(int maxNumberOfThreads)
+      : MaxNumberOfThreads(maxNumberOfThreads)
+    {
+    }
+    Config(std::string backend)
+      : Backend(backend)
+    {
+    }
+    Config(const char* backend)
+      : Backend(backend)
+    {
+    }
+    Config(bool nestedParallelism)
+      : NestedParallelism(nestedParallelism)
+    {
+    }
+    Config(int maxNumberOfThreads, std::string backend, bool nestedParallelism)
+      : MaxNumberOfThreads(maxNumberOfThreads)
+      , Backend(backend)
+      , NestedParallelism(nestedParallelism)
+    {
+    }
+#ifndef __VTK_WRAP__
+    Config(vtk::detail::smp::vtkSMPToolsAPI& API)
+      : MaxNumberOfThreads(API.GetInternalDesiredNumberOfThread())
+      , Backend(API.GetBackend())
+      , NestedParallelism(API.GetNestedParallelism())
+    {
+    }
+#endif
+  };
+
+  /**
+   * Scope limited configuration.
+   *
+   * This method runs a lambda function with the given configuration and
+   * restores the previous one afterwards, even if the lambda throws. It is
+   * meant to change the backend, the number of threads or the nested
+   * parallelism for a single algorithm without affecting the rest of the
+   * application. The configuration is process wide, so it should not be
+   * changed while another thread runs a parallel section.
+   *
+   * Example:
+   * \code
+   * vtkSMPTools::LocalScope(vtkSMPTools::Config{ 4, "OpenMP", false }, [&]() { ... });
+   * \endcode
+   */
+  template <typename T>
+  static void LocalScope(Config const& config, T&& lambda)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    SMPToolsAPI.LocalScope<vtkSMPTools::Config>(config, lambda);
+  }
+
+  /**
+   * A convenience method for transforming data. It is a drop in replacement
+   * for std::transform(), it does a unary operation on the input ranges. The
+   * data array must have the same length. The performance gain is observed
+   * when the operation done on the input data is costly or when the input
+   * is large. The iterators can come from vtk::DataArrayValueRange or
+   * vtk::DataArrayTupleRange as well as from std containers.
+   *
+   * Usage example:
+   * \code
+   * const auto range0 = vtk::DataArrayValueRange<1>(array0);
+   * auto range1 = vtk::DataArrayValueRange<1>(array1);
+   * vtkSMPTools::Transform(
+   *   range0.cbegin(), range0.cend(), range1.begin(), [](double x) { return x - 1; });
+   * \endcode
+   *
+   * Please visit vtkDataArrayRange.h documentation for more information and
+   * optimisation.
+   */
+  template <typename InputIt, typename OutputIt, typename Functor>
+  static void Transform(InputIt inBegin, InputIt inEnd, OutputIt outBegin, Functor transform)
+  {
+    vtk::detail::smp::vtkSMPTools_UnaryTransformCall<InputIt, OutputIt, Functor> call(
+      inBegin, outBegin, transform);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(inEnd - inBegin), call);
+  }
+
+  /**
+   * A convenience method for transforming data. It is a drop in replacement
+   * for std::transform(), it does a binary operation on the input ranges.
+   * The data array must have the same length.
+   *
+   * Usage example:
+   * \code
+   * const auto range0 = vtk::DataArrayValueRange<1>(array0);
+   * auto range1 = vtk::DataArrayValueRange<1>(array1);
+   * vtkSMPTools::Transform(range0.cbegin(), range0.cend(), range1.cbegin(), range1.begin(),
+   *   [](double x, double y) { return x * y; });
+   * \endcode
+   */
+  template <typename InputIt1, typename InputIt2, typename OutputIt, typename Functor>
+  static void Transform(
+    InputIt1 inBegin1, InputIt1 inEnd, InputIt2 inBegin2, OutputIt outBegin, Functor transform)
+  {
+    vtk::detail::smp::vtkSMPTools_BinaryTransformCall<InputIt1, InputIt2, OutputIt, Functor> call(
+      inBegin1, inBegin2, outBegin, transform);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(inEnd - inBegin1), call);
+  }
+
+  /**
+   * A convenience method for filling data. It is a drop in replacement for
+   * std::fill(), it assigns the given value to the element in ranges.
+   *
+   * Usage example:
+   * \code
+   * auto range = vtk::DataArrayValueRange<1>(array);
+   * vtkSMPTools::Fill(range.begin(), range.end(), 0.0);
+   * \endcode
+   */
+  template <typename Iterator, typename T>
+  static void Fill(Iterator begin, Iterator end, const T& value)
+  {
+    vtk::detail::smp::vtkSMPTools_FillFunctor<Iterator, T> fill(begin, value);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(end - begin), fill);
+  }
+
+  /**
+   * A convenience method for reducing data. It is a parallel replacement for
+   * std::accumulate(): it returns the combination of init and of every
+   * element of the range with op, which must be associative. The range is
+   * split in blocks that only depend on its size and the partial results are
+   * combined in order, so the result does not depend on the backend or on
+   * the number of threads.
+   *
+   * Usage example:
+   * \code
+   * const auto range = vtk::DataArrayValueRange<1>(array);
+   * double sum = vtkSMPTools::Reduce(range.cbegin(), range.cend(), 0.0);
+   * double max = vtkSMPTools::Reduce(range.cbegin(), range.cend(), VTK_DOUBLE_MIN,
+   *   [](double a, double b) { return std::max(a, b); });
+   * \endcode
+   */
+  template <typename Iterator, typename T, typename BinaryOp>
+  static T Reduce(Iterator begin, Iterator end, T init, BinaryOp op)
+  {
+    const vtkIdType size = static_cast<vtkIdType>(end - begin);
+    if (size <= 0)
+    {
+      return init;
+    }
+    vtk::detail::smp::vtkSMPTools_Blocks blocks(size);
+    std::vector<T> partials(blocks.NumberOfBlocks, init);
+    vtk::detail::smp::vtkSMPTools_BlockReduceFunctor<Iterator, T, BinaryOp> reduce(
+      begin, blocks, partials, op);
+    vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, reduce);
+
+    T result = init;
+    for (const T& partial : partials)
+    {
+      result = op(result, partial);
+    }
+    return result;
+  }
+
+  /**
+   * Same as above, summing the elements.
+   */
+  template <typename Iterator, typename T>
+  static T Reduce(Iterator begin, Iterator end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init, std::plus<T>());
+  }
+
+  //@{
+  /**
+   * Parallel prefix sums. They are drop in replacements for
+   * std::exclusive_scan() and std::inclusive_scan(): output element i is the
+   * combination with op of init and of the input elements before i
+   * (exclusive) or up to i (inclusive). op must be associative. The output
+   * range may be the input range. Returns the end of the output range.
+   *
+   * The scan runs in two parallel passes over the data: the first reduces
+   * fixed blocks of the input and the second writes the outputs of each
+   * block starting from the combination of the blocks before it. This is the
+   * building block of the "count, then allocate, then write" pattern used to
+   * compact the output of a filter in parallel:
+   *
+   * \code
+   * std::vector<vtkIdType> offsets(numberOfCells + 1);
+   * vtkSMPTools::For(0, numberOfCells, [&](vtkIdType begin, vtkIdType end) {
+   *   for (vtkIdType cellId = begin; cellId < end; ++cellId)
+   *   {
+   *     offsets[cellId] = CountOutput(cellId);
+   *   }
+   * });
+   * vtkSMPTools::ExclusiveScan(
+   *   offsets.begin(), offsets.end(), offsets.begin(), static_cast<vtkIdType>(0));
+   * // offsets[cellId] is now where the output of cellId starts and
+   * // offsets.back() the size to allocate.
+   * \endcode
+   */
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static OutputIt ExclusiveScan(
+    InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init, BinaryOp op)
+  {
+    return vtkSMPTools::ScanInternal(inBegin, inEnd, outBegin, init, true, false, op);
+  }
+
+  template <typename InputIt, typename OutputIt, typename T>
+  static OutputIt ExclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init)
+  {
+    return vtkSMPTools::ExclusiveScan(inBegin, inEnd, outBegin, init, std::plus<T>());
+  }
+
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static OutputIt InclusiveScan(
+    InputIt inBegin, InputIt inEnd, OutputIt outBegin, BinaryOp op, T init)
+  {
+    return vtkSMPTools::ScanInternal(inBegin, inEnd, outBegin, init, true, true, op);
+  }
+
+  template <typename InputIt, typename OutputIt, typename BinaryOp>
+  static OutputIt InclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, BinaryOp op)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    return vtkSMPTools::ScanInternal(inBegin, inEnd, outBegin, T(), false, true, op);
+  }
+
+  template <typename InputIt, typename OutputIt>
+  static OutputIt InclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    return vtkSMPTools::InclusiveScan(inBegin, inEnd, outBegin, std::plus<T>());
+  }
+  //@}
+
   /**
    * A convenience method for sorting data. It is a drop in replacement for
    * std::sort(). Under the hood different methods are used. For example,
@@ -252,7 +733,8 @@ public:
   template <typename RandomAccessIterator>
   static void Sort(RandomAccessIterator begin, RandomAccessIterator end)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_Sort(begin, end);
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    SMPToolsAPI.Sort(begin, end);
   }
 
   /**
@@ -264,7 +746,42 @@ public:
   template <typename RandomAccessIterator, typename Compare>
   static void Sort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
   {
-    vtk::detail::smp::vtkSMPTools_Impl_Sort(begin, end, comp);
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    SMPToolsAPI.Sort(begin, end, comp);
+  }
+
+private:
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static OutputIt ScanInternal(InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init,
+    bool hasInit, bool inclusive, BinaryOp& op)
+  {
+    const vtkIdType size = static_cast<vtkIdType>(inEnd - inBegin);
+    if (size <= 0)
+    {
+      return outBegin;
+    }
+    vtk::detail::smp::vtkSMPTools_Blocks blocks(size);
+
+    // First pass: reduce every block but the last one, which does not
+    // contribute to any offset.
+    std::vector<T> partials(blocks.NumberOfBlocks, init);
+    vtk::detail::smp::vtkSMPTools_BlockReduceFunctor<InputIt, T, BinaryOp> reduce(
+      inBegin, blocks, partials, op);
+    vtkSMPTools::For(0, blocks.NumberOfBlocks - 1, 1, reduce);
+
+    // Exclusive scan of the partial results gives the start of each block.
+    std::vector<T> offsets(blocks.NumberOfBlocks, init);
+    for (vtkIdType block = 1; block < blocks.NumberOfBlocks; ++block)
+    {
+      offsets[block] = (block == 1 && !hasInit) ? partials[0]
+                                                : op(offsets[block - 1], partials[block - 1]);
+    }
+
+    // Second pass: scan every block from its offset.
+    vtk::detail::smp::vtkSMPTools_BlockScanFunctor<InputIt, OutputIt, T, BinaryOp> scan(
+      inBegin, outBegin, blocks, offsets, hasInit, inclusive, op);
+    vtkSMPTools::For(0, blocks.NumberOfBlocks, 1, scan);
+    return outBegin + size;
   }
 };
 
@@ -0,0 +1,190 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetAttributesInterpolation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the batched InterpolateEdges() and InterpolatePoints() of
+// vtkDataSetAttributes give the same tuples as InterpolateEdge() and
+// InterpolatePoint(), for several array types, nearest neighbor interpolation
+// and arrays which are not data arrays.
+
+#include "vtkBitArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkShortArray.h"
+#include "vtkStringArray.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const vtkIdType NumberOfInputPoints = 1000;
+const vtkIdType NumberOfOutputPoints = 5000;
+const vtkIdType NumberOfCopiedPoints = 10;
+
+void MakeInput(vtkPointData* input)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(NumberOfInputPoints);
+  vtkNew<vtkShortArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(NumberOfInputPoints);
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("ints");
+  ints->SetNumberOfComponents(2);
+  ints->SetNumberOfTuples(NumberOfInputPoints);
+  vtkNew<vtkUnsignedCharArray> chars;
+  chars->SetName("chars");
+  chars->SetNumberOfTuples(NumberOfInputPoints);
+  vtkNew<vtkBitArray> bits;
+  bits->SetName("bits");
+  bits->SetNumberOfTuples(NumberOfInputPoints);
+  vtkNew<vtkStringArray> strings;
+  strings->SetName("strings");
+  strings->SetNumberOfTuples(NumberOfInputPoints);
+  for (vtkIdType i = 0; i < NumberOfInputPoints; i++)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      random->Next();
+      vectors->SetTypedComponent(i, c, static_cast<float>(random->GetRangeValue(-1.0, 1.0)));
+    }
+    random->Next();
+    scalars->SetValue(i, static_cast<short>(random->GetRangeValue(-1000.0, 1000.0)));
+    random->Next();
+    ints->SetTypedComponent(i, 0, static_cast<int>(random->GetRangeValue(-1.0e6, 1.0e6)));
+    ints->SetTypedComponent(i, 1, static_cast<int>(i));
+    random->Next();
+    chars->SetValue(i, static_cast<unsigned char>(random->GetRangeValue(0.0, 255.0)));
+    bits->SetValue(i, static_cast<int>(i % 3 == 0));
+    strings->SetValue(i, std::to_string(i));
+  }
+  input->SetVectors(vectors);
+  input->SetScalars(scalars);
+  input->AddArray(ints);
+  input->AddArray(chars);
+  input->AddArray(bits);
+  input->AddArray(strings);
+}
+
+void InitializeOutput(vtkPointData* output, vtkPointData* input)
+{
+  // the scalars are interpolated from the nearest point
+  output->SetCopyAttribute(vtkDataSetAttributes::SCALARS, 2, vtkDataSetAttributes::INTERPOLATE);
+  output->InterpolateAllocate(input, NumberOfCopiedPoints);
+  for (vtkIdType i = 0; i < NumberOfCopiedPoints; i++)
+  {
+    output->CopyData(input, i, i);
+  }
+}
+
+bool SameOutputs(vtkPointData* output1, vtkPointData* output2, const char* name)
+{
+  for (int i = 0; i < output1->GetNumberOfArrays(); i++)
+  {
+    vtkAbstractArray* array = output1->GetAbstractArray(i);
+    if (array->GetNumberOfTuples() != NumberOfCopiedPoints + NumberOfOutputPoints)
+    {
+      std::cerr << name << ": wrong number of tuples in " << array->GetName() << std::endl;
+      return false;
+    }
+  }
+  return vtkTestDataComparison::SameFieldData(output1, output2, name);
+}
+}
+
+int TestDataSetAttributesInterpolation(int, char*[])
+{
+  vtkNew<vtkPointData> input;
+  MakeInput(input);
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(7);
+  std::vector<vtkIdType> edges;
+  std::vector<double> t;
+  std::vector<vtkIdType> offsets(1, 0);
+  std::vector<vtkIdType> ids;
+  std::vector<double> weights;
+  for (vtkIdType i = 0; i < NumberOfOutputPoints; i++)
+  {
+    for (int j = 0; j < 2; j++)
+    {
+      random->Next();
+      edges.push_back(static_cast<vtkIdType>(random->GetRangeValue(0.0, NumberOfInputPoints)));
+    }
+    random->Next();
+    t.push_back(i % 10 == 0 ? 0.5 : random->GetValue());
+
+    const int numIds = 1 + static_cast<int>(i % 8);
+    for (int j = 0; j < numIds; j++)
+    {
+      random->Next();
+      ids.push_back(static_cast<vtkIdType>(random->GetRangeValue(0.0, NumberOfInputPoints)));
+      random->Next();
+      weights.push_back(random->GetRangeValue(0.0, 2.0 / numIds));
+    }
+    offsets.push_back(static_cast<vtkIdType>(ids.size()));
+  }
+
+  // interpolation point by point
+  vtkNew<vtkPointData> edgeOutput;
+  InitializeOutput(edgeOutput, input);
+  vtkNew<vtkPointData> pointOutput;
+  InitializeOutput(pointOutput, input);
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType i = 0; i < NumberOfOutputPoints; i++)
+  {
+    const vtkIdType toId = NumberOfCopiedPoints + i;
+    edgeOutput->InterpolateEdge(input, toId, edges[2 * i], edges[2 * i + 1], t[i]);
+    ptIds->SetNumberOfIds(offsets[i + 1] - offsets[i]);
+    for (vtkIdType j = offsets[i]; j < offsets[i + 1]; j++)
+    {
+      ptIds->SetId(j - offsets[i], ids[j]);
+    }
+    pointOutput->InterpolatePoint(input, toId, ptIds, weights.data() + offsets[i]);
+  }
+
+  // batched interpolation, appended to the copied tuples
+  for (int numThreads : { 1, 4 })
+  {
+    vtkNew<vtkPointData> edgesOutput;
+    InitializeOutput(edgesOutput, input);
+    vtkNew<vtkPointData> pointsOutput;
+    InitializeOutput(pointsOutput, input);
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ numThreads, "STDThread", false }, [&]() {
+      edgesOutput->InterpolateEdges(
+        input, NumberOfCopiedPoints, NumberOfOutputPoints, edges.data(), t.data());
+      pointsOutput->InterpolatePoints(input, NumberOfCopiedPoints, NumberOfOutputPoints,
+        offsets.data(), ids.data(), weights.data());
+    });
+    if (!SameOutputs(edgeOutput, edgesOutput, "InterpolateEdges") ||
+      !SameOutputs(pointOutput, pointsOutput, "InterpolatePoints"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TimeDataSetAttributesCopyData.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Times vtkDataSetAttributes::CopyData() with id lists on AOS, SOA and string
+// arrays, against copying each array with InsertTuples(), and checks that
+// both give the same arrays.
+
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkSOADataArrayTemplate.h"
+#include "vtkSmartPointer.h"
+#include "vtkStringArray.h"
+#include "vtkTestDataComparison.h"
+#include "vtkTimerLog.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+
+namespace
+{
+const vtkIdType NumberOfPoints = 200000;
+
+void MakeInput(vtkPointData* input)
+{
+  vtkMath::RandomSeed(314159);
+  for (int i = 0; i < 6; i++)
+  {
+    vtkNew<vtkFloatArray> aos;
+    aos->SetName(("aos" + std::to_string(i)).c_str());
+    aos->SetNumberOfComponents(3);
+    aos->SetNumberOfTuples(NumberOfPoints);
+    for (vtkIdType j = 0; j < aos->GetNumberOfValues(); j++)
+    {
+      aos->SetValue(j, static_cast<float>(vtkMath::Random(-1, 1)));
+    }
+    input->AddArray(aos);
+  }
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("ints");
+  ints->SetNumberOfTuples(NumberOfPoints);
+  std::iota(ints->GetPointer(0), ints->GetPointer(0) + NumberOfPoints, 0);
+  input->AddArray(ints);
+  for (int i = 0; i < 4; i++)
+  {
+    vtkNew<vtkSOADataArrayTemplate<double>> soa;
+    soa->SetName(("soa" + std::to_string(i)).c_str());
+    soa->SetNumberOfComponents(3);
+    soa->SetNumberOfTuples(NumberOfPoints);
+    for (vtkIdType j = 0; j < NumberOfPoints; j++)
+    {
+      for (int c = 0; c < 3; c++)
+      {
+        soa->SetTypedComponent(j, c, vtkMath::Random(-1, 1));
+      }
+    }
+    input->AddArray(soa);
+  }
+  for (int i = 0; i < 2; i++)
+  {
+    vtkNew<vtkStringArray> strings;
+    strings->SetName(("strings" + std::to_string(i)).c_str());
+    strings->SetNumberOfComponents(i + 1);
+    for (vtkIdType j = 0; j < NumberOfPoints * (i + 1); j++)
+    {
+      strings->InsertNextValue("value " + std::to_string(j));
+    }
+    input->AddArray(strings);
+  }
+}
+
+// Copy each array with InsertTuples().
+void CopyArrays(vtkPointData* input, vtkPointData* output, vtkIdList* fromIds, vtkIdList* toIds)
+{
+  for (int i = 0; i < input->GetNumberOfArrays(); i++)
+  {
+    vtkAbstractArray* fromArray = input->GetAbstractArray(i);
+    vtkSmartPointer<vtkAbstractArray> toArray =
+      vtkSmartPointer<vtkAbstractArray>::Take(fromArray->NewInstance());
+    toArray->SetName(fromArray->GetName());
+    toArray->SetNumberOfComponents(fromArray->GetNumberOfComponents());
+    toArray->InsertTuples(toIds, fromIds, fromArray);
+    output->AddArray(toArray);
+  }
+}
+
+double TimeCopyData(vtkPointData* input, vtkPointData* output, vtkIdList* fromIds,
+  vtkIdList* toIds, int numThreads)
+{
+  vtkNew<vtkTimerLog> timer;
+  output->CopyAllocate(input);
+  timer->StartTimer();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ numThreads, "STDThread", false },
+    [&]() { output->CopyData(input, fromIds, toIds); });
+  timer->StopTimer();
+  return timer->GetElapsedTime();
+}
+}
+
+int TimeDataSetAttributesCopyData(int, char*[])
+{
+  vtkNew<vtkPointData> input;
+  MakeInput(input);
+
+  // gather three quarters of the points in random order
+  std::vector<vtkIdType> ids(NumberOfPoints);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(7));
+  const vtkIdType numIds = 3 * NumberOfPoints / 4;
+  vtkNew<vtkIdList> fromIds;
+  vtkNew<vtkIdList> toIds;
+  fromIds->SetNumberOfIds(numIds);
+  toIds->SetNumberOfIds(numIds);
+  for (vtkIdType i = 0; i < numIds; i++)
+  {
+    fromIds->SetId(i, ids[i]);
+    toIds->SetId(i, numIds - 1 - i);
+  }
+
+  vtkNew<vtkTimerLog> timer;
+  vtkNew<vtkPointData> reference;
+  timer->StartTimer();
+  CopyArrays(input, reference, fromIds, toIds);
+  timer->StopTimer();
+  const double insertTime = timer->GetElapsedTime();
+
+  vtkNew<vtkPointData> serialOutput;
+  const double serialTime = TimeCopyData(input, serialOutput, fromIds, toIds, 1);
+  vtkNew<vtkPointData> parallelOutput;
+  const double parallelTime = TimeCopyData(input, parallelOutput, fromIds, toIds, 0);
+
+  std::cout << "Copying " << numIds << " tuples of " << input->GetNumberOfArrays()
+            << " arrays (AOS, SOA and strings)\n";
+  std::cout << "  InsertTuples per array: " << insertTime << " s\n";
+  std::cout << "  CopyData, 1 thread: " << serialTime << " s\n";
+  std::cout << "  CopyData, " << vtkSMPTools::GetEstimatedNumberOfThreads()
+            << " threads: " << parallelTime << " s" << std::endl;
+
+  if (!vtkTestDataComparison::SameFieldData(reference, serialOutput, "CopyData, 1 thread") ||
+    !vtkTestDataComparison::SameFieldData(reference, parallelOutput, "CopyData"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // repeated destination ids, the last copy of a tuple wins
+  for (vtkIdType i = 0; i < numIds; i++)
+  {
+    toIds->SetId(i, i / 2);
+  }
+  vtkNew<vtkPointData> repeatedReference;
+  CopyArrays(input, repeatedReference, fromIds, toIds);
+  vtkNew<vtkPointData> repeatedOutput;
+  TimeCopyData(input, repeatedOutput, fromIds, toIds, 0);
+  if (!vtkTestDataComparison::SameFieldData(
+        repeatedReference, repeatedOutput, "CopyData with repeated ids"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
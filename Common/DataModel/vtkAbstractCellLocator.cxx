@@ -19,9 +19,16 @@
 #include "vtkDataSet.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 vtkAbstractCellLocator::vtkAbstractCellLocator()
@@ -51,10 +58,19 @@ bool vtkAbstractCellLocator::StoreCellBounds()
   // Allocate space for cell bounds storage, then fill
   vtkIdType numCells = this->DataSet->GetNumberOfCells();
   this->CellBounds = new double[numCells][6];
-  for (vtkIdType j = 0; j < numCells; j++)
+  if (numCells < 1)
   {
-    this->DataSet->GetCellBounds(j, CellBounds[j]);
+    return true;
   }
+  // GetCellBounds() is only thread safe once it has been called from a
+  // single thread.
+  this->DataSet->GetCellBounds(0, this->CellBounds[0]);
+  vtkSMPTools::For(1, numCells, [this](vtkIdType cellId, vtkIdType endCellId) {
+    for (; cellId < endCellId; ++cellId)
+    {
+      this->DataSet->GetCellBounds(cellId, this->CellBounds[cellId]);
+    }
+  });
   return true;
 }
 //------------------------------------------------------------------------------
@@ -178,6 +194,132 @@ vtkIdType vtkAbstractCellLocator::FindCell(
   }
   return returnVal;
 }
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::FindCells(
+  vtkDataArray* points, vtkIdTypeArray* cellIds, vtkDataArray* pcoords)
+{
+  const vtkIdType numQueries = points->GetNumberOfTuples();
+  cellIds->SetNumberOfComponents(1);
+  cellIds->SetNumberOfTuples(numQueries);
+  if (pcoords)
+  {
+    pcoords->SetNumberOfComponents(3);
+    pcoords->SetNumberOfTuples(numQueries);
+  }
+  if (numQueries < 1)
+  {
+    return;
+  }
+
+  const int maxCellSize = this->DataSet ? std::max(this->DataSet->GetMaxCellSize(), 1) : 1;
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPThreadLocal<std::vector<double>> tlWeights;
+  auto findCells = [&](vtkIdType queryId, vtkIdType endQueryId) {
+    vtkGenericCell* cell = tlCell.Local();
+    std::vector<double>& weights = tlWeights.Local();
+    weights.resize(maxCellSize);
+    double x[3], pc[3] = { 0.0, 0.0, 0.0 };
+    for (; queryId < endQueryId; ++queryId)
+    {
+      points->GetTuple(queryId, x);
+      cellIds->SetValue(queryId, this->FindCell(x, 0.0, cell, pc, weights.data()));
+      if (pcoords)
+      {
+        pcoords->SetTuple(queryId, pc);
+      }
+    }
+  };
+
+  // The first query builds the locator if needed, and takes care of the
+  // initialization of the dataset that must happen in a single thread.
+  findCells(0, 1);
+  if (this->IsFindCellThreadSafe())
+  {
+    this->PrepareConcurrentQueries();
+    vtkSMPTools::For(1, numQueries, findCells);
+  }
+  else
+  {
+    findCells(1, numQueries);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::IntersectWithLines(vtkDataArray* p1, vtkDataArray* p2, double tol,
+  vtkIdTypeArray* cellIds, vtkDataArray* t, vtkDataArray* x)
+{
+  const vtkIdType numQueries = std::min(p1->GetNumberOfTuples(), p2->GetNumberOfTuples());
+  cellIds->SetNumberOfComponents(1);
+  cellIds->SetNumberOfTuples(numQueries);
+  if (t)
+  {
+    t->SetNumberOfComponents(1);
+    t->SetNumberOfTuples(numQueries);
+  }
+  if (x)
+  {
+    x->SetNumberOfComponents(3);
+    x->SetNumberOfTuples(numQueries);
+  }
+  if (numQueries < 1)
+  {
+    return;
+  }
+
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  auto intersectWithLines = [&](vtkIdType queryId, vtkIdType endQueryId) {
+    vtkGenericCell* cell = tlCell.Local();
+    double a0[3], a1[3], tHit, xHit[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    for (; queryId < endQueryId; ++queryId)
+    {
+      p1->GetTuple(queryId, a0);
+      p2->GetTuple(queryId, a1);
+      tHit = 0.0;
+      xHit[0] = xHit[1] = xHit[2] = 0.0;
+      cellId = -1;
+      if (!this->IntersectWithLine(a0, a1, tol, tHit, xHit, pcoords, subId, cellId, cell))
+      {
+        cellId = -1;
+      }
+      cellIds->SetValue(queryId, cellId);
+      if (t)
+      {
+        t->SetComponent(queryId, 0, tHit);
+      }
+      if (x)
+      {
+        x->SetTuple(queryId, xHit);
+      }
+    }
+  };
+
+  intersectWithLines(0, 1);
+  if (this->IsIntersectWithLineThreadSafe())
+  {
+    this->PrepareConcurrentQueries();
+    vtkSMPTools::For(1, numQueries, intersectWithLines);
+  }
+  else
+  {
+    intersectWithLines(1, numQueries);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::PrepareConcurrentQueries()
+{
+  // GetCell() and GetCellBounds() are only thread safe once they have been
+  // called from a single thread.
+  if (this->DataSet && this->DataSet->GetNumberOfCells() > 0)
+  {
+    double bounds[6];
+    this->DataSet->GetCell(0, this->GenericCell);
+    this->DataSet->GetCellBounds(0, bounds);
+  }
+}
+
 //------------------------------------------------------------------------------
 bool vtkAbstractCellLocator::InsideCellBounds(double x[3], vtkIdType cell_ID)
 {
@@ -41,8 +41,10 @@
 #include "vtkLocator.h"
 
 class vtkCellArray;
+class vtkDataArray;
 class vtkGenericCell;
 class vtkIdList;
+class vtkIdTypeArray;
 class vtkPoints;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkAbstractCellLocator : public vtkLocator
@@ -248,6 +250,38 @@ public:
   virtual vtkIdType FindCell(
     double x[3], double tol2, vtkGenericCell* GenCell, double pcoords[3], double* weights);
 
+  //@{
+  /**
+   * Batched versions of FindCell() and IntersectWithLine(). FindCells() finds
+   * the cell containing each point of the 3-component array points and stores
+   * its id, or -1, in cellIds, and optionally its parametric coordinates in
+   * pcoords. IntersectWithLines() intersects the segments going from each
+   * point of p1 to the matching point of p2 with the cells, and stores the id
+   * of the intersected cell, or -1, in cellIds, and optionally the parametric
+   * coordinate along the segment in t and the intersection point in x. The
+   * output arrays are resized to the number of queries.
+   *
+   * The queries are processed in parallel with vtkSMPTools when the locator
+   * supports concurrent queries (see IsFindCellThreadSafe() and
+   * IsIntersectWithLineThreadSafe()), and one after the other otherwise. The
+   * results are the same as those of the single queries.
+   */
+  virtual void FindCells(
+    vtkDataArray* points, vtkIdTypeArray* cellIds, vtkDataArray* pcoords = nullptr);
+  virtual void IntersectWithLines(vtkDataArray* p1, vtkDataArray* p2, double tol,
+    vtkIdTypeArray* cellIds, vtkDataArray* t = nullptr, vtkDataArray* x = nullptr);
+  //@}
+
+  //@{
+  /**
+   * Return whether FindCell() and IntersectWithLine(), in their versions
+   * taking a vtkGenericCell, may be called from several threads at once
+   * once the locator is built. False unless a subclass says otherwise.
+   */
+  virtual bool IsFindCellThreadSafe() { return false; }
+  virtual bool IsIntersectWithLineThreadSafe() { return false; }
+  //@}
+
   /**
    * Quickly test if a point is inside the bounds of a particular cell.
    * Some locators cache cell bounds and this function can make use
@@ -271,6 +305,13 @@ protected:
   virtual void FreeCellBounds();
   //@}
 
+  /**
+   * Called by FindCells() and IntersectWithLines() before processing queries
+   * in parallel, once the locator is built. Performs the initialization of
+   * the dataset that is not thread safe.
+   */
+  virtual void PrepareConcurrentQueries();
+
   int NumberOfCellsPerNode;
   vtkTypeBool RetainCellLists;
   vtkTypeBool CacheCellBounds;
@@ -20,8 +20,10 @@
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkCellLocator);
 
@@ -1189,7 +1191,7 @@ void vtkCellLocator::ForceBuildLocator()
 //
 void vtkCellLocator::BuildLocatorInternal()
 {
-  double length, cellBounds[6], *boundsPtr;
+  double length, *boundsPtr;
   vtkIdType numCells;
   int ndivs, product;
   int i, j, k, ijkMin[3], ijkMax[3];
@@ -1272,12 +1274,27 @@ void vtkCellLocator::BuildLocatorInternal()
     hTol[i] = this->H[i] / 100.0;
   }
 
+  //  Compute the bounds of the cells in parallel when they are not cached,
+  //  then insert them serially so that the octants list the cells in order.
+  //
+  std::vector<double> allCellBounds;
+  if (!this->CellBounds)
+  {
+    allCellBounds.resize(6 * numCells);
+    this->DataSet->GetCellBounds(0, allCellBounds.data());
+    vtkSMPTools::For(1, numCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType id = begin; id < end; ++id)
+      {
+        this->DataSet->GetCellBounds(id, allCellBounds.data() + 6 * id);
+      }
+    });
+  }
+
   //  Insert each cell into the appropriate octant.  Make sure cell
   //  falls within octant.
   //
   parentOffset = numOctants - (ndivs * ndivs * ndivs);
   product = ndivs * ndivs;
-  boundsPtr = cellBounds;
   for (cellId = 0; cellId < numCells; cellId++)
   {
     if (this->CellBounds)
@@ -1286,7 +1303,7 @@ void vtkCellLocator::BuildLocatorInternal()
     }
     else
     {
-      this->DataSet->GetCellBounds(cellId, cellBounds);
+      boundsPtr = allCellBounds.data() + 6 * cellId;
     }
 
     // find min/max locations of bounding box
@@ -136,6 +136,12 @@ public:
   vtkIdType FindCell(
     double x[3], double tol2, vtkGenericCell* GenCell, double pcoords[3], double* weights) override;
 
+  /**
+   * FindCell() only reads the locator once it is built, so the queries of
+   * FindCells() run in parallel.
+   */
+  bool IsFindCellThreadSafe() override { return true; }
+
   /**
    * Return a list of unique cell ids inside of a given bounding box. The
    * user must provide the vtkIdList to populate. This method returns data
@@ -27,13 +27,18 @@
 #include "vtkIntArray.h"
 #include "vtkLongArray.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkShortArray.h"
+#include "vtkStringArray.h"
 #include "vtkStructuredExtent.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
 #include "vtkUnsignedShortArray.h"
+#include <algorithm>
+#include <functional>
 #include <vector>
 
 vtkStandardNewMacro(vtkDataSetAttributes);
@@ -827,16 +832,190 @@ void vtkDataSetAttributes::CopyData(vtkDataSetAttributes* fromPd, vtkIdType from
   }
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+// Below this number of tuple copies, the tuples are gathered serially.
+constexpr vtkIdType GatherThreshold = 65536;
+// Number of tuples of one array gathered by a task.
+constexpr vtkIdType GatherBlockSize = 8192;
+
+// Copies the tuples fromIds[i] to toIds[i] of one array, for i in [begin, end).
+using GatherFunction = std::function<void(vtkIdType, vtkIdType)>;
+
+// Make sure that the array has at least numTuples tuples, keeping its values.
+void ExtendArray(vtkAbstractArray* array, vtkIdType numTuples)
+{
+  if (array->GetNumberOfTuples() < numTuples)
+  {
+    if (array->GetSize() < numTuples * array->GetNumberOfComponents())
+    {
+      array->Resize(numTuples);
+    }
+    array->SetNumberOfTuples(numTuples);
+  }
+}
+
+struct GatherTuplesWorker
+{
+  GatherFunction Gather;
+
+  template <typename ToArrayT, typename FromArrayT>
+  void operator()(
+    ToArrayT* toArray, FromArrayT* fromArray, const vtkIdType* fromIds, const vtkIdType* toIds)
+  {
+    this->Gather = [toArray, fromArray, fromIds, toIds](vtkIdType begin, vtkIdType end) {
+      const auto fromTuples = vtk::DataArrayTupleRange(fromArray);
+      auto toTuples = vtk::DataArrayTupleRange(toArray);
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        toTuples[toIds[i]] = fromTuples[fromIds[i]];
+      }
+    };
+  }
+};
+
+// Returns the function gathering the tuples of an array, or an empty function
+// if the array is not gathered in parallel. The destination array is
+// extended to hold the tuple maxToId.
+GatherFunction PrepareGather(vtkAbstractArray* fromArray, vtkAbstractArray* toArray,
+  const vtkIdType* fromIds, const vtkIdType* toIds, vtkIdType maxFromId, vtkIdType maxToId)
+{
+  const int numComps = toArray->GetNumberOfComponents();
+  if (fromArray == toArray || fromArray->GetNumberOfComponents() != numComps ||
+    maxFromId >= fromArray->GetNumberOfTuples())
+  {
+    return GatherFunction();
+  }
+
+  vtkStringArray* fromStrings = vtkArrayDownCast<vtkStringArray>(fromArray);
+  vtkStringArray* toStrings = vtkArrayDownCast<vtkStringArray>(toArray);
+  if (fromStrings && toStrings)
+  {
+    // vtkStringArray::Resize() counts values, extend by inserting the last one.
+    if (toStrings->GetNumberOfTuples() <= maxToId)
+    {
+      toStrings->InsertValue((maxToId + 1) * numComps - 1, vtkStdString());
+    }
+    const vtkStdString* from = fromStrings->GetPointer(0);
+    vtkStdString* to = toStrings->GetPointer(0);
+    return [from, to, fromIds, toIds, numComps](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        std::copy(from + fromIds[i] * numComps, from + (fromIds[i] + 1) * numComps,
+          to + toIds[i] * numComps);
+      }
+    };
+  }
+
+  vtkDataArray* fromDA = vtkArrayDownCast<vtkDataArray>(fromArray);
+  vtkDataArray* toDA = vtkArrayDownCast<vtkDataArray>(toArray);
+  if (!fromDA || !toDA || fromDA->GetDataType() != toDA->GetDataType() ||
+    toDA->GetDataType() == VTK_BIT)
+  {
+    return GatherFunction();
+  }
+
+  ExtendArray(toDA, maxToId + 1);
+  GatherTuplesWorker worker;
+  if (vtkArrayDispatch::Dispatch2SameValueType::Execute(toDA, fromDA, worker, fromIds, toIds))
+  {
+    return worker.Gather;
+  }
+  if (fromDA->GetArrayType() == vtkAbstractArray::SoADataArrayTemplate &&
+    toDA->GetArrayType() == vtkAbstractArray::SoADataArrayTemplate)
+  {
+    // Fallback to SetTuple(), which copies typed values between arrays of the
+    // same class without reallocating.
+    return [fromDA, toDA, fromIds, toIds](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        toDA->SetTuple(toIds[i], fromIds[i], fromDA);
+      }
+    };
+  }
+  return GatherFunction();
+}
+
+// Copies the tuples fromIds of the first arrays of the pairs to the tuples
+// toIds of the second ones. Large copies are done in parallel, over the
+// arrays and over blocks of tuples, after sizing the destination arrays
+// once. Arrays which cannot be gathered this way, small copies and repeated
+// destination ids use InsertTuples().
+void GatherTuples(const std::vector<std::pair<vtkAbstractArray*, vtkAbstractArray*>>& arrays,
+  vtkIdList* fromIds, vtkIdList* toIds)
+{
+  const vtkIdType numIds = toIds->GetNumberOfIds();
+  bool parallel = fromIds->GetNumberOfIds() == numIds &&
+    numIds * static_cast<vtkIdType>(arrays.size()) >= GatherThreshold;
+  vtkIdType maxFromId = 0;
+  vtkIdType maxToId = 0;
+  if (parallel)
+  {
+    maxFromId = *std::max_element(fromIds->begin(), fromIds->end());
+    maxToId = *std::max_element(toIds->begin(), toIds->end());
+    std::vector<bool> written(maxToId + 1, false);
+    for (vtkIdType toId : *toIds)
+    {
+      if (toId < 0 || written[toId])
+      {
+        parallel = false;
+        break;
+      }
+      written[toId] = true;
+    }
+    parallel = parallel && *std::min_element(fromIds->begin(), fromIds->end()) >= 0;
+  }
+
+  std::vector<GatherFunction> gathers;
+  std::vector<vtkAbstractArray*> gathered;
+  for (const auto& fromTo : arrays)
+  {
+    GatherFunction gather;
+    if (parallel)
+    {
+      gather = PrepareGather(fromTo.first, fromTo.second, fromIds->GetPointer(0),
+        toIds->GetPointer(0), maxFromId, maxToId);
+    }
+    if (gather)
+    {
+      gathers.push_back(std::move(gather));
+      gathered.push_back(fromTo.second);
+    }
+    else
+    {
+      fromTo.second->InsertTuples(toIds, fromIds, fromTo.first);
+    }
+  }
+
+  const vtkIdType numBlocks = (numIds + GatherBlockSize - 1) / GatherBlockSize;
+  const vtkIdType numTasks = numBlocks * static_cast<vtkIdType>(gathers.size());
+  vtkSMPTools::For(0, numTasks, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType task = begin; task < end; ++task)
+    {
+      const vtkIdType block = task % numBlocks;
+      gathers[task / numBlocks](
+        block * GatherBlockSize, std::min((block + 1) * GatherBlockSize, numIds));
+    }
+  });
+  for (vtkAbstractArray* array : gathered)
+  {
+    array->DataChanged();
+  }
+}
+} // end anon namespace
+
 //------------------------------------------------------------------------------
 void vtkDataSetAttributes::CopyData(
   vtkDataSetAttributes* fromPd, vtkIdList* fromIds, vtkIdList* toIds)
 {
-  int i;
-  for (i = this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
+  std::vector<std::pair<vtkAbstractArray*, vtkAbstractArray*>> arrays;
+  for (int i = this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
        i = this->RequiredArrays.NextIndex())
   {
-    this->CopyTuples(fromPd->Data[i], this->Data[this->TargetIndices[i]], fromIds, toIds);
+    arrays.emplace_back(fromPd->Data[i], this->Data[this->TargetIndices[i]]);
   }
+  ::GatherTuples(arrays, fromIds, toIds);
 }
 
 //------------------------------------------------------------------------------
@@ -864,12 +1043,174 @@ void vtkDataSetAttributes::InterpolateAllocate(
   this->InternalCopyAllocate(pd, INTERPOLATE, sze, ext, shallowCopyArrays);
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+// Interpolate one tuple of one array from a point stencil.
+void InterpolatePointTuple(vtkAbstractArray* toArray, vtkAbstractArray* fromArray, vtkIdType toId,
+  vtkIdList* ptIds, double* weights, bool nearest)
+{
+  if (nearest)
+  {
+    vtkIdType numIds = ptIds->GetNumberOfIds();
+    vtkIdType maxId = ptIds->GetId(0);
+    vtkIdType maxWeight = 0.;
+    for (int j = 0; j < numIds; j++)
+    {
+      if (weights[j] > maxWeight)
+      {
+        maxWeight = weights[j];
+        maxId = ptIds->GetId(j);
+      }
+    }
+    toArray->InsertTuple(toId, maxId, fromArray);
+  }
+  else
+  {
+    toArray->InterpolateTuple(toId, ptIds, fromArray, weights);
+  }
+}
+
+// Interpolate one tuple of one array along an edge.
+void InterpolateEdgeTuple(vtkAbstractArray* toArray, vtkAbstractArray* fromArray, vtkIdType toId,
+  vtkIdType p1, vtkIdType p2, double t, bool nearest)
+{
+  if (nearest)
+  {
+    if (t < .5)
+    {
+      toArray->InsertTuple(toId, p1, fromArray);
+    }
+    else
+    {
+      toArray->InsertTuple(toId, p2, fromArray);
+    }
+  }
+  else
+  {
+    toArray->InterpolateTuple(toId, p1, fromArray, p2, fromArray, t);
+  }
+}
+
+// Batched edge interpolation of one array, computing the values as
+// vtkGenericDataArray::InterpolateTuple() does.
+struct InterpolateEdgesWorker
+{
+  template <typename ToArrayT, typename FromArrayT>
+  void operator()(ToArrayT* toArray, FromArrayT* fromArray, vtkIdType toStart, vtkIdType n,
+    const vtkIdType* edges, const double* t)
+  {
+    VTK_ASSUME(fromArray->GetNumberOfComponents() == toArray->GetNumberOfComponents());
+    using ValueType = vtk::GetAPIType<ToArrayT>;
+    const auto fromTuples = vtk::DataArrayTupleRange(fromArray);
+    auto toTuples = vtk::DataArrayTupleRange(toArray, toStart, toStart + n);
+    const int numComps = toArray->GetNumberOfComponents();
+
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const auto tuple1 = fromTuples[edges[2 * i]];
+        const auto tuple2 = fromTuples[edges[2 * i + 1]];
+        auto toTuple = toTuples[i];
+        const double oneMinusT = 1. - t[i];
+        for (int c = 0; c < numComps; ++c)
+        {
+          const double val =
+            static_cast<double>(tuple1[c]) * oneMinusT + static_cast<double>(tuple2[c]) * t[i];
+          ValueType valT;
+          vtkMath::RoundDoubleToIntegralIfNecessary(val, &valT);
+          toTuple[c] = valT;
+        }
+      }
+    });
+  }
+};
+
+// Batched stencil interpolation of one array, computing the values as
+// vtkGenericDataArray::InterpolateTuple() does.
+struct InterpolatePointsWorker
+{
+  template <typename ToArrayT, typename FromArrayT>
+  void operator()(ToArrayT* toArray, FromArrayT* fromArray, vtkIdType toStart, vtkIdType n,
+    const vtkIdType* offsets, const vtkIdType* ids, const double* weights)
+  {
+    VTK_ASSUME(fromArray->GetNumberOfComponents() == toArray->GetNumberOfComponents());
+    using ValueType = vtk::GetAPIType<ToArrayT>;
+    const auto fromTuples = vtk::DataArrayTupleRange(fromArray);
+    auto toTuples = vtk::DataArrayTupleRange(toArray, toStart, toStart + n);
+    const int numComps = toArray->GetNumberOfComponents();
+
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        auto toTuple = toTuples[i];
+        for (int c = 0; c < numComps; ++c)
+        {
+          double val = 0.;
+          for (vtkIdType j = offsets[i]; j < offsets[i + 1]; ++j)
+          {
+            val += weights[j] * static_cast<double>(fromTuples[ids[j]][c]);
+          }
+          ValueType valT;
+          vtkMath::RoundDoubleToIntegralIfNecessary(val, &valT);
+          toTuple[c] = valT;
+        }
+      }
+    });
+  }
+};
+} // end anon namespace
+
 //------------------------------------------------------------------------------
 // Interpolate data from points and interpolation weights. Make sure that the
 // method InterpolateAllocate() has been invoked before using this method.
 void vtkDataSetAttributes::InterpolatePoint(
   vtkDataSetAttributes* fromPd, vtkIdType toId, vtkIdList* ptIds, double* weights)
 {
+  for (int i = this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
+       i = this->RequiredArrays.NextIndex())
+  {
+    // check if the destination array needs nearest neighbor interpolation
+    int attributeIndex = this->IsArrayAnAttribute(this->TargetIndices[i]);
+    bool nearest =
+      attributeIndex != -1 && this->CopyAttributeFlags[INTERPOLATE][attributeIndex] == 2;
+    ::InterpolatePointTuple(
+      this->Data[this->TargetIndices[i]], fromPd->Data[i], toId, ptIds, weights, nearest);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Interpolate data from the two points p1,p2 (forming an edge) and an
+// interpolation factor, t, along the edge. The weight ranges from (0,1),
+// with t=0 located at p1. Make sure that the method InterpolateAllocate()
+// has been invoked before using this method.
+void vtkDataSetAttributes::InterpolateEdge(
+  vtkDataSetAttributes* fromPd, vtkIdType toId, vtkIdType p1, vtkIdType p2, double t)
+{
+  for (int i = this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
+       i = this->RequiredArrays.NextIndex())
+  {
+    // check if the destination array needs nearest neighbor interpolation
+    int attributeIndex = this->IsArrayAnAttribute(this->TargetIndices[i]);
+    bool nearest =
+      attributeIndex != -1 && this->CopyAttributeFlags[INTERPOLATE][attributeIndex] == 2;
+    ::InterpolateEdgeTuple(
+      this->Data[this->TargetIndices[i]], fromPd->Data[i], toId, p1, p2, t, nearest);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Interpolate n tuples along edges. The data arrays are interpolated in one
+// typed, parallel pass; nearest neighbor interpolation and the other arrays
+// go through the per tuple code.
+void vtkDataSetAttributes::InterpolateEdges(vtkDataSetAttributes* fromPd, vtkIdType toStart,
+  vtkIdType n, const vtkIdType* edges, const double* t)
+{
+  if (n <= 0)
+  {
+    return;
+  }
+
   for (int i = this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
        i = this->RequiredArrays.NextIndex())
   {
@@ -878,36 +1219,46 @@ void vtkDataSetAttributes::InterpolatePoint(
 
     // check if the destination array needs nearest neighbor interpolation
     int attributeIndex = this->IsArrayAnAttribute(this->TargetIndices[i]);
-    if (attributeIndex != -1 && this->CopyAttributeFlags[INTERPOLATE][attributeIndex] == 2)
+    bool nearest =
+      attributeIndex != -1 && this->CopyAttributeFlags[INTERPOLATE][attributeIndex] == 2;
+
+    vtkDataArray* fromDA = vtkArrayDownCast<vtkDataArray>(fromArray);
+    vtkDataArray* toDA = vtkArrayDownCast<vtkDataArray>(toArray);
+    if (!nearest && fromDA && toDA &&
+      fromDA->GetNumberOfComponents() == toDA->GetNumberOfComponents())
     {
-      vtkIdType numIds = ptIds->GetNumberOfIds();
-      vtkIdType maxId = ptIds->GetId(0);
-      vtkIdType maxWeight = 0.;
-      for (int j = 0; j < numIds; j++)
+      ::ExtendArray(toDA, toStart + n);
+      InterpolateEdgesWorker worker;
+      if (vtkArrayDispatch::Dispatch2SameValueType::Execute(
+            toDA, fromDA, worker, toStart, n, edges, t))
       {
-        if (weights[j] > maxWeight)
-        {
-          maxWeight = weights[j];
-          maxId = ptIds->GetId(j);
-        }
+        toDA->DataChanged();
+        continue;
       }
-      toArray->InsertTuple(toId, maxId, fromArray);
     }
-    else
+
+    // Fallback to the per tuple interpolation (e.g. vtkStringArray, vtkBitArray):
+    for (vtkIdType j = 0; j < n; ++j)
     {
-      toArray->InterpolateTuple(toId, ptIds, fromArray, weights);
+      ::InterpolateEdgeTuple(
+        toArray, fromArray, toStart + j, edges[2 * j], edges[2 * j + 1], t[j], nearest);
     }
   }
 }
 
 //------------------------------------------------------------------------------
-// Interpolate data from the two points p1,p2 (forming an edge) and an
-// interpolation factor, t, along the edge. The weight ranges from (0,1),
-// with t=0 located at p1. Make sure that the method InterpolateAllocate()
-// has been invoked before using this method.
-void vtkDataSetAttributes::InterpolateEdge(
-  vtkDataSetAttributes* fromPd, vtkIdType toId, vtkIdType p1, vtkIdType p2, double t)
+// Interpolate n tuples from point stencils. The data arrays are interpolated
+// in one typed, parallel pass; nearest neighbor interpolation and the other
+// arrays go through the per tuple code.
+void vtkDataSetAttributes::InterpolatePoints(vtkDataSetAttributes* fromPd, vtkIdType toStart,
+  vtkIdType n, const vtkIdType* offsets, const vtkIdType* ids, const double* weights)
 {
+  if (n <= 0)
+  {
+    return;
+  }
+
+  vtkNew<vtkIdList> ptIds;
   for (int i = this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
        i = this->RequiredArrays.NextIndex())
   {
@@ -916,20 +1267,32 @@ void vtkDataSetAttributes::InterpolateEdge(
 
     // check if the destination array needs nearest neighbor interpolation
     int attributeIndex = this->IsArrayAnAttribute(this->TargetIndices[i]);
-    if (attributeIndex != -1 && this->CopyAttributeFlags[INTERPOLATE][attributeIndex] == 2)
+    bool nearest =
+      attributeIndex != -1 && this->CopyAttributeFlags[INTERPOLATE][attributeIndex] == 2;
+
+    vtkDataArray* fromDA = vtkArrayDownCast<vtkDataArray>(fromArray);
+    vtkDataArray* toDA = vtkArrayDownCast<vtkDataArray>(toArray);
+    if (!nearest && fromDA && toDA &&
+      fromDA->GetNumberOfComponents() == toDA->GetNumberOfComponents())
     {
-      if (t < .5)
+      ::ExtendArray(toDA, toStart + n);
+      InterpolatePointsWorker worker;
+      if (vtkArrayDispatch::Dispatch2SameValueType::Execute(
+            toDA, fromDA, worker, toStart, n, offsets, ids, weights))
       {
-        toArray->InsertTuple(toId, p1, fromArray);
-      }
-      else
-      {
-        toArray->InsertTuple(toId, p2, fromArray);
+        toDA->DataChanged();
+        continue;
       }
     }
-    else
+
+    // Fallback to the per tuple interpolation (e.g. vtkStringArray, vtkBitArray):
+    for (vtkIdType j = 0; j < n; ++j)
     {
-      toArray->InterpolateTuple(toId, p1, fromArray, p2, fromArray, t);
+      const vtkIdType numIds = offsets[j + 1] - offsets[j];
+      ptIds->SetNumberOfIds(numIds);
+      std::copy(ids + offsets[j], ids + offsets[j + 1], ptIds->begin());
+      ::InterpolatePointTuple(toArray, fromArray, toStart + j, ptIds,
+        const_cast<double*>(weights + offsets[j]), nearest);
     }
   }
 }
@@ -987,7 +1350,7 @@ void vtkDataSetAttributes::CopyTuple(
 void vtkDataSetAttributes::CopyTuples(
   vtkAbstractArray* fromData, vtkAbstractArray* toData, vtkIdList* fromIds, vtkIdList* toIds)
 {
-  toData->InsertTuples(toIds, fromIds, fromData);
+  ::GatherTuples({ { fromData, toData } }, fromIds, toIds);
 }
 
 //------------------------------------------------------------------------------
@@ -505,6 +505,8 @@ public:
    * for that attribute, ignore (2) and (3), 2) if there is a copy field for
    * that field (on or off), obey the flag, ignore (3) 3) obey
    * CopyAllOn/Off
+   * The form taking id lists sizes the destination arrays once and copies
+   * large sets of tuples in parallel, over the arrays and over the tuples.
    */
   void CopyData(vtkDataSetAttributes* fromPd, vtkIdType fromId, vtkIdType toId);
   void CopyData(vtkDataSetAttributes* fromPd, vtkIdList* fromIds, vtkIdList* toIds);
@@ -573,6 +575,27 @@ public:
   void InterpolateEdge(
     vtkDataSetAttributes* fromPd, vtkIdType toId, vtkIdType p1, vtkIdType p2, double t);
 
+  //@{
+  /**
+   * Batched forms of InterpolateEdge() and InterpolatePoint(), interpolating
+   * the n tuples toStart, ..., toStart+n-1 in one pass per array. The tuples
+   * are interpolated in parallel, and the results are the same as those of
+   * the methods above. InterpolateEdges() takes n edges (edges[2*i],
+   * edges[2*i+1]) with the interpolation factors t[i]. InterpolatePoints()
+   * takes n stencils, stencil i weighting the ids[j] by weights[j] for
+   * offsets[i] <= j < offsets[i+1] (offsets has n+1 entries). This lets
+   * filters record interpolation stencils while generating their geometry and
+   * interpolate all the attributes at the end. The tuples interpolated from
+   * must not be among the written tuples when fromPd is this object. Make
+   * sure that the method InterpolateAllocate() has been invoked before using
+   * these methods.
+   */
+  void InterpolateEdges(vtkDataSetAttributes* fromPd, vtkIdType toStart, vtkIdType n,
+    const vtkIdType* edges, const double* t);
+  void InterpolatePoints(vtkDataSetAttributes* fromPd, vtkIdType toStart, vtkIdType n,
+    const vtkIdType* offsets, const vtkIdType* ids, const double* weights);
+  //@}
+
   /**
    * Interpolate data from the same id (point or cell) at different points
    * in time (parameter t). Two input data set attributes objects are input.
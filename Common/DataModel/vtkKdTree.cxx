@@ -29,6 +29,7 @@
 #include "vtkDataSetCollection.h"
 #include "vtkFloatArray.h"
 #include "vtkGarbageCollector.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
@@ -40,6 +41,9 @@
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkTimerLog.h"
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
@@ -49,6 +53,7 @@
 #include <map>
 #include <queue>
 #include <set>
+#include <vector>
 
 namespace
 {
@@ -645,52 +650,56 @@ float* vtkKdTree::ComputeCellCenters(vtkDataSet* set)
     }
   }
 
-  double* weights = new double[maxCellSize];
-
-  float* cptr = center;
-  double dcenter[3];
-
-  if (set)
-  {
-    for (int j = 0; j < totalCells; j++)
+  // The centers are computed in parallel, each cell independently of the
+  // others.
+  int doneCells = 0;
+  auto computeCenters = [&](vtkDataSet* iset, float* cptr) {
+    const vtkIdType nCells = iset->GetNumberOfCells();
+    if (nCells < 1)
     {
-      this->ComputeCellCenter(set->GetCell(j), dcenter, weights);
-      cptr[0] = static_cast<float>(dcenter[0]);
-      cptr[1] = static_cast<float>(dcenter[1]);
-      cptr[2] = static_cast<float>(dcenter[2]);
-      cptr += 3;
-      if (j % 1000 == 0)
+      return;
+    }
+    // GetCell() is only thread safe once it has been called from a single
+    // thread.
+    vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+    iset->GetCell(0, tlCell.Local());
+    vtkSMPThreadLocal<std::vector<double>> tlWeights;
+    vtkSMPTools::For(0, nCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+      vtkGenericCell* cell = tlCell.Local();
+      std::vector<double>& weights = tlWeights.Local();
+      weights.resize(maxCellSize > 0 ? maxCellSize : 1);
+      double dcenter[3];
+      for (; cellId < endCellId; ++cellId)
       {
-        this->UpdateSubOperationProgress(static_cast<double>(j) / totalCells);
+        iset->GetCell(cellId, cell);
+        this->ComputeCellCenter(cell, dcenter, weights.data());
+        float* c = cptr + 3 * cellId;
+        c[0] = static_cast<float>(dcenter[0]);
+        c[1] = static_cast<float>(dcenter[1]);
+        c[2] = static_cast<float>(dcenter[2]);
       }
-    }
+    });
+    doneCells += nCells;
+    this->UpdateSubOperationProgress(static_cast<double>(doneCells) / totalCells);
+  };
+
+  if (set)
+  {
+    computeCenters(set, center);
   }
   else
   {
+    float* cptr = center;
     vtkCollectionSimpleIterator cookie;
     this->DataSets->InitTraversal(cookie);
     for (vtkDataSet* iset = this->DataSets->GetNextDataSet(cookie); iset != nullptr;
          iset = this->DataSets->GetNextDataSet(cookie))
     {
-      int nCells = iset->GetNumberOfCells();
-
-      for (int j = 0; j < nCells; j++)
-      {
-        this->ComputeCellCenter(iset->GetCell(j), dcenter, weights);
-        cptr[0] = static_cast<float>(dcenter[0]);
-        cptr[1] = static_cast<float>(dcenter[1]);
-        cptr[2] = static_cast<float>(dcenter[2]);
-        cptr += 3;
-        if (j % 1000 == 0)
-        {
-          this->UpdateSubOperationProgress(static_cast<double>(j) / totalCells);
-        }
-      }
+      computeCenters(iset, cptr);
+      cptr += 3 * iset->GetNumberOfCells();
     }
   }
 
-  delete[] weights;
-
   this->UpdateSubOperationProgress(1.0);
   return center;
 }
@@ -184,6 +184,15 @@ public:
     return this->Superclass::IntersectWithLine(p1, p2, points, cellIds);
   }
 
+  //@{
+  /**
+   * The queries of this locator are thread safe, so FindCells() and
+   * IntersectWithLines() process them in parallel.
+   */
+  bool IsFindCellThreadSafe() override { return true; }
+  bool IsIntersectWithLineThreadSafe() override { return true; }
+  //@}
+
   //@{
   /**
    * Satisfy vtkLocator abstract interface.
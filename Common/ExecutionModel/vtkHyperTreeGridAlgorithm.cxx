@@ -15,12 +15,19 @@
 #include "vtkHyperTreeGridAlgorithm.h"
 
 #include "vtkBitArray.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
 #include "vtkCommand.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkHyperTree.h"
 #include "vtkHyperTreeGrid.h"
+#include "vtkHyperTreeGridScales.h"
+#include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnstructuredGrid.h"
@@ -277,6 +284,100 @@ int vtkHyperTreeGridAlgorithm::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//------------------------------------------------------------------------------
+void vtkHyperTreeGridAlgorithm::GetTreeIndices(
+  vtkHyperTreeGrid* input, std::vector<vtkIdType>& indices)
+{
+  indices.clear();
+  const unsigned int numLevels = input->GetNumberOfLevels();
+  vtkIdType index;
+  vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
+  input->InitializeTreeIterator(it);
+  while (vtkHyperTree* tree = it.GetNextTree(index))
+  {
+    indices.push_back(index);
+    if (tree->HasScales())
+    {
+      // Cursors ask for the scales of the children of the deepest cells
+      tree->GetScales()->GetScale(numLevels);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkHyperTreeGridAlgorithm::MergeTreeChunk(vtkPolyData* chunk,
+  vtkIncrementalPointLocator* locator, vtkPoints* points, vtkCellArray* verts,
+  vtkCellArray* lines, vtkCellArray* polys, vtkDataSetAttributes* outPointData,
+  vtkDataSetAttributes* outCellData)
+{
+  vtkPoints* chunkPoints = chunk->GetPoints();
+  const vtkIdType numChunkPts = chunkPoints ? chunkPoints->GetNumberOfPoints() : 0;
+  vtkDataSetAttributes* chunkPointData = chunk->GetPointData();
+  std::vector<vtkIdType> pointMap(numChunkPts);
+  if (locator)
+  {
+    for (vtkIdType ptId = 0; ptId < numChunkPts; ++ptId)
+    {
+      double x[3];
+      chunkPoints->GetPoint(ptId, x);
+      if (locator->InsertUniquePoint(x, pointMap[ptId]) && outPointData)
+      {
+        for (int i = 0; i < outPointData->GetNumberOfArrays(); ++i)
+        {
+          outPointData->GetAbstractArray(i)->InsertTuple(
+            pointMap[ptId], ptId, chunkPointData->GetAbstractArray(i));
+        }
+      }
+    }
+  }
+  else if (numChunkPts)
+  {
+    const vtkIdType firstPtId = points->GetNumberOfPoints();
+    points->GetData()->InsertTuples(firstPtId, numChunkPts, 0, chunkPoints->GetData());
+    for (vtkIdType ptId = 0; ptId < numChunkPts; ++ptId)
+    {
+      pointMap[ptId] = firstPtId + ptId;
+    }
+    for (int i = 0; outPointData && i < outPointData->GetNumberOfArrays(); ++i)
+    {
+      outPointData->GetAbstractArray(i)->InsertTuples(
+        firstPtId, numChunkPts, 0, chunkPointData->GetAbstractArray(i));
+    }
+  }
+
+  vtkCellArray* chunkCells[3] = { chunk->GetVerts(), chunk->GetLines(), chunk->GetPolys() };
+  vtkCellArray* newCells[3] = { verts, lines, polys };
+  const vtkIdType firstCellId = outCellData ? outCellData->GetNumberOfTuples() : 0;
+  vtkIdType numChunkCells = 0;
+  std::vector<vtkIdType> cellPts;
+  for (int kind = 0; kind < 3; ++kind)
+  {
+    if (!newCells[kind])
+    {
+      continue;
+    }
+    const vtkIdType numCells = chunkCells[kind]->GetNumberOfCells();
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      vtkIdType npts;
+      const vtkIdType* pts;
+      chunkCells[kind]->GetCellAtId(cellId, npts, pts);
+      cellPts.resize(npts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        cellPts[i] = pointMap[pts[i]];
+      }
+      newCells[kind]->InsertNextCell(npts, cellPts.data());
+    }
+    numChunkCells += numCells;
+  }
+  for (int i = 0; outCellData && numChunkCells && i < outCellData->GetNumberOfArrays(); ++i)
+  {
+    outCellData->GetAbstractArray(i)->InsertTuples(
+      firstCellId, numChunkCells, 0, chunk->GetCellData()->GetAbstractArray(i));
+  }
+}
+
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridAlgorithm::SetInputData(vtkDataObject* input)
 {
@@ -38,9 +38,14 @@
 #include "vtkAlgorithm.h"
 #include "vtkCommonExecutionModelModule.h" // For export macro
 
+#include <vector> // For GetTreeIndices
+
 class vtkBitArray;
+class vtkCellArray;
 class vtkDataSetAttributes;
 class vtkHyperTreeGrid;
+class vtkIncrementalPointLocator;
+class vtkPoints;
 class vtkPolyData;
 class vtkUnstructuredGrid;
 
@@ -140,6 +145,36 @@ protected:
    */
   virtual int ProcessTrees(vtkHyperTreeGrid*, vtkDataObject*) = 0;
 
+  /**
+   * Collect the indices of the trees of the input, in the order of its tree
+   * iterator, so that concrete algorithms can process them in several threads
+   * and produce the same output as when iterating over them. The cell scales
+   * of the trees, otherwise extended lazily by the geometry cursors, are
+   * computed down to the deepest level beforehand.
+   */
+  static void GetTreeIndices(vtkHyperTreeGrid* input, std::vector<vtkIdType>& indices);
+
+  /**
+   * Number of consecutive trees, in the order of GetTreeIndices(), processed
+   * into the same chunk output by the concrete algorithms that run in
+   * several threads, before the chunks are merged with MergeTreeChunk().
+   */
+  static constexpr vtkIdType TreeChunkSize = 16;
+
+  /**
+   * Append the output of a chunk of trees to the points and cells of the
+   * output, in order. The points are merged with the locator when given,
+   * which then holds the output points, and appended otherwise. The cells of
+   * the chunk are appended to the output cell arrays which are given, with
+   * their point ids renumbered. The point data of the new points, and the
+   * cell data of the appended cells, are copied when the output attributes
+   * are given. The cell data is appended in the order of the cells of the
+   * chunk, which suits outputs with one kind of cells.
+   */
+  static void MergeTreeChunk(vtkPolyData* chunk, vtkIncrementalPointLocator* locator,
+    vtkPoints* points, vtkCellArray* verts, vtkCellArray* lines, vtkCellArray* polys,
+    vtkDataSetAttributes* outPointData, vtkDataSetAttributes* outCellData);
+
   //@{
   /**
    * Define default input and output port types
@@ -17,25 +17,26 @@
 #include "vtkCellData.h"
 #include "vtkCommand.h"
 #include "vtkDataArray.h"
+#include "vtkDataObject.h"
+#include "vtkExecutive.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
+#include "vtkInformationExecutivePortVectorKey.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
-#include "vtkSMP.h"
 #include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
-// If SMP backend is Sequential then fall back to vtkMultiThreader,
-// else enable the newer vtkSMPTools code path by default.
-#ifdef VTK_SMP_Sequential
-bool vtkThreadedImageAlgorithm::GlobalDefaultEnableSMP = false;
-#else
+// Enable the newer vtkSMPTools code path by default. When the backend in use
+// is Sequential, the filters fall back to vtkMultiThreader at execution.
 bool vtkThreadedImageAlgorithm::GlobalDefaultEnableSMP = true;
-#endif
 
 //------------------------------------------------------------------------------
 vtkThreadedImageAlgorithm::vtkThreadedImageAlgorithm()
@@ -60,12 +61,17 @@ vtkThreadedImageAlgorithm::vtkThreadedImageAlgorithm()
 
   // The desired block size in bytes
   this->DesiredBytesPerPiece = 65536;
+
+  this->FusedExtentExecution = false;
+  this->Fusion = nullptr;
+  this->ForwardingDataRequest = false;
 }
 
 //------------------------------------------------------------------------------
 vtkThreadedImageAlgorithm::~vtkThreadedImageAlgorithm()
 {
   this->Threader->Delete();
+  delete this->Fusion;
 }
 
 //------------------------------------------------------------------------------
@@ -90,6 +96,7 @@ void vtkThreadedImageAlgorithm::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
   os << indent << "EnableSMP: " << (this->EnableSMP ? "On\n" : "Off\n");
+  os << indent << "FusedExtentExecution: " << (this->FusedExtentExecution ? "On\n" : "Off\n");
   os << indent << "GlobalDefaultEnableSMP: "
      << (vtkThreadedImageAlgorithm::GlobalDefaultEnableSMP ? "On\n" : "Off\n");
   os << indent << "MinimumPieceSize: " << this->MinimumPieceSize[0] << " "
@@ -103,15 +110,22 @@ void vtkThreadedImageAlgorithm::PrintSelf(ostream& os, vtkIndent indent)
 }
 
 //------------------------------------------------------------------------------
-struct vtkImageThreadStruct
+// What the pieces of a filter need, kept until the next filter executes
+// them with its own pieces in fused extent mode. The request is copied, and
+// the information vectors are those of the executive when the pieces run.
+struct vtkThreadedImageAlgorithmFusion
 {
-  vtkThreadedImageAlgorithm* Filter;
-  vtkInformation* Request;
+  vtkSmartPointer<vtkInformation> Request;
   vtkInformationVector** InputsInfo;
   vtkInformationVector* OutputsInfo;
+  std::vector<vtkImageData*> Connections;
+  std::vector<vtkImageData**> Ports;
   vtkImageData*** Inputs;
   vtkImageData** Outputs;
-  int* UpdateExtent;
+  int Extent[6];
+  int BytesPerVoxel;
+  // the previous filter, fused with this one, if any
+  vtkThreadedImageAlgorithm* Input;
 };
 
 //------------------------------------------------------------------------------
@@ -347,42 +361,6 @@ int vtkThreadedImageAlgorithm::SplitExtent(int splitExt[6], int startExt[6], int
   return total;
 }
 
-//------------------------------------------------------------------------------
-// The old way to thread an image filter, before vtkSMPTools existed:
-// this mess is really a simple function. All it does is call
-// the ThreadedExecute method after setting the correct
-// extent for this thread. It's just a pain to calculate
-// the correct extent.
-static VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute(void* arg)
-{
-  vtkImageThreadStruct* str;
-  int splitExt[6], total;
-  int threadId, threadCount;
-
-  threadId = static_cast<vtkMultiThreader::ThreadInfo*>(arg)->ThreadID;
-  threadCount = static_cast<vtkMultiThreader::ThreadInfo*>(arg)->NumberOfThreads;
-
-  str =
-    static_cast<vtkImageThreadStruct*>(static_cast<vtkMultiThreader::ThreadInfo*>(arg)->UserData);
-
-  // execute the actual method with appropriate extent
-  // first find out how many pieces extent can be split into.
-  total = str->Filter->SplitExtent(splitExt, str->UpdateExtent, threadId, threadCount);
-
-  if (threadId < total)
-  {
-    // return if nothing to do
-    if (splitExt[1] < splitExt[0] || splitExt[3] < splitExt[2] || splitExt[5] < splitExt[4])
-    {
-      return VTK_THREAD_RETURN_VALUE;
-    }
-    str->Filter->ThreadedRequestData(str->Request, str->InputsInfo, str->OutputsInfo, str->Inputs,
-      str->Outputs, splitExt, threadId);
-  }
-
-  return VTK_THREAD_RETURN_VALUE;
-}
-
 //------------------------------------------------------------------------------
 // This functor is used with vtkSMPTools to execute the algorithm in pieces
 // split over the extent of the data.
@@ -393,7 +371,7 @@ public:
   // needed by the ThreadedRequestData method that the functor will call.
   vtkThreadedImageAlgorithmFunctor(vtkThreadedImageAlgorithm* algo, vtkInformation* request,
     vtkInformationVector** inputsInfo, vtkInformationVector* outputsInfo, vtkImageData*** inputs,
-    vtkImageData** outputs, const int extent[6], vtkIdType pieces)
+    vtkImageData** outputs, const int extent[6], vtkIdType pieces, bool fused)
     : Algorithm(algo)
     , Request(request)
     , InputsInfo(inputsInfo)
@@ -401,6 +379,7 @@ public:
     , Inputs(inputs)
     , Outputs(outputs)
     , NumberOfPieces(pieces)
+    , Fused(fused)
   {
     for (int i = 0; i < 6; i++)
     {
@@ -411,8 +390,41 @@ public:
   // Called by vtkSMPTools to execute the algorithm over specific pieces.
   void operator()(vtkIdType begin, vtkIdType end)
   {
-    this->Algorithm->SMPRequestData(this->Request, this->InputsInfo, this->OutputsInfo,
-      this->Inputs, this->Outputs, begin, end, this->NumberOfPieces, this->Extent);
+    if (!this->Fused)
+    {
+      this->Algorithm->SMPRequestData(this->Request, this->InputsInfo, this->OutputsInfo,
+        this->Inputs, this->Outputs, begin, end, this->NumberOfPieces, this->Extent);
+      return;
+    }
+    for (vtkIdType piece = begin; piece < end; piece++)
+    {
+      this->ExecutePiece(piece, this->NumberOfPieces);
+    }
+  }
+
+  // Execute one of the given number of pieces the extent is split in, along
+  // with the pieces of the previous filters when fused.
+  void ExecutePiece(vtkIdType piece, vtkIdType numPieces)
+  {
+    int splitExt[6] = { 0, -1, 0, -1, 0, -1 };
+
+    vtkIdType total = this->Algorithm->SplitExtent(
+      splitExt, this->Extent, static_cast<int>(piece), static_cast<int>(numPieces));
+
+    // check for valid piece and extent
+    if (piece < total && splitExt[0] <= splitExt[1] && splitExt[2] <= splitExt[3] &&
+      splitExt[4] <= splitExt[5])
+    {
+      if (this->Fused)
+      {
+        this->Algorithm->ExecuteFusedPiece(splitExt, static_cast<int>(piece));
+      }
+      else
+      {
+        this->Algorithm->ThreadedRequestData(this->Request, this->InputsInfo, this->OutputsInfo,
+          this->Inputs, this->Outputs, splitExt, static_cast<int>(piece));
+      }
+    }
   }
 
 private:
@@ -426,8 +438,20 @@ private:
   vtkImageData** Outputs;
   int Extent[6];
   vtkIdType NumberOfPieces;
+  bool Fused;
 };
 
+//------------------------------------------------------------------------------
+// The old way to thread an image filter, before vtkSMPTools existed: each
+// thread created by the vtkMultiThreader executes the piece matching its id.
+static VTK_THREAD_RETURN_TYPE vtkThreadedImageAlgorithmThreadedExecute(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  static_cast<vtkThreadedImageAlgorithmFunctor*>(info->UserData)
+    ->ExecutePiece(info->ThreadID, info->NumberOfThreads);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //------------------------------------------------------------------------------
 // The execute method created by the subclass.
 void vtkThreadedImageAlgorithm::SMPRequestData(vtkInformation* request,
@@ -589,64 +613,246 @@ int vtkThreadedImageAlgorithm::RequestData(
   if (updateExtent[0] <= updateExtent[1] && updateExtent[2] <= updateExtent[3] &&
     updateExtent[4] <= updateExtent[5])
   {
-    if (this->EnableSMP)
+    // a fusion left from an execution that the next filter did not run
+    if (this->Fusion)
     {
-      // SMP is enabled, use vtkSMPTools to thread the filter
-      vtkIdType pieces = vtkSMPTools::GetEstimatedNumberOfThreads();
+      this->ExecuteFusion();
+    }
 
-      // compute a reasonable number of pieces, this will be a multiple of
-      // the number of available threads and relative to the data size
-      vtkTypeInt64 bytesize = (static_cast<vtkTypeInt64>(updateExtent[1] - updateExtent[0] + 1) *
-        static_cast<vtkTypeInt64>(updateExtent[3] - updateExtent[2] + 1) *
-        static_cast<vtkTypeInt64>(updateExtent[5] - updateExtent[4] + 1) * bytesPerVoxel);
-      vtkTypeInt64 bytesPerPiece = this->DesiredBytesPerPiece;
+    vtkThreadedImageAlgorithm* fusedInput = nullptr;
+    bool fused = false;
+    if (this->FusedExtentExecution && this->CanFuseExtent())
+    {
+      fusedInput = this->GetFusedInput(updateExtent);
+      fused = this->WillBeFused(inputVector, outputVector);
+    }
 
-      if (bytesPerPiece > 0 && bytesPerPiece < bytesize)
+    if (fused || fusedInput)
+    {
+      this->Fusion = new vtkThreadedImageAlgorithmFusion;
+      this->Fusion->Request = vtkSmartPointer<vtkInformation>::New();
+      this->Fusion->Request->Copy(request);
+      this->Fusion->Connections = std::move(connections);
+      this->Fusion->Ports = std::move(ports);
+      this->Fusion->Inputs = inputs;
+      this->Fusion->Outputs = outputs;
+      std::copy(updateExtent, updateExtent + 6, this->Fusion->Extent);
+      this->Fusion->BytesPerVoxel = bytesPerVoxel;
+      this->Fusion->Input = fusedInput;
+
+      // the output is allocated, the next filter will fill it
+      if (!fused)
       {
-        vtkTypeInt64 b = pieces * bytesPerPiece;
-        pieces *= (bytesize + b - 1) / b;
+        this->ExecuteFusion();
       }
-      // do a dummy execution of SplitExtent to compute the number of pieces
-      int subExtent[6];
-      pieces = this->SplitExtent(subExtent, updateExtent, 0, pieces);
+    }
+    else
+    {
+      this->ExecutePieces(
+        request, inputVector, outputVector, inputs, outputs, updateExtent, bytesPerVoxel, false);
+    }
+  }
 
-      // always shut off debugging to avoid threading problems with GetMacros
-      bool debug = this->Debug;
-      this->Debug = false;
+  return 1;
+}
 
-      vtkThreadedImageAlgorithmFunctor functor(
-        this, request, inputVector, outputVector, inputs, outputs, updateExtent, pieces);
+//------------------------------------------------------------------------------
+void vtkThreadedImageAlgorithm::ExecutePieces(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector, vtkImageData*** inputs,
+  vtkImageData** outputs, int updateExtent[6], int bytesPerVoxel, bool fused)
+{
+  // always shut off debugging to avoid threading problems with GetMacros
+  bool debug = this->Debug;
+  this->Debug = false;
 
-      vtkSMPTools::For(0, pieces, functor);
+  // the Sequential backend would execute the pieces one after the other
+  const bool sequential = (strcmp(vtkSMPTools::GetBackend(), "Sequential") == 0);
 
-      this->Debug = debug;
+  if (this->EnableSMP && !sequential)
+  {
+    // SMP is enabled, use vtkSMPTools to thread the filter
+    vtkIdType pieces = vtkSMPTools::GetEstimatedNumberOfThreads();
+
+    // compute a reasonable number of pieces, this will be a multiple of
+    // the number of available threads and relative to the data size
+    vtkTypeInt64 bytesize = (static_cast<vtkTypeInt64>(updateExtent[1] - updateExtent[0] + 1) *
+      static_cast<vtkTypeInt64>(updateExtent[3] - updateExtent[2] + 1) *
+      static_cast<vtkTypeInt64>(updateExtent[5] - updateExtent[4] + 1) * bytesPerVoxel);
+    vtkTypeInt64 bytesPerPiece = this->DesiredBytesPerPiece;
+
+    if (bytesPerPiece > 0 && bytesPerPiece < bytesize)
+    {
+      vtkTypeInt64 b = pieces * bytesPerPiece;
+      pieces *= (bytesize + b - 1) / b;
     }
-    else
+    // do a dummy execution of SplitExtent to compute the number of pieces
+    int subExtent[6];
+    pieces = this->SplitExtent(subExtent, updateExtent, 0, pieces);
+
+    vtkThreadedImageAlgorithmFunctor functor(
+      this, request, inputVector, outputVector, inputs, outputs, updateExtent, pieces, fused);
+
+    vtkSMPTools::For(0, pieces, functor);
+  }
+  else
+  {
+    // do a dummy execution of SplitExtent to compute the number of pieces
+    int subExtent[6];
+    vtkIdType pieces = this->SplitExtent(subExtent, updateExtent, 0, this->NumberOfThreads);
+
+    vtkThreadedImageAlgorithmFunctor functor(
+      this, request, inputVector, outputVector, inputs, outputs, updateExtent, pieces, fused);
+
+    if (sequential)
     {
-      // if SMP is not enabled, use the vtkMultiThreader
-      vtkImageThreadStruct str;
-      str.Filter = this;
-      str.Request = request;
-      str.InputsInfo = inputVector;
-      str.OutputsInfo = outputVector;
-      str.Inputs = inputs;
-      str.Outputs = outputs;
-      str.UpdateExtent = updateExtent;
-
-      // do a dummy execution of SplitExtent to compute the number of pieces
-      int subExtent[6];
-      vtkIdType pieces = this->SplitExtent(subExtent, updateExtent, 0, this->NumberOfThreads);
+      // without SMP threads, use the vtkMultiThreader
       this->Threader->SetNumberOfThreads(pieces);
-      this->Threader->SetSingleMethod(vtkThreadedImageAlgorithmThreadedExecute, &str);
-      // always shut off debugging to avoid threading problems with GetMacros
-      bool debug = this->Debug;
-      this->Debug = false;
+      this->Threader->SetSingleMethod(vtkThreadedImageAlgorithmThreadedExecute, &functor);
       this->Threader->SingleMethodExecute();
-      this->Debug = debug;
+    }
+    else
+    {
+      // if SMP is not enabled, still run one piece per thread, but on the
+      // threads of the vtkSMPTools backend instead of new ones
+      vtkSMPTools::For(0, pieces, 1, [&functor, pieces](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType piece = begin; piece < end; piece++)
+        {
+          functor.ExecutePiece(piece, pieces);
+        }
+      });
     }
   }
 
-  return 1;
+  this->Debug = debug;
+}
+
+//------------------------------------------------------------------------------
+vtkTypeBool vtkThreadedImageAlgorithm::ProcessRequest(
+  vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkTypeBool result = this->Superclass::ProcessRequest(request, inputVector, outputVector);
+
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()) &&
+    this->GetNumberOfInputPorts() == 1 && this->GetNumberOfInputConnections(0) == 1)
+  {
+    vtkThreadedImageAlgorithm* input =
+      vtkThreadedImageAlgorithm::SafeDownCast(this->GetInputAlgorithm(0, 0));
+    // unless this filter left both executions to the next one
+    if (input && input->Fusion && !(this->Fusion && this->Fusion->Input == input))
+    {
+      input->ExecuteFusion();
+    }
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+int vtkThreadedImageAlgorithm::ModifyRequest(vtkInformation* request, int when)
+{
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+  {
+    this->ForwardingDataRequest = (when == vtkExecutive::BeforeForward);
+  }
+  return this->Superclass::ModifyRequest(request, when);
+}
+
+//------------------------------------------------------------------------------
+// The next filter fuses with this one if it is the only consumer of its
+// output, if it is updating it for its own execution, and if the input of
+// this filter stays in memory until then.
+bool vtkThreadedImageAlgorithm::WillBeFused(
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (this->GetNumberOfInputPorts() != 1 || this->GetNumberOfOutputPorts() != 1 ||
+    inputVector[0]->GetNumberOfInformationObjects() != 1)
+  {
+    return false;
+  }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  if (vtkDataObject::GetGlobalReleaseDataFlag() ||
+    inInfo->Get(vtkDemandDrivenPipeline::RELEASE_DATA()))
+  {
+    return false;
+  }
+
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  if (vtkExecutive::CONSUMERS()->Length(outInfo) != 1)
+  {
+    return false;
+  }
+  vtkThreadedImageAlgorithm* next = vtkThreadedImageAlgorithm::SafeDownCast(
+    vtkExecutive::CONSUMERS()->GetExecutives(outInfo)[0]->GetAlgorithm());
+  return next && next->ForwardingDataRequest && next->FusedExtentExecution &&
+    next->CanFuseExtent() && next->GetNumberOfInputPorts() == 1 &&
+    next->GetNumberOfInputConnections(0) == 1;
+}
+
+//------------------------------------------------------------------------------
+// Returns the previous filter if it left its execution to this one, for the
+// same extent. Otherwise, it is completed here.
+vtkThreadedImageAlgorithm* vtkThreadedImageAlgorithm::GetFusedInput(const int extent[6])
+{
+  if (this->GetNumberOfInputPorts() != 1 || this->GetNumberOfInputConnections(0) != 1)
+  {
+    return nullptr;
+  }
+
+  vtkThreadedImageAlgorithm* input =
+    vtkThreadedImageAlgorithm::SafeDownCast(this->GetInputAlgorithm(0, 0));
+  if (!input || !input->Fusion)
+  {
+    return nullptr;
+  }
+  if (!std::equal(extent, extent + 6, input->Fusion->Extent))
+  {
+    input->ExecuteFusion();
+    return nullptr;
+  }
+  return input;
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedImageAlgorithm::ExecuteFusion()
+{
+  // the information vectors given to RequestData() may be gone by now
+  for (vtkThreadedImageAlgorithm* algo = this; algo; algo = algo->Fusion->Input)
+  {
+    algo->Fusion->InputsInfo = algo->GetExecutive()->GetInputInformation();
+    algo->Fusion->OutputsInfo = algo->GetExecutive()->GetOutputInformation();
+  }
+
+  vtkThreadedImageAlgorithmFusion* fusion = this->Fusion;
+  this->ExecutePieces(fusion->Request, fusion->InputsInfo, fusion->OutputsInfo, fusion->Inputs,
+    fusion->Outputs, fusion->Extent, fusion->BytesPerVoxel, true);
+  this->ReleaseFusion();
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedImageAlgorithm::ExecuteFusedPiece(int extent[6], int piece)
+{
+  vtkThreadedImageAlgorithmFusion* fusion = this->Fusion;
+  if (fusion->Input)
+  {
+    fusion->Input->ExecuteFusedPiece(extent, piece);
+  }
+  this->ThreadedRequestData(fusion->Request, fusion->InputsInfo, fusion->OutputsInfo,
+    fusion->Inputs, fusion->Outputs, extent, piece);
+}
+
+//------------------------------------------------------------------------------
+void vtkThreadedImageAlgorithm::ReleaseFusion()
+{
+  if (this->Fusion)
+  {
+    if (this->Fusion->Input)
+    {
+      this->Fusion->Input->ReleaseFusion();
+    }
+    delete this->Fusion;
+    this->Fusion = nullptr;
+  }
 }
 
 //------------------------------------------------------------------------------
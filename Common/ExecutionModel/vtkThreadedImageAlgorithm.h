@@ -34,6 +34,7 @@
 
 class vtkImageData;
 class vtkMultiThreader;
+struct vtkThreadedImageAlgorithmFusion;
 
 class VTKCOMMONEXECUTIONMODEL_EXPORT vtkThreadedImageAlgorithm : public vtkImageAlgorithm
 {
@@ -57,7 +58,8 @@ public:
 
   //@{
   /**
-   * Enable/Disable SMP for threading.
+   * Enable/Disable SMP for threading. When the vtkSMPTools backend in use is
+   * Sequential, the filter executes as if SMP was disabled.
    */
   vtkGetMacro(EnableSMP, bool);
   vtkSetMacro(EnableSMP, bool);
@@ -71,6 +73,19 @@ public:
   static bool GetGlobalDefaultEnableSMP();
   //@}
 
+  //@{
+  /**
+   * Enable/Disable the fused extent execution. When it is enabled on
+   * consecutive filters that compute each output voxel from the same input
+   * voxel, such as vtkImageShiftScale, vtkImageMapToColors and vtkImageCast,
+   * a filter whose output only feeds the next one leaves its execution to
+   * it: the next filter runs each piece of the previous filters right
+   * before its own, while the piece is still in cache. Off by default.
+   */
+  vtkGetMacro(FusedExtentExecution, bool);
+  vtkSetMacro(FusedExtentExecution, bool);
+  //@}
+
   //@{
   /**
    * The minimum piece size when volume is split for execution.
@@ -108,8 +123,11 @@ public:
 
   //@{
   /**
-   * Get/Set the number of threads to create when rendering.
-   * This is ignored if EnableSMP is On.
+   * Get/Set the number of pieces the volume is split in when EnableSMP is
+   * Off. Unless the SMP backend is Sequential, the pieces are executed by
+   * the threads of the vtkSMPTools backend, which persist between the
+   * executions of all the filters, instead of threads created for each
+   * execution. This is ignored if EnableSMP is On.
    */
   vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
   vtkGetMacro(NumberOfThreads, int);
@@ -120,6 +138,20 @@ public:
    */
   virtual int SplitExtent(int splitExt[6], int startExt[6], int num, int total);
 
+  /**
+   * Completes the execution that the input filter left to this one when
+   * this filter did not fuse it, e.g. because RequestData was overridden.
+   */
+  vtkTypeBool ProcessRequest(
+    vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  /**
+   * Keeps track of the data requests that this filter forwards to its
+   * inputs, which are the only ones for which the input filter can leave
+   * its execution to this one.
+   */
+  int ModifyRequest(vtkInformation* request, int when) override;
+
 protected:
   vtkThreadedImageAlgorithm();
   ~vtkThreadedImageAlgorithm() override;
@@ -130,6 +162,8 @@ protected:
   bool EnableSMP;
   static bool GlobalDefaultEnableSMP;
 
+  bool FusedExtentExecution;
+
   enum SplitModeEnum
   {
     SLAB = 0,
@@ -170,10 +204,31 @@ protected:
     vtkInformationVector* outputVector, vtkImageData*** inDataObjects = nullptr,
     vtkImageData** outDataObjects = nullptr);
 
+  /**
+   * Returns true if the filter has one input and one output with the same
+   * extents, and computes each output voxel from the same input voxel only.
+   * Its execution can then be fused with the ones of the previous and next
+   * filters. The default is false, pointwise filters override it.
+   */
+  virtual bool CanFuseExtent() { return false; }
+
 private:
   vtkThreadedImageAlgorithm(const vtkThreadedImageAlgorithm&) = delete;
   void operator=(const vtkThreadedImageAlgorithm&) = delete;
 
+  // The execution of this filter, kept while it is fused with the next one.
+  vtkThreadedImageAlgorithmFusion* Fusion;
+  bool ForwardingDataRequest;
+  bool WillBeFused(vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+  vtkThreadedImageAlgorithm* GetFusedInput(const int extent[6]);
+  void ExecuteFusion();
+  void ExecuteFusedPiece(int extent[6], int piece);
+  void ReleaseFusion();
+
+  void ExecutePieces(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector, vtkImageData*** inData, vtkImageData** outData,
+    int extent[6], int bytesPerVoxel, bool fused);
+
   friend class vtkThreadedImageAlgorithmFunctor;
 };
 
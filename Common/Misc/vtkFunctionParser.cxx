@@ -17,11 +17,75 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 
 vtkStandardNewMacro(vtkFunctionParser);
 
 static double vtkParserVectorErrorResult[3] = { VTK_PARSER_ERROR_RESULT, VTK_PARSER_ERROR_RESULT,
   VTK_PARSER_ERROR_RESULT };
+
+namespace
+{
+// The operations of EvaluateBlock, applied to blocks of n values so that the
+// loops can be vectorized.
+template <typename Op>
+void BlockUnary(double* x, vtkIdType n, Op op)
+{
+  for (vtkIdType i = 0; i < n; i++)
+  {
+    x[i] = op(x[i]);
+  }
+}
+
+template <typename Op>
+void BlockBinary(double* x, const double* y, vtkIdType n, Op op)
+{
+  for (vtkIdType i = 0; i < n; i++)
+  {
+    x[i] = op(x[i], y[i]);
+  }
+}
+
+// The invalid sets of values of a block: the first invalid operation of each
+// set, or 0, and its argument.
+struct BlockErrors
+{
+  double* Operations;
+  double* Arguments;
+
+  void Flag(vtkIdType i, unsigned int operation, double argument)
+  {
+    if (this->Operations[i] == 0.0)
+    {
+      this->Operations[i] = operation;
+      this->Arguments[i] = argument;
+    }
+  }
+};
+
+// A unary operation whose argument is checked: invalid arguments are
+// replaced, or flagged in errors.
+template <typename Valid, typename Op>
+void BlockChecked(double* x, vtkIdType n, bool replace, double replacement, BlockErrors& errors,
+  unsigned int operation, Valid valid, Op op)
+{
+  for (vtkIdType i = 0; i < n; i++)
+  {
+    if (valid(x[i]))
+    {
+      x[i] = op(x[i]);
+    }
+    else if (replace)
+    {
+      x[i] = replacement;
+    }
+    else
+    {
+      errors.Flag(i, operation, x[i]);
+    }
+  }
+}
+}
 //------------------------------------------------------------------------------
 vtkFunctionParser::vtkFunctionParser()
 {
@@ -415,12 +479,6 @@ void vtkFunctionParser::InvalidateFunction()
 //------------------------------------------------------------------------------
 bool vtkFunctionParser::Evaluate()
 {
-  int numBytesProcessed;
-  int numImmediatesProcessed = 0;
-  int stackPosition = -1;
-  double magnitude;
-  double temp[3];
-
   this->StackPointer = -1;
 
   if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime())
@@ -431,422 +489,433 @@ bool vtkFunctionParser::Evaluate()
     }
   }
 
-  for (numBytesProcessed = 0; numBytesProcessed < this->ByteCodeSize; numBytesProcessed++)
+  // a block of a single set of values, those of the variables
+  const int stackPosition = this->ExecuteBlock(1, nullptr, nullptr, this->BlockStack);
+  const double* errors = this->BlockStack.data() + this->StackSize;
+  const double argument = errors[1];
+  switch (static_cast<unsigned int>(errors[0]))
   {
-    switch (this->ByteCode[numBytesProcessed])
+    case 0:
+      break;
+    case VTK_PARSER_DIVIDE:
+      vtkErrorMacro("Trying to divide by zero");
+      return false;
+    case VTK_PARSER_LOGARITHM:
+      vtkErrorMacro("Trying to take a log of a non-positive value");
+      return false;
+    case VTK_PARSER_LOGARITHME:
+      vtkErrorMacro("Trying to take a natural logarithm of a non-positive value");
+      return false;
+    case VTK_PARSER_LOGARITHM10:
+      vtkErrorMacro("Trying to take a log10 of a non-positive value");
+      return false;
+    case VTK_PARSER_SQUARE_ROOT:
+      vtkErrorMacro("Trying to take a square root of a negative value");
+      return false;
+    case VTK_PARSER_ARCSINE:
+      vtkErrorMacro("Trying to take asin of a value < -1 or > 1. Arg is q" << argument);
+      return false;
+    case VTK_PARSER_ARCCOSINE:
+      vtkErrorMacro("Trying to take acos of a value < -1 or > 1. Arg is q" << argument);
+      return false;
+    default:
+      return false;
+  }
+
+  std::copy_n(this->BlockStack.data(), stackPosition + 1, this->Stack);
+  this->StackPointer = stackPosition;
+
+  this->EvaluateMTime.Modified();
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkFunctionParser::EvaluateBlock(vtkIdType numValues, const double* const* scalars,
+  const double* const* vectors, double* result, std::vector<double>& stack) const
+{
+  if (numValues <= 0)
+  {
+    return 0;
+  }
+  if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime() || this->StackSize == 0)
+  {
+    return numValues;
+  }
+
+  const vtkIdType n = numValues;
+  const int stackPosition = this->ExecuteBlock(n, scalars, vectors, stack);
+  if (stackPosition != 0 && stackPosition != 2)
+  {
+    return numValues;
+  }
+  const double* invalid = stack.data() + static_cast<size_t>(this->StackSize) * n;
+  auto slot = [&](int position) { return stack.data() + static_cast<size_t>(position) * n; };
+  const int numComponents = stackPosition + 1;
+  vtkIdType numInvalid = 0;
+  for (vtkIdType i = 0; i < n; i++)
+  {
+    const bool isInvalid = invalid[i] != 0.0;
+    numInvalid += isInvalid;
+    for (int c = 0; c < numComponents; c++)
+    {
+      result[numComponents * i + c] = isInvalid ? VTK_PARSER_ERROR_RESULT : slot(c)[i];
+    }
+  }
+  return numInvalid;
+}
+
+//------------------------------------------------------------------------------
+int vtkFunctionParser::ExecuteBlock(vtkIdType n, const double* const* scalars,
+  const double* const* vectors, std::vector<double>& stack) const
+{
+  // The stack holds StackSize blocks of values, followed by the first invalid
+  // operation of each set of values and its argument.
+  stack.resize(static_cast<size_t>(this->StackSize + 2) * n);
+  BlockErrors errors{ stack.data() + static_cast<size_t>(this->StackSize) * n,
+    stack.data() + static_cast<size_t>(this->StackSize + 1) * n };
+  std::fill_n(errors.Operations, n, 0.0);
+  auto slot = [&](int position) { return stack.data() + static_cast<size_t>(position) * n; };
+
+  const int numScalarVariables = static_cast<int>(this->ScalarVariableNames.size());
+  const bool replace = this->ReplaceInvalidValues != 0;
+  const double replacement = this->ReplacementValue;
+  int numImmediatesProcessed = 0;
+  int stackPosition = -1;
+
+  for (int numBytesProcessed = 0; numBytesProcessed < this->ByteCodeSize; numBytesProcessed++)
+  {
+    const unsigned int byte = this->ByteCode[numBytesProcessed];
+    // the operands of binary operations, and the top of the stack
+    double* x = stackPosition > 0 ? slot(stackPosition - 1) : nullptr;
+    double* y = stackPosition >= 0 ? slot(stackPosition) : nullptr;
+    switch (byte)
     {
       case VTK_PARSER_IMMEDIATE:
-        this->Stack[++stackPosition] = this->Immediates[numImmediatesProcessed++];
+        ++stackPosition;
+        std::fill_n(slot(stackPosition), n, this->Immediates[numImmediatesProcessed++]);
         break;
       case VTK_PARSER_UNARY_MINUS:
-        this->Stack[stackPosition] = -(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return -a; });
         break;
       case VTK_PARSER_UNARY_PLUS:
         break;
       case VTK_PARSER_ADD:
-        this->Stack[stackPosition - 1] += this->Stack[stackPosition];
+        BlockBinary(x, y, n, [](double a, double b) { return a + b; });
         stackPosition--;
         break;
       case VTK_PARSER_SUBTRACT:
-        this->Stack[stackPosition - 1] -= this->Stack[stackPosition];
+        BlockBinary(x, y, n, [](double a, double b) { return a - b; });
         stackPosition--;
         break;
       case VTK_PARSER_MULTIPLY:
-        this->Stack[stackPosition - 1] *= this->Stack[stackPosition];
+        BlockBinary(x, y, n, [](double a, double b) { return a * b; });
         stackPosition--;
         break;
       case VTK_PARSER_DIVIDE:
-        if (this->Stack[stackPosition] == 0)
+        for (vtkIdType i = 0; i < n; i++)
         {
-          if (this->ReplaceInvalidValues)
+          if (y[i] != 0)
+          {
+            x[i] /= y[i];
+          }
+          else if (replace)
           {
-            this->Stack[stackPosition - 1] = this->ReplacementValue;
-            stackPosition--;
+            x[i] = replacement;
           }
           else
           {
-            vtkErrorMacro("Trying to divide by zero");
-            return false;
+            errors.Flag(i, byte, y[i]);
           }
         }
-        else
-        {
-          this->Stack[stackPosition - 1] /= this->Stack[stackPosition];
-          stackPosition--;
-        }
+        stackPosition--;
         break;
       case VTK_PARSER_POWER:
-        this->Stack[stackPosition - 1] =
-          pow(this->Stack[stackPosition - 1], this->Stack[stackPosition]);
+        BlockBinary(x, y, n, [](double a, double b) { return pow(a, b); });
         stackPosition--;
         break;
       case VTK_PARSER_ABSOLUTE_VALUE:
-        this->Stack[stackPosition] = fabs(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return fabs(a); });
         break;
       case VTK_PARSER_EXPONENT:
-        this->Stack[stackPosition] = exp(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return exp(a); });
         break;
       case VTK_PARSER_CEILING:
-        this->Stack[stackPosition] = ceil(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return ceil(a); });
         break;
       case VTK_PARSER_FLOOR:
-        this->Stack[stackPosition] = floor(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return floor(a); });
         break;
       case VTK_PARSER_LOGARITHM:
-        if (this->Stack[stackPosition] <= 0)
-        {
-          if (this->ReplaceInvalidValues)
-          {
-            this->Stack[stackPosition] = this->ReplacementValue;
-          }
-          else
-          {
-            vtkErrorMacro("Trying to take a log of a non-positive value");
-            return false;
-          }
-        }
-        else
-        {
-          this->Stack[stackPosition] = log(this->Stack[stackPosition]);
-        }
-        break;
       case VTK_PARSER_LOGARITHME:
-        if (this->Stack[stackPosition] <= 0)
-        {
-          if (this->ReplaceInvalidValues)
-          {
-            this->Stack[stackPosition] = this->ReplacementValue;
-          }
-          else
-          {
-            vtkErrorMacro("Trying to take a natural logarithm of a non-positive value");
-            return false;
-          }
-        }
-        else
-        {
-          this->Stack[stackPosition] = log(this->Stack[stackPosition]);
-        }
+        BlockChecked(y, n, replace, replacement, errors, byte, [](double a) { return !(a <= 0); },
+          [](double a) { return log(a); });
         break;
       case VTK_PARSER_LOGARITHM10:
-        if (this->Stack[stackPosition] <= 0)
-        {
-          if (this->ReplaceInvalidValues)
-          {
-            this->Stack[stackPosition] = this->ReplacementValue;
-          }
-          else
-          {
-            vtkErrorMacro("Trying to take a log10 of a non-positive value");
-            return false;
-          }
-        }
-        else
-        {
-          this->Stack[stackPosition] = log10(this->Stack[stackPosition]);
-        }
+        BlockChecked(y, n, replace, replacement, errors, byte, [](double a) { return !(a <= 0); },
+          [](double a) { return log10(a); });
         break;
       case VTK_PARSER_SQUARE_ROOT:
-        if (this->Stack[stackPosition] < 0)
-        {
-          if (this->ReplaceInvalidValues)
-          {
-            this->Stack[stackPosition] = this->ReplacementValue;
-          }
-          else
-          {
-            vtkErrorMacro("Trying to take a square root of a negative value");
-            return false;
-          }
-        }
-        else
-        {
-          this->Stack[stackPosition] = sqrt(this->Stack[stackPosition]);
-        }
+        BlockChecked(y, n, replace, replacement, errors, byte, [](double a) { return !(a < 0); },
+          [](double a) { return sqrt(a); });
         break;
       case VTK_PARSER_SINE:
-        this->Stack[stackPosition] = sin(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return sin(a); });
         break;
       case VTK_PARSER_COSINE:
-        this->Stack[stackPosition] = cos(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return cos(a); });
         break;
       case VTK_PARSER_TANGENT:
-        this->Stack[stackPosition] = tan(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return tan(a); });
         break;
       case VTK_PARSER_ARCSINE:
-        if (this->Stack[stackPosition] < -1 || this->Stack[stackPosition] > 1)
-        {
-          if (this->ReplaceInvalidValues)
-          {
-            this->Stack[stackPosition] = this->ReplacementValue;
-          }
-          else
-          {
-            vtkErrorMacro(
-              "Trying to take asin of a value < -1 or > 1. Arg is q" << this->Stack[stackPosition]);
-            return false;
-          }
-        }
-        else
-        {
-          this->Stack[stackPosition] = asin(this->Stack[stackPosition]);
-        }
+        BlockChecked(y, n, replace, replacement, errors, byte,
+          [](double a) { return !(a < -1 || a > 1); }, [](double a) { return asin(a); });
         break;
       case VTK_PARSER_ARCCOSINE:
-        if (this->Stack[stackPosition] < -1 || this->Stack[stackPosition] > 1)
-        {
-          if (this->ReplaceInvalidValues)
-          {
-            this->Stack[stackPosition] = this->ReplacementValue;
-          }
-          else
-          {
-            vtkErrorMacro(
-              "Trying to take acos of a value < -1 or > 1. Arg is q" << this->Stack[stackPosition]);
-            return false;
-          }
-        }
-        else
-        {
-          this->Stack[stackPosition] = acos(this->Stack[stackPosition]);
-        }
+        BlockChecked(y, n, replace, replacement, errors, byte,
+          [](double a) { return !(a < -1 || a > 1); }, [](double a) { return acos(a); });
         break;
       case VTK_PARSER_ARCTANGENT:
-        this->Stack[stackPosition] = atan(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return atan(a); });
         break;
       case VTK_PARSER_HYPERBOLIC_SINE:
-        this->Stack[stackPosition] = sinh(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return sinh(a); });
         break;
       case VTK_PARSER_HYPERBOLIC_COSINE:
-        this->Stack[stackPosition] = cosh(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return cosh(a); });
         break;
       case VTK_PARSER_HYPERBOLIC_TANGENT:
-        this->Stack[stackPosition] = tanh(this->Stack[stackPosition]);
+        BlockUnary(y, n, [](double a) { return tanh(a); });
         break;
       case VTK_PARSER_MIN:
-        if (this->Stack[stackPosition] < this->Stack[stackPosition - 1])
-        {
-          this->Stack[stackPosition - 1] = this->Stack[stackPosition];
-        }
+        BlockBinary(x, y, n, [](double a, double b) { return b < a ? b : a; });
         stackPosition--;
         break;
       case VTK_PARSER_MAX:
-        if (this->Stack[stackPosition] > this->Stack[stackPosition - 1])
-        {
-          this->Stack[stackPosition - 1] = this->Stack[stackPosition];
-        }
+        BlockBinary(x, y, n, [](double a, double b) { return b > a ? b : a; });
         stackPosition--;
         break;
       case VTK_PARSER_CROSS:
-// Cross Product
-#define Ux (stackPosition - 5)
-#define Uy (stackPosition - 4)
-#define Uz (stackPosition - 3)
-#define Vx (stackPosition - 2)
-#define Vy (stackPosition - 1)
-#define Vz stackPosition
-        temp[0] = this->Stack[Uy] * this->Stack[Vz] - this->Stack[Uz] * this->Stack[Vy];
-        temp[1] = this->Stack[Uz] * this->Stack[Vx] - this->Stack[Ux] * this->Stack[Vz];
-        temp[2] = this->Stack[Ux] * this->Stack[Vy] - this->Stack[Uy] * this->Stack[Vx];
-        this->Stack[Ux] = temp[0];
-        this->Stack[Uy] = temp[1];
-        this->Stack[Uz] = temp[2];
-#undef Ux
-#undef Uy
-#undef Uz
-#undef Vx
-#undef Vy
-#undef Vz
+      {
+        double* ux = slot(stackPosition - 5);
+        double* uy = slot(stackPosition - 4);
+        double* uz = slot(stackPosition - 3);
+        const double* vx = slot(stackPosition - 2);
+        const double* vy = slot(stackPosition - 1);
+        const double* vz = y;
+        for (vtkIdType i = 0; i < n; i++)
+        {
+          const double cx = uy[i] * vz[i] - uz[i] * vy[i];
+          const double cy = uz[i] * vx[i] - ux[i] * vz[i];
+          const double cz = ux[i] * vy[i] - uy[i] * vx[i];
+          ux[i] = cx;
+          uy[i] = cy;
+          uz[i] = cz;
+        }
         stackPosition -= 3;
         break;
+      }
       case VTK_PARSER_SIGN:
-        if (this->Stack[stackPosition] < 0)
-        {
-          this->Stack[stackPosition] = -1;
-        }
-        else if (this->Stack[stackPosition] == 0)
-        {
-          this->Stack[stackPosition] = 0;
-        }
-        else
-        {
-          this->Stack[stackPosition] = 1;
-        }
+        BlockUnary(y, n, [](double a) { return a < 0 ? -1.0 : (a == 0 ? 0.0 : 1.0); });
         break;
       case VTK_PARSER_VECTOR_UNARY_MINUS:
-        this->Stack[stackPosition] = -this->Stack[stackPosition];
-        this->Stack[stackPosition - 1] = -this->Stack[stackPosition - 1];
-        this->Stack[stackPosition - 2] = -this->Stack[stackPosition - 2];
+        for (int c = 0; c < 3; c++)
+        {
+          BlockUnary(slot(stackPosition - c), n, [](double a) { return -a; });
+        }
         break;
       case VTK_PARSER_VECTOR_UNARY_PLUS:
         break;
       case VTK_PARSER_DOT_PRODUCT:
-        this->Stack[stackPosition - 3] *= this->Stack[stackPosition];
-        this->Stack[stackPosition - 4] *= this->Stack[stackPosition - 1];
-        this->Stack[stackPosition - 5] *= this->Stack[stackPosition - 2];
-        this->Stack[stackPosition - 5] = this->Stack[stackPosition - 5] +
-          this->Stack[stackPosition - 4] + this->Stack[stackPosition - 3];
+      {
+        double* ux = slot(stackPosition - 5);
+        const double* uy = slot(stackPosition - 4);
+        const double* uz = slot(stackPosition - 3);
+        const double* vx = slot(stackPosition - 2);
+        const double* vy = slot(stackPosition - 1);
+        const double* vz = y;
+        for (vtkIdType i = 0; i < n; i++)
+        {
+          ux[i] = ux[i] * vx[i] + uy[i] * vy[i] + uz[i] * vz[i];
+        }
         stackPosition -= 5;
         break;
+      }
       case VTK_PARSER_VECTOR_ADD:
-        this->Stack[stackPosition - 3] += this->Stack[stackPosition];
-        this->Stack[stackPosition - 4] += this->Stack[stackPosition - 1];
-        this->Stack[stackPosition - 5] += this->Stack[stackPosition - 2];
+        for (int c = 0; c < 3; c++)
+        {
+          BlockBinary(slot(stackPosition - 5 + c), slot(stackPosition - 2 + c), n,
+            [](double a, double b) { return a + b; });
+        }
         stackPosition -= 3;
         break;
       case VTK_PARSER_VECTOR_SUBTRACT:
-        this->Stack[stackPosition - 3] -= this->Stack[stackPosition];
-        this->Stack[stackPosition - 4] -= this->Stack[stackPosition - 1];
-        this->Stack[stackPosition - 5] -= this->Stack[stackPosition - 2];
+        for (int c = 0; c < 3; c++)
+        {
+          BlockBinary(slot(stackPosition - 5 + c), slot(stackPosition - 2 + c), n,
+            [](double a, double b) { return a - b; });
+        }
         stackPosition -= 3;
         break;
       case VTK_PARSER_SCALAR_TIMES_VECTOR:
-        this->Stack[stackPosition] *= this->Stack[stackPosition - 3];
-        this->Stack[stackPosition - 1] *= this->Stack[stackPosition - 3];
-        this->Stack[stackPosition - 2] *= this->Stack[stackPosition - 3];
-        this->Stack[stackPosition - 3] = this->Stack[stackPosition - 2];
-        this->Stack[stackPosition - 2] = this->Stack[stackPosition - 1];
-        this->Stack[stackPosition - 1] = this->Stack[stackPosition];
+      {
+        // the vector is moved down over the scalar
+        double* s = slot(stackPosition - 3);
+        double* vx = slot(stackPosition - 2);
+        double* vy = x;
+        const double* vz = y;
+        for (vtkIdType i = 0; i < n; i++)
+        {
+          const double scale = s[i];
+          s[i] = vx[i] * scale;
+          vx[i] = vy[i] * scale;
+          vy[i] = vz[i] * scale;
+        }
         stackPosition--;
         break;
+      }
       case VTK_PARSER_VECTOR_TIMES_SCALAR:
-        this->Stack[stackPosition - 3] *= this->Stack[stackPosition];
-        this->Stack[stackPosition - 2] *= this->Stack[stackPosition];
-        this->Stack[stackPosition - 1] *= this->Stack[stackPosition];
+        for (int c = 1; c <= 3; c++)
+        {
+          BlockBinary(slot(stackPosition - c), y, n, [](double a, double b) { return a * b; });
+        }
         stackPosition--;
         break;
       case VTK_PARSER_VECTOR_OVER_SCALAR:
-        if (this->Stack[stackPosition] != 0.0)
+        for (int c = 1; c <= 3; c++)
         {
-          this->Stack[stackPosition - 3] /= this->Stack[stackPosition];
-          this->Stack[stackPosition - 2] /= this->Stack[stackPosition];
-          this->Stack[stackPosition - 1] /= this->Stack[stackPosition];
+          BlockBinary(slot(stackPosition - c), y, n,
+            [](double a, double b) { return b != 0.0 ? a / b : a; });
         }
         stackPosition--;
         break;
       case VTK_PARSER_MAGNITUDE:
-        this->Stack[stackPosition - 2] = sqrt(pow(this->Stack[stackPosition], 2) +
-          pow(this->Stack[stackPosition - 1], 2) + pow(this->Stack[stackPosition - 2], 2));
+      {
+        double* vx = slot(stackPosition - 2);
+        const double* vy = x;
+        const double* vz = y;
+        for (vtkIdType i = 0; i < n; i++)
+        {
+          vx[i] = sqrt(pow(vz[i], 2) + pow(vy[i], 2) + pow(vx[i], 2));
+        }
         stackPosition -= 2;
         break;
+      }
       case VTK_PARSER_NORMALIZE:
-        magnitude = sqrt(pow(this->Stack[stackPosition], 2) +
-          pow(this->Stack[stackPosition - 1], 2) + pow(this->Stack[stackPosition - 2], 2));
-        if (magnitude != 0)
+      {
+        double* vx = slot(stackPosition - 2);
+        double* vy = x;
+        double* vz = y;
+        for (vtkIdType i = 0; i < n; i++)
         {
-          this->Stack[stackPosition] /= magnitude;
-          this->Stack[stackPosition - 1] /= magnitude;
-          this->Stack[stackPosition - 2] /= magnitude;
+          const double magnitude = sqrt(pow(vz[i], 2) + pow(vy[i], 2) + pow(vx[i], 2));
+          if (magnitude != 0)
+          {
+            vz[i] /= magnitude;
+            vy[i] /= magnitude;
+            vx[i] /= magnitude;
+          }
         }
         break;
+      }
       case VTK_PARSER_IHAT:
-        this->Stack[++stackPosition] = 1;
-        this->Stack[++stackPosition] = 0;
-        this->Stack[++stackPosition] = 0;
-        break;
       case VTK_PARSER_JHAT:
-        this->Stack[++stackPosition] = 0;
-        this->Stack[++stackPosition] = 1;
-        this->Stack[++stackPosition] = 0;
-        break;
       case VTK_PARSER_KHAT:
-        this->Stack[++stackPosition] = 0;
-        this->Stack[++stackPosition] = 0;
-        this->Stack[++stackPosition] = 1;
+        for (unsigned int c = 0; c < 3; c++)
+        {
+          ++stackPosition;
+          std::fill_n(slot(stackPosition), n, byte - VTK_PARSER_IHAT == c ? 1.0 : 0.0);
+        }
         break;
       case VTK_PARSER_LESS_THAN:
-        this->Stack[stackPosition - 1] =
-          (this->Stack[stackPosition - 1] < this->Stack[stackPosition]);
+        BlockBinary(x, y, n, [](double a, double b) { return static_cast<double>(a < b); });
         stackPosition--;
         break;
       case VTK_PARSER_GREATER_THAN:
-        this->Stack[stackPosition - 1] =
-          (this->Stack[stackPosition - 1] > this->Stack[stackPosition]);
+        BlockBinary(x, y, n, [](double a, double b) { return static_cast<double>(a > b); });
         stackPosition--;
         break;
       case VTK_PARSER_EQUAL_TO:
-        this->Stack[stackPosition - 1] =
-          (this->Stack[stackPosition - 1] == this->Stack[stackPosition]);
+        BlockBinary(x, y, n, [](double a, double b) { return static_cast<double>(a == b); });
         stackPosition--;
         break;
       case VTK_PARSER_AND:
-        this->Stack[stackPosition - 1] =
-          (this->Stack[stackPosition - 1] && this->Stack[stackPosition]);
+        BlockBinary(x, y, n, [](double a, double b) { return static_cast<double>(a && b); });
         stackPosition--;
         break;
       case VTK_PARSER_OR:
-        this->Stack[stackPosition - 1] =
-          (this->Stack[stackPosition - 1] || this->Stack[stackPosition]);
+        BlockBinary(x, y, n, [](double a, double b) { return static_cast<double>(a || b); });
         stackPosition--;
         break;
       case VTK_PARSER_IF:
       {
-        // Stack[stackPosition]=Stack[2] refers to the bool
-        // argument of if(bool,valtrue,valfalse). Stack[1] is valtrue, and
-        // Stack[0] is valfalse.
-        int result = stackPosition - 2;
-        int valFalse = stackPosition - 2;
-        int valTrue = stackPosition - 1;
-        int boolArg = stackPosition;
-
-        if (this->Stack[boolArg] != 0.0)
-          this->Stack[result] = this->Stack[valTrue];
-        else
-          this->Stack[result] = this->Stack[valFalse];
+        // the result replaces the false value, below the true value and the
+        // boolean argument
+        double* valFalse = slot(stackPosition - 2);
+        const double* valTrue = x;
+        const double* boolArg = y;
+        for (vtkIdType i = 0; i < n; i++)
+        {
+          valFalse[i] = boolArg[i] != 0.0 ? valTrue[i] : valFalse[i];
+        }
         stackPosition -= 2;
         break;
       }
       case VTK_PARSER_VECTOR_IF:
       {
-        int xResult = stackPosition - 6;
-        int yResult = stackPosition - 5;
-        int zResult = stackPosition - 4;
-        int xValFalse = stackPosition - 6;
-        int yValFalse = stackPosition - 5;
-        int zValFalse = stackPosition - 4;
-        int xValTrue = stackPosition - 3;
-        int yValTrue = stackPosition - 2;
-        int zValTrue = stackPosition - 1;
-        int boolArg = stackPosition;
-
-        if (this->Stack[boolArg] != 0.0)
-        {
-          this->Stack[xResult] = this->Stack[xValTrue];
-          this->Stack[yResult] = this->Stack[yValTrue];
-          this->Stack[zResult] = this->Stack[zValTrue];
-        }
-        else
+        const double* boolArg = y;
+        for (int c = 0; c < 3; c++)
         {
-          this->Stack[xResult] = this->Stack[xValFalse];
-          this->Stack[yResult] = this->Stack[yValFalse];
-          this->Stack[zResult] = this->Stack[zValFalse];
+          double* valFalse = slot(stackPosition - 6 + c);
+          const double* valTrue = slot(stackPosition - 3 + c);
+          for (vtkIdType i = 0; i < n; i++)
+          {
+            valFalse[i] = boolArg[i] != 0.0 ? valTrue[i] : valFalse[i];
+          }
         }
         stackPosition -= 4;
         break;
       }
       default:
-        if ((this->ByteCode[numBytesProcessed] - VTK_PARSER_BEGIN_VARIABLES) <
-          static_cast<unsigned int>(this->GetNumberOfScalarVariables()))
+        if ((byte - VTK_PARSER_BEGIN_VARIABLES) < static_cast<unsigned int>(numScalarVariables))
         {
-          this->Stack[++stackPosition] =
-            this->ScalarVariableValues[this->ByteCode[numBytesProcessed] -
-              VTK_PARSER_BEGIN_VARIABLES];
+          const int scalarNum = byte - VTK_PARSER_BEGIN_VARIABLES;
+          ++stackPosition;
+          if (scalars && scalars[scalarNum])
+          {
+            std::copy_n(scalars[scalarNum], n, slot(stackPosition));
+          }
+          else
+          {
+            std::fill_n(slot(stackPosition), n, this->ScalarVariableValues[scalarNum]);
+          }
         }
         else
         {
-          int vectorNum = this->ByteCode[numBytesProcessed] - VTK_PARSER_BEGIN_VARIABLES -
-            this->GetNumberOfScalarVariables();
-          this->Stack[++stackPosition] = this->VectorVariableValues[vectorNum][0];
-          this->Stack[++stackPosition] = this->VectorVariableValues[vectorNum][1];
-          this->Stack[++stackPosition] = this->VectorVariableValues[vectorNum][2];
+          const int vectorNum = byte - VTK_PARSER_BEGIN_VARIABLES - numScalarVariables;
+          for (int c = 0; c < 3; c++)
+          {
+            ++stackPosition;
+            double* component = slot(stackPosition);
+            if (vectors && vectors[vectorNum])
+            {
+              const double* values = vectors[vectorNum];
+              for (vtkIdType i = 0; i < n; i++)
+              {
+                component[i] = values[3 * i + c];
+              }
+            }
+            else
+            {
+              std::fill_n(component, n, this->VectorVariableValues[vectorNum][c]);
+            }
+          }
         }
     }
   }
-  this->StackPointer = stackPosition;
 
-  this->EvaluateMTime.Modified();
-
-  return true;
+  return stackPosition;
 }
 
 //------------------------------------------------------------------------------
@@ -181,6 +181,25 @@ public:
   }
   //@}
 
+  /**
+   * Evaluate the function for numValues sets of values of its variables at
+   * once, each operation of the byte code being applied to the whole block of
+   * values. scalars and vectors hold a pointer per scalar and vector variable,
+   * to numValues values and to numValues interleaved triples respectively; a
+   * variable whose pointer is null, or all of them when scalars or vectors is
+   * null, keeps the value it was set to. The results, numValues scalars or
+   * interleaved triples depending on IsScalarResult(), are written to result,
+   * and stack is resized to hold the intermediate values.
+   *
+   * The function must have been parsed, e.g. by a call to IsScalarResult().
+   * This method does not modify the parser, so that several threads can
+   * evaluate blocks at the same time with their own stacks. Invalid
+   * operations which are not replaced give VTK_PARSER_ERROR_RESULT without
+   * reporting an error; the number of such sets of values is returned.
+   */
+  vtkIdType EvaluateBlock(vtkIdType numValues, const double* const* scalars,
+    const double* const* vectors, double* result, std::vector<double>& stack) const;
+
   //@{
   /**
    * Set the value of a scalar variable.  If a variable with this name
@@ -342,6 +361,15 @@ protected:
    */
   bool Evaluate();
 
+  /**
+   * Run the byte code on blocks of n sets of values, as described in
+   * EvaluateBlock(), and return the final stack position. The stack is
+   * followed by a block with the first invalid operation of each set of
+   * values, or 0, and a block with the argument of that operation.
+   */
+  int ExecuteBlock(vtkIdType n, const double* const* scalars, const double* const* vectors,
+    std::vector<double>& stack) const;
+
   int CheckSyntax();
 
   void CopyParseError(int& position, char** error);
@@ -400,6 +428,7 @@ protected:
   double* Stack;
   int StackSize;
   int StackPointer;
+  std::vector<double> BlockStack;
 
   vtkTimeStamp FunctionMTime;
   vtkTimeStamp ParseMTime;
@@ -0,0 +1,216 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestArrayCalculatorBlocks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that vtkArrayCalculator, which evaluates its function on blocks of
+// tuples in several threads, gives the same results as vtkFunctionParser
+// evaluated tuple by tuple, for scalar and vector functions of arrays and
+// coordinates, invalid values and float results.
+
+#include "vtkArrayCalculator.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkFunctionParser.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestErrorObserver.h"
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+vtkSmartPointer<vtkImageData> MakeImage()
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(40, 30, 20);
+  image->SetSpacing(0.1, 0.2, 0.3);
+  image->SetOrigin(-2.0, -3.0, -1.0);
+  const vtkIdType numPoints = image->GetNumberOfPoints();
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  vtkNew<vtkDoubleArray> a;
+  a->SetName("a");
+  a->SetNumberOfTuples(numPoints);
+  vtkNew<vtkFloatArray> b;
+  b->SetName("b");
+  b->SetNumberOfComponents(3);
+  b->SetNumberOfTuples(numPoints);
+  vtkNew<vtkIntArray> c;
+  c->SetName("c");
+  c->SetNumberOfTuples(numPoints);
+  for (vtkIdType i = 0; i < numPoints; i++)
+  {
+    random->Next();
+    a->SetValue(i, random->GetRangeValue(-2.0, 2.0));
+    for (int j = 0; j < 3; j++)
+    {
+      random->Next();
+      b->SetTypedComponent(i, j, static_cast<float>(random->GetRangeValue(-1.0, 1.0)));
+    }
+    c->SetValue(i, static_cast<int>(i % 7) - 2);
+  }
+  // the first tuple, evaluated to find the type of the result, is valid
+  a->SetValue(0, 0.5);
+  c->SetValue(0, 1);
+  image->GetPointData()->AddArray(a);
+  image->GetPointData()->AddArray(b);
+  image->GetPointData()->AddArray(c);
+  return image;
+}
+
+// The same points and point data as a point set.
+vtkSmartPointer<vtkPolyData> MakePolyData(vtkImageData* image)
+{
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+  {
+    double x[3];
+    image->GetPoint(i, x);
+    points->SetPoint(i, x);
+  }
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->GetPointData()->ShallowCopy(image->GetPointData());
+  return polyData;
+}
+
+// The function evaluated tuple by tuple.
+std::vector<double> Evaluate(
+  vtkDataSet* input, const char* function, int numComps, bool replace, vtkCommand* observer)
+{
+  vtkNew<vtkFunctionParser> parser;
+  parser->AddObserver(vtkCommand::ErrorEvent, observer);
+  parser->SetFunction(function);
+  parser->SetReplaceInvalidValues(replace);
+  parser->SetReplacementValue(0.5);
+  vtkPointData* pointData = input->GetPointData();
+  std::vector<double> results;
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); i++)
+  {
+    double x[3];
+    input->GetPoint(i, x);
+    parser->SetScalarVariableValue("a", pointData->GetArray("a")->GetComponent(i, 0));
+    parser->SetScalarVariableValue("c", pointData->GetArray("c")->GetComponent(i, 0));
+    parser->SetVectorVariableValue("b", pointData->GetArray("b")->GetTuple3(i));
+    parser->SetScalarVariableValue("coordsY", x[1]);
+    parser->SetVectorVariableValue("coords", x);
+    if (numComps == 1)
+    {
+      results.push_back(parser->GetScalarResult());
+    }
+    else
+    {
+      double* result = parser->GetVectorResult();
+      results.insert(results.end(), result, result + 3);
+    }
+  }
+  return results;
+}
+
+bool TestFunction(vtkDataSet* input, const char* function, int numComps, bool replace = false,
+  int resultType = VTK_DOUBLE)
+{
+  vtkNew<vtkTest::ErrorObserver> observer;
+  vtkNew<vtkArrayCalculator> calculator;
+  calculator->AddObserver(vtkCommand::ErrorEvent, observer);
+  calculator->SetInputData(input);
+  calculator->AddScalarArrayName("a");
+  calculator->AddScalarArrayName("c");
+  calculator->AddVectorArrayName("b");
+  calculator->AddCoordinateScalarVariable("coordsY", 1);
+  calculator->AddCoordinateVectorVariable("coords", 0, 1, 2);
+  calculator->SetFunction(function);
+  calculator->SetReplaceInvalidValues(replace);
+  calculator->SetReplacementValue(0.5);
+  calculator->SetResultArrayType(resultType);
+  calculator->SetResultArrayName("result");
+  calculator->Update();
+
+  vtkDataArray* result =
+    vtkDataSet::SafeDownCast(calculator->GetOutput())->GetPointData()->GetArray("result");
+  if (!result || result->GetDataType() != resultType ||
+    result->GetNumberOfComponents() != numComps ||
+    result->GetNumberOfTuples() != input->GetNumberOfPoints())
+  {
+    std::cerr << function << ": wrong result array" << std::endl;
+    return false;
+  }
+  const bool calculatorError = observer->GetError();
+
+  observer->Clear();
+  std::vector<double> expected = Evaluate(input, function, numComps, replace, observer);
+  if (calculatorError != observer->GetError())
+  {
+    std::cerr << function << ": the errors differ" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < result->GetNumberOfValues(); i++)
+  {
+    double value = expected[i];
+    if (resultType == VTK_FLOAT)
+    {
+      value = static_cast<float>(value);
+    }
+    const double actual = result->GetComponent(i / numComps, i % numComps);
+    if (actual != value)
+    {
+      std::cerr << function << ": value " << i << " is " << actual << " instead of " << value
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestArrayCalculatorBlocks(int, char*[])
+{
+  vtkSmartPointer<vtkImageData> image = MakeImage();
+  vtkSmartPointer<vtkPolyData> polyData = MakePolyData(image);
+
+  for (vtkDataSet* input :
+    { static_cast<vtkDataSet*>(image), static_cast<vtkDataSet*>(polyData) })
+  {
+    if (!TestFunction(input, "a * c + sin(a) - cos(c) / (1 + abs(a)) ^ 2", 1) ||
+      !TestFunction(input,
+        "min(a, c) + max(exp(a), floor(3 * a)) * ceil(a) + sign(c) + atan(a) + tanh(a) + "
+        "sinh(a) - cosh(a) + tan(a)",
+        1) ||
+      !TestFunction(input, "if(a > 0 & c < 2 | c = 0, mag(b) * a, b . coords) + coordsY", 1) ||
+      !TestFunction(input, "cross(b, iHat + 2 * jHat) + a * norm(b) - b / c + coordsY * kHat", 3) ||
+      !TestFunction(input, "if(a < 0, -b, coords * 2) - (c * b) / 3", 3) ||
+      !TestFunction(input, "a * coords + b", 3, false, VTK_FLOAT))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // invalid values, replaced or not
+    const char* invalid = "sqrt(a) + ln(a) + log10(c) + asin(a) + acos(a / 2) + 1 / c";
+    if (!TestFunction(input, invalid, 1, true) || !TestFunction(input, invalid, 1, false))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCleanPolyDataParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the parallel point merging of vtkCleanPolyData produces the
+// same output as the serial path when the tolerance is 0, and the same output
+// for any number of threads otherwise.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTestDataComparison.h>
+
+#include <iostream>
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> ConstructPolyData(int dataType)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  // Points on a coarse lattice so that many of them are duplicated.
+  const vtkIdType numPts = 20000;
+  vtkNew<vtkPoints> points;
+  points->SetDataType(dataType);
+  points->SetNumberOfPoints(numPts);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = static_cast<int>(random->GetRangeValue(0, 16)) * 0.1;
+      random->Next();
+    }
+    points->SetPoint(i, x);
+    scalars->SetValue(i, static_cast<double>(i));
+  }
+
+  // Random cells of every kind, some of them degenerated by the merging.
+  vtkCellArray* cells[4];
+  for (int kind = 0; kind < 4; ++kind)
+  {
+    cells[kind] = vtkCellArray::New();
+    const int minSize[4] = { 1, 2, 3, 3 };
+    for (int c = 0; c < 2000; ++c)
+    {
+      const int npts = minSize[kind] + static_cast<int>(random->GetRangeValue(0, 4));
+      random->Next();
+      cells[kind]->InsertNextCell(npts);
+      for (int i = 0; i < npts; ++i)
+      {
+        // Draw the points of a cell close together so that merges happen.
+        const vtkIdType ptId = static_cast<vtkIdType>(random->GetRangeValue(0, 64)) +
+          static_cast<vtkIdType>(c * (numPts - 64) / 2000);
+        random->Next();
+        cells[kind]->InsertCellPoint(ptId);
+      }
+    }
+  }
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->GetPointData()->SetScalars(scalars);
+  polyData->SetVerts(cells[0]);
+  polyData->SetLines(cells[1]);
+  polyData->SetPolys(cells[2]);
+  polyData->SetStrips(cells[3]);
+  for (int kind = 0; kind < 4; ++kind)
+  {
+    cells[kind]->Delete();
+  }
+
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(polyData->GetNumberOfCells());
+  for (vtkIdType i = 0; i < polyData->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, i);
+  }
+  polyData->GetCellData()->AddArray(cellIds);
+
+  return polyData;
+}
+
+vtkSmartPointer<vtkPolyData> Clean(
+  vtkPolyData* input, double tol, bool parallel, int numThreads = 1)
+{
+  vtkNew<vtkCleanPolyData> clean;
+  clean->SetInputData(input);
+  clean->SetTolerance(tol);
+  clean->SetParallelMerging(parallel);
+  return vtkPolyData::SafeDownCast(
+    vtkTestDataComparison::UpdateWithThreads(clean.GetPointer(), numThreads));
+}
+
+bool SameOutput(vtkPolyData* output1, vtkPolyData* output2, const char* name)
+{
+  if (output1->GetPoints()->GetDataType() != output2->GetPoints()->GetDataType())
+  {
+    std::cerr << name << ": point types differ" << std::endl;
+    return false;
+  }
+  return vtkTestDataComparison::SameDataSets(output1, output2, name);
+}
+}
+
+int TestCleanPolyDataParallel(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  const int dataTypes[2] = { VTK_FLOAT, VTK_DOUBLE };
+  for (int dataType : dataTypes)
+  {
+    vtkSmartPointer<vtkPolyData> input = ConstructPolyData(dataType);
+
+    vtkSmartPointer<vtkPolyData> serial = Clean(input, 0.0, false);
+    vtkSmartPointer<vtkPolyData> parallel = Clean(input, 0.0, true);
+    if (serial->GetNumberOfPoints() >= input->GetNumberOfPoints())
+    {
+      std::cerr << "No points were merged" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!SameOutput(serial, parallel, "Parallel merging"))
+    {
+      return EXIT_FAILURE;
+    }
+
+    vtkSmartPointer<vtkPolyData> merged1 = Clean(input, 0.04, true, 1);
+    vtkSmartPointer<vtkPolyData> merged4 = Clean(input, 0.04, true, 4);
+    if (merged1->GetNumberOfPoints() >= parallel->GetNumberOfPoints())
+    {
+      std::cerr << "Tolerance did not merge more points" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!SameOutput(merged1, merged4, "Merging with a tolerance"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
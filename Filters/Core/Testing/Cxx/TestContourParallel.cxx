@@ -0,0 +1,255 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestContourParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the threaded contouring of the general paths of
+// vtkContourFilter, vtkContourGrid and vtkCutter gives the same output as the
+// serial one, on cells of several types and dimensions.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkContourFilter.h"
+#include "vtkCutter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphere.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+const int Resolution = 24;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + (Resolution + 1) * (j + (Resolution + 1) * k);
+}
+
+// Integer scalars, so that some contours go through the points.
+void AddPointData(vtkDataSet* dataSet)
+{
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkDoubleArray> coords;
+  coords->SetName("Coords");
+  coords->SetNumberOfComponents(3);
+  for (vtkIdType ptId = 0; ptId < dataSet->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    dataSet->GetPoint(ptId, x);
+    scalars->InsertNextValue(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+    coords->InsertNextTuple(x);
+  }
+  dataSet->GetPointData()->SetScalars(scalars);
+  dataSet->GetPointData()->AddArray(coords);
+
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < dataSet->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(cellId);
+  }
+  dataSet->GetCellData()->AddArray(cellIds);
+}
+
+vtkSmartPointer<vtkPoints> ConstructPoints()
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int k = 0; k <= Resolution; ++k)
+  {
+    for (int j = 0; j <= Resolution; ++j)
+    {
+      for (int i = 0; i <= Resolution; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  return points;
+}
+
+// 3D cells of several types, with 2D and 1D cells on the boundary.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(ConstructPoints());
+  grid->Allocate(2 * Resolution * Resolution * Resolution);
+
+  for (int j = 0; j < Resolution; ++j)
+  {
+    for (int i = 0; i < Resolution; ++i)
+    {
+      const vtkIdType quad[4] = { PointId(i, j, 0), PointId(i + 1, j, 0),
+        PointId(i + 1, j + 1, 0), PointId(i, j + 1, 0) };
+      grid->InsertNextCell(VTK_QUAD, 4, quad);
+    }
+  }
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        const vtkIdType hex[8] = { PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k), PointId(i, j, k + 1),
+          PointId(i + 1, j, k + 1), PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        switch ((i + 2 * j + 3 * k) % 4)
+        {
+          case 0:
+            grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+            break;
+          case 1:
+          {
+            const vtkIdType voxel[8] = { hex[0], hex[1], hex[3], hex[2], hex[4], hex[5], hex[7],
+              hex[6] };
+            grid->InsertNextCell(VTK_VOXEL, 8, voxel);
+            break;
+          }
+          case 2:
+          {
+            const vtkIdType wedge1[6] = { hex[0], hex[1], hex[3], hex[4], hex[5], hex[7] };
+            const vtkIdType wedge2[6] = { hex[1], hex[2], hex[3], hex[5], hex[6], hex[7] };
+            grid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+            grid->InsertNextCell(VTK_WEDGE, 6, wedge2);
+            break;
+          }
+          default:
+          {
+            const vtkIdType tetra[4] = { hex[0], hex[1], hex[3], hex[4] };
+            const vtkIdType pyramid[5] = { hex[1], hex[2], hex[6], hex[5], hex[3] };
+            grid->InsertNextCell(VTK_TETRA, 4, tetra);
+            grid->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+            break;
+          }
+        }
+      }
+    }
+  }
+  for (int i = 0; i < Resolution; ++i)
+  {
+    const vtkIdType line[2] = { PointId(i, Resolution, Resolution),
+      PointId(i + 1, Resolution, Resolution) };
+    grid->InsertNextCell(VTK_LINE, 2, line);
+  }
+
+  AddPointData(grid);
+  return grid;
+}
+
+// Polygons of several types, and lines.
+vtkSmartPointer<vtkPolyData> ConstructPolyData()
+{
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  for (int k = 0; k <= Resolution; k += Resolution / 4)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        const vtkIdType quad[4] = { PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k) };
+        if ((i + j) % 3 == 0)
+        {
+          polys->InsertNextCell(3, quad);
+          const vtkIdType triangle[3] = { quad[0], quad[2], quad[3] };
+          polys->InsertNextCell(3, triangle);
+        }
+        else
+        {
+          polys->InsertNextCell(4, quad);
+        }
+      }
+      const vtkIdType line[3] = { PointId(0, j, k), PointId(j, j, k), PointId(j, Resolution, k) };
+      lines->InsertNextCell(3, line);
+    }
+  }
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(ConstructPoints());
+  polyData->SetLines(lines);
+  polyData->SetPolys(polys);
+  AddPointData(polyData);
+  return polyData;
+}
+
+bool SameParallelOutput(vtkPolyDataAlgorithm* filter, const char* name)
+{
+  vtkSmartPointer<vtkDataObject> output1 = vtkTestDataComparison::UpdateWithThreads(filter, 1);
+  vtkSmartPointer<vtkDataObject> output4 = vtkTestDataComparison::UpdateWithThreads(filter, 4);
+  vtkDataSet* dataSet1 = vtkDataSet::SafeDownCast(output1);
+  if (dataSet1->GetNumberOfCells() == 0)
+  {
+    std::cerr << name << ": empty output" << std::endl;
+    return false;
+  }
+  return vtkTestDataComparison::SameDataSets(dataSet1, vtkDataSet::SafeDownCast(output4), name);
+}
+}
+
+int TestContourParallel(int, char*[])
+{
+  vtkSmartPointer<vtkDataSet> inputs[2] = { ConstructGrid(), ConstructPolyData() };
+  for (int input = 0; input < 2; ++input)
+  {
+    for (int mode = 0; mode < 4; ++mode)
+    {
+      vtkNew<vtkContourFilter> contour;
+      contour->SetInputData(inputs[input]);
+      contour->SetValue(0, 50.0);
+      contour->SetValue(1, 200.5);
+      contour->SetValue(2, 400.0);
+      contour->SetGenerateTriangles((mode & 1) != 0);
+      contour->SetComputeScalars((mode & 2) != 0);
+      const std::string name =
+        "Contour of input " + std::to_string(input) + " in mode " + std::to_string(mode);
+      if (!SameParallelOutput(contour, name.c_str()))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+
+    vtkNew<vtkSphere> sphere;
+    sphere->SetRadius(0.0);
+    vtkNew<vtkPlane> plane;
+    plane->SetNormal(1.0, 1.0, 1.0);
+    vtkImplicitFunction* functions[2] = { sphere, plane };
+    for (int function = 0; function < 2; ++function)
+    {
+      vtkNew<vtkCutter> cutter;
+      cutter->SetInputData(inputs[input]);
+      cutter->SetCutFunction(functions[function]);
+      cutter->SetValue(0, function ? 40.0 : 100.0);
+      cutter->SetValue(1, 20.0);
+      cutter->SetGenerateCutScalars(function);
+      const std::string name =
+        "Cut of input " + std::to_string(input) + " by function " + std::to_string(function);
+      if (!SameParallelOutput(cutter, name.c_str()))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
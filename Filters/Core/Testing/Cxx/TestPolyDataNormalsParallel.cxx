@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormalsParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that vtkPolyDataNormals produces the same output whatever the
+// number of threads, on meshes with several connected regions, inconsistent
+// orientations and feature edges.
+
+#include <vtkAppendPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkCubeSource.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTestDataComparison.h>
+#include <vtkTriangleFilter.h>
+
+#include <iostream>
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> ConstructPolyData()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(48);
+  vtkNew<vtkCubeSource> cube;
+  cube->SetCenter(3.0, 0.0, 0.0);
+  vtkNew<vtkCleanPolyData> clean;
+  clean->SetInputConnection(cube->GetOutputPort());
+  vtkNew<vtkTriangleFilter> triangles;
+  triangles->SetInputConnection(clean->GetOutputPort());
+  vtkNew<vtkAppendPolyData> append;
+  append->AddInputConnection(sphere->GetOutputPort());
+  append->AddInputConnection(triangles->GetOutputPort());
+  append->Update();
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(append->GetOutput()->GetPoints());
+
+  // Reverse some of the polygons at random.
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkIdList> ptIds;
+  vtkCellArray* inPolys = append->GetOutput()->GetPolys();
+  for (vtkIdType cellId = 0; cellId < inPolys->GetNumberOfCells(); ++cellId)
+  {
+    inPolys->GetCellAtId(cellId, ptIds);
+    if (random->GetValue() < 0.3)
+    {
+      const vtkIdType npts = ptIds->GetNumberOfIds();
+      for (vtkIdType i = 0; i < npts / 2; ++i)
+      {
+        const vtkIdType tmp = ptIds->GetId(i);
+        ptIds->SetId(i, ptIds->GetId(npts - 1 - i));
+        ptIds->SetId(npts - 1 - i, tmp);
+      }
+    }
+    random->Next();
+    polys->InsertNextCell(ptIds);
+  }
+  polyData->SetPolys(polys);
+  return polyData;
+}
+
+vtkSmartPointer<vtkPolyData> ComputeNormals(vtkPolyData* input, int numThreads, bool autoOrient)
+{
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(input);
+  normals->SetAutoOrientNormals(autoOrient);
+  normals->ComputeCellNormalsOn();
+  return vtkPolyData::SafeDownCast(
+    vtkTestDataComparison::UpdateWithThreads(normals.GetPointer(), numThreads));
+}
+}
+
+int TestPolyDataNormalsParallel(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkSmartPointer<vtkPolyData> input = ConstructPolyData();
+
+  for (int autoOrient = 0; autoOrient < 2; ++autoOrient)
+  {
+    vtkSmartPointer<vtkPolyData> output1 = ComputeNormals(input, 1, autoOrient != 0);
+    vtkSmartPointer<vtkPolyData> output4 = ComputeNormals(input, 4, autoOrient != 0);
+    if (!vtkTestDataComparison::SameDataSets(output1, output4, "Normals"))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // The edges of the cube are feature edges: its 8 corners are split in 3.
+    if (output1->GetNumberOfPoints() != input->GetNumberOfPoints() + 16)
+    {
+      std::cerr << "Expected " << input->GetNumberOfPoints() + 16 << " points, got "
+                << output1->GetNumberOfPoints() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Once consistently ordered and oriented, the normals point outward.
+    if (autoOrient)
+    {
+      vtkDataArray* normals = output1->GetPointData()->GetNormals();
+      for (vtkIdType ptId = 0; ptId < output1->GetNumberOfPoints(); ++ptId)
+      {
+        double x[3], n[3];
+        output1->GetPoint(ptId, x);
+        normals->GetTuple(ptId, n);
+        if (x[0] > 2.0)
+        {
+          x[0] -= 3.0;
+        }
+        if (x[0] * n[0] + x[1] * n[1] + x[2] * n[2] <= 0.0)
+        {
+          std::cerr << "Normal of point " << ptId << " points inward" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the parallel thresholding of unstructured grids and images
+// gives the same output as the serial one, used here for polydata, and does
+// not depend on the number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataComparison.h"
+#include "vtkThreshold.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+vtkSmartPointer<vtkUnstructuredGrid> Threshold(
+  vtkDataSet* input, bool useCellScalars, bool allScalars, bool invert)
+{
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetInputData(input);
+  threshold->ThresholdBetween(0.25, 0.75);
+  threshold->SetAllScalars(allScalars);
+  threshold->SetInvert(invert);
+  if (useCellScalars)
+  {
+    threshold->SetInputArrayToProcess(
+      0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, vtkDataSetAttributes::SCALARS);
+  }
+  threshold->Update();
+  return threshold->GetOutput();
+}
+
+bool SameOutput(vtkUnstructuredGrid* output1, vtkUnstructuredGrid* output2, const char* name)
+{
+  if (output1->GetNumberOfCells() == 0)
+  {
+    std::cerr << name << ": empty output" << std::endl;
+    return false;
+  }
+  return vtkTestDataComparison::SameDataSets(output1, output2, name);
+}
+}
+
+int TestThresholdParallel(int, char*[])
+{
+  // The same cells, as polydata and as an unstructured grid.
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  const vtkIdType numPts = 1000;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3] = { 0.0, 0.0, 0.0 };
+    for (int j = 0; j < 2; ++j)
+    {
+      x[j] = random->GetRangeValue(0, 1);
+      random->Next();
+    }
+    points->InsertNextPoint(x);
+    pointScalars->InsertNextValue(random->GetRangeValue(0, 1));
+    random->Next();
+  }
+
+  vtkNew<vtkCellArray> cells[3];
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->Allocate(3000);
+  const int cellTypes[3] = { VTK_VERTEX, VTK_LINE, VTK_QUAD };
+  const int cellSizes[3] = { 1, 2, 4 };
+  for (int kind = 0; kind < 3; ++kind)
+  {
+    for (vtkIdType c = 0; c < 1000; ++c)
+    {
+      vtkIdType ptIds[4];
+      for (int i = 0; i < cellSizes[kind]; ++i)
+      {
+        ptIds[i] = static_cast<vtkIdType>(random->GetRangeValue(0, numPts));
+        random->Next();
+      }
+      cells[kind]->InsertNextCell(cellSizes[kind], ptIds);
+      grid->InsertNextCell(cellTypes[kind], cellSizes[kind], ptIds);
+    }
+  }
+  vtkNew<vtkDoubleArray> cellScalars;
+  cellScalars->SetName("CellScalars");
+  for (vtkIdType c = 0; c < 3000; ++c)
+  {
+    cellScalars->InsertNextValue(random->GetRangeValue(0, 1));
+    random->Next();
+  }
+
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points);
+  polyData->SetVerts(cells[0]);
+  polyData->SetLines(cells[1]);
+  polyData->SetPolys(cells[2]);
+  polyData->GetPointData()->SetScalars(pointScalars);
+  polyData->GetCellData()->SetScalars(cellScalars);
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(pointScalars);
+  grid->GetCellData()->SetScalars(cellScalars);
+
+  for (int mode = 0; mode < 8; ++mode)
+  {
+    const bool useCellScalars = (mode & 1) != 0;
+    const bool allScalars = (mode & 2) != 0;
+    const bool invert = (mode & 4) != 0;
+    vtkSmartPointer<vtkUnstructuredGrid> serial =
+      Threshold(polyData, useCellScalars, allScalars, invert);
+    vtkSmartPointer<vtkUnstructuredGrid> parallel =
+      Threshold(grid, useCellScalars, allScalars, invert);
+    const std::string name = "Parallel threshold in mode " + std::to_string(mode);
+    if (!SameOutput(serial, parallel, name.c_str()))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  vtkNew<vtkRTAnalyticSource> source;
+  source->Update();
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetInputConnection(source->GetOutputPort());
+  threshold->ThresholdBetween(100, 200);
+  threshold->SetAllScalars(0);
+  vtkSmartPointer<vtkUnstructuredGrid> output1 = vtkUnstructuredGrid::SafeDownCast(
+    vtkTestDataComparison::UpdateWithThreads(threshold.GetPointer(), 1));
+  vtkSmartPointer<vtkUnstructuredGrid> output4 = vtkUnstructuredGrid::SafeDownCast(
+    vtkTestDataComparison::UpdateWithThreads(threshold.GetPointer(), 4));
+  if (!SameOutput(output1, output4, "Threshold of an image"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
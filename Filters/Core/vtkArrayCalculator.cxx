@@ -14,9 +14,11 @@
 =========================================================================*/
 #include "vtkArrayCalculator.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArrayRange.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkFieldData.h"
@@ -29,11 +31,181 @@
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTable.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 vtkStandardNewMacro(vtkArrayCalculator);
 
+namespace
+{
+// The number of tuples evaluated at once by the function parser.
+constexpr vtkIdType BlockSize = 512;
+
+// Copies a component of a range of tuples to every stride-th double.
+struct GatherComponent
+{
+  template <typename ArrayT>
+  void operator()(ArrayT* array, vtkIdType begin, vtkIdType end, int component, int stride,
+    double* values) const
+  {
+    for (const auto tuple : vtk::DataArrayTupleRange(array, begin, end))
+    {
+      *values = static_cast<double>(tuple[component]);
+      values += stride;
+    }
+  }
+};
+
+// Copies the results of a range of tuples to the result array.
+struct ScatterResults
+{
+  template <typename ArrayT>
+  void operator()(ArrayT* array, vtkIdType begin, vtkIdType end, const double* results) const
+  {
+    using ValueType = vtk::GetAPIType<ArrayT>;
+    const int numComps = array->GetNumberOfComponents();
+    for (auto&& value : vtk::DataArrayValueRange(array, begin * numComps, end * numComps))
+    {
+      value = static_cast<ValueType>(*results++);
+    }
+  }
+};
+
+// Evaluates the function on blocks of tuples, whose variables are gathered
+// from their arrays, or from the points of DataSet for coordinates without
+// an array.
+struct ArrayCalculatorWorker
+{
+  struct Input
+  {
+    int Variable;
+    vtkDataArray* Array;
+    int Components[3];
+  };
+
+  vtkFunctionParser* Parser;
+  vtkDataArray* Result;
+  vtkDataSet* DataSet = nullptr;
+  std::vector<Input> ScalarInputs;
+  std::vector<Input> VectorInputs;
+  vtkSMPThreadLocal<std::vector<double>> Values;
+  vtkSMPThreadLocal<std::vector<double>> Stack;
+  std::atomic<vtkIdType> NumberOfInvalidTuples;
+
+  ArrayCalculatorWorker(vtkFunctionParser* parser, vtkDataArray* result)
+    : Parser(parser)
+    , Result(result)
+    , NumberOfInvalidTuples(0)
+  {
+  }
+
+  void AddScalarInput(int variable, vtkDataArray* array, int component)
+  {
+    this->ScalarInputs.push_back(Input{ variable, array, { component, 0, 0 } });
+  }
+
+  void AddVectorInput(int variable, vtkDataArray* array, const int components[3])
+  {
+    this->VectorInputs.push_back(
+      Input{ variable, array, { components[0], components[1], components[2] } });
+  }
+
+  static void Gather(vtkDataArray* array, vtkIdType begin, vtkIdType end, int component,
+    int stride, double* values)
+  {
+    GatherComponent gather;
+    if (!vtkArrayDispatch::Dispatch::Execute(array, gather, begin, end, component, stride, values))
+    {
+      gather(array, begin, end, component, stride, values);
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    // The values of the block: results, points, then the scalar and vector
+    // inputs.
+    const size_t numScalars = this->ScalarInputs.size();
+    const size_t numVectors = this->VectorInputs.size();
+    std::vector<double>& values = this->Values.Local();
+    values.resize((6 + numScalars + 3 * numVectors) * BlockSize);
+    double* results = values.data();
+    double* points = results + 3 * BlockSize;
+    std::vector<const double*> scalars(this->Parser->GetNumberOfScalarVariables(), nullptr);
+    std::vector<const double*> vectors(this->Parser->GetNumberOfVectorVariables(), nullptr);
+    for (size_t i = 0; i < numScalars; i++)
+    {
+      scalars[this->ScalarInputs[i].Variable] = points + (3 + i) * BlockSize;
+    }
+    for (size_t i = 0; i < numVectors; i++)
+    {
+      vectors[this->VectorInputs[i].Variable] = points + (3 + numScalars + 3 * i) * BlockSize;
+    }
+
+    for (vtkIdType first = begin; first < end; first += BlockSize)
+    {
+      const vtkIdType last = std::min(first + BlockSize, end);
+      if (this->DataSet)
+      {
+        for (vtkIdType i = first; i < last; i++)
+        {
+          this->DataSet->GetPoint(i, points + 3 * (i - first));
+        }
+      }
+      for (size_t i = 0; i < numScalars; i++)
+      {
+        const Input& input = this->ScalarInputs[i];
+        double* scalar = points + (3 + i) * BlockSize;
+        if (input.Array)
+        {
+          Gather(input.Array, first, last, input.Components[0], 1, scalar);
+        }
+        else
+        {
+          for (vtkIdType j = 0; j < last - first; j++)
+          {
+            scalar[j] = points[3 * j + input.Components[0]];
+          }
+        }
+      }
+      for (size_t i = 0; i < numVectors; i++)
+      {
+        const Input& input = this->VectorInputs[i];
+        double* vector = points + (3 + numScalars + 3 * i) * BlockSize;
+        for (int c = 0; c < 3; c++)
+        {
+          if (input.Array)
+          {
+            Gather(input.Array, first, last, input.Components[c], 3, vector + c);
+          }
+          else
+          {
+            for (vtkIdType j = 0; j < last - first; j++)
+            {
+              vector[3 * j + c] = points[3 * j + input.Components[c]];
+            }
+          }
+        }
+      }
+
+      this->NumberOfInvalidTuples += this->Parser->EvaluateBlock(
+        last - first, scalars.data(), vectors.data(), results, this->Stack.Local());
+
+      ScatterResults scatter;
+      if (!vtkArrayDispatch::Dispatch::Execute(this->Result, scatter, first, last, results))
+      {
+        scatter(this->Result, first, last, results);
+      }
+    }
+  }
+};
+}
+
 vtkArrayCalculator::vtkArrayCalculator()
 {
   this->FunctionParser = vtkFunctionParser::New();
@@ -399,27 +571,13 @@ int vtkArrayCalculator::ProcessDataObject(vtkDataObject* input, vtkDataObject* o
       vtkArrayDownCast<vtkDataArray>(vtkAbstractArray::CreateArray(this->ResultArrayType)));
   }
 
-  if (resultType == SCALAR_RESULT)
-  {
-    resultArray->SetNumberOfComponents(1);
-    resultArray->SetNumberOfTuples(numTuples);
-    double scalarResult = this->FunctionParser->GetScalarResult();
-    resultArray->SetTuple(0, &scalarResult);
-  }
-  else
-  {
-    resultArray->Allocate(numTuples * 3);
-    resultArray->SetNumberOfComponents(3);
-    resultArray->SetNumberOfTuples(numTuples);
-    resultArray->SetTuple(0, this->FunctionParser->GetVectorResult());
-  }
-
-  // Save array pointers to avoid looking them up for each tuple.
-  std::vector<vtkDataArray*> scalarArrays(this->NumberOfScalarArrays);
-  std::vector<vtkDataArray*> vectorArrays(this->NumberOfVectorArrays);
-  std::vector<int> scalarArrayIndicies(this->NumberOfScalarArrays);
-  std::vector<int> vectorArrayIndicies(this->NumberOfVectorArrays);
+  resultArray->SetNumberOfComponents(resultType == SCALAR_RESULT ? 1 : 3);
+  resultArray->SetNumberOfTuples(numTuples);
 
+  // Collect the arrays and the coordinates of the variables needed by the
+  // function, indexed by the parser. Later variables with the same index
+  // override earlier ones, the coordinates last.
+  ArrayCalculatorWorker worker(this->FunctionParser, resultArray);
   for (int cc = 0; cc < this->NumberOfScalarArrays; cc++)
   {
     int idx = this->FunctionParser->GetScalarVariableIndex(this->ScalarVariableNames[cc]);
@@ -429,8 +587,7 @@ int vtkArrayCalculator::ProcessDataObject(vtkDataObject* input, vtkDataObject* o
       auto array = inFD->GetArray(this->ScalarArrayNames[cc]);
       if (needed && array)
       {
-        scalarArrays[cc] = array;
-        scalarArrayIndicies[cc] = idx;
+        worker.AddScalarInput(idx, array, this->SelectedScalarComponents[cc]);
       }
       else if (needed)
       {
@@ -450,8 +607,7 @@ int vtkArrayCalculator::ProcessDataObject(vtkDataObject* input, vtkDataObject* o
       auto array = inFD->GetArray(this->VectorArrayNames[cc]);
       if (needed && array)
       {
-        vectorArrays[cc] = array;
-        vectorArrayIndicies[cc] = idx;
+        worker.AddVectorInput(idx, array, this->SelectedVectorComponents[cc]);
       }
       else if (needed)
       {
@@ -462,61 +618,72 @@ int vtkArrayCalculator::ProcessDataObject(vtkDataObject* input, vtkDataObject* o
     }
   }
 
-  for (vtkIdType i = 1; i < numTuples; i++)
+  vtkSmartPointer<vtkDoubleArray> graphPoints;
+  if (attributeType == vtkDataObject::POINT || attributeType == vtkDataObject::VERTEX)
   {
-    for (int j = 0; j < this->NumberOfScalarArrays; j++)
+    // The coordinates are read from the points of point sets, copied for
+    // graphs, and read with the thread safe GetPoint() of other datasets,
+    // once it has been called above.
+    vtkPointSet* psInput = vtkPointSet::SafeDownCast(input);
+    vtkDataArray* coordinates = nullptr;
+    if (psInput && psInput->GetPoints())
     {
-      if ((currentArray = scalarArrays[j]))
-      {
-        this->FunctionParser->SetScalarVariableValue(
-          scalarArrayIndicies[j], currentArray->GetComponent(i, this->SelectedScalarComponents[j]));
-      }
+      coordinates = psInput->GetPoints()->GetData();
     }
-    for (int j = 0; j < this->NumberOfVectorArrays; j++)
+    else if (graphInput &&
+      (this->NumberOfCoordinateScalarArrays > 0 || this->NumberOfCoordinateVectorArrays > 0))
     {
-      if ((currentArray = vectorArrays[j]))
+      graphPoints = vtkSmartPointer<vtkDoubleArray>::New();
+      graphPoints->SetNumberOfComponents(3);
+      graphPoints->SetNumberOfTuples(numTuples);
+      for (vtkIdType i = 0; i < numTuples; i++)
       {
-        this->FunctionParser->SetVectorVariableValue(vectorArrayIndicies[j],
-          currentArray->GetComponent(i, this->SelectedVectorComponents[j][0]),
-          currentArray->GetComponent(i, this->SelectedVectorComponents[j][1]),
-          currentArray->GetComponent(i, this->SelectedVectorComponents[j][2]));
+        graphPoints->SetTypedTuple(i, graphInput->GetPoint(i));
       }
+      coordinates = graphPoints;
     }
-    if (attributeType == vtkDataObject::POINT || attributeType == vtkDataObject::VERTEX)
+
+    bool needed = false;
+    for (int j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
     {
-      double* pt = nullptr;
-      if (dsInput)
-      {
-        pt = dsInput->GetPoint(i);
-      }
-      else
-      {
-        pt = graphInput->GetPoint(i);
-      }
-      for (int j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
-      {
-        this->FunctionParser->SetScalarVariableValue(
-          j + this->NumberOfScalarArrays, pt[this->SelectedCoordinateScalarComponents[j]]);
-      }
-      for (int j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
+      const char* name = this->CoordinateScalarVariableNames[j];
+      int idx = this->FunctionParser->GetScalarVariableIndex(name);
+      if (idx >= 0 && this->FunctionParser->GetScalarVariableNeeded(idx))
       {
-        this->FunctionParser->SetVectorVariableValue(j + this->NumberOfVectorArrays,
-          pt[this->SelectedCoordinateVectorComponents[j][0]],
-          pt[this->SelectedCoordinateVectorComponents[j][1]],
-          pt[this->SelectedCoordinateVectorComponents[j][2]]);
+        worker.AddScalarInput(idx, coordinates, this->SelectedCoordinateScalarComponents[j]);
+        needed = true;
       }
     }
-    if (resultType == SCALAR_RESULT)
+    for (int j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
     {
-      double scalarResult = this->FunctionParser->GetScalarResult();
-      resultArray->SetTuple(i, &scalarResult);
+      const char* name = this->CoordinateVectorVariableNames[j];
+      int idx = this->FunctionParser->GetVectorVariableIndex(name);
+      if (idx >= 0 && this->FunctionParser->GetVectorVariableNeeded(idx))
+      {
+        worker.AddVectorInput(idx, coordinates, this->SelectedCoordinateVectorComponents[j]);
+        needed = true;
+      }
     }
-    else
+    if (needed && !coordinates)
     {
-      resultArray->SetTuple(i, this->FunctionParser->GetVectorResult());
+      worker.DataSet = dsInput;
     }
   }
 
+  // Bits cannot be written by several threads.
+  if (resultArray->GetDataType() == VTK_BIT)
+  {
+    worker(0, numTuples);
+  }
+  else
+  {
+    vtkSMPTools::For(0, numTuples, worker);
+  }
+  if (worker.NumberOfInvalidTuples > 0)
+  {
+    vtkErrorMacro("Invalid operations, such as divisions by zero, for "
+      << worker.NumberOfInvalidTuples << " tuples, whose result is " << VTK_PARSER_ERROR_RESULT);
+  }
   output->ShallowCopy(input);
   if (resultPoints)
   {
@@ -54,6 +54,12 @@
  * tuple-wise (i.e., tuple-by-tuple). The user must specify which arrays to use as
  * vectors and/or scalars, and the name of the output data array.
  *
+ * The function is evaluated on blocks of tuples at once, with
+ * vtkFunctionParser::EvaluateBlock(), and the blocks are processed in
+ * parallel with vtkSMPTools. Invalid operations which are not replaced give
+ * VTK_PARSER_ERROR_RESULT, and a single error is reported for the tuples
+ * concerned.
+ *
  * @sa
  * vtkFunctionParser
  */
@@ -16,17 +16,276 @@
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDataArrayRange.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 vtkStandardNewMacro(vtkCleanPolyData);
 
+namespace
+{ // anonymous
+
+//------------------------------------------------------------------------------
+// Kinds of cells, in the order vtkCleanPolyData processes the cell arrays.
+// A cell may become a cell of a lower kind when some of its points merge.
+enum CellKind
+{
+  VERTS = 0,
+  LINES = 1,
+  POLYS = 2,
+  STRIPS = 3,
+  DROPPED = 4
+};
+
+//------------------------------------------------------------------------------
+// Record the first position at which each point appears in the connectivity
+// of the cell arrays taken one after the other. This is the order in which
+// the serial path inserts the points in the locator.
+struct FirstUseWorker
+{
+  template <typename CellStateT>
+  void operator()(CellStateT& state, vtkIdType connBase, std::atomic<vtkIdType>* firstUse)
+  {
+    const auto conn = vtk::DataArrayValueRange<1>(state.GetConnectivity());
+    vtkSMPTools::For(0, conn.size(), [&](vtkIdType pos, vtkIdType endPos) {
+      for (; pos < endPos; ++pos)
+      {
+        std::atomic<vtkIdType>& first = firstUse[conn[pos]];
+        const vtkIdType use = connBase + pos;
+        vtkIdType current = first.load(std::memory_order_relaxed);
+        while (use < current &&
+          !first.compare_exchange_weak(current, use, std::memory_order_relaxed))
+        {
+        }
+      }
+    });
+  }
+};
+
+//------------------------------------------------------------------------------
+// Each used point is merged into the used point within the tolerance that
+// appears first in the connectivity.
+struct MergeWorker
+{
+  vtkStaticPointLocator* Locator;
+  vtkPoints* Points;
+  double Tolerance;
+  const std::atomic<vtkIdType>* FirstUse;
+  vtkIdType* MergeMap;
+  vtkSMPThreadLocalObject<vtkIdList> Neighbors;
+
+  MergeWorker(vtkStaticPointLocator* locator, vtkPoints* points, double tol,
+    const std::atomic<vtkIdType>* firstUse, vtkIdType* mergeMap)
+    : Locator(locator)
+    , Points(points)
+    , Tolerance(tol)
+    , FirstUse(firstUse)
+    , MergeMap(mergeMap)
+  {
+  }
+
+  void Initialize() {}
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkIdList* neighbors = this->Neighbors.Local();
+    double x[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      vtkIdType first = this->FirstUse[ptId];
+      if (first == VTK_ID_MAX)
+      {
+        this->MergeMap[ptId] = -1; // unused point
+        continue;
+      }
+      this->Points->GetPoint(ptId, x);
+      this->Locator->FindPointsWithinRadius(this->Tolerance, x, neighbors);
+      vtkIdType mergeId = ptId;
+      const vtkIdType numNeighbors = neighbors->GetNumberOfIds();
+      for (vtkIdType i = 0; i < numNeighbors; ++i)
+      {
+        const vtkIdType nei = neighbors->GetId(i);
+        const vtkIdType neiFirst = this->FirstUse[nei];
+        if (neiFirst < first)
+        {
+          first = neiFirst;
+          mergeId = nei;
+        }
+      }
+      this->MergeMap[ptId] = mergeId;
+    }
+  }
+
+  void Reduce() {}
+};
+
+//------------------------------------------------------------------------------
+// Applies the point map to a cell and the same degeneracy rules as the serial
+// path. Returns the kind of the output cell.
+struct CellCleaner
+{
+  const vtkIdType* PointMap;
+  vtkTypeBool ConvertLinesToPoints;
+  vtkTypeBool ConvertPolysToLines;
+  vtkTypeBool ConvertStripsToPolys;
+  vtkIdType MaxCellSize;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Buffer;
+
+  vtkIdType* GetBuffer()
+  {
+    std::vector<vtkIdType>& buffer = this->Buffer.Local();
+    buffer.resize(this->MaxCellSize);
+    return buffer.data();
+  }
+
+  template <typename CellRangeT>
+  int Clean(int inKind, const CellRangeT& cell, vtkIdType* newPts, vtkIdType& numNewPts) const
+  {
+    const vtkIdType npts = static_cast<vtkIdType>(cell.size());
+    numNewPts = 0;
+    for (const auto id : cell)
+    {
+      const vtkIdType ptId = this->PointMap[id];
+      if (inKind == VERTS || numNewPts == 0 || ptId != newPts[numNewPts - 1])
+      {
+        newPts[numNewPts++] = ptId;
+      }
+    }
+
+    switch (inKind)
+    {
+      case VERTS:
+        return numNewPts > 0 ? VERTS : DROPPED;
+      case LINES:
+        if (numNewPts >= 2)
+        {
+          return LINES;
+        }
+        break;
+      case POLYS:
+        if (numNewPts > 2 && newPts[0] == newPts[numNewPts - 1])
+        {
+          numNewPts--;
+        }
+        if (numNewPts > 2)
+        {
+          return POLYS;
+        }
+        break;
+      case STRIPS:
+        if (numNewPts > 1 && newPts[0] == newPts[numNewPts - 1])
+        {
+          numNewPts--;
+        }
+        if (numNewPts > 3)
+        {
+          return STRIPS;
+        }
+        if (numNewPts == 3 && (npts == numNewPts || this->ConvertStripsToPolys))
+        {
+          return POLYS;
+        }
+        break;
+    }
+
+    if (inKind != LINES && numNewPts == 2 && (npts == numNewPts || this->ConvertPolysToLines))
+    {
+      return LINES;
+    }
+    if (numNewPts == 1 && (npts == numNewPts || this->ConvertLinesToPoints))
+    {
+      return VERTS;
+    }
+    return DROPPED;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Compute the kind and size of the output cell of every input cell.
+struct ClassifyWorker
+{
+  template <typename CellStateT>
+  void operator()(CellStateT& state, CellCleaner* cleaner, int inKind, vtkIdType cellBase,
+    unsigned char* kinds, vtkIdType* sizes)
+  {
+    vtkSMPTools::For(0, state.GetNumberOfCells(), [&](vtkIdType cellId, vtkIdType endCellId) {
+      vtkIdType* newPts = cleaner->GetBuffer();
+      vtkIdType numNewPts;
+      for (; cellId < endCellId; ++cellId)
+      {
+        const int kind = cleaner->Clean(inKind, state.GetCellRange(cellId), newPts, numNewPts);
+        kinds[cellBase + cellId] = static_cast<unsigned char>(kind);
+        sizes[cellBase + cellId] = numNewPts;
+      }
+    });
+  }
+};
+
+//------------------------------------------------------------------------------
+// Where the input cells that produce cells of one output kind are written.
+// The cell ids and connectivity offsets are indexed by the input cell id minus
+// RangeBegin, the first input cell that may produce such a cell.
+struct CellOutput
+{
+  int Kind;
+  vtkIdType RangeBegin;
+  const unsigned char* Kinds;
+  const vtkIdType* CellIds;
+  const vtkIdType* ConnOffsets;
+  vtkIdType* Offsets;
+  vtkIdType* Connectivity;
+  vtkIdType* SourceCells; // indexed by the cell id in the output polydata
+  vtkIdType CellIdBase;
+};
+
+struct WriteWorker
+{
+  template <typename CellStateT>
+  void operator()(CellStateT& state, CellCleaner* cleaner, int inKind, vtkIdType cellBase,
+    const CellOutput* output)
+  {
+    vtkSMPTools::For(0, state.GetNumberOfCells(), [&](vtkIdType cellId, vtkIdType endCellId) {
+      vtkIdType* newPts = cleaner->GetBuffer();
+      vtkIdType numNewPts;
+      for (; cellId < endCellId; ++cellId)
+      {
+        const vtkIdType inCellId = cellBase + cellId;
+        if (output->Kinds[inCellId] != output->Kind)
+        {
+          continue;
+        }
+        cleaner->Clean(inKind, state.GetCellRange(cellId), newPts, numNewPts);
+        const vtkIdType idx = inCellId - output->RangeBegin;
+        const vtkIdType outCellId = output->CellIds[idx];
+        vtkIdType* conn = output->Connectivity + output->ConnOffsets[idx];
+        std::copy(newPts, newPts + numNewPts, conn);
+        output->Offsets[outCellId] = output->ConnOffsets[idx];
+        output->SourceCells[output->CellIdBase + outCellId] = inCellId;
+      }
+    });
+  }
+};
+
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 // Specify a spatial locator for speeding the search process. By
 // default an instance of vtkPointLocator is used.
@@ -37,6 +296,7 @@ vtkCxxSetObjectMacro(vtkCleanPolyData, Locator, vtkIncrementalPointLocator);
 vtkCleanPolyData::vtkCleanPolyData()
 {
   this->PointMerging = 1;
+  this->ParallelMerging = 0;
   this->ToleranceIsAbsolute = 0;
   this->Tolerance = 0.0;
   this->AbsoluteTolerance = 1.0;
@@ -129,10 +389,6 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
     vtkDebugMacro(<< "No data to Operate On!");
     return 1;
   }
-  vtkIdType* updatedPts = new vtkIdType[input->GetMaxCellSize()];
-
-  vtkIdType numNewPts;
-  vtkIdType numUsedPts = 0;
   vtkPoints* newPts = inPts->NewInstance();
 
   // Set the desired precision for the points in the output.
@@ -149,6 +405,19 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
     newPts->SetDataType(VTK_DOUBLE);
   }
 
+  // Merging in parallel compares the points the same way vtkMergePoints does
+  // only for real coordinates.
+  if (this->PointMerging && this->ParallelMerging &&
+    (newPts->GetDataType() == VTK_FLOAT || newPts->GetDataType() == VTK_DOUBLE))
+  {
+    int retVal = this->ParallelClean(input, newPts, output);
+    newPts->Delete();
+    return retVal;
+  }
+
+  vtkIdType* updatedPts = new vtkIdType[input->GetMaxCellSize()];
+  vtkIdType numNewPts;
+  vtkIdType numUsedPts = 0;
   newPts->Allocate(numPts);
 
   // we'll be needing these
@@ -610,6 +879,248 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//------------------------------------------------------------------------------
+// Threaded version of RequestData() with point merging. The merged points are
+// numbered in the order in which the serial path inserts them in the locator,
+// that is, the order of their first use in the verts, lines, polys and strips.
+// Then the cells are classified and written with the same degeneracy rules.
+int vtkCleanPolyData::ParallelClean(vtkPolyData* input, vtkPoints* newPts, vtkPolyData* output)
+{
+  vtkPoints* inPts = input->GetPoints();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  vtkCellArray* inCells[4] = { input->GetVerts(), input->GetLines(), input->GetPolys(),
+    input->GetStrips() };
+
+  vtkIdType cellBase[5] = { 0, 0, 0, 0, 0 };
+  vtkIdType connBase[5] = { 0, 0, 0, 0, 0 };
+  for (int kind = VERTS; kind <= STRIPS; ++kind)
+  {
+    cellBase[kind + 1] = cellBase[kind] + inCells[kind]->GetNumberOfCells();
+    connBase[kind + 1] = connBase[kind] + inCells[kind]->GetNumberOfConnectivityIds();
+  }
+  const vtkIdType numCells = cellBase[4];
+  const vtkIdType connSize = connBase[4];
+
+  // Find where each point is used first. Unused points keep VTK_ID_MAX.
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUse(new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    for (; ptId < endPtId; ++ptId)
+    {
+      firstUse[ptId].store(VTK_ID_MAX, std::memory_order_relaxed);
+    }
+  });
+  for (int kind = VERTS; kind <= STRIPS; ++kind)
+  {
+    inCells[kind]->Visit(FirstUseWorker{}, connBase[kind], firstUse.get());
+  }
+
+  // Points are compared in the precision of the output, as vtkMergePoints
+  // does, so they are operated on and stored with the output type first.
+  vtkNew<vtkPoints> mappedPts;
+  mappedPts->SetDataType(newPts->GetDataType());
+  mappedPts->SetNumberOfPoints(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    double x[3], newx[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      inPts->GetPoint(ptId, x);
+      this->OperateOnPoint(x, newx);
+      mappedPts->SetPoint(ptId, newx);
+    }
+  });
+
+  vtkNew<vtkPolyData> mappedInput;
+  mappedInput->SetPoints(mappedPts);
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(mappedInput);
+  locator->BuildLocator();
+
+  const double tol =
+    (this->ToleranceIsAbsolute ? this->AbsoluteTolerance : this->Tolerance * input->GetLength());
+  std::vector<vtkIdType> mergeMap(numPts);
+  MergeWorker merge(locator, mappedPts, tol, firstUse.get(), mergeMap.data());
+  vtkSMPTools::For(0, numPts, merge);
+
+  if (tol > 0.0)
+  {
+    // A point may be merged into a point that is itself merged into another
+    // one. Follow the chains until every point is merged into a point merged
+    // into itself.
+    std::vector<vtkIdType> nextMap(numPts);
+    std::atomic<bool> changed(true);
+    while (changed)
+    {
+      changed = false;
+      vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+        bool localChanged = false;
+        for (; ptId < endPtId; ++ptId)
+        {
+          const vtkIdType mergeId = mergeMap[ptId];
+          nextMap[ptId] = (mergeId < 0 ? mergeId : mergeMap[mergeId]);
+          localChanged |= (nextMap[ptId] != mergeId);
+        }
+        if (localChanged)
+        {
+          changed = true;
+        }
+      });
+      mergeMap.swap(nextMap);
+    }
+  }
+  this->UpdateProgress(0.25);
+
+  // Number the points kept in the order of their first use.
+  std::vector<vtkIdType> newIds(connSize + 1, 0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    for (; ptId < endPtId; ++ptId)
+    {
+      if (mergeMap[ptId] == ptId)
+      {
+        newIds[firstUse[ptId]] = 1;
+      }
+    }
+  });
+  vtkSMPTools::ExclusiveScan(newIds.begin(), newIds.end(), newIds.begin(), vtkIdType(0));
+  const vtkIdType numNewPts = newIds[connSize];
+
+  std::vector<vtkIdType> pointMap(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    for (; ptId < endPtId; ++ptId)
+    {
+      const vtkIdType mergeId = mergeMap[ptId];
+      pointMap[ptId] = (mergeId < 0 ? -1 : newIds[firstUse[mergeId]]);
+    }
+  });
+  std::vector<vtkIdType>().swap(newIds);
+  firstUse.reset();
+
+  // The points kept carry the coordinates and the data of their first use.
+  newPts->SetNumberOfPoints(numNewPts);
+  vtkNew<vtkIdList> srcPtIds;
+  vtkNew<vtkIdList> dstPtIds;
+  srcPtIds->SetNumberOfIds(numNewPts);
+  dstPtIds->SetNumberOfIds(numNewPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    double x[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      if (mergeMap[ptId] == ptId)
+      {
+        const vtkIdType newId = pointMap[ptId];
+        mappedPts->GetPoint(ptId, x);
+        newPts->SetPoint(newId, x);
+        srcPtIds->SetId(newId, ptId);
+        dstPtIds->SetId(newId, newId);
+      }
+    }
+  });
+  vtkPointData* outputPD = output->GetPointData();
+  outputPD->CopyAllocate(input->GetPointData(), numNewPts);
+  outputPD->CopyData(input->GetPointData(), srcPtIds, dstPtIds);
+  output->SetPoints(newPts);
+  this->UpdateProgress(0.5);
+
+  vtkDebugMacro(<< "Removed " << numPts - numNewPts << " points");
+
+  // Rewrite the cells. The cells of each output kind are ordered like the
+  // input cells producing them, which belong to the same or a higher kind.
+  CellCleaner cleaner;
+  cleaner.PointMap = pointMap.data();
+  cleaner.ConvertLinesToPoints = this->ConvertLinesToPoints;
+  cleaner.ConvertPolysToLines = this->ConvertPolysToLines;
+  cleaner.ConvertStripsToPolys = this->ConvertStripsToPolys;
+  cleaner.MaxCellSize = input->GetMaxCellSize();
+
+  std::vector<unsigned char> kinds(numCells);
+  std::vector<vtkIdType> sizes(numCells);
+  for (int kind = VERTS; kind <= STRIPS; ++kind)
+  {
+    inCells[kind]->Visit(
+      ClassifyWorker{}, &cleaner, kind, cellBase[kind], kinds.data(), sizes.data());
+  }
+
+  std::vector<vtkIdType> cellIds(numCells + 1);
+  std::vector<vtkIdType> connOffsets(numCells + 1);
+  std::vector<vtkIdType> sourceCells(numCells);
+  vtkIdType numNewCells = 0;
+  for (int outKind = VERTS; outKind <= STRIPS; ++outKind)
+  {
+    const vtkIdType rangeBegin = cellBase[outKind];
+    const vtkIdType rangeSize = numCells - rangeBegin;
+    const unsigned char match = static_cast<unsigned char>(outKind);
+    vtkSMPTools::Transform(kinds.begin() + rangeBegin, kinds.end(), cellIds.begin(),
+      [match](unsigned char kind) -> vtkIdType { return kind == match ? 1 : 0; });
+    vtkSMPTools::Transform(kinds.begin() + rangeBegin, kinds.end(), sizes.begin() + rangeBegin,
+      connOffsets.begin(), [match](unsigned char kind, vtkIdType size) -> vtkIdType {
+        return kind == match ? size : 0;
+      });
+    cellIds[rangeSize] = 0;
+    connOffsets[rangeSize] = 0;
+    vtkSMPTools::ExclusiveScan(
+      cellIds.begin(), cellIds.begin() + rangeSize + 1, cellIds.begin(), vtkIdType(0));
+    vtkSMPTools::ExclusiveScan(
+      connOffsets.begin(), connOffsets.begin() + rangeSize + 1, connOffsets.begin(), vtkIdType(0));
+
+    const vtkIdType numKindCells = cellIds[rangeSize];
+    if (numKindCells == 0 && inCells[outKind]->GetNumberOfCells() == 0)
+    {
+      continue;
+    }
+
+    vtkNew<vtkIdTypeArray> offsets;
+    vtkNew<vtkIdTypeArray> conn;
+    offsets->SetNumberOfValues(numKindCells + 1);
+    offsets->SetValue(numKindCells, connOffsets[rangeSize]);
+    conn->SetNumberOfValues(connOffsets[rangeSize]);
+
+    CellOutput cellOutput = { outKind, rangeBegin, kinds.data(), cellIds.data(),
+      connOffsets.data(), offsets->GetPointer(0), conn->GetPointer(0), sourceCells.data(),
+      numNewCells };
+    for (int inKind = outKind; inKind <= STRIPS; ++inKind)
+    {
+      inCells[inKind]->Visit(WriteWorker{}, &cleaner, inKind, cellBase[inKind], &cellOutput);
+    }
+
+    vtkNew<vtkCellArray> newCells;
+    newCells->SetData(offsets, conn);
+    switch (outKind)
+    {
+      case VERTS:
+        output->SetVerts(newCells);
+        break;
+      case LINES:
+        output->SetLines(newCells);
+        break;
+      case POLYS:
+        output->SetPolys(newCells);
+        break;
+      case STRIPS:
+        output->SetStrips(newCells);
+        break;
+    }
+    numNewCells += numKindCells;
+  }
+  this->UpdateProgress(0.75);
+
+  vtkNew<vtkIdList> srcCellIds;
+  vtkNew<vtkIdList> dstCellIds;
+  srcCellIds->SetNumberOfIds(numNewCells);
+  dstCellIds->SetNumberOfIds(numNewCells);
+  vtkSMPTools::For(0, numNewCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    for (; cellId < endCellId; ++cellId)
+    {
+      srcCellIds->SetId(cellId, sourceCells[cellId]);
+      dstCellIds->SetId(cellId, cellId);
+    }
+  });
+  vtkCellData* outputCD = output->GetCellData();
+  outputCD->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
+  outputCD->CopyAllocate(input->GetCellData(), numNewCells);
+  outputCD->CopyData(input->GetCellData(), srcCellIds, dstCellIds);
+
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 // Method manages creation of locators. It takes into account the potential
 // change of tolerance (zero to non-zero).
@@ -666,6 +1177,7 @@ void vtkCleanPolyData::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "Point Merging: " << (this->PointMerging ? "On\n" : "Off\n");
+  os << indent << "Parallel Merging: " << (this->ParallelMerging ? "On\n" : "Off\n");
   os << indent << "ToleranceIsAbsolute: " << (this->ToleranceIsAbsolute ? "On\n" : "Off\n");
   os << indent << "Tolerance: " << (this->Tolerance ? "On\n" : "Off\n");
   os << indent << "AbsoluteTolerance: " << (this->AbsoluteTolerance ? "On\n" : "Off\n");
@@ -50,6 +50,14 @@
  * will not be used, and points that are not used by any cells will be
  * eliminated, but never merged.
  *
+ * When ParallelMerging is on, the points are merged with vtkSMPTools instead
+ * of being inserted one by one into the locator: the points are binned with a
+ * vtkStaticPointLocator, duplicates are resolved concurrently and the cells
+ * are rewritten in parallel. The output is deterministic, and identical to
+ * the one of the serial path when the tolerance is 0. With a non-zero
+ * tolerance each point is merged into the first used point within the
+ * tolerance, which may group points differently than the serial path.
+ *
  * @warning
  * Merging points can alter topology, including introducing non-manifold
  * forms. The tolerance should be chosen carefully to avoid these problems.
@@ -73,6 +81,7 @@
 #include "vtkPolyDataAlgorithm.h"
 
 class vtkIncrementalPointLocator;
+class vtkPoints;
 
 class VTKFILTERSCORE_EXPORT vtkCleanPolyData : public vtkPolyDataAlgorithm
 {
@@ -148,6 +157,19 @@ public:
   vtkBooleanMacro(PointMerging, vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether point merging is
+   * performed in parallel. When on, the Locator is not used and
+   * OperateOnPoint() may be called concurrently, so subclasses overriding it
+   * must be thread safe. This only applies when the output points are float
+   * or double. By default, parallel merging is off.
+   */
+  vtkSetMacro(ParallelMerging, vtkTypeBool);
+  vtkGetMacro(ParallelMerging, vtkTypeBool);
+  vtkBooleanMacro(ParallelMerging, vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Set/Get a spatial locator for speeding the search process. By
@@ -209,7 +231,11 @@ protected:
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
   int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  // Merges the points with vtkSMPTools when ParallelMerging is on.
+  int ParallelClean(vtkPolyData* input, vtkPoints* newPts, vtkPolyData* output);
+
   vtkTypeBool PointMerging;
+  vtkTypeBool ParallelMerging;
   double Tolerance;
   double AbsoluteTolerance;
   vtkTypeBool ConvertLinesToPoints;
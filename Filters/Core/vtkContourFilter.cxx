@@ -37,6 +37,7 @@
 #include "vtkPolyDataNormals.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkSMPTools.h"
 #include "vtkSpanSpace.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
@@ -540,9 +541,19 @@ int vtkContourFilter::RequestData(
       unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
       vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
       int dimensionality;
+      const bool inParallel = vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+        vtkContourHelper::CanContourInParallel(input, this->Locator);
       // We skip 0d cells (points), because they cannot be cut (generate no data).
-      for (dimensionality = 1; dimensionality <= 3; ++dimensionality)
+      for (dimensionality = 1; dimensionality <= 3 && !abortExecute; ++dimensionality)
       {
+        if (inParallel)
+        {
+          helper.ContourCells(input, dimensionality, inScalars, numContours, values);
+          this->UpdateProgress(dimensionality / 3.0);
+          abortExecute = this->GetAbortExecute();
+          continue;
+        }
+
         // Loop over all cells; get scalar values for all cell points
         // and process each cell.
         //
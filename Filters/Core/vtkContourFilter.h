@@ -34,6 +34,11 @@
  * contours are being extracted. If you want to use a scalar tree,
  * invoke the method UseScalarTreeOn().
  *
+ * When more than one vtkSMPTools thread is available and no scalar tree is
+ * used, the cells of unstructured data are contoured in parallel. The
+ * output is the one of contouring the cells in turn, as long as the locator
+ * merges coincident points only (the default vtkMergePoints).
+ *
  * @warning
  * For unstructured data or structured grids, normals and gradients
  * are not computed. Use vtkPolyDataNormals to compute the surface
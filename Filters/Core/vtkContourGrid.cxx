@@ -35,6 +35,7 @@
 #include "vtkPointLocator.h"
 #include "vtkPolyData.h"
 #include "vtkPolyDataNormals.h"
+#include "vtkSMPTools.h"
 #include "vtkSimpleScalarTree.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -229,9 +230,19 @@ void vtkContourGridExecute(vtkContourGrid* self, vtkDataSet* input, vtkPolyData*
     unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
     vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
     int dimensionality;
+    const bool inParallel = vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+      vtkContourHelper::CanContourInParallel(input, locator);
     // We skip 0d cells (points), because they cannot be cut (generate no data).
-    for (dimensionality = 1; dimensionality <= 3; ++dimensionality)
+    for (dimensionality = 1; dimensionality <= 3 && !abortExecute; ++dimensionality)
     {
+      if (inParallel)
+      {
+        helper.ContourCells(input, dimensionality, inScalars, numContours, values);
+        self->UpdateProgress(dimensionality / 3.0);
+        abortExecute = self->GetAbortExecute();
+        continue;
+      }
+
       // Loop over all cells; get scalar values for all cell points
       // and process each cell.
       //
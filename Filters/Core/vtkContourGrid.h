@@ -34,6 +34,10 @@
  * contours are being extracted. If you want to use a scalar tree,
  * invoke the method UseScalarTreeOn().
  *
+ * When more than one vtkSMPTools thread is available and no scalar tree is
+ * used, the cells are contoured in parallel, with the same output as the
+ * serial one as long as the locator is a vtkMergePoints (the default).
+ *
  * @warning
  * If the input vtkUnstructuredGrid contains 3D linear cells, the class
  * vtkContour3DLinearGrid is much faster and may be preferred in certain
@@ -14,14 +14,239 @@
 =========================================================================*/
 #include "vtkContourHelper.h"
 
+#include "vtkBoundingBox.h"
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkCutter.h"
 #include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkIdListCollection.h"
+#include "vtkImageData.h"
 #include "vtkIncrementalPointLocator.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
 #include "vtkPolygonBuilder.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace
+{
+// Number of cells contoured into the same chunk output by ContourCells().
+// The chunks are split by cell index, not by thread, so their points are
+// merged in the same order however they are scheduled.
+const vtkIdType ContourChunkSize = 1024;
+
+// The output of a chunk of cells.
+struct ContourChunk
+{
+  vtkNew<vtkPoints> Points;
+  vtkNew<vtkCellArray> Verts;
+  vtkNew<vtkCellArray> Lines;
+  vtkNew<vtkCellArray> Polys;
+  vtkNew<vtkPointData> OutPd;
+  vtkNew<vtkCellData> OutCd;
+
+  // When the triangles of 3D cells are merged into polygons, the cell and the
+  // end of the triangles of each contour, merged once their points are.
+  std::vector<vtkIdType> TriangleCellIds;
+  std::vector<vtkIdType> TriangleEnds;
+};
+
+// The chunk outputs are allocated as the output, to copy their arrays in
+// order once merged.
+void CopyAttributeFlags(vtkDataSetAttributes* from, vtkDataSetAttributes* to)
+{
+  for (int attribute = 0; attribute < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attribute)
+  {
+    for (int ctype = vtkDataSetAttributes::COPYTUPLE; ctype < vtkDataSetAttributes::ALLCOPY;
+         ++ctype)
+    {
+      to->SetCopyAttribute(attribute, from->GetCopyAttribute(attribute, ctype), ctype);
+    }
+  }
+}
+
+void ComputeRange(vtkDoubleArray* cellScalars, double range[2])
+{
+  range[0] = std::numeric_limits<double>::max();
+  range[1] = std::numeric_limits<double>::lowest();
+  const vtkIdType numValues = cellScalars->GetNumberOfValues();
+  const double* value = cellScalars->GetPointer(0);
+  for (vtkIdType i = 0; i < numValues; ++i)
+  {
+    range[0] = std::min(range[0], value[i]);
+    range[1] = std::max(range[1], value[i]);
+  }
+}
+
+bool IsAnyInRange(const double range[2], vtkIdType numValues, const double* values)
+{
+  for (vtkIdType i = 0; i < numValues; ++i)
+  {
+    if (values[i] >= range[0] && values[i] <= range[1])
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Contours each chunk of cells into its own output, with its own locator.
+class ContourChunks
+{
+public:
+  ContourChunks(vtkDataSet* input, int dimensionality, vtkDataArray* scalars, vtkIdType numValues,
+    const double* values, int pointsType, vtkPointData* inPd, vtkCellData* inCd,
+    vtkPointData* outPd, vtkCellData* outCd, bool generateTriangles,
+    std::vector<std::unique_ptr<ContourChunk>>& chunks)
+    : Input(input)
+    , Dimensionality(dimensionality)
+    , Scalars(scalars)
+    , NumberOfValues(numValues)
+    , Values(values)
+    , PointsType(pointsType)
+    , InPd(inPd)
+    , InCd(inCd)
+    , OutPd(outPd)
+    , OutCd(outCd)
+    , GenerateTriangles(generateTriangles)
+    , Chunks(chunks)
+  {
+    vtkCutter::GetCellTypeDimensions(this->CellTypeDimensions);
+  }
+
+  void operator()(vtkIdType beginChunk, vtkIdType endChunk)
+  {
+    vtkGenericCell* cell = this->Cell.Local();
+    vtkIdList* ptIds = this->PointIds.Local();
+    vtkDoubleArray* cellScalars = this->CellScalars.Local();
+    cellScalars->SetNumberOfComponents(this->Scalars->GetNumberOfComponents());
+    std::vector<vtkIdType>& cellIds = this->CellIds.Local();
+    const vtkIdType numCells = this->Input->GetNumberOfCells();
+    double range[2];
+    double x[3];
+
+    for (vtkIdType chunkId = beginChunk; chunkId < endChunk; ++chunkId)
+    {
+      // Find the cells the contours cross, and the bounds of the chunk output.
+      cellIds.clear();
+      vtkBoundingBox bbox;
+      const vtkIdType endCellId = std::min((chunkId + 1) * ContourChunkSize, numCells);
+      for (vtkIdType cellId = chunkId * ContourChunkSize; cellId < endCellId; ++cellId)
+      {
+        const int cellType = this->Input->GetCellType(cellId);
+        if (cellType >= VTK_NUMBER_OF_CELL_TYPES ||
+          this->CellTypeDimensions[cellType] != this->Dimensionality)
+        {
+          continue;
+        }
+        this->Input->GetCellPoints(cellId, ptIds);
+        cellScalars->SetNumberOfTuples(ptIds->GetNumberOfIds());
+        this->Scalars->GetTuples(ptIds, cellScalars);
+        ComputeRange(cellScalars, range);
+        if (!IsAnyInRange(range, this->NumberOfValues, this->Values))
+        {
+          continue;
+        }
+        cellIds.push_back(cellId);
+        for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+        {
+          this->Input->GetPoint(ptIds->GetId(i), x);
+          bbox.AddPoint(x);
+        }
+      }
+      if (cellIds.empty())
+      {
+        continue;
+      }
+
+      std::unique_ptr<ContourChunk> chunk(new ContourChunk);
+      const vtkIdType estimatedSize = static_cast<vtkIdType>(cellIds.size()) * this->NumberOfValues;
+      chunk->Points->SetDataType(this->PointsType);
+      chunk->Points->Allocate(estimatedSize);
+      vtkNew<vtkMergePoints> locator;
+      double bounds[6];
+      bbox.GetBounds(bounds);
+      locator->InitPointInsertion(chunk->Points, bounds, estimatedSize);
+      CopyAttributeFlags(this->OutPd, chunk->OutPd);
+      chunk->OutPd->InterpolateAllocate(this->InPd, estimatedSize, estimatedSize);
+      CopyAttributeFlags(this->OutCd, chunk->OutCd);
+      chunk->OutCd->CopyAllocate(this->InCd, estimatedSize, estimatedSize);
+
+      // Polygon merging depends on the point ids, so it is done after the
+      // points of the chunk are merged.
+      vtkContourHelper helper(locator, chunk->Verts, chunk->Lines, chunk->Polys, this->InPd,
+        this->InCd, chunk->OutPd, chunk->OutCd, static_cast<int>(estimatedSize), true);
+      for (vtkIdType cellId : cellIds)
+      {
+        this->Input->GetCell(cellId, cell);
+        cellScalars->SetNumberOfTuples(cell->GetNumberOfPoints());
+        this->Scalars->GetTuples(cell->GetPointIds(), cellScalars);
+        ComputeRange(cellScalars, range);
+        const bool mergeTriangles = !this->GenerateTriangles && cell->GetCellDimension() == 3;
+        for (vtkIdType i = 0; i < this->NumberOfValues; ++i)
+        {
+          if (this->Values[i] >= range[0] && this->Values[i] <= range[1])
+          {
+            helper.Contour(cell, this->Values[i], cellScalars, cellId);
+            if (mergeTriangles)
+            {
+              chunk->TriangleCellIds.push_back(cellId);
+              chunk->TriangleEnds.push_back(chunk->Polys->GetNumberOfCells());
+            }
+          }
+        }
+      }
+      this->Chunks[chunkId] = std::move(chunk);
+    }
+  }
+
+private:
+  vtkDataSet* Input;
+  int Dimensionality;
+  vtkDataArray* Scalars;
+  vtkIdType NumberOfValues;
+  const double* Values;
+  int PointsType;
+  vtkPointData* InPd;
+  vtkCellData* InCd;
+  vtkPointData* OutPd;
+  vtkCellData* OutCd;
+  bool GenerateTriangles;
+  std::vector<std::unique_ptr<ContourChunk>>& Chunks;
+  unsigned char CellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+  vtkSMPThreadLocalObject<vtkDoubleArray> CellScalars;
+  vtkSMPThreadLocal<std::vector<vtkIdType>> CellIds;
+};
+
+// Copies the tuple of each array of an attribute to the same array of another.
+void CopyTuples(
+  vtkDataSetAttributes* from, vtkIdType fromId, vtkDataSetAttributes* to, vtkIdType toId)
+{
+  for (int i = 0; i < to->GetNumberOfArrays(); ++i)
+  {
+    to->GetAbstractArray(i)->InsertTuple(toId, fromId, from->GetAbstractArray(i));
+  }
+}
+}
 
 //------------------------------------------------------------------------------
 vtkContourHelper::vtkContourHelper(vtkIncrementalPointLocator* locator, vtkCellArray* verts,
@@ -76,37 +301,152 @@ void vtkContourHelper::Contour(
     this->OutPd, this->InCd, cellId, outCD);
   if (mergeTriangles)
   {
-    this->PolyBuilder.Reset();
+    this->MergeTriangles(cellId);
+  }
+}
 
-    vtkIdType cellSize;
-    const vtkIdType* cellVerts;
-    while (this->Tris->GetNextCell(cellSize, cellVerts))
+//------------------------------------------------------------------------------
+void vtkContourHelper::MergeTriangles(vtkIdType cellId)
+{
+  this->PolyBuilder.Reset();
+
+  vtkIdType cellSize;
+  const vtkIdType* cellVerts;
+  while (this->Tris->GetNextCell(cellSize, cellVerts))
+  {
+    if (cellSize == 3)
     {
-      if (cellSize == 3)
-      {
-        this->PolyBuilder.InsertTriangle(cellVerts);
-      }
-      else // for whatever reason, the cell contouring is already outputting polys
+      this->PolyBuilder.InsertTriangle(cellVerts);
+    }
+    else // for whatever reason, the cell contouring is already outputting polys
+    {
+      vtkIdType outCellId = this->Polys->InsertNextCell(cellSize, cellVerts);
+      this->OutCd->CopyData(this->InCd, cellId,
+        outCellId + this->Verts->GetNumberOfCells() + this->Lines->GetNumberOfCells());
+    }
+  }
+
+  this->PolyBuilder.GetPolygons(this->PolyCollection);
+  int nPolys = this->PolyCollection->GetNumberOfItems();
+  for (int polyId = 0; polyId < nPolys; ++polyId)
+  {
+    vtkIdList* poly = this->PolyCollection->GetItem(polyId);
+    if (poly->GetNumberOfIds() != 0)
+    {
+      vtkIdType outCellId = this->Polys->InsertNextCell(poly);
+      this->OutCd->CopyData(this->InCd, cellId,
+        outCellId + this->Verts->GetNumberOfCells() + this->Lines->GetNumberOfCells());
+    }
+    poly->Delete();
+  }
+  this->PolyCollection->RemoveAllItems();
+}
+
+//------------------------------------------------------------------------------
+void vtkContourHelper::ContourCells(vtkDataSet* input, int dimensionality, vtkDataArray* scalars,
+  vtkIdType numValues, const double* values)
+{
+  const vtkIdType numCells = input->GetNumberOfCells();
+  if (numCells < 1)
+  {
+    return;
+  }
+
+  // Build the cells of the input before using them from several threads.
+  vtkNew<vtkGenericCell> cell;
+  input->GetCell(0, cell);
+
+  vtkPoints* newPts = static_cast<vtkMergePoints*>(this->Locator)->GetPoints();
+  const vtkIdType numChunks = (numCells + ContourChunkSize - 1) / ContourChunkSize;
+  std::vector<std::unique_ptr<ContourChunk>> chunks(numChunks);
+  ContourChunks contourChunks(input, dimensionality, scalars, numValues, values,
+    newPts->GetDataType(), this->InPd, this->InCd, this->OutPd, this->OutCd,
+    this->GenerateTriangles, chunks);
+  vtkSMPTools::For(0, numChunks, 1, contourChunks);
+
+  // Merge the chunk outputs in order, as the serial contour would have
+  // inserted them.
+  std::vector<vtkIdType> pointMap;
+  std::vector<vtkIdType> cellPts;
+  for (const auto& chunk : chunks)
+  {
+    if (!chunk)
+    {
+      continue;
+    }
+
+    const vtkIdType numPts = chunk->Points->GetNumberOfPoints();
+    pointMap.resize(numPts);
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+      double x[3];
+      chunk->Points->GetPoint(ptId, x);
+      if (this->Locator->InsertUniquePoint(x, pointMap[ptId]))
       {
-        vtkIdType outCellId = this->Polys->InsertNextCell(cellSize, cellVerts);
-        this->OutCd->CopyData(this->InCd, cellId,
-          outCellId + this->Verts->GetNumberOfCells() + this->Lines->GetNumberOfCells());
+        CopyTuples(chunk->OutPd, ptId, this->OutPd, pointMap[ptId]);
       }
     }
 
-    this->PolyBuilder.GetPolygons(this->PolyCollection);
-    int nPolys = this->PolyCollection->GetNumberOfItems();
-    for (int polyId = 0; polyId < nPolys; ++polyId)
+    // Cell data is numbered after the verts, then after the verts and lines.
+    vtkCellArray* chunkCells[3] = { chunk->Verts, chunk->Lines, chunk->Polys };
+    vtkCellArray* newCells[3] = { this->Verts, this->Lines, this->Polys };
+    vtkIdType chunkOffset = 0;
+    for (int kind = 0; kind < 3; ++kind)
     {
-      vtkIdList* poly = this->PolyCollection->GetItem(polyId);
-      if (poly->GetNumberOfIds() != 0)
+      const vtkIdType offset = (kind > 0 ? this->Verts->GetNumberOfCells() : 0) +
+        (kind > 1 ? this->Lines->GetNumberOfCells() : 0);
+      const vtkIdType numChunkCells = chunkCells[kind]->GetNumberOfCells();
+      auto mapCell = [&](vtkIdType chunkCellId) {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        chunkCells[kind]->GetCellAtId(chunkCellId, npts, pts);
+        cellPts.resize(npts);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          cellPts[i] = pointMap[pts[i]];
+        }
+        return npts;
+      };
+
+      if (kind == 2 && !chunk->TriangleEnds.empty())
+      {
+        vtkIdType chunkCellId = 0;
+        for (std::size_t group = 0; group < chunk->TriangleEnds.size(); ++group)
+        {
+          for (; chunkCellId < chunk->TriangleEnds[group]; ++chunkCellId)
+          {
+            const vtkIdType npts = mapCell(chunkCellId);
+            this->Tris->InsertNextCell(npts, cellPts.data());
+          }
+          this->MergeTriangles(chunk->TriangleCellIds[group]);
+        }
+        continue;
+      }
+      for (vtkIdType chunkCellId = 0; chunkCellId < numChunkCells; ++chunkCellId)
       {
-        vtkIdType outCellId = this->Polys->InsertNextCell(poly);
-        this->OutCd->CopyData(this->InCd, cellId,
-          outCellId + this->Verts->GetNumberOfCells() + this->Lines->GetNumberOfCells());
+        const vtkIdType npts = mapCell(chunkCellId);
+        const vtkIdType newCellId = newCells[kind]->InsertNextCell(npts, cellPts.data());
+        CopyTuples(chunk->OutCd, chunkOffset + chunkCellId, this->OutCd, offset + newCellId);
       }
-      poly->Delete();
+      chunkOffset += numChunkCells;
     }
-    this->PolyCollection->RemoveAllItems();
   }
 }
+
+//------------------------------------------------------------------------------
+bool vtkContourHelper::CanContourInParallel(
+  vtkDataSet* input, vtkIncrementalPointLocator* locator)
+{
+  if (!vtkMergePoints::SafeDownCast(locator))
+  {
+    return false;
+  }
+  if (vtkPolyData* polyData = vtkPolyData::SafeDownCast(input))
+  {
+    return polyData->GetVerts()->IsStorageShareable() &&
+      polyData->GetLines()->IsStorageShareable() && polyData->GetPolys()->IsStorageShareable() &&
+      polyData->GetStrips()->IsStorageShareable();
+  }
+  return vtkUnstructuredGrid::SafeDownCast(input) || vtkImageData::SafeDownCast(input) ||
+    vtkRectilinearGrid::SafeDownCast(input) || vtkStructuredGrid::SafeDownCast(input);
+}
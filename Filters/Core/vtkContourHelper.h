@@ -20,6 +20,12 @@
  *  produce either triangles and/or polygons based on the outputTriangles parameter
  *  When working with multidimensional dataset, it is needed to process cells
  *  from low to high dimensions.
+ *
+ *  ContourCells() contours all the cells of a given dimension with
+ *  vtkSMPTools. The cells are split in chunks of fixed size, each contoured
+ *  into a separate output whose points are merged in chunk order, so that the
+ *  output is the same as the one of Contour() called on each cell in turn,
+ *  whatever the number of threads.
  * @sa
  * vtkContourGrid vtkCutter vtkContourFilter
  */
@@ -37,6 +43,7 @@ class vtkPointData;
 class vtkCellData;
 class vtkCell;
 class vtkDataArray;
+class vtkDataSet;
 class vtkIdListCollection;
 
 class VTKFILTERSCORE_EXPORT vtkContourHelper
@@ -48,10 +55,31 @@ public:
   ~vtkContourHelper();
   void Contour(vtkCell* cell, double value, vtkDataArray* cellScalars, vtkIdType cellId);
 
+  /**
+   * Contour, with several threads, the cells of the input with the given
+   * dimension, as Contour() would for each of the values within the range of
+   * the cell scalars, in the order of the cells. The other values do not cross
+   * the cell. The scalars are the point scalars of the input.
+   * The locator must be initialized and CanContourInParallel() true.
+   */
+  void ContourCells(vtkDataSet* input, int dimensionality, vtkDataArray* scalars,
+    vtkIdType numValues, const double* values);
+
+  /**
+   * Return whether ContourCells() can be used with the given input and
+   * locator: the cells of the input must be safely accessed from several
+   * threads, and the locator must merge coincident points only
+   * (vtkMergePoints) so that the merged output does not depend on the order
+   * of insertion.
+   */
+  static bool CanContourInParallel(vtkDataSet* input, vtkIncrementalPointLocator* locator);
+
 private:
   vtkContourHelper(const vtkContourHelper&) = delete;
   vtkContourHelper& operator=(const vtkContourHelper&) = delete;
 
+  void MergeTriangles(vtkIdType cellId);
+
   vtkIncrementalPointLocator* Locator;
   vtkCellArray* Verts;
   vtkCellArray* Lines;
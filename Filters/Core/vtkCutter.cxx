@@ -41,6 +41,7 @@
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
@@ -637,10 +638,21 @@ void vtkCutter::DataSetCutter(vtkDataSet* input, vtkPolyData* output)
     int dimensionality;
 
     vtkIdType progressInterval = numCells / 20 + 1;
+    const bool inParallel = vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+      vtkContourHelper::CanContourInParallel(input, this->Locator);
 
     // We skip 0d cells (points), because they cannot be cut (generate no data).
-    for (dimensionality = 1; dimensionality <= 3; ++dimensionality)
+    for (dimensionality = 1; dimensionality <= 3 && !abortExecute; ++dimensionality)
     {
+      if (inParallel)
+      {
+        helper.ContourCells(
+          input, dimensionality, cutScalars, numContours, this->ContourValues->GetValues());
+        this->UpdateProgress(dimensionality / 3.0);
+        abortExecute = this->GetAbortExecute();
+        continue;
+      }
+
       // Loop over all cells; get scalar values for all cell points
       // and process each cell.
       //
@@ -920,10 +932,20 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet* input, vtkPolyData* output)
     vtkIdType numCuts = 3 * numCells;
     vtkIdType progressInterval = numCuts / 20 + 1;
     int cellId = 0;
+    const bool inParallel = vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+      vtkContourHelper::CanContourInParallel(input, this->Locator);
 
     // We skip 0d cells (points), because they cannot be cut (generate no data).
-    for (dimensionality = 1; dimensionality <= 3; ++dimensionality)
+    for (dimensionality = 1; dimensionality <= 3 && !abortExecute; ++dimensionality)
     {
+      if (inParallel)
+      {
+        helper.ContourCells(input, dimensionality, cutScalars, numContours, contourValues);
+        this->UpdateProgress(dimensionality / 3.0);
+        abortExecute = this->GetAbortExecute();
+        continue;
+      }
+
       // Loop over all cells; get scalar values for all cell points
       // and process each cell.
       //
@@ -38,6 +38,10 @@
  * By default, if an implicit function is set it is used to clip the data
  * set, otherwise the dataset scalars are used to perform the clipping.
  *
+ * When more than one vtkSMPTools thread is available, unstructured data
+ * sorted by value is cut in parallel, with the same output as the serial
+ * one as long as the locator is a vtkMergePoints (the default).
+ *
  * @sa
  * vtkImplicitFunction vtkClipPolyData
  */
@@ -16,8 +16,10 @@
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDataArrayRange.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -27,12 +29,379 @@
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkTriangleStrip.h"
 
-#include "vtkNew.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataNormals);
 
+#define VTK_CELL_NOT_VISITED 0
+#define VTK_CELL_VISITED 1
+
+namespace
+{ // anonymous
+
+// Copy the offsets and connectivity of a cell array into vtkIdType arrays
+// that threads can read and modify directly.
+struct CopyCellsWorker
+{
+  template <typename CellStateT>
+  void operator()(CellStateT& state, vtkIdTypeArray* offsets, vtkIdTypeArray* conn)
+  {
+    using ValueType = typename CellStateT::ValueType;
+    const auto inOffsets = vtk::DataArrayValueRange<1>(state.GetOffsets());
+    const auto inConn = vtk::DataArrayValueRange<1>(state.GetConnectivity());
+    offsets->SetNumberOfValues(inOffsets.size());
+    conn->SetNumberOfValues(inConn.size());
+    auto toId = [](ValueType value) -> vtkIdType { return static_cast<vtkIdType>(value); };
+    vtkSMPTools::Transform(inOffsets.cbegin(), inOffsets.cend(), offsets->GetPointer(0), toId);
+    vtkSMPTools::Transform(inConn.cbegin(), inConn.cend(), conn->GetPointer(0), toId);
+  }
+};
+
+// The polygons of the mesh. OldConn keeps the input ordering and is used for
+// the topological queries, NewConn is reordered and split. The links are
+// sorted by cell id, as vtkPolyData::BuildLinks() does, so that the
+// traversals visit the cells in the same order whatever the number of
+// threads.
+struct PolyMesh
+{
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  vtkNew<vtkIdTypeArray> Offsets;
+  vtkNew<vtkIdTypeArray> OldConn;
+  vtkNew<vtkIdTypeArray> NewConn;
+  vtkNew<vtkStaticCellLinks> Links;
+  std::vector<vtkIdType> LinkOffsets;
+
+  void Build(vtkPolyData* mesh)
+  {
+    this->NumberOfPoints = mesh->GetNumberOfPoints();
+    this->NumberOfCells = mesh->GetPolys()->GetNumberOfCells();
+    mesh->GetPolys()->Visit(
+      CopyCellsWorker{}, this->Offsets.GetPointer(), this->OldConn.GetPointer());
+    this->NewConn->DeepCopy(this->OldConn);
+
+    this->Links->BuildLinks(mesh);
+    this->LinkOffsets.resize(this->NumberOfPoints + 1);
+    vtkSMPTools::For(0, this->NumberOfPoints, [this](vtkIdType ptId, vtkIdType endPtId) {
+      for (; ptId < endPtId; ++ptId)
+      {
+        vtkIdType* cells = this->Links->GetCells(ptId);
+        const vtkIdType ncells = this->Links->GetNcells(ptId);
+        std::sort(cells, cells + ncells);
+        this->LinkOffsets[ptId] = ncells;
+      }
+    });
+    this->LinkOffsets[this->NumberOfPoints] = 0;
+    vtkSMPTools::ExclusiveScan(this->LinkOffsets.begin(), this->LinkOffsets.end(),
+      this->LinkOffsets.begin(), vtkIdType(0));
+  }
+
+  vtkIdType GetCellSize(vtkIdType cellId)
+  {
+    const vtkIdType* offsets = this->Offsets->GetPointer(0);
+    return offsets[cellId + 1] - offsets[cellId];
+  }
+
+  vtkIdType* GetOldCell(vtkIdType cellId)
+  {
+    return this->OldConn->GetPointer(this->Offsets->GetValue(cellId));
+  }
+
+  vtkIdType* GetNewCell(vtkIdType cellId)
+  {
+    return this->NewConn->GetPointer(this->Offsets->GetValue(cellId));
+  }
+
+  // Same as vtkPolyData::GetCellEdgeNeighbors().
+  void GetCellEdgeNeighbors(
+    vtkIdType cellId, vtkIdType p1, vtkIdType p2, std::vector<vtkIdType>& neighbors)
+  {
+    neighbors.clear();
+    const vtkIdType* cells1 = this->Links->GetCells(p1);
+    const vtkIdType* cells1End = cells1 + this->Links->GetNcells(p1);
+    const vtkIdType* cells2 = this->Links->GetCells(p2);
+    const vtkIdType* cells2End = cells2 + this->Links->GetNcells(p2);
+    for (; cells1 != cells1End; ++cells1)
+    {
+      if (*cells1 != cellId && std::binary_search(cells2, cells2End, *cells1))
+      {
+        neighbors.push_back(*cells1);
+      }
+    }
+  }
+};
+
+// Per thread storage of the traversals.
+struct TraversalBuffers
+{
+  std::vector<vtkIdType> Wave;
+  std::vector<vtkIdType> Wave2;
+  std::vector<vtkIdType> Neighbors;
+  std::vector<int> Regions;
+  std::vector<float> Normals;
+};
+
+// Propagate a wave of consistently ordered polygons from the seed cell. Each
+// neighbor may be reordered to maintain consistency with its (already
+// checked) neighbors. Returns the number of polygons reversed.
+int TraverseAndOrder(PolyMesh& mesh, vtkIdType seed, unsigned char* visited,
+  vtkTypeBool nonManifoldTraversal, TraversalBuffers& buffers)
+{
+  std::vector<vtkIdType>& wave = buffers.Wave;
+  std::vector<vtkIdType>& wave2 = buffers.Wave2;
+  std::vector<vtkIdType>& neighbors = buffers.Neighbors;
+  wave.clear();
+  wave2.clear();
+  wave.push_back(seed);
+  int numFlips = 0;
+
+  // propagate wave until nothing left in wave
+  while (!wave.empty())
+  {
+    for (const vtkIdType cellId : wave)
+    {
+      const vtkIdType npts = mesh.GetCellSize(cellId);
+      const vtkIdType* pts = mesh.GetNewCell(cellId);
+
+      for (vtkIdType j = 0, j1 = 1; j < npts; ++j, j1 = (j1 + 1 < npts) ? j1 + 1 : 0)
+      {
+        mesh.GetCellEdgeNeighbors(cellId, pts[j], pts[j1], neighbors);
+
+        //  Check the direction of the neighbor ordering.  Should be
+        //  consistent with us (i.e., if we are n1->n2,
+        // neighbor should be n2->n1).
+        if (neighbors.size() == 1 || nonManifoldTraversal)
+        {
+          for (const vtkIdType neighbor : neighbors)
+          {
+            if (visited[neighbor] == VTK_CELL_NOT_VISITED)
+            {
+              const vtkIdType numNeiPts = mesh.GetCellSize(neighbor);
+              vtkIdType* neiPts = mesh.GetNewCell(neighbor);
+
+              vtkIdType l;
+              for (l = 0; l < numNeiPts; l++)
+              {
+                if (neiPts[l] == pts[j1])
+                {
+                  break;
+                }
+              }
+
+              //  Have to reverse ordering if neighbor not consistent
+              //
+              if (neiPts[(l + 1) % numNeiPts] != pts[j])
+              {
+                numFlips++;
+                std::reverse(neiPts, neiPts + numNeiPts);
+              }
+              visited[neighbor] = VTK_CELL_VISITED;
+              wave2.push_back(neighbor);
+            } // if cell not visited
+          }   // for each edge neighbor
+        }     // for manifold or non-manifold traversal allowed
+      }       // for all edges of this polygon
+    }         // for all cells in wave
+
+    // swap wave and proceed with propagation
+    wave.swap(wave2);
+    wave2.clear();
+  } // while wave still propagating
+
+  return numFlips;
+}
+
+// Lock-free union-find used to gather the polygons the traversal can reach
+// from one another. Each set is rooted at its smallest cell id.
+vtkIdType FindRoot(std::atomic<vtkIdType>* parent, vtkIdType cellId)
+{
+  for (;;)
+  {
+    vtkIdType up = parent[cellId].load();
+    if (up == cellId)
+    {
+      return cellId;
+    }
+    const vtkIdType upUp = parent[up].load();
+    if (upUp != up)
+    {
+      parent[cellId].compare_exchange_weak(up, upUp);
+    }
+    cellId = upUp;
+  }
+}
+
+void Unite(std::atomic<vtkIdType>* parent, vtkIdType cellId1, vtkIdType cellId2)
+{
+  for (;;)
+  {
+    vtkIdType root1 = FindRoot(parent, cellId1);
+    vtkIdType root2 = FindRoot(parent, cellId2);
+    if (root1 == root2)
+    {
+      return;
+    }
+    if (root1 < root2)
+    {
+      std::swap(root1, root2);
+    }
+    if (parent[root1].compare_exchange_strong(root1, root2))
+    {
+      return;
+    }
+  }
+}
+
+// Mark the polygons around a point with the region they belong to, regions
+// being separated by feature edges. Regions are numbered in the order of
+// their smallest cell, region 0 keeps the point and each other region gets
+// a duplicate of it. Returns the number of regions.
+int MarkRegions(PolyMesh& mesh, vtkIdType ptId, const float* polyNormals, double cosAngle,
+  int* regions, std::vector<vtkIdType>& neighbors)
+{
+  // Get the cells using this point and make sure that we have to do something
+  const vtkIdType ncells = mesh.Links->GetNcells(ptId);
+  const vtkIdType* cells = mesh.Links->GetCells(ptId);
+  if (ncells <= 1)
+  {
+    std::fill_n(regions, ncells, 0);
+    return 1; // point does not need to be further disconnected
+  }
+
+  // A cell using the point several times shares the region of its first
+  // entry in the links.
+  auto region = [&](vtkIdType cellId) -> int& {
+    return regions[std::lower_bound(cells, cells + ncells, cellId) - cells];
+  };
+
+  // Start moving around the "cycle" of points using the point. Label
+  // each point as requiring a visit. Then label each subregion of cells
+  // connected to this point that are connected (and not separated by
+  // a feature edge) with a given region number.
+  std::fill_n(regions, ncells, -1);
+
+  // Loop over all cells and mark the region that each is in.
+  //
+  vtkIdType numPts;
+  const vtkIdType* pts;
+  int numRegions = 0;
+  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
+  double thisNormal[3], neiNormal[3];
+  for (vtkIdType j = 0; j < ncells; j++) // for all cells connected to point
+  {
+    if (region(cells[j]) < 0) // for all unvisited cells
+    {
+      region(cells[j]) = numRegions;
+      // okay, mark all the cells connected to this seed cell and using ptId
+      numPts = mesh.GetCellSize(cells[j]);
+      pts = mesh.GetOldCell(cells[j]);
+
+      // find the two edges
+      for (spot = 0; spot < numPts; spot++)
+      {
+        if (pts[spot] == ptId)
+        {
+          break;
+        }
+      }
+
+      if (spot == 0)
+      {
+        neiPt[0] = pts[spot + 1];
+        neiPt[1] = pts[numPts - 1];
+      }
+      else if (spot == (numPts - 1))
+      {
+        neiPt[0] = pts[spot - 1];
+        neiPt[1] = pts[0];
+      }
+      else
+      {
+        neiPt[0] = pts[spot + 1];
+        neiPt[1] = pts[spot - 1];
+      }
+
+      for (int i = 0; i < 2; i++) // for each of the two edges of the seed cell
+      {
+        cellId = cells[j];
+        nei = neiPt[i];
+        while (cellId >= 0) // while we can grow this region
+        {
+          mesh.GetCellEdgeNeighbors(cellId, ptId, nei, neighbors);
+          if (neighbors.size() == 1 && region((neiCellId = neighbors[0])) < 0)
+          {
+            for (int k = 0; k < 3; ++k)
+            {
+              thisNormal[k] = polyNormals[3 * cellId + k];
+              neiNormal[k] = polyNormals[3 * neiCellId + k];
+            }
+
+            if (vtkMath::Dot(thisNormal, neiNormal) > cosAngle)
+            {
+              // visit and arrange to visit next edge neighbor
+              region(neiCellId) = numRegions;
+              cellId = neiCellId;
+              numPts = mesh.GetCellSize(cellId);
+              pts = mesh.GetOldCell(cellId);
+
+              for (spot = 0; spot < numPts; spot++)
+              {
+                if (pts[spot] == ptId)
+                {
+                  break;
+                }
+              }
+
+              if (spot == 0)
+              {
+                nei = (pts[spot + 1] != nei ? pts[spot + 1] : pts[numPts - 1]);
+              }
+              else if (spot == (numPts - 1))
+              {
+                nei = (pts[spot - 1] != nei ? pts[spot - 1] : pts[0]);
+              }
+              else
+              {
+                nei = (pts[spot + 1] != nei ? pts[spot + 1] : pts[spot - 1]);
+              }
+
+            } // if not separated by edge angle
+            else
+            {
+              cellId = -1; // separated by edge angle
+            }
+          } // if can move to edge neighbor
+          else
+          {
+            cellId = -1; // separated by previous visit, boundary, or non-manifold
+          }
+        } // while visit wave is propagating
+      }   // for each of the two edges of the starting cell
+      numRegions++;
+    } // if cell is unvisited
+  }   // for all cells connected to point ptId
+
+  for (vtkIdType j = 1; j < ncells; j++)
+  {
+    if (cells[j] == cells[j - 1])
+    {
+      regions[j] = regions[j - 1];
+    }
+  }
+  return numRegions;
+}
+
+} // anonymous namespace
+
 // Construct with feature angle=30, splitting and consistency turned on,
 // flipNormals turned off, and non-manifold traversal turned on.
 vtkPolyDataNormals::vtkPolyDataNormals()
@@ -48,22 +417,8 @@ vtkPolyDataNormals::vtkPolyDataNormals()
   // some internal data
   this->NumFlips = 0;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
-  this->Wave = nullptr;
-  this->Wave2 = nullptr;
-  this->CellIds = nullptr;
-  this->CellPoints = nullptr;
-  this->NeighborPoints = nullptr;
-  this->Map = nullptr;
-  this->OldMesh = nullptr;
-  this->NewMesh = nullptr;
-  this->Visited = nullptr;
-  this->PolyNormals = nullptr;
-  this->CosAngle = 0.0;
 }
 
-#define VTK_CELL_NOT_VISITED 0
-#define VTK_CELL_VISITED 1
-
 // Generate normals for polygon meshes
 int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
   vtkInformationVector** inputVector, vtkInformationVector* outputVector)
@@ -90,8 +445,7 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
   vtkPointData *pd, *outPD;
   vtkDataSetAttributes* outCD = output->GetCellData();
   double n[3];
-  vtkCellArray* newPolys;
-  vtkIdType ptId, oldId;
+  vtkIdType ptId;
 
   vtkDebugMacro(<< "Generating surface normals");
 
@@ -128,8 +482,8 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
   inPolys = input->GetPolys();
   inStrips = input->GetStrips();
 
-  this->OldMesh = vtkPolyData::New();
-  this->OldMesh->SetPoints(inPts);
+  vtkNew<vtkPolyData> oldMesh;
+  oldMesh->SetPoints(inPts);
   if (numStrips > 0) // have to decompose strips into triangles
   {
     vtkDataSetAttributes* inCD = input->GetCellData();
@@ -166,45 +520,30 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
         outCD->CopyData(inCD, inCellIdx, outCellIdx++);
       }
     }
-    this->OldMesh->SetPolys(polys);
+    oldMesh->SetPolys(polys);
     polys->Delete();
     numPolys = polys->GetNumberOfCells(); // added some new triangles
   }
   else
   {
-    this->OldMesh->SetPolys(inPolys);
-    polys = inPolys;
+    oldMesh->SetPolys(inPolys);
   }
-  this->OldMesh->BuildLinks();
+
+  PolyMesh mesh;
+  mesh.Build(oldMesh);
   this->UpdateProgress(0.10);
 
   pd = input->GetPointData();
   outPD = output->GetPointData();
 
-  this->NewMesh = vtkPolyData::New();
-  this->NewMesh->SetPoints(inPts);
-  // create a copy because we're modifying it
-  newPolys = vtkCellArray::New();
-  newPolys->DeepCopy(polys);
-  this->NewMesh->SetPolys(newPolys);
-  this->NewMesh->BuildCells(); // builds connectivity
+  vtkSMPThreadLocal<TraversalBuffers> buffers;
 
   // The visited array keeps track of which polygons have been visited.
   //
-  if (this->Consistency || this->Splitting || this->AutoOrientNormals)
-  {
-    this->Visited = new int[numPolys];
-    memset(this->Visited, VTK_CELL_NOT_VISITED, numPolys * sizeof(int));
-    this->CellIds = vtkIdList::New();
-    this->CellIds->Allocate(VTK_CELL_SIZE);
-    this->CellPoints = vtkIdList::New();
-    this->CellPoints->Allocate(VTK_CELL_SIZE);
-    this->NeighborPoints = vtkIdList::New();
-    this->NeighborPoints->Allocate(VTK_CELL_SIZE);
-  }
-  else
+  std::vector<unsigned char> visited;
+  if (this->Consistency || this->AutoOrientNormals)
   {
-    this->Visited = nullptr;
+    visited.resize(numPolys, VTK_CELL_NOT_VISITED);
   }
 
   //  Traverse all polygons insuring proper direction of ordering.  This
@@ -229,16 +568,10 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
     vtkIdType leftmostCellID = -1, currentPointID, currentCellID;
     vtkIdType* leftmostCells;
     vtkIdType nleftmostCells;
-    const vtkIdType* cellPts;
-    vtkIdType nCellPts;
-    int cIdx;
+    vtkIdType cIdx;
     double bestNormalAbsXComponent;
     int bestReverseFlag;
     vtkPriorityQueue* leftmostPoints = vtkPriorityQueue::New();
-    this->Wave = vtkIdList::New();
-    this->Wave->Allocate(numPolys / 4 + 1, numPolys);
-    this->Wave2 = vtkIdList::New();
-    this->Wave2->Allocate(numPolys / 4 + 1, numPolys);
 
     // Put all the points in the priority queue, based on x coord
     // So that we can find leftmost point
@@ -262,18 +595,19 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
       do
       {
         currentPointID = leftmostPoints->Pop();
-        this->OldMesh->GetPointCells(currentPointID, nleftmostCells, leftmostCells);
+        nleftmostCells = mesh.Links->GetNcells(currentPointID);
+        leftmostCells = mesh.Links->GetCells(currentPointID);
         bestNormalAbsXComponent = 0.0;
         bestReverseFlag = 0;
         for (cIdx = 0; cIdx < nleftmostCells; cIdx++)
         {
           currentCellID = leftmostCells[cIdx];
-          if (this->Visited[currentCellID] == VTK_CELL_VISITED)
+          if (visited[currentCellID] == VTK_CELL_VISITED)
           {
             continue;
           }
-          this->OldMesh->GetCellPoints(currentCellID, nCellPts, cellPts);
-          vtkPolygon::ComputeNormal(inPts, nCellPts, cellPts, n);
+          vtkPolygon::ComputeNormal(inPts, static_cast<int>(mesh.GetCellSize(currentCellID)),
+            mesh.GetOldCell(currentCellID), n);
           // Ok, see if this leftmost cell candidate is the best
           // so far
           if (fabs(n[0]) > bestNormalAbsXComponent)
@@ -295,18 +629,15 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
         // normals, but if both are true, then we leave it as it is.
         if (bestReverseFlag ^ this->FlipNormals)
         {
-          this->NewMesh->ReverseCell(leftmostCellID);
+          vtkIdType* cellPts = mesh.GetNewCell(leftmostCellID);
+          std::reverse(cellPts, cellPts + mesh.GetCellSize(leftmostCellID));
           this->NumFlips++;
         }
-        this->Wave->InsertNextId(leftmostCellID);
-        this->Visited[leftmostCellID] = VTK_CELL_VISITED;
-        this->TraverseAndOrder();
-        this->Wave->Reset();
-        this->Wave2->Reset();
+        visited[leftmostCellID] = VTK_CELL_VISITED;
+        this->NumFlips += TraverseAndOrder(
+          mesh, leftmostCellID, visited.data(), this->NonManifoldTraversal, buffers.Local());
       } // if found leftmost cell
     }   // Still some points in the queue
-    this->Wave->Delete();
-    this->Wave2->Delete();
     leftmostPoints->Delete();
     vtkDebugMacro(<< "Reversed ordering of " << this->NumFlips << " polygons");
   } // automatically orient normals
@@ -314,30 +645,91 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
   {
     if (this->Consistency)
     {
-      this->Wave = vtkIdList::New();
-      this->Wave->Allocate(numPolys / 4 + 1, numPolys);
-      this->Wave2 = vtkIdList::New();
-      this->Wave2->Allocate(numPolys / 4 + 1, numPolys);
-      for (cellId = 0; cellId < numPolys; cellId++)
+      // Gather the polygons reachable from one another. The traversal of
+      // each group is sequential, but the groups are independent.
+      std::unique_ptr<std::atomic<vtkIdType>[]> parent(new std::atomic<vtkIdType>[numPolys]);
+      vtkSMPTools::For(0, numPolys, [&](vtkIdType cellI, vtkIdType endCellId) {
+        for (; cellI < endCellId; ++cellI)
+        {
+          parent[cellI].store(cellI);
+        }
+      });
+      vtkSMPTools::For(0, numPolys, [&](vtkIdType cellI, vtkIdType endCellId) {
+        std::vector<vtkIdType>& neighbors = buffers.Local().Neighbors;
+        for (; cellI < endCellId; ++cellI)
+        {
+          const vtkIdType numCellPts = mesh.GetCellSize(cellI);
+          const vtkIdType* cellPts = mesh.GetOldCell(cellI);
+          for (vtkIdType j = 0; j < numCellPts; ++j)
+          {
+            mesh.GetCellEdgeNeighbors(
+              cellI, cellPts[j], cellPts[(j + 1) % numCellPts], neighbors);
+            if (neighbors.size() == 1 || this->NonManifoldTraversal)
+            {
+              for (const vtkIdType neighbor : neighbors)
+              {
+                Unite(parent.get(), cellI, neighbor);
+              }
+            }
+          }
+        }
+      });
+
+      // Sort the polygons by group, then by id: the seeds of a group are
+      // then taken in the same order as a sequential traversal would.
+      std::vector<vtkIdType> roots(numPolys);
+      std::vector<vtkIdType> order(numPolys);
+      vtkSMPTools::For(0, numPolys, [&](vtkIdType cellI, vtkIdType endCellId) {
+        for (; cellI < endCellId; ++cellI)
+        {
+          roots[cellI] = FindRoot(parent.get(), cellI);
+          order[cellI] = cellI;
+        }
+      });
+      parent.reset();
+      vtkSMPTools::Sort(order.begin(), order.end(), [&roots](vtkIdType a, vtkIdType b) {
+        return roots[a] < roots[b] || (roots[a] == roots[b] && a < b);
+      });
+      std::vector<vtkIdType> groups;
+      for (vtkIdType i = 0; i < numPolys; ++i)
       {
-        if (this->Visited[cellId] == VTK_CELL_NOT_VISITED)
+        if (i == 0 || roots[order[i]] != roots[order[i - 1]])
         {
-          if (this->FlipNormals)
+          groups.push_back(i);
+        }
+      }
+      const vtkIdType numGroups = static_cast<vtkIdType>(groups.size());
+      groups.push_back(numPolys);
+
+      vtkSMPThreadLocal<int> numFlips(0);
+      vtkSMPTools::For(0, numGroups, [&](vtkIdType group, vtkIdType endGroup) {
+        TraversalBuffers& localBuffers = buffers.Local();
+        int& localFlips = numFlips.Local();
+        for (; group < endGroup; ++group)
+        {
+          for (vtkIdType i = groups[group]; i < groups[group + 1]; ++i)
           {
-            this->NumFlips++;
-            this->NewMesh->ReverseCell(cellId);
+            const vtkIdType seed = order[i];
+            if (visited[seed] == VTK_CELL_NOT_VISITED)
+            {
+              if (this->FlipNormals)
+              {
+                localFlips++;
+                vtkIdType* cellPts = mesh.GetNewCell(seed);
+                std::reverse(cellPts, cellPts + mesh.GetCellSize(seed));
+              }
+              visited[seed] = VTK_CELL_VISITED;
+              localFlips += TraverseAndOrder(
+                mesh, seed, visited.data(), this->NonManifoldTraversal, localBuffers);
+            }
           }
-          this->Wave->InsertNextId(cellId);
-          this->Visited[cellId] = VTK_CELL_VISITED;
-          this->TraverseAndOrder();
         }
-
-        this->Wave->Reset();
-        this->Wave2->Reset();
+      });
+      for (const int flips : numFlips)
+      {
+        this->NumFlips += flips;
       }
 
-      this->Wave->Delete();
-      this->Wave2->Delete();
       vtkDebugMacro(<< "Reversed ordering of " << this->NumFlips << " polygons");
     } // Consistent ordering
   }   // don't automatically orient normals
@@ -346,10 +738,10 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
 
   //  Initial pass to compute polygon normals without effects of neighbors
   //
-  this->PolyNormals = vtkFloatArray::New();
-  this->PolyNormals->SetNumberOfComponents(3);
-  this->PolyNormals->SetName("Normals");
-  this->PolyNormals->SetNumberOfTuples(numVerts + numLines + numPolys);
+  vtkFloatArray* polyNormals = vtkFloatArray::New();
+  polyNormals->SetNumberOfComponents(3);
+  polyNormals->SetName("Normals");
+  polyNormals->SetNumberOfTuples(numVerts + numLines + numPolys);
 
   vtkIdType offsetCells = numVerts + numLines;
   n[0] = 1.0;
@@ -359,22 +751,37 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
   {
     // add a default value for vertices and lines
     // normals do not have meaningful values, we set them to X
-    this->PolyNormals->SetTuple(cellId, n);
+    polyNormals->SetTuple(cellId, n);
   }
 
-  for (cellId = 0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts); cellId++)
+  // The polygons are processed by chunks, between which progress is reported
+  // and abort is checked.
+  const vtkIdType chunkSize = 100000;
+  for (cellId = 0; cellId < numPolys; cellId += chunkSize)
   {
-    if ((cellId % 1000) == 0)
+    this->UpdateProgress(0.333 + 0.167 * cellId / numPolys);
+    if (this->GetAbortExecute())
     {
-      this->UpdateProgress(0.333 + 0.333 * (double)cellId / (double)numPolys);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
+      break;
     }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(offsetCells + cellId, n);
+    vtkSMPTools::For(cellId, std::min(cellId + chunkSize, numPolys),
+      [&](vtkIdType cellI, vtkIdType endCellId) {
+        double normal[3];
+        for (; cellI < endCellId; ++cellI)
+        {
+          vtkPolygon::ComputeNormal(
+            inPts, static_cast<int>(mesh.GetCellSize(cellI)), mesh.GetNewCell(cellI), normal);
+          polyNormals->SetTuple(offsetCells + cellI, normal);
+        }
+      });
   }
+  this->UpdateProgress(0.5);
+
+  // The region of each polygon around each of its points, see MarkRegions().
+  // New points are numbered after the input ones, in the order of the point
+  // they duplicate.
+  std::vector<int> regions;
+  std::vector<vtkIdType> splitOffsets;
 
   // Split mesh if sharp features
   if (this->Splitting)
@@ -383,26 +790,48 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
     //  edges found, split mesh creating new nodes.  Update polygon
     // connectivity.
     //
-    this->CosAngle = cos(vtkMath::RadiansFromDegrees(this->FeatureAngle));
-    //  Splitting will create new points.  We have to create index array
-    // to map new points into old points.
-    //
-    this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (vtkIdType i = 0; i < numPts; i++)
-    {
-      this->Map->SetId(i, i);
-    }
-
-    for (ptId = 0; ptId < numPts; ptId++)
-    {
-      this->MarkAndSplit(ptId);
-    } // for all input points
-
-    numNewPts = this->Map->GetNumberOfIds();
+    const double cosAngle = cos(vtkMath::RadiansFromDegrees(this->FeatureAngle));
+    const float* fPolyNormals = polyNormals->GetPointer(0);
+    regions.resize(mesh.LinkOffsets[numPts]);
+    splitOffsets.resize(numPts + 1);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType ptI, vtkIdType endPtId) {
+      std::vector<vtkIdType>& neighbors = buffers.Local().Neighbors;
+      for (; ptI < endPtId; ++ptI)
+      {
+        const int numRegions = MarkRegions(mesh, ptI, fPolyNormals, cosAngle,
+          regions.data() + mesh.LinkOffsets[ptI], neighbors);
+        splitOffsets[ptI] = numRegions - 1;
+      }
+    });
+    splitOffsets[numPts] = 0;
+    vtkSMPTools::ExclusiveScan(
+      splitOffsets.begin(), splitOffsets.end(), splitOffsets.begin(), vtkIdType(0));
+    numNewPts = numPts + splitOffsets[numPts];
 
     vtkDebugMacro(<< "Created " << numNewPts - numPts << " new points");
 
+    // For all cells not in the first region of a point, the point is
+    // replaced with its duplicate for that region.
+    vtkSMPTools::For(0, numPolys, [&](vtkIdType cellI, vtkIdType endCellId) {
+      for (; cellI < endCellId; ++cellI)
+      {
+        const vtkIdType numCellPts = mesh.GetCellSize(cellI);
+        vtkIdType* cellPts = mesh.GetNewCell(cellI);
+        for (vtkIdType i = 0; i < numCellPts; ++i)
+        {
+          const vtkIdType oldId = cellPts[i];
+          const vtkIdType* cells = mesh.Links->GetCells(oldId);
+          const vtkIdType idx =
+            std::lower_bound(cells, cells + mesh.Links->GetNcells(oldId), cellI) - cells;
+          const int region = regions[mesh.LinkOffsets[oldId] + idx];
+          if (region > 0)
+          {
+            cellPts[i] = numPts + splitOffsets[oldId] + region - 1;
+          }
+        }
+      }
+    });
+
     //  Now need to map attributes of old points into new points.
     //
     outPD->CopyNormalsOff();
@@ -433,13 +862,28 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
     }
 
     newPts->SetNumberOfPoints(numNewPts);
-    for (ptId = 0; ptId < numNewPts; ptId++)
-    {
-      oldId = this->Map->GetId(ptId);
-      newPts->SetPoint(ptId, inPts->GetPoint(oldId));
-      outPD->CopyData(pd, oldId, ptId);
-    }
-    this->Map->Delete();
+    vtkNew<vtkIdList> srcIds;
+    vtkNew<vtkIdList> dstIds;
+    srcIds->SetNumberOfIds(numNewPts);
+    dstIds->SetNumberOfIds(numNewPts);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType ptI, vtkIdType endPtId) {
+      double x[3];
+      for (; ptI < endPtId; ++ptI)
+      {
+        inPts->GetPoint(ptI, x);
+        newPts->SetPoint(ptI, x);
+        srcIds->SetId(ptI, ptI);
+        dstIds->SetId(ptI, ptI);
+        for (vtkIdType newId = numPts + splitOffsets[ptI];
+             newId < numPts + splitOffsets[ptI + 1]; ++newId)
+        {
+          newPts->SetPoint(newId, x);
+          srcIds->SetId(newId, ptI);
+          dstIds->SetId(newId, newId);
+        }
+      }
+    });
+    outPD->CopyData(pd, srcIds, dstIds);
   } // splitting
 
   else // no splitting, so no new points
@@ -449,17 +893,6 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
     outPD->PassData(pd);
   }
 
-  if (this->Consistency || this->Splitting)
-  {
-    delete[] this->Visited;
-    this->CellIds->Delete();
-    this->CellIds = nullptr;
-    this->CellPoints->Delete();
-    this->CellPoints = nullptr;
-    this->NeighborPoints->Delete();
-    this->NeighborPoints = nullptr;
-  }
-
   this->UpdateProgress(0.80);
 
   //  Finally, traverse all elements, computing polygon normals and
@@ -475,35 +908,56 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
   newNormals->SetNumberOfTuples(numNewPts);
   newNormals->SetName("Normals");
   float* fNormals = newNormals->WritePointer(0, 3 * numNewPts);
-  std::fill_n(fNormals, 3 * numNewPts, 0);
 
-  float* fPolyNormals = this->PolyNormals->WritePointer(3 * offsetCells, 3 * numPolys);
+  const float* fPolyNormals = polyNormals->GetPointer(3 * offsetCells);
 
   if (this->ComputePointNormals)
   {
-    for (cellId = 0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts); ++cellId)
-    {
-      for (vtkIdType i = 0; i < npts; ++i)
+    // Each point sums the normals of its polygons in increasing cell order,
+    // separately for each region when the point was split.
+    vtkSMPTools::For(0, numPts, [&](vtkIdType ptI, vtkIdType endPtId) {
+      std::vector<float>& sums = buffers.Local().Normals;
+      for (; ptI < endPtId; ++ptI)
       {
-        fNormals[3 * pts[i]] += fPolyNormals[3 * cellId];
-        fNormals[3 * pts[i] + 1] += fPolyNormals[3 * cellId + 1];
-        fNormals[3 * pts[i] + 2] += fPolyNormals[3 * cellId + 2];
-      }
-    }
+        const vtkIdType ncells = mesh.Links->GetNcells(ptI);
+        const vtkIdType* cells = mesh.Links->GetCells(ptI);
+        const int* cellRegions =
+          regions.empty() ? nullptr : regions.data() + mesh.LinkOffsets[ptI];
+        const vtkIdType numRegions = splitOffsets.empty()
+          ? 1
+          : splitOffsets[ptI + 1] - splitOffsets[ptI] + 1;
+        sums.assign(3 * numRegions, 0.0f);
+        for (vtkIdType i = 0; i < ncells; ++i)
+        {
+          float* sum = sums.data() + 3 * (cellRegions ? cellRegions[i] : 0);
+          sum[0] += fPolyNormals[3 * cells[i]];
+          sum[1] += fPolyNormals[3 * cells[i] + 1];
+          sum[2] += fPolyNormals[3 * cells[i] + 2];
+        }
 
-    for (vtkIdType i = 0; i < numNewPts; ++i)
-    {
-      const double length =
-        sqrt(fNormals[3 * i] * fNormals[3 * i] + fNormals[3 * i + 1] * fNormals[3 * i + 1] +
-          fNormals[3 * i + 2] * fNormals[3 * i + 2]) *
-        flipDirection;
-      if (length != 0.0)
-      {
-        fNormals[3 * i] /= length;
-        fNormals[3 * i + 1] /= length;
-        fNormals[3 * i + 2] /= length;
+        for (vtkIdType r = 0; r < numRegions; ++r)
+        {
+          const vtkIdType id = (r == 0 ? ptI : numPts + splitOffsets[ptI] + r - 1);
+          float* normal = fNormals + 3 * id;
+          const float* sum = sums.data() + 3 * r;
+          const double length =
+            sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]) * flipDirection;
+          normal[0] = sum[0];
+          normal[1] = sum[1];
+          normal[2] = sum[2];
+          if (length != 0.0)
+          {
+            normal[0] /= length;
+            normal[1] /= length;
+            normal[2] /= length;
+          }
+        }
       }
-    }
+    });
+  }
+  else
+  {
+    std::fill_n(fNormals, 3 * numNewPts, 0);
   }
 
   //  Update ourselves.  If no new nodes have been created (i.e., no
@@ -524,9 +978,9 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
 
   if (this->ComputeCellNormals)
   {
-    outCD->SetNormals(this->PolyNormals);
+    outCD->SetNormals(polyNormals);
   }
-  this->PolyNormals->Delete();
+  polyNormals->Delete();
 
   if (this->ComputePointNormals)
   {
@@ -534,245 +988,17 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
   }
   newNormals->Delete();
 
+  vtkNew<vtkCellArray> newPolys;
+  newPolys->SetData(mesh.Offsets, mesh.NewConn);
   output->SetPolys(newPolys);
-  newPolys->Delete();
 
   // copy the original vertices and lines to the output
   output->SetVerts(input->GetVerts());
   output->SetLines(input->GetLines());
 
-  this->OldMesh->Delete();
-  this->NewMesh->Delete();
-
   return 1;
 }
 
-//  Propagate wave of consistently ordered polygons.
-//
-void vtkPolyDataNormals::TraverseAndOrder()
-{
-  vtkIdType i, k;
-  int j, l, j1;
-  vtkIdType numIds, cellId;
-  const vtkIdType* pts;
-  const vtkIdType* neiPts;
-  vtkIdType npts;
-  vtkIdType numNeiPts;
-  vtkIdType neighbor;
-  vtkIdList* tmpWave;
-
-  // propagate wave until nothing left in wave
-  while ((numIds = this->Wave->GetNumberOfIds()) > 0)
-  {
-    for (i = 0; i < numIds; i++)
-    {
-      cellId = this->Wave->GetId(i);
-
-      // Store the results here in a vtkIdList, since passing npts/pts directly
-      // would result in the data getting invalidated by the later call to
-      // NewMesh->GetCellPoints.
-      this->NewMesh->GetCellPoints(cellId, this->CellPoints);
-      npts = this->CellPoints->GetNumberOfIds();
-      pts = this->CellPoints->GetPointer(0);
-
-      for (j = 0, j1 = 1; j < npts; ++j, (j1 = (++j1 < npts) ? j1 : 0)) // for each edge neighbor
-      {
-        this->OldMesh->GetCellEdgeNeighbors(cellId, pts[j], pts[j1], this->CellIds);
-
-        //  Check the direction of the neighbor ordering.  Should be
-        //  consistent with us (i.e., if we are n1->n2,
-        // neighbor should be n2->n1).
-        if (this->CellIds->GetNumberOfIds() == 1 || this->NonManifoldTraversal)
-        {
-          for (k = 0; k < this->CellIds->GetNumberOfIds(); k++)
-          {
-            if (this->Visited[this->CellIds->GetId(k)] == VTK_CELL_NOT_VISITED)
-            {
-              neighbor = this->CellIds->GetId(k);
-              this->NewMesh->GetCellPoints(neighbor, this->NeighborPoints);
-              numNeiPts = this->NeighborPoints->GetNumberOfIds();
-              neiPts = this->NeighborPoints->GetPointer(0);
-
-              for (l = 0; l < numNeiPts; l++)
-              {
-                if (neiPts[l] == pts[j1])
-                {
-                  break;
-                }
-              }
-
-              //  Have to reverse ordering if neighbor not consistent
-              //
-              if (neiPts[(l + 1) % numNeiPts] != pts[j])
-              {
-                this->NumFlips++;
-                this->NewMesh->ReverseCell(neighbor);
-              }
-              this->Visited[neighbor] = VTK_CELL_VISITED;
-              this->Wave2->InsertNextId(neighbor);
-            } // if cell not visited
-          }   // for each edge neighbor
-        }     // for manifold or non-manifold traversal allowed
-      }       // for all edges of this polygon
-    }         // for all cells in wave
-
-    // swap wave and proceed with propagation
-    tmpWave = this->Wave;
-    this->Wave = this->Wave2;
-    this->Wave2 = tmpWave;
-    this->Wave2->Reset();
-  } // while wave still propagating
-}
-
-//
-//  Mark polygons around vertex.  Create new vertex (if necessary) and
-//  replace (i.e., split mesh).
-//
-void vtkPolyDataNormals::MarkAndSplit(vtkIdType ptId)
-{
-  int i, j;
-
-  // Get the cells using this point and make sure that we have to do something
-  vtkIdType ncells;
-  vtkIdType* cells;
-  this->OldMesh->GetPointCells(ptId, ncells, cells);
-  if (ncells <= 1)
-  {
-    return; // point does not need to be further disconnected
-  }
-
-  // Start moving around the "cycle" of points using the point. Label
-  // each point as requiring a visit. Then label each subregion of cells
-  // connected to this point that are connected (and not separated by
-  // a feature edge) with a given region number. For each N regions
-  // created, N-1 duplicate (split) points are created. The split point
-  // replaces the current point ptId in the polygons connectivity array.
-  //
-  // Start by initializing the cells as unvisited
-  for (i = 0; i < ncells; i++)
-  {
-    this->Visited[cells[i]] = -1;
-  }
-
-  // Loop over all cells and mark the region that each is in.
-  //
-  vtkIdType numPts;
-  const vtkIdType* pts;
-  int numRegions = 0;
-  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
-  double thisNormal[3], neiNormal[3];
-  for (j = 0; j < ncells; j++) // for all cells connected to point
-  {
-    if (this->Visited[cells[j]] < 0) // for all unvisited cells
-    {
-      this->Visited[cells[j]] = numRegions;
-      // okay, mark all the cells connected to this seed cell and using ptId
-      this->OldMesh->GetCellPoints(cells[j], numPts, pts);
-
-      // find the two edges
-      for (spot = 0; spot < numPts; spot++)
-      {
-        if (pts[spot] == ptId)
-        {
-          break;
-        }
-      }
-
-      if (spot == 0)
-      {
-        neiPt[0] = pts[spot + 1];
-        neiPt[1] = pts[numPts - 1];
-      }
-      else if (spot == (numPts - 1))
-      {
-        neiPt[0] = pts[spot - 1];
-        neiPt[1] = pts[0];
-      }
-      else
-      {
-        neiPt[0] = pts[spot + 1];
-        neiPt[1] = pts[spot - 1];
-      }
-
-      for (i = 0; i < 2; i++) // for each of the two edges of the seed cell
-      {
-        cellId = cells[j];
-        nei = neiPt[i];
-        while (cellId >= 0) // while we can grow this region
-        {
-          this->OldMesh->GetCellEdgeNeighbors(cellId, ptId, nei, this->CellIds);
-          if (this->CellIds->GetNumberOfIds() == 1 &&
-            this->Visited[(neiCellId = this->CellIds->GetId(0))] < 0)
-          {
-            this->PolyNormals->GetTuple(cellId, thisNormal);
-            this->PolyNormals->GetTuple(neiCellId, neiNormal);
-
-            if (vtkMath::Dot(thisNormal, neiNormal) > CosAngle)
-            {
-              // visit and arrange to visit next edge neighbor
-              this->Visited[neiCellId] = numRegions;
-              cellId = neiCellId;
-              this->OldMesh->GetCellPoints(cellId, numPts, pts);
-
-              for (spot = 0; spot < numPts; spot++)
-              {
-                if (pts[spot] == ptId)
-                {
-                  break;
-                }
-              }
-
-              if (spot == 0)
-              {
-                nei = (pts[spot + 1] != nei ? pts[spot + 1] : pts[numPts - 1]);
-              }
-              else if (spot == (numPts - 1))
-              {
-                nei = (pts[spot - 1] != nei ? pts[spot - 1] : pts[0]);
-              }
-              else
-              {
-                nei = (pts[spot + 1] != nei ? pts[spot + 1] : pts[spot - 1]);
-              }
-
-            } // if not separated by edge angle
-            else
-            {
-              cellId = -1; // separated by edge angle
-            }
-          } // if can move to edge neighbor
-          else
-          {
-            cellId = -1; // separated by previous visit, boundary, or non-manifold
-          }
-        } // while visit wave is propagating
-      }   // for each of the two edges of the starting cell
-      numRegions++;
-    } // if cell is unvisited
-  }   // for all cells connected to point ptId
-
-  if (numRegions <= 1)
-  {
-    return; // a single region, no splitting ever required
-  }
-
-  // Okay, for all cells not in the first region, the ptId is
-  // replaced with a new ptId, which is a duplicate of the first
-  // point, but disconnected topologically.
-  //
-  vtkIdType lastId = this->Map->GetNumberOfIds();
-  vtkIdType replacementPoint;
-  for (j = 0; j < ncells; j++)
-  {
-    if (this->Visited[cells[j]] > 0) // replace point if splitting needed
-    {
-      replacementPoint = lastId + this->Visited[cells[j]] - 1;
-      this->Map->InsertId(replacementPoint, ptId);
-      this->NewMesh->ReplaceCellPoint(cells[j], ptId, replacementPoint);
-    } // if not in first regions and requiring splitting
-  }   // for all cells connected to ptId
-}
-
 void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
@@ -39,6 +39,14 @@
  * are split and new points generated to prevent blurry edges (due to
  * Gouraud shading).
  *
+ * The filter is threaded with vtkSMPTools. Polygon normals, point splitting
+ * and the averaging of normals at points run in parallel. The consistent
+ * reordering of polygons is a traversal that stays sequential within each
+ * connected region of the mesh, but separate regions are processed in
+ * parallel. Point normals sum the polygon normals in increasing cell order
+ * and split points are numbered in the order of the points they duplicate,
+ * so the output is the same as with a single thread.
+ *
  * @warning
  * Normals are computed only for polygons and triangle strips. Normals are
  * not computed for lines or vertices.
@@ -60,8 +68,6 @@
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkPolyDataAlgorithm.h"
 
-class vtkFloatArray;
-class vtkIdList;
 class vtkPolyData;
 
 class VTKFILTERSCORE_EXPORT vtkPolyDataNormals : public vtkPolyDataAlgorithm
@@ -191,28 +197,6 @@ protected:
   int NumFlips;
   int OutputPointsPrecision;
 
-private:
-  vtkIdList* Wave;
-  vtkIdList* Wave2;
-  vtkIdList* CellIds;
-  vtkIdList* CellPoints;
-  vtkIdList* NeighborPoints;
-  vtkIdList* Map;
-  vtkPolyData* OldMesh;
-  vtkPolyData* NewMesh;
-  int* Visited;
-  vtkFloatArray* PolyNormals;
-  double CosAngle;
-
-  // Uses the list of cell ids (this->Wave) to propagate a wave of
-  // checked and properly ordered polygons.
-  void TraverseAndOrder(void);
-
-  // Check the point id give to see whether it lies on a feature
-  // edge. If so, split the point (i.e., duplicate it) to topologically
-  // separate the mesh.
-  void MarkAndSplit(vtkIdType ptId);
-
 private:
   vtkPolyDataNormals(const vtkPolyDataNormals&) = delete;
   void operator=(const vtkPolyDataNormals&) = delete;
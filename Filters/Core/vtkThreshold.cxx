@@ -15,20 +15,46 @@
 #include "vtkThreshold.h"
 
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
+namespace
+{
+//------------------------------------------------------------------------------
+void FillIdentity(vtkIdList* ids, vtkIdType numIds)
+{
+  ids->SetNumberOfIds(numIds);
+  vtkIdType* idsPtr = ids->GetPointer(0);
+  vtkSMPTools::For(0, numIds, [idsPtr](vtkIdType id, vtkIdType endId) {
+    for (; id < endId; ++id)
+    {
+      idsPtr[id] = id;
+    }
+  });
+}
+}
+
 // Construct with lower threshold=0, upper threshold=1, and threshold
 // function=upper AllScalars=1.
 vtkThreshold::vtkThreshold()
@@ -147,12 +173,7 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
   }
 
   outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
   outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
-
-  numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
 
   newPoints = vtkPoints::New();
 
@@ -178,6 +199,27 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
     newPoints->SetDataType(VTK_DOUBLE);
   }
 
+  // are we using pointScalars?
+  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
+  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
+
+  // Unstructured grids without polyhedra and images are thresholded in
+  // parallel, see ThresholdInParallel().
+  vtkUnstructuredGrid* inputGrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if ((inputGrid && !inputGrid->GetFaces()) || vtkImageData::SafeDownCast(input))
+  {
+    this->ThresholdInParallel(input, inScalars, usePointScalars, newPoints, output);
+    output->SetPoints(newPoints);
+    newPoints->Delete();
+    output->Squeeze();
+    return 1;
+  }
+
+  outPD->CopyAllocate(pd);
+  outCD->CopyAllocate(cd);
+
+  numPts = input->GetNumberOfPoints();
+  output->Allocate(input->GetNumberOfCells());
   newPoints->Allocate(numPts);
 
   pointMap = vtkIdList::New(); // maps old point ids into new
@@ -189,10 +231,6 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
 
   newCellPts = vtkIdList::New();
 
-  // are we using pointScalars?
-  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
-  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
-
   // Check that the scalars of each cell satisfy the threshold criterion
   for (cellId = 0; cellId < input->GetNumberOfCells(); cellId++)
   {
@@ -200,41 +238,7 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
     cellPts = cell->GetPointIds();
     numCellPts = cell->GetNumberOfPoints();
 
-    if (usePointScalars)
-    {
-      if (this->AllScalars)
-      {
-        keepCell = 1;
-        for (i = 0; keepCell && (i < numCellPts); i++)
-        {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents(inScalars, ptId);
-        }
-      }
-      else
-      {
-        if (!this->UseContinuousCellRange)
-        {
-          keepCell = 0;
-          for (i = 0; (!keepCell) && (i < numCellPts); i++)
-          {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents(inScalars, ptId);
-          }
-        }
-        else
-        {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
-        }
-      }
-    }
-    else // use cell scalars
-    {
-      keepCell = this->EvaluateComponents(inScalars, cellId);
-    }
-
-    // Invert the keep flag if the Invert option is enabled.
-    keepCell = this->Invert ? (1 - keepCell) : keepCell;
+    keepCell = this->KeepCell(inScalars, usePointScalars, cellId, cellPts, numCellPts);
 
     if (numCellPts > 0 && keepCell)
     {
@@ -278,6 +282,196 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//------------------------------------------------------------------------------
+int vtkThreshold::KeepCell(
+  vtkDataArray* scalars, bool usePointScalars, vtkIdType cellId, vtkIdList* cellPts, int numCellPts)
+{
+  int keepCell;
+  if (usePointScalars)
+  {
+    if (this->AllScalars)
+    {
+      keepCell = 1;
+      for (int i = 0; keepCell && (i < numCellPts); i++)
+      {
+        keepCell = this->EvaluateComponents(scalars, cellPts->GetId(i));
+      }
+    }
+    else
+    {
+      if (!this->UseContinuousCellRange)
+      {
+        keepCell = 0;
+        for (int i = 0; (!keepCell) && (i < numCellPts); i++)
+        {
+          keepCell = this->EvaluateComponents(scalars, cellPts->GetId(i));
+        }
+      }
+      else
+      {
+        keepCell = this->EvaluateCell(scalars, cellPts, numCellPts);
+      }
+    }
+  }
+  else // use cell scalars
+  {
+    keepCell = this->EvaluateComponents(scalars, cellId);
+  }
+
+  // Invert the keep flag if the Invert option is enabled.
+  return this->Invert ? (1 - keepCell) : keepCell;
+}
+
+//------------------------------------------------------------------------------
+void vtkThreshold::ThresholdInParallel(vtkDataSet* input, vtkDataArray* inScalars,
+  bool usePointScalars, vtkPoints* newPoints, vtkUnstructuredGrid* output)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+
+  // The first call of GetCellPoints() is not thread safe.
+  if (numCells > 0)
+  {
+    vtkNew<vtkIdList> firstCellPts;
+    input->GetCellPoints(0, firstCellPts);
+  }
+
+  // First pass: evaluate the cells, and count the cells and the
+  // connectivity entries of the output.
+  std::vector<vtkIdType> cellMap(numCells + 1);
+  std::vector<vtkIdType> connOffsets(numCells + 1);
+  vtkSMPThreadLocalObject<vtkIdList> localCellPts;
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    vtkIdList* cellPts = localCellPts.Local();
+    for (; cellId < endCellId; ++cellId)
+    {
+      input->GetCellPoints(cellId, cellPts);
+      const int numCellPts = static_cast<int>(cellPts->GetNumberOfIds());
+      // Blanked cells of uniform grids are empty.
+      const bool keepCell = numCellPts > 0 && input->GetCellType(cellId) != VTK_EMPTY_CELL &&
+        this->KeepCell(inScalars, usePointScalars, cellId, cellPts, numCellPts);
+      cellMap[cellId] = keepCell ? 1 : 0;
+      connOffsets[cellId] = keepCell ? numCellPts : 0;
+    }
+  });
+  cellMap[numCells] = connOffsets[numCells] = 0;
+  vtkSMPTools::ExclusiveScan(cellMap.begin(), cellMap.end(), cellMap.begin(), vtkIdType(0));
+  vtkSMPTools::ExclusiveScan(
+    connOffsets.begin(), connOffsets.end(), connOffsets.begin(), vtkIdType(0));
+  const vtkIdType numNewCells = cellMap[numCells];
+  const vtkIdType connSize = connOffsets[numCells];
+
+  // Second pass: write the kept cells with their input point ids, and
+  // remember where each point is used first.
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numNewCells + 1);
+  vtkNew<vtkIdTypeArray> conn;
+  conn->SetNumberOfValues(connSize);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numNewCells);
+  vtkNew<vtkIdList> srcCellIds;
+  srcCellIds->SetNumberOfIds(numNewCells);
+  vtkIdType* connPtr = conn->GetPointer(0);
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUse(new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    for (; ptId < endPtId; ++ptId)
+    {
+      firstUse[ptId].store(connSize, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    vtkIdList* cellPts = localCellPts.Local();
+    for (; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType newCellId = cellMap[cellId];
+      if (cellMap[cellId + 1] == newCellId)
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, cellPts);
+      offsets->SetValue(newCellId, connOffsets[cellId]);
+      types->SetValue(newCellId, static_cast<unsigned char>(input->GetCellType(cellId)));
+      srcCellIds->SetId(newCellId, cellId);
+      vtkIdType pos = connOffsets[cellId];
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i, ++pos)
+      {
+        const vtkIdType ptId = cellPts->GetId(i);
+        connPtr[pos] = ptId;
+        std::atomic<vtkIdType>& first = firstUse[ptId];
+        vtkIdType current = first.load(std::memory_order_relaxed);
+        while (pos < current &&
+          !first.compare_exchange_weak(current, pos, std::memory_order_relaxed))
+        {
+        }
+      }
+    }
+  });
+  offsets->SetValue(numNewCells, connSize);
+
+  // Points are numbered in the order of their first use, as the serial
+  // traversal of the cells does.
+  std::vector<vtkIdType> pointMap(connSize + 1);
+  vtkSMPTools::For(0, connSize, [&](vtkIdType pos, vtkIdType endPos) {
+    for (; pos < endPos; ++pos)
+    {
+      pointMap[pos] = (firstUse[connPtr[pos]].load(std::memory_order_relaxed) == pos) ? 1 : 0;
+    }
+  });
+  pointMap[connSize] = 0;
+  vtkSMPTools::ExclusiveScan(pointMap.begin(), pointMap.end(), pointMap.begin(), vtkIdType(0));
+  const vtkIdType numNewPts = pointMap[connSize];
+
+  vtkNew<vtkIdList> srcPtIds;
+  srcPtIds->SetNumberOfIds(numNewPts);
+  vtkSMPTools::For(0, connSize, [&](vtkIdType pos, vtkIdType endPos) {
+    for (; pos < endPos; ++pos)
+    {
+      const vtkIdType ptId = connPtr[pos];
+      const vtkIdType first = firstUse[ptId].load(std::memory_order_relaxed);
+      if (first == pos)
+      {
+        srcPtIds->SetId(pointMap[pos], ptId);
+      }
+    }
+  });
+  vtkSMPTools::For(0, connSize, [&](vtkIdType pos, vtkIdType endPos) {
+    for (; pos < endPos; ++pos)
+    {
+      connPtr[pos] = pointMap[firstUse[connPtr[pos]].load(std::memory_order_relaxed)];
+    }
+  });
+  firstUse.reset();
+
+  newPoints->SetNumberOfPoints(numNewPts);
+  vtkSMPTools::For(0, numNewPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    double x[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      input->GetPoint(srcPtIds->GetId(ptId), x);
+      newPoints->SetPoint(ptId, x);
+    }
+  });
+
+  vtkNew<vtkIdList> dstPtIds;
+  FillIdentity(dstPtIds, numNewPts);
+  vtkPointData* outPD = output->GetPointData();
+  outPD->CopyAllocate(input->GetPointData(), numNewPts);
+  outPD->CopyData(input->GetPointData(), srcPtIds, dstPtIds);
+
+  vtkNew<vtkIdList> dstCellIds;
+  FillIdentity(dstCellIds, numNewCells);
+  vtkCellData* outCD = output->GetCellData();
+  outCD->CopyAllocate(input->GetCellData(), numNewCells);
+  outCD->CopyData(input->GetCellData(), srcCellIds, dstCellIds);
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetData(offsets, conn);
+  output->SetCells(types, cells);
+
+  vtkDebugMacro(<< "Extracted " << numNewCells << " number of cells.");
+}
+
+//------------------------------------------------------------------------------
 int vtkThreshold::EvaluateCell(vtkDataArray* scalars, vtkIdList* cellPts, int numCellPts)
 {
   int c(0);
@@ -30,6 +30,10 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * Unstructured grids without polyhedra and image data are thresholded in
+ * parallel with vtkSMPTools. The output is the same as the one of the serial
+ * algorithm used for the other dataset types, whatever the number of threads.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
  */
@@ -51,6 +55,7 @@
 
 class vtkDataArray;
 class vtkIdList;
+class vtkPoints;
 
 class VTKFILTERSCORE_EXPORT vtkThreshold : public vtkUnstructuredGridAlgorithm
 {
@@ -233,6 +238,20 @@ protected:
   int EvaluateCell(vtkDataArray* scalars, vtkIdList* cellPts, int numCellPts);
   int EvaluateCell(vtkDataArray* scalars, int c, vtkIdList* cellPts, int numCellPts);
 
+  /**
+   * Evaluate the threshold criterion for a cell, including the Invert option.
+   */
+  int KeepCell(vtkDataArray* scalars, bool usePointScalars, vtkIdType cellId, vtkIdList* cellPts,
+    int numCellPts);
+
+  /**
+   * Threshold in parallel: a first pass evaluates the cells, prefix sums
+   * give the location of the output cells, and a second pass writes them.
+   * The input must provide thread safe GetCellPoints() and GetCellType().
+   */
+  void ThresholdInParallel(vtkDataSet* input, vtkDataArray* inScalars, bool usePointScalars,
+    vtkPoints* newPoints, vtkUnstructuredGrid* output);
+
 private:
   vtkThreshold(const vtkThreshold&) = delete;
   void operator=(const vtkThreshold&) = delete;
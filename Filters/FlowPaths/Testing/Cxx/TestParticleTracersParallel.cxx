@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestParticleTracersParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the particles advected in several threads by the particle
+// tracers do not depend on the number of threads, and are the same as the
+// ones advected serially up to the rounding errors of the interpolated point
+// data.
+
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkImageAlgorithm.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkParticlePathFilter.h"
+#include "vtkPointData.h"
+#include "vtkPointSource.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreaklineFilter.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestDataComparison.h"
+
+#include <cmath>
+#include <functional>
+#include <iostream>
+
+namespace
+{
+// A swirling flow on [-1, 1]^3, whose vertical component changes with time.
+class UnsteadySource : public vtkImageAlgorithm
+{
+public:
+  static UnsteadySource* New();
+  vtkTypeMacro(UnsteadySource, vtkImageAlgorithm);
+
+protected:
+  UnsteadySource() { this->SetNumberOfInputPorts(0); }
+  ~UnsteadySource() override = default;
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector) override
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double timeSteps[10];
+    for (int i = 0; i < 10; i++)
+    {
+      timeSteps[i] = i;
+    }
+    double timeRange[2] = { 0.0, 9.0 };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), timeSteps, 10);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), timeRange, 2);
+    int extent[6] = { 0, 20, 0, 20, 0, 20 };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+    outInfo->Set(vtkDataObject::SPACING(), 0.1, 0.1, 0.1);
+    outInfo->Set(vtkDataObject::ORIGIN(), -1.0, -1.0, -1.0);
+    return 1;
+  }
+
+  int RequestData(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector) override
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkImageData* image = vtkImageData::GetData(outInfo);
+    const double time = outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP())
+      ? outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP())
+      : 0.0;
+    image->SetExtent(outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
+    image->SetSpacing(0.1, 0.1, 0.1);
+    image->SetOrigin(-1.0, -1.0, -1.0);
+
+    vtkNew<vtkFloatArray> velocity;
+    velocity->SetName("Velocity");
+    velocity->SetNumberOfComponents(3);
+    velocity->SetNumberOfTuples(image->GetNumberOfPoints());
+    for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ptId++)
+    {
+      double x[3];
+      image->GetPoint(ptId, x);
+      velocity->SetTuple3(
+        ptId, -0.5 * x[1], 0.5 * x[0], 0.15 * std::sin(2.0 * time + 3.0 * x[0]) + 0.02);
+    }
+    image->GetPointData()->SetVectors(velocity);
+    image->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+    return 1;
+  }
+
+private:
+  UnsteadySource(const UnsteadySource&) = delete;
+  void operator=(const UnsteadySource&) = delete;
+};
+
+vtkStandardNewMacro(UnsteadySource);
+
+vtkSmartPointer<vtkPolyData> Advect(vtkParticleTracerBase* tracer, bool threaded, int numThreads)
+{
+  tracer->SetThreadedAdvection(threaded);
+  return vtkPolyData::SafeDownCast(vtkTestDataComparison::UpdateWithThreads(tracer, numThreads));
+}
+
+bool SameOutputs(vtkPolyData* output1, vtkPolyData* output2, double tolerance, const char* name)
+{
+  if (output1->GetNumberOfLines() < 100)
+  {
+    std::cerr << name << ": too few particles " << output1->GetNumberOfLines() << std::endl;
+    return false;
+  }
+  return vtkTestDataComparison::SameDataSets(output1, output2, name, tolerance);
+}
+
+// The tracers keep their particles between updates: each run gets its own.
+bool TestTracer(const std::function<vtkSmartPointer<vtkParticleTracerBase>()>& newTracer,
+  const char* name)
+{
+  vtkSmartPointer<vtkPolyData> serial = Advect(newTracer(), false, 4);
+  vtkSmartPointer<vtkPolyData> threaded1 = Advect(newTracer(), true, 1);
+  vtkSmartPointer<vtkPolyData> threaded4 = Advect(newTracer(), true, 4);
+  return SameOutputs(threaded1, threaded4, 0.0, name) &&
+    SameOutputs(serial, threaded4, 1e-12, name);
+}
+}
+
+int TestParticleTracersParallel(int, char*[])
+{
+  vtkNew<UnsteadySource> source;
+  vtkNew<vtkPointSource> seeds;
+  seeds->SetRadius(0.8);
+  seeds->SetNumberOfPoints(300);
+
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputConnection(source->GetOutputPort());
+
+  for (int staticMesh = 0; staticMesh < 2; staticMesh++)
+  {
+    // Image data, with the cells cached between steps for a static mesh.
+    auto newPathFilter = [&]() {
+      vtkSmartPointer<vtkParticlePathFilter> filter =
+        vtkSmartPointer<vtkParticlePathFilter>::New();
+      filter->SetInputConnection(0, source->GetOutputPort());
+      filter->SetInputConnection(1, seeds->GetOutputPort());
+      filter->SetTerminationTime(6.0);
+      filter->SetStaticMesh(staticMesh);
+      return vtkSmartPointer<vtkParticleTracerBase>(filter);
+    };
+    if (!TestTracer(newPathFilter, staticMesh ? "Static image" : "Image"))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // Tetrahedra, searched with cell locators, and particles injected at
+    // each step.
+    auto newStreakFilter = [&]() {
+      vtkSmartPointer<vtkStreaklineFilter> filter = vtkSmartPointer<vtkStreaklineFilter>::New();
+      filter->SetInputConnection(0, tetrahedralize->GetOutputPort());
+      filter->SetInputConnection(1, seeds->GetOutputPort());
+      filter->SetTerminationTime(4.0);
+      filter->SetForceReinjectionEveryNSteps(1);
+      filter->SetStaticMesh(staticMesh);
+      return vtkSmartPointer<vtkParticleTracerBase>(filter);
+    };
+    if (!TestTracer(newStreakFilter, staticMesh ? "Static tetrahedra" : "Tetrahedra"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
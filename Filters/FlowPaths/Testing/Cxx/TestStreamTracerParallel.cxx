@@ -0,0 +1,153 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStreamTracerParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the streamlines integrated in several threads are the same as
+// the ones integrated serially.
+
+#include "vtkCellData.h"
+#include "vtkCellLocatorInterpolatedVelocityField.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkImageData.h"
+#include "vtkImageGradient.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkStreamTracer.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+
+namespace
+{
+vtkSmartPointer<vtkImageData> MakeImage(int xMin, int xMax)
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(xMin, xMax, -10, 10, -10, 10);
+  vtkNew<vtkImageGradient> gradient;
+  gradient->SetDimensionality(3);
+  gradient->SetInputConnection(source->GetOutputPort());
+  gradient->Update();
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->DeepCopy(gradient->GetOutput());
+  image->GetPointData()->SetActiveVectors("RTDataGradient");
+  return image;
+}
+
+vtkSmartPointer<vtkPolyData> Trace(
+  vtkStreamTracer* tracer, vtkDataObject* input, bool threaded, int numThreads)
+{
+  vtkNew<vtkPlaneSource> seeds;
+  seeds->SetOrigin(-8.0, -8.0, 1.0);
+  seeds->SetPoint1(8.0, -8.0, 1.0);
+  seeds->SetPoint2(-8.0, 8.0, 1.0);
+  seeds->SetResolution(15, 15);
+
+  tracer->SetInputData(input);
+  tracer->SetSourceConnection(seeds->GetOutputPort());
+  tracer->SetMaximumPropagation(10.0);
+  tracer->SetIntegrationDirectionToBoth();
+  tracer->SetThreadedIntegration(threaded);
+  return vtkPolyData::SafeDownCast(vtkTestDataComparison::UpdateWithThreads(tracer, numThreads));
+}
+
+bool SameStreamlines(vtkPolyData* output1, vtkPolyData* output2, const char* name)
+{
+  if (output1->GetNumberOfLines() < 100)
+  {
+    std::cerr << name << ": too few streamlines " << output1->GetNumberOfLines() << std::endl;
+    return false;
+  }
+  return vtkTestDataComparison::SameDataSets(output1, output2, name);
+}
+
+// The locators built with several threads may order the cells differently
+// than the serial ones, and find another cell for a point on a face: the
+// serial and threaded integrations are compared with the same number of
+// threads.
+bool TestInput(vtkStreamTracer* tracer, vtkDataObject* input, const char* name)
+{
+  for (int numThreads : { 4, 1 })
+  {
+    // Threads first, so that they start from an input without cell links or
+    // locators.
+    vtkSmartPointer<vtkPolyData> threaded = Trace(tracer, input, true, numThreads);
+    vtkSmartPointer<vtkPolyData> serial = Trace(tracer, input, false, numThreads);
+    if (!SameStreamlines(serial, threaded, name))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestStreamTracerParallel(int, char*[])
+{
+  vtkSmartPointer<vtkImageData> image = MakeImage(-10, 10);
+
+  // Image data, with the default interpolator.
+  vtkNew<vtkStreamTracer> tracer;
+  tracer->SetIntegratorTypeToRungeKutta4();
+  if (!TestInput(tracer, image, "Image"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Tetrahedra, with a shared cell locator and the adaptive integrator.
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputData(image);
+  tetrahedralize->Update();
+  tetrahedralize->GetOutput()->GetPointData()->SetActiveVectors("RTDataGradient");
+  vtkNew<vtkCellLocatorInterpolatedVelocityField> interpolator;
+  vtkNew<vtkStaticCellLocator> locator;
+  interpolator->SetCellLocatorPrototype(locator);
+  tracer->SetInterpolatorPrototype(interpolator);
+  tracer->SetIntegratorTypeToRungeKutta45();
+  if (!TestInput(tracer, tetrahedralize->GetOutput(), "Tetrahedra"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Tetrahedra, with the default interpolator and its find cell strategy.
+  vtkNew<vtkStreamTracer> tracer2;
+  tracer2->SetIntegratorTypeToRungeKutta2();
+  if (!TestInput(tracer2, tetrahedralize->GetOutput(), "Tetrahedra with point locator"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Two touching images, for which the streamlines only have to be the same
+  // whatever the number of threads.
+  vtkNew<vtkMultiBlockDataSet> blocks;
+  blocks->SetNumberOfBlocks(2);
+  blocks->SetBlock(0, MakeImage(-10, 0));
+  blocks->SetBlock(1, MakeImage(0, 10));
+  vtkNew<vtkStreamTracer> tracer3;
+  vtkSmartPointer<vtkPolyData> threaded1 = Trace(tracer3, blocks, true, 1);
+  vtkSmartPointer<vtkPolyData> threaded4 = Trace(tracer3, blocks, true, 4);
+  if (!SameStreamlines(threaded1, threaded4, "Blocks"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
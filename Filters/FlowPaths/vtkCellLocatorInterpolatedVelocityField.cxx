@@ -221,9 +221,6 @@ void vtkCellLocatorInterpolatedVelocityField::AddDataSet(vtkDataSet* dataset)
     return;
   }
 
-  // insert the dataset (do NOT register the dataset to 'this')
-  this->DataSets->push_back(dataset);
-
   // We need to attach a valid vtkAbstractCellLocator to any vtkPointSet for
   // robust cell location as vtkPointSet::FindCell() may incur failures. For
   // any non-vtkPointSet dataset, either vtkImageData or vtkRectilinearGrid,
@@ -248,6 +245,21 @@ void vtkCellLocatorInterpolatedVelocityField::AddDataSet(vtkDataSet* dataset)
     locator->SetLazyEvaluation(1);
     locator->SetDataSet(dataset);
   }
+  this->AddDataSet(dataset, locator);
+}
+
+//------------------------------------------------------------------------------
+void vtkCellLocatorInterpolatedVelocityField::AddDataSet(
+  vtkDataSet* dataset, vtkAbstractCellLocator* locator)
+{
+  if (!dataset)
+  {
+    vtkErrorMacro(<< "Dataset nullptr!");
+    return;
+  }
+
+  // insert the dataset (do NOT register the dataset to 'this')
+  this->DataSets->push_back(dataset);
   this->CellLocators->push_back(locator);
 
   int size = dataset->GetMaxCellSize();
@@ -259,6 +271,16 @@ void vtkCellLocatorInterpolatedVelocityField::AddDataSet(vtkDataSet* dataset)
   }
 }
 
+//------------------------------------------------------------------------------
+vtkAbstractCellLocator* vtkCellLocatorInterpolatedVelocityField::GetCellLocator(int index)
+{
+  if (index < 0 || index >= static_cast<int>(this->CellLocators->size()))
+  {
+    return nullptr;
+  }
+  return (*this->CellLocators)[index];
+}
+
 //------------------------------------------------------------------------------
 void vtkCellLocatorInterpolatedVelocityField::CopyParameters(
   vtkAbstractInterpolatedVelocityField* from)
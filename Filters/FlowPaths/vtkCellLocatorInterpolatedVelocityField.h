@@ -101,6 +101,24 @@ public:
    */
   void AddDataSet(vtkDataSet* dataset) override;
 
+  /**
+   * Add a dataset with the cell locator to use for it, instead of one
+   * instantiated from the prototype. The locator is not copied: copies of an
+   * interpolator used concurrently may share the locators of the original,
+   * provided that the locators support concurrent queries (see
+   * vtkAbstractCellLocator::IsFindCellThreadSafe()) and are built beforehand.
+   * THIS FUNCTION DOES NOT CHANGE THE REFERENCE COUNT OF dataset FOR THREAD
+   * SAFETY REASONS.
+   */
+  void AddDataSet(vtkDataSet* dataset, vtkAbstractCellLocator* locator);
+
+  /**
+   * Get the cell locator used for the dataset of the given index, in the
+   * order the datasets were added. Image data and rectilinear grids do not
+   * need one, and nullptr is returned for them.
+   */
+  vtkAbstractCellLocator* GetCellLocator(int index);
+
   using Superclass::FunctionValues;
   /**
    * Evaluate the velocity field f at point (x, y, z).
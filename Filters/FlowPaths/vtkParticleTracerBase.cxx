@@ -34,6 +34,8 @@
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTemporalInterpolatedVelocityField.h"
@@ -131,6 +133,7 @@ vtkParticleTracerBase::vtkParticleTracerBase()
   this->RotationScale = 1.0;
   this->MaximumError = 1.0e-6;
   this->TerminalSpeed = vtkParticleTracerBase::Epsilon;
+  this->ThreadedAdvection = false;
   this->IntegrationStep = 0.5;
 
   this->Interpolator = vtkSmartPointer<vtkTemporalInterpolatedVelocityField>::New();
@@ -869,18 +872,22 @@ vtkPolyData* vtkParticleTracerBase::Execute(vtkInformationVector** inputVector)
     {
       vtkDebugMacro(<< "Begin Pass " << pass << " with " << this->ParticleHistories.size()
                     << " Particles");
-      for (ParticleListIterator it = it_first; it != it_last;)
+      if (!this->ThreadedAdvection || from == this->CurrentTimeValue ||
+        !this->IntegrateParticlesInThreads(it_first, it_last, from, this->CurrentTimeValue))
       {
-        // Keep the 'next' iterator handy because if a particle is terminated
-        // or leaves the domain, the 'current' iterator will be deleted.
-        it_next = it;
-        it_next++;
-        this->IntegrateParticle(it, from, this->CurrentTimeValue, integrator);
-        if (this->GetAbortExecute())
+        for (ParticleListIterator it = it_first; it != it_last;)
         {
-          break;
+          // Keep the 'next' iterator handy because if a particle is terminated
+          // or leaves the domain, the 'current' iterator will be deleted.
+          it_next = it;
+          it_next++;
+          this->IntegrateParticle(it, from, this->CurrentTimeValue, integrator);
+          if (this->GetAbortExecute())
+          {
+            break;
+          }
+          it = it_next;
         }
-        it = it_next;
       }
       // Particles might have been deleted during the first pass as they move
       // out of domain or age. Before adding any new particles that are sent
@@ -1066,17 +1073,25 @@ int vtkParticleTracerBase::RequestData(
 //------------------------------------------------------------------------------
 void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double currenttime,
   double targettime, vtkInitialValueProblemSolver* integrator)
+{
+  double velocity[3] = { 0.0, 0.0, 0.0 };
+  ParticleInformation previous = (*it);
+  int status =
+    this->AdvectParticle(*it, currenttime, targettime, integrator, this->Interpolator, velocity);
+  this->FinishParticleAdvection(it, previous, status, velocity);
+}
+
+//------------------------------------------------------------------------------
+int vtkParticleTracerBase::AdvectParticle(ParticleInformation& info, double currenttime,
+  double targettime, vtkInitialValueProblemSolver* integrator,
+  vtkTemporalInterpolatedVelocityField* interpolator, double velocity[3])
 {
   double epsilon = (targettime - currenttime) / 100.0;
-  double velocity[3], point1[4], point2[4] = { 0.0, 0.0, 0.0, 0.0 };
+  double point1[4], point2[4] = { 0.0, 0.0, 0.0, 0.0 };
   double minStep = 0, maxStep = 0;
   double stepWanted, stepTaken = 0.0;
   int substeps = 0;
 
-  ParticleInformation& info = (*it);
-  ParticleInformation previous = (*it);
-  bool particle_good = true;
-
   info.ErrorCode = 0;
 
   // Get the Initial point {x,y,z,t}
@@ -1085,126 +1100,153 @@ void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double c
   if (currenttime == targettime)
   {
     Assert(point1[3] == currenttime);
+    return PARTICLE_UNMOVED;
+  }
+
+  Assert(point1[3] >= (currenttime - epsilon) && point1[3] <= (targettime + epsilon));
+
+  //
+  // begin interpolation between available time values, if the particle has
+  // a cached cell ID and dataset - try to use it,
+  //
+  if (this->AllFixedGeometry)
+  {
+    interpolator->SetCachedCellIds(info.CachedCellId, info.CachedDataSetId);
   }
   else
   {
-    Assert(point1[3] >= (currenttime - epsilon) && point1[3] <= (targettime + epsilon));
+    // The datasets at T0 are those at T1 of the previous step, and the
+    // datasets at T1 often have the same cells: start both searches from
+    // the cell the particle was in at T1.
+    vtkIdType cellIds[2] = { info.CachedCellId[1], info.CachedCellId[1] };
+    int dataSetIds[2] = { info.CachedDataSetId[1], info.CachedDataSetId[1] };
+    interpolator->SetCachedCellIds(cellIds, dataSetIds);
+  }
 
+  double delT = (targettime - currenttime) * this->IntegrationStep;
+  epsilon = delT * 1E-3;
+
+  while (point1[3] < (targettime - epsilon))
+  {
     //
-    // begin interpolation between available time values, if the particle has
-    // a cached cell ID and dataset - try to use it,
+    // Here beginneth the real work
     //
-    if (this->AllFixedGeometry)
-    {
-      this->Interpolator->SetCachedCellIds(info.CachedCellId, info.CachedDataSetId);
-    }
-    else
+    double error = 0;
+
+    // If, with the next step, propagation will be larger than
+    // max, reduce it so that it is (approximately) equal to max.
+    stepWanted = delT;
+    if ((point1[3] + stepWanted) > targettime)
     {
-      this->Interpolator->ClearCache();
+      stepWanted = targettime - point1[3];
+      maxStep = stepWanted;
     }
 
-    double delT = (targettime - currenttime) * this->IntegrationStep;
-    epsilon = delT * 1E-3;
-
-    while (point1[3] < (targettime - epsilon))
+    // Calculate the next step using the integrator provided.
+    // If the next point is out of bounds, send it to another process
+    if (integrator->ComputeNextStep(point1, point2, point1[3], stepWanted, stepTaken, minStep,
+          maxStep, this->MaximumError, error) != 0)
     {
-      //
-      // Here beginneth the real work
-      //
-      double error = 0;
-
-      // If, with the next step, propagation will be larger than
-      // max, reduce it so that it is (approximately) equal to max.
-      stepWanted = delT;
-      if ((point1[3] + stepWanted) > targettime)
+      // if the particle is sent, remove it from the list
+      info.ErrorCode = 1;
+      if (!this->RetryWithPush(info, point1, delT, substeps, interpolator))
       {
-        stepWanted = targettime - point1[3];
-        maxStep = stepWanted;
-      }
-
-      // Calculate the next step using the integrator provided.
-      // If the next point is out of bounds, send it to another process
-      if (integrator->ComputeNextStep(point1, point2, point1[3], stepWanted, stepTaken, minStep,
-            maxStep, this->MaximumError, error) != 0)
-      {
-        // if the particle is sent, remove it from the list
-        info.ErrorCode = 1;
-        if (!this->RetryWithPush(info, point1, delT, substeps))
-        {
-          if (previous.PointId < 0 && previous.TailPointId < 0)
-          {
-            vtkErrorMacro("the particle should have been added");
-          }
-          else
-          {
-            this->SendParticleToAnotherProcess(info, previous, this->ParticlePointData);
-          }
-          this->ParticleHistories.erase(it);
-          particle_good = false;
-          break;
-        }
-        else
-        {
-          // particle was not sent, retry saved it, so copy info back
-          substeps++;
-          memcpy(point1, &info.CurrentPosition, sizeof(Position));
-        }
+        return PARTICLE_LOST;
       }
-      else // success, increment position/time
+      else
       {
+        // particle was not sent, retry saved it, so copy info back
         substeps++;
+        memcpy(point1, &info.CurrentPosition, sizeof(Position));
+      }
+    }
+    else // success, increment position/time
+    {
+      substeps++;
 
-        // increment the particle time
-        point2[3] = point1[3] + stepTaken;
-        info.age += stepTaken;
-        info.SimulationTime += stepTaken;
+      // increment the particle time
+      point2[3] = point1[3] + stepTaken;
+      info.age += stepTaken;
+      info.SimulationTime += stepTaken;
 
-        // Point is valid. Insert it.
-        memcpy(&info.CurrentPosition, point2, sizeof(Position));
-        memcpy(point1, point2, sizeof(Position));
-      }
+      // Point is valid. Insert it.
+      memcpy(&info.CurrentPosition, point2, sizeof(Position));
+      memcpy(point1, point2, sizeof(Position));
+    }
 
-      // If the solver is adaptive and the next time step (delT.Interval)
-      // that the solver wants to use is smaller than minStep or larger
-      // than maxStep, re-adjust it. This has to be done every step
-      // because minStep and maxStep can change depending on the Cell
-      // size (unless it is specified in time units)
-      if (integrator->IsAdaptive())
-      {
-        // code removed. Put it back when this is stable
-      }
+    // If the solver is adaptive and the next time step (delT.Interval)
+    // that the solver wants to use is smaller than minStep or larger
+    // than maxStep, re-adjust it. This has to be done every step
+    // because minStep and maxStep can change depending on the Cell
+    // size (unless it is specified in time units)
+    if (integrator->IsAdaptive())
+    {
+      // code removed. Put it back when this is stable
     }
+  }
 
-    if (particle_good)
+  // The integration succeeded, but check the computed final position
+  // is actually inside the domain (the intermediate steps taken inside
+  // the integrator were ok, but the final step may just pass out)
+  // if it moves out, we can't interpolate scalars, so we must send it away
+#ifdef DEBUGPARTICLETRACE
+  double eps = (this->GetCacheDataTime(1) - this->GetCacheDataTime(0)) / 100;
+  Assert(point1[3] >= (this->GetCacheDataTime(0) - eps) &&
+    point1[3] <= (this->GetCacheDataTime(1) + eps));
+#endif
+  info.LocationState = interpolator->TestPoint(info.CurrentPosition.x);
+  interpolator->GetLastGoodVelocity(velocity);
+  //
+  // store the last Cell Ids and dataset indices for next time particle is updated
+  //
+  interpolator->GetCachedCellIds(info.CachedCellId, info.CachedDataSetId);
+  if (info.LocationState == ID_OUTSIDE_ALL)
+  {
+    info.ErrorCode = 2;
+    return PARTICLE_OUTSIDE;
+  }
+  return PARTICLE_MOVED;
+}
+
+//------------------------------------------------------------------------------
+void vtkParticleTracerBase::FinishParticleAdvection(
+  ParticleListIterator& it, ParticleInformation& previous, int status, double velocity[3])
+{
+  ParticleInformation& info = (*it);
+  bool particle_good = true;
+
+  if (status == PARTICLE_LOST)
+  {
+    if (previous.PointId < 0 && previous.TailPointId < 0)
     {
-      // The integration succeeded, but check the computed final position
-      // is actually inside the domain (the intermediate steps taken inside
-      // the integrator were ok, but the final step may just pass out)
-      // if it moves out, we can't interpolate scalars, so we must send it away
-      info.LocationState = this->Interpolator->TestPoint(info.CurrentPosition.x);
-      if (info.LocationState == ID_OUTSIDE_ALL)
-      {
-        info.ErrorCode = 2;
-        // if the particle is sent, remove it from the list
-        if (this->SendParticleToAnotherProcess(info, previous, this->OutputPointData))
-        {
-          this->ParticleHistories.erase(it);
-          particle_good = false;
-        }
-      }
+      vtkErrorMacro("the particle should have been added");
+    }
+    else
+    {
+      this->SendParticleToAnotherProcess(info, previous, this->ParticlePointData);
+    }
+    this->ParticleHistories.erase(it);
+    particle_good = false;
+  }
+  else if (status == PARTICLE_OUTSIDE)
+  {
+    // if the particle is sent, remove it from the list
+    if (this->SendParticleToAnotherProcess(info, previous, this->OutputPointData))
+    {
+      this->ParticleHistories.erase(it);
+      particle_good = false;
     }
+  }
 
-    // Has this particle stagnated
-    //
-    if (particle_good)
+  // Has this particle stagnated
+  //
+  if (particle_good && status != PARTICLE_UNMOVED)
+  {
+    info.speed = vtkMath::Norm(velocity);
+    if (info.speed <= this->TerminalSpeed)
     {
-      this->Interpolator->GetLastGoodVelocity(velocity);
-      info.speed = vtkMath::Norm(velocity);
-      if (it->speed <= this->TerminalSpeed)
-      {
-        this->ParticleHistories.erase(it);
-        particle_good = false;
-      }
+      this->ParticleHistories.erase(it);
+      particle_good = false;
     }
   }
 
@@ -1212,14 +1254,13 @@ void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double c
   // We got this far without error :
   // Insert the point into the output
   // Create any new scalars and interpolate existing ones
-  // Cache cell ids and datasets
   //
   if (particle_good)
   {
-    //
-    // store the last Cell Ids and dataset indices for next time particle is updated
-    //
-    this->Interpolator->GetCachedCellIds(info.CachedCellId, info.CachedDataSetId);
+    if (status == PARTICLE_UNMOVED)
+    {
+      this->Interpolator->GetCachedCellIds(info.CachedCellId, info.CachedDataSetId);
+    }
     //
     info.TimeStepAge += 1;
     //
@@ -1231,12 +1272,73 @@ void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double c
   {
     this->Interpolator->ClearCache();
   }
+}
 
-#ifdef DEBUGPARTICLETRACE
-  double eps = (this->GetCacheDataTime(1) - this->GetCacheDataTime(0)) / 100;
-  Assert(point1[3] >= (this->GetCacheDataTime(0) - eps) &&
-    point1[3] <= (this->GetCacheDataTime(1) + eps));
-#endif
+//------------------------------------------------------------------------------
+bool vtkParticleTracerBase::IntegrateParticlesInThreads(
+  ParticleListIterator first, ParticleListIterator last, double currenttime, double targettime)
+{
+  if (!this->Interpolator->BuildSearchStructures())
+  {
+    return false;
+  }
+
+  // The particles are advected in copies, so that the list keeps the
+  // previous states needed to send particles to other processes.
+  std::vector<ParticleListIterator> particles;
+  for (ParticleListIterator it = first; it != last; ++it)
+  {
+    particles.push_back(it);
+  }
+  const vtkIdType numParticles = static_cast<vtkIdType>(particles.size());
+  std::vector<ParticleInformation> advected(numParticles);
+  std::vector<int> statuses(numParticles);
+  std::vector<double> velocities(3 * numParticles);
+
+  vtkSMPThreadLocal<vtkSmartPointer<vtkTemporalInterpolatedVelocityField>> localInterpolators;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkInitialValueProblemSolver>> localIntegrators;
+  vtkSMPTools::For(0, numParticles, [&](vtkIdType begin, vtkIdType end) {
+    vtkSmartPointer<vtkTemporalInterpolatedVelocityField>& interpolator =
+      localInterpolators.Local();
+    vtkSmartPointer<vtkInitialValueProblemSolver>& integrator = localIntegrators.Local();
+    if (!interpolator)
+    {
+      interpolator = vtkSmartPointer<vtkTemporalInterpolatedVelocityField>::New();
+      interpolator->CopyParameters(this->Interpolator);
+      integrator.TakeReference(this->GetIntegrator()->NewInstance());
+      integrator->SetFunctionSet(interpolator);
+    }
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (this->GetAbortExecute())
+      {
+        break;
+      }
+      advected[i] = *particles[i];
+      statuses[i] = this->AdvectParticle(
+        advected[i], currenttime, targettime, integrator, interpolator, &velocities[3 * i]);
+    }
+  });
+  if (this->GetAbortExecute())
+  {
+    return true;
+  }
+
+  for (vtkIdType i = 0; i < numParticles; ++i)
+  {
+    ParticleInformation previous = *particles[i];
+    ParticleInformation& info = *particles[i];
+    info = advected[i];
+    if (statuses[i] != PARTICLE_LOST)
+    {
+      // Evaluate again in the cells found by the advection, for the point
+      // data and the vorticity of the output.
+      this->Interpolator->SetCachedCellIds(info.CachedCellId, info.CachedDataSetId);
+      this->Interpolator->TestPoint(info.CurrentPosition.x);
+    }
+    this->FinishParticleAdvection(particles[i], previous, statuses[i], &velocities[3 * i]);
+  }
+  return true;
 }
 
 //------------------------------------------------------------------------------
@@ -1253,6 +1355,7 @@ void vtkParticleTracerBase::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "StaticMesh: " << this->StaticMesh << endl;
   os << indent << "TerminationTime: " << this->TerminationTime << endl;
   os << indent << "StaticSeeds: " << this->StaticSeeds << endl;
+  os << indent << "ThreadedAdvection: " << this->ThreadedAdvection << endl;
 }
 
 //------------------------------------------------------------------------------
@@ -1448,13 +1551,13 @@ void vtkParticleTracerBase::CreateProtoPD(vtkDataObject* input)
 }
 
 //------------------------------------------------------------------------------
-bool vtkParticleTracerBase::RetryWithPush(
-  ParticleInformation& info, double* point1, double delT, int substeps)
+bool vtkParticleTracerBase::RetryWithPush(ParticleInformation& info, double* point1,
+  double delT, int substeps, vtkTemporalInterpolatedVelocityField* interpolator)
 {
   double velocity[3];
-  this->Interpolator->ClearCache();
+  interpolator->ClearCache();
 
-  info.LocationState = this->Interpolator->TestPoint(point1);
+  info.LocationState = interpolator->TestPoint(point1);
 
   if (info.LocationState == ID_OUTSIDE_ALL)
   {
@@ -1463,7 +1566,7 @@ bool vtkParticleTracerBase::RetryWithPush(
     // send the particle 'as is' and hope it lands in another process
     if (substeps > 0)
     {
-      this->Interpolator->GetLastGoodVelocity(velocity);
+      interpolator->GetLastGoodVelocity(velocity);
     }
     else
     {
@@ -1474,19 +1577,19 @@ bool vtkParticleTracerBase::RetryWithPush(
   else if (info.LocationState == ID_OUTSIDE_T0)
   {
     // the particle left the volume but can be tested at T2, so use the velocity at T2
-    this->Interpolator->GetLastGoodVelocity(velocity);
+    interpolator->GetLastGoodVelocity(velocity);
     info.ErrorCode = 4;
   }
   else if (info.LocationState == ID_OUTSIDE_T1)
   {
     // the particle left the volume but can be tested at T1, so use the velocity at T1
-    this->Interpolator->GetLastGoodVelocity(velocity);
+    interpolator->GetLastGoodVelocity(velocity);
     info.ErrorCode = 5;
   }
   else
   {
     // The test returned INSIDE_ALL, so test failed near start of integration,
-    this->Interpolator->GetLastGoodVelocity(velocity);
+    interpolator->GetLastGoodVelocity(velocity);
   }
 
   // try adding a one increment push to the particle to get over a rotating/moving boundary
@@ -1496,7 +1599,7 @@ bool vtkParticleTracerBase::RetryWithPush(
   }
 
   info.CurrentPosition.x[3] += delT;
-  info.LocationState = this->Interpolator->TestPoint(info.CurrentPosition.x);
+  info.LocationState = interpolator->TestPoint(info.CurrentPosition.x);
   info.age += delT;
   info.SimulationTime += delT; // = this->GetCurrentTimeValue();
 
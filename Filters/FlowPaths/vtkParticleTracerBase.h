@@ -20,6 +20,12 @@
  * in a vector field. Note that the input vtkPointData structure must
  * be identical on all datasets.
  *
+ * When ThreadedAdvection is on, the particles are advected concurrently
+ * with vtkSMPTools, each thread using its own copies of the interpolator
+ * and of the integrator. The particles are then output in the order of the
+ * particle list, as they are serially, their point data being interpolated
+ * again in the cells the threads found them in.
+ *
  * @sa
  * vtkRibbonFilter vtkRuledSurfaceFilter vtkInitialValueProblemSolver
  * vtkRungeKutta2 vtkRungeKutta4 vtkRungeKutta45 vtkStreamTracer
@@ -261,6 +267,19 @@ public:
   vtkBooleanMacro(DisableResetCache, vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Set/Get whether the particles are advected concurrently at each time
+   * step. Each particle is advected on its own, then the particles are
+   * finished and output serially in list order, so the output only differs
+   * from the serial one by the rounding errors of the interpolated point
+   * data. The default is off.
+   */
+  vtkSetMacro(ThreadedAdvection, bool);
+  vtkGetMacro(ThreadedAdvection, bool);
+  vtkBooleanMacro(ThreadedAdvection, bool);
+  //@}
+
   //@{
   /**
    * Provide support for multiple seed sources
@@ -486,7 +505,46 @@ private:
    * to the integrator that is used.
    */
   bool RetryWithPush(vtkParticleTracerBaseNamespace::ParticleInformation& info, double* point1,
-    double delT, int subSteps);
+    double delT, int subSteps, vtkTemporalInterpolatedVelocityField* interpolator);
+
+  // What AdvectParticle() did to a particle.
+  enum AdvectionStatus
+  {
+    PARTICLE_UNMOVED, // the start and end times are the same
+    PARTICLE_MOVED,
+    PARTICLE_LOST, // the integration failed, even with a push
+    PARTICLE_OUTSIDE
+  };
+
+  /**
+   * Move a particle between the two times supplied with an integrator whose
+   * function set is the given interpolator. Only the particle and the
+   * interpolator are modified, so that particles can be advected
+   * concurrently with copies of the interpolator. Return an
+   * AdvectionStatus, and the velocity at the end position of the particle.
+   */
+  int AdvectParticle(vtkParticleTracerBaseNamespace::ParticleInformation& info,
+    double currenttime, double targettime, vtkInitialValueProblemSolver* integrator,
+    vtkTemporalInterpolatedVelocityField* interpolator, double velocity[3]);
+
+  /**
+   * Remove an advected particle from the list, send it to another process or
+   * output it, according to the status returned by AdvectParticle().
+   * The interpolator must have been last evaluated at the particle position.
+   */
+  void FinishParticleAdvection(vtkParticleTracerBaseNamespace::ParticleListIterator& it,
+    vtkParticleTracerBaseNamespace::ParticleInformation& previous, int status,
+    double velocity[3]);
+
+  /**
+   * Advect the particles in [first, last) concurrently, then finish their
+   * advection in the order of the list. Return false if the search
+   * structures of the input do not support concurrent searches, in which
+   * case no particle has been advected.
+   */
+  bool IntegrateParticlesInThreads(vtkParticleTracerBaseNamespace::ParticleListIterator first,
+    vtkParticleTracerBaseNamespace::ParticleListIterator last, double currenttime,
+    double targettime);
 
   bool SetTerminationTimeNoModify(double t);
 
@@ -497,6 +555,7 @@ private:
   bool ComputeVorticity;
   double RotationScale;
   double TerminalSpeed;
+  bool ThreadedAdvection;
 
   // A counter to keep track of how many times we reinjected
   int ReinjectionCounter;
@@ -15,16 +15,20 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkStreamTracer.h"
 
 #include "vtkAMRInterpolatedVelocityField.h"
+#include "vtkAbstractCellLocator.h"
 #include "vtkAbstractInterpolatedVelocityField.h"
+#include "vtkAppendPolyData.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellLocatorInterpolatedVelocityField.h"
+#include "vtkClosestPointStrategy.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkDoubleArray.h"
 #include "vtkExecutive.h"
+#include "vtkFindCellStrategy.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
@@ -43,9 +47,12 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStaticCellLocator.h"
 
+#include <algorithm>
 #include <vector>
 
 vtkObjectFactoryNewMacro(vtkStreamTracer);
@@ -128,6 +135,9 @@ vtkStreamTracer::vtkStreamTracer()
   this->HasMatchingPointAttributes = true;
 
   this->SurfaceStreamlines = false;
+
+  this->ThreadedIntegration = false;
+  this->IntegratingBatches = false;
 }
 
 //------------------------------------------------------------------------------
@@ -512,11 +522,23 @@ int vtkStreamTracer::RequestData(vtkInformation* vtkNotUsed(request),
     if (vectors)
     {
       const char* vecName = vectors->GetName();
-      double propagation = 0;
-      vtkIdType numSteps = 0;
-      double integrationTime = 0;
-      this->Integrate(input0->GetPointData(), output, seeds, seedIds, integrationDirections,
-        lastPoint, func, maxCellSize, vecType, vecName, propagation, numSteps, integrationTime);
+      // Stay serial with custom termination callbacks, which may not be
+      // thread safe, and when Integrate() has to turn surface streamlines off.
+      if (this->ThreadedIntegration && this->Integrator &&
+        this->CustomTerminationCallback.empty() &&
+        (!this->SurfaceStreamlines || vtkInterpolatedVelocityField::SafeDownCast(func)))
+      {
+        this->IntegrateInThreads(input0->GetPointData(), output, seeds, seedIds,
+          integrationDirections, func, maxCellSize, vecType, vecName);
+      }
+      else
+      {
+        double propagation = 0;
+        vtkIdType numSteps = 0;
+        double integrationTime = 0;
+        this->Integrate(input0->GetPointData(), output, seeds, seedIds, integrationDirections,
+          lastPoint, func, maxCellSize, vecType, vecName, propagation, numSteps, integrationTime);
+      }
     }
     func->Delete();
     seeds->Delete();
@@ -780,7 +802,10 @@ void vtkStreamTracer::Integrate(vtkPointData* input0Data, vtkPolyData* output,
   for (int currentLine = 0; currentLine < numLines; currentLine++)
   {
     double progress = static_cast<double>(currentLine) / numLines;
-    this->UpdateProgress(progress);
+    if (!this->IntegratingBatches)
+    {
+      this->UpdateProgress(progress);
+    }
 
     switch (integrationDirections->GetValue(currentLine))
     {
@@ -925,8 +950,11 @@ void vtkStreamTracer::Integrate(vtkPointData* input0Data, vtkPolyData* output,
 
       if (numSteps++ % 1000 == 1)
       {
-        progress = (currentLine + propagation / this->MaximumPropagation) / numLines;
-        this->UpdateProgress(progress);
+        if (!this->IntegratingBatches)
+        {
+          progress = (currentLine + propagation / this->MaximumPropagation) / numLines;
+          this->UpdateProgress(progress);
+        }
 
         if (this->GetAbortExecute())
         {
@@ -959,7 +987,10 @@ void vtkStreamTracer::Integrate(vtkPointData* input0Data, vtkPolyData* output,
         }
         maxStep = stepSize.Interval;
       }
-      this->LastUsedStepSize = stepSize.Interval;
+      if (!this->IntegratingBatches)
+      {
+        this->LastUsedStepSize = stepSize.Interval;
+      }
 
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
@@ -1196,6 +1227,184 @@ void vtkStreamTracer::Integrate(vtkPointData* input0Data, vtkPolyData* output,
   output->Squeeze();
 }
 
+//------------------------------------------------------------------------------
+void vtkStreamTracer::IntegrateInThreads(vtkPointData* input0Data, vtkPolyData* output,
+  vtkDataArray* seedSource, vtkIdList* seedIds, vtkIntArray* integrationDirections,
+  vtkAbstractInterpolatedVelocityField* func, int maxCellSize, int vecType, const char* vecName)
+{
+  // The datasets, in the order CheckInputs() added them to func.
+  std::vector<vtkDataSet*> dataSets;
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(this->InputData->NewIterator());
+  for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    if (vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject()))
+    {
+      dataSets.push_back(ds);
+    }
+  }
+
+  // Build what the interpolators otherwise build on their first evaluation
+  // and share through the datasets: the cells, the cell links and the
+  // locators of the find cell strategies. The bounds come last, as building
+  // may modify the datasets.
+  vtkNew<vtkGenericCell> cell;
+  vtkNew<vtkIdList> cellIds;
+  for (vtkDataSet* ds : dataSets)
+  {
+    if (ds->GetNumberOfCells() > 0)
+    {
+      ds->GetCell(0, cell);
+    }
+    vtkPointSet* ps = vtkPointSet::SafeDownCast(ds);
+    if (ps && ps->GetNumberOfPoints() > 0)
+    {
+      ps->GetPointCells(0, cellIds);
+      if (vtkInterpolatedVelocityField::SafeDownCast(func))
+      {
+        vtkSmartPointer<vtkFindCellStrategy> strategy;
+        if (func->GetFindCellStrategy())
+        {
+          strategy.TakeReference(func->GetFindCellStrategy()->NewInstance());
+        }
+        else
+        {
+          strategy = vtkSmartPointer<vtkClosestPointStrategy>::New();
+        }
+        strategy->Initialize(ps);
+      }
+    }
+    ds->GetLength();
+  }
+
+  // The cell locators that support concurrent queries are built now rather
+  // than on the first query, and shared by all the copies of func.
+  std::vector<vtkAbstractCellLocator*> locators(dataSets.size(), nullptr);
+  if (vtkCellLocatorInterpolatedVelocityField* cellLocatorFunc =
+        vtkCellLocatorInterpolatedVelocityField::SafeDownCast(func))
+  {
+    for (size_t i = 0; i < dataSets.size(); ++i)
+    {
+      vtkAbstractCellLocator* locator = cellLocatorFunc->GetCellLocator(static_cast<int>(i));
+      if (locator && locator->IsFindCellThreadSafe())
+      {
+        locator->SetLazyEvaluation(0);
+        locator->BuildLocator();
+        locators[i] = locator;
+      }
+    }
+  }
+
+  vtkOverlappingAMR* amrData = vtkOverlappingAMR::SafeDownCast(this->InputData);
+  auto newFunction = [&]() {
+    vtkSmartPointer<vtkAbstractInterpolatedVelocityField> copy;
+    copy.TakeReference(func->NewInstance());
+    copy->CopyParameters(func);
+    copy->SelectVectors(vecType, vecName);
+    if (vtkAMRInterpolatedVelocityField* amrFunc =
+          vtkAMRInterpolatedVelocityField::SafeDownCast(copy))
+    {
+      amrFunc->SetAMRData(amrData);
+    }
+    else if (vtkCellLocatorInterpolatedVelocityField* cellLocatorFunc =
+               vtkCellLocatorInterpolatedVelocityField::SafeDownCast(copy))
+    {
+      for (size_t i = 0; i < dataSets.size(); ++i)
+      {
+        if (locators[i])
+        {
+          cellLocatorFunc->AddDataSet(dataSets[i], locators[i]);
+        }
+        else
+        {
+          cellLocatorFunc->AddDataSet(dataSets[i]);
+        }
+      }
+    }
+    else if (vtkCompositeInterpolatedVelocityField* compositeFunc =
+               vtkCompositeInterpolatedVelocityField::SafeDownCast(copy))
+    {
+      for (vtkDataSet* ds : dataSets)
+      {
+        compositeFunc->AddDataSet(ds);
+      }
+    }
+    return copy;
+  };
+
+  // At most 1024 batches of consecutive seeds, whose outputs are appended in
+  // seed order once all are integrated.
+  const vtkIdType numLines = seedIds->GetNumberOfIds();
+  const vtkIdType batchSize = std::max<vtkIdType>((numLines + 1023) / 1024, 1);
+  const vtkIdType numBatches = (numLines + batchSize - 1) / batchSize;
+  std::vector<vtkSmartPointer<vtkPolyData>> batchOutputs(numBatches);
+  vtkSMPThreadLocal<vtkSmartPointer<vtkAbstractInterpolatedVelocityField>> localFuncs;
+
+  // The normals of all the streamlines are generated at once afterwards.
+  const bool generateNormals = this->GenerateNormalsInIntegrate;
+  this->GenerateNormalsInIntegrate = false;
+  this->IntegratingBatches = true;
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType beginBatch, vtkIdType endBatch) {
+    vtkSmartPointer<vtkAbstractInterpolatedVelocityField>& localFunc = localFuncs.Local();
+    for (vtkIdType batch = beginBatch; batch < endBatch; ++batch)
+    {
+      // Each batch starts as the serial integration does, from the first
+      // dataset, whichever thread integrated the previous batch with
+      // localFunc. The AMR interpolator cannot be reset, but is cheap to copy.
+      if (!localFunc || amrData)
+      {
+        localFunc = newFunction();
+      }
+      else
+      {
+        localFunc->SetLastCellId(-1, 0);
+      }
+
+      const vtkIdType firstLine = batch * batchSize;
+      const vtkIdType lastLine = std::min(firstLine + batchSize, numLines);
+      vtkNew<vtkIdList> batchSeedIds;
+      batchSeedIds->SetNumberOfIds(lastLine - firstLine);
+      vtkNew<vtkIntArray> batchDirections;
+      batchDirections->SetNumberOfValues(lastLine - firstLine);
+      for (vtkIdType line = firstLine; line < lastLine; ++line)
+      {
+        batchSeedIds->SetId(line - firstLine, seedIds->GetId(line));
+        batchDirections->SetValue(line - firstLine, integrationDirections->GetValue(line));
+      }
+
+      batchOutputs[batch] = vtkSmartPointer<vtkPolyData>::New();
+      double lastPoint[3];
+      double propagation = 0;
+      vtkIdType numSteps = 0;
+      double integrationTime = 0;
+      this->Integrate(input0Data, batchOutputs[batch], seedSource, batchSeedIds, batchDirections,
+        lastPoint, localFunc, maxCellSize, vecType, vecName, propagation, numSteps,
+        integrationTime);
+    }
+  });
+  this->IntegratingBatches = false;
+  this->GenerateNormalsInIntegrate = generateNormals;
+
+  if (this->GetAbortExecute())
+  {
+    return;
+  }
+
+  // Concatenate the streamlines of the batches, in order.
+  std::vector<vtkPolyData*> inputs(numBatches);
+  for (vtkIdType batch = 0; batch < numBatches; ++batch)
+  {
+    inputs[batch] = batchOutputs[batch];
+  }
+  vtkNew<vtkAppendPolyData> append;
+  append->ExecuteAppend(output, inputs.data(), static_cast<int>(numBatches));
+  if (generateNormals && output->GetNumberOfPoints() > 1)
+  {
+    this->GenerateNormals(output, nullptr, vecName);
+  }
+  output->Squeeze();
+}
+
 //------------------------------------------------------------------------------
 void vtkStreamTracer::GenerateNormals(vtkPolyData* output, double* firstNormal, const char* vecName)
 {
@@ -1407,6 +1616,7 @@ void vtkStreamTracer::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Maximum number of steps: " << this->MaximumNumberOfSteps << endl;
   os << indent << "Vorticity computation: " << (this->ComputeVorticity ? " On" : " Off") << endl;
   os << indent << "Rotation scale: " << this->RotationScale << endl;
+  os << indent << "Threaded integration: " << (this->ThreadedIntegration ? "On" : "Off") << endl;
 }
 
 //------------------------------------------------------------------------------
@@ -69,6 +69,9 @@
  * a source object, traces will be generated from each point in the source
  * that is inside the dataset.
  *
+ * When ThreadedIntegration is on, the seeds are integrated concurrently with
+ * vtkSMPTools. The streamlines are still output in the order of the seeds.
+ *
  * @note Field data is shallow copied to the output. When the input is a
  * composite data set, field data associated with the root block is shallow-
  * copied to the output vtkPolyData.
@@ -297,6 +300,24 @@ public:
   vtkBooleanMacro(SurfaceStreamlines, bool);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the integration of the seeds in several threads. The seeds
+   * are split in batches integrated concurrently, each thread using its own
+   * copies of the interpolator and of the integrator. The cell locators of
+   * a vtkCellLocatorInterpolatedVelocityField are built once and shared by
+   * the copies when they support concurrent queries. The streamlines are
+   * output in the order of the seeds. For an input made of a single dataset
+   * they are the same as the serial ones; with several datasets, a point on
+   * the boundary of two of them may be located in the other one. The seeds
+   * are integrated serially when custom termination callbacks are set, as
+   * they may not be thread safe. Default is off.
+   */
+  vtkSetMacro(ThreadedIntegration, bool);
+  vtkGetMacro(ThreadedIntegration, bool);
+  vtkBooleanMacro(ThreadedIntegration, bool);
+  //@}
+
   enum
   {
     FORWARD,
@@ -404,6 +425,10 @@ protected:
     const char* vecFieldName, double& propagation, vtkIdType& numSteps, double& integrationTime);
   double SimpleIntegrate(double seed[3], double lastPoint[3], double stepSize,
     vtkAbstractInterpolatedVelocityField* func);
+  void IntegrateInThreads(vtkPointData* inputData, vtkPolyData* output, vtkDataArray* seedSource,
+    vtkIdList* seedIds, vtkIntArray* integrationDirections,
+    vtkAbstractInterpolatedVelocityField* func, int maxCellSize, int vecType,
+    const char* vecFieldName);
   int CheckInputs(vtkAbstractInterpolatedVelocityField*& func, int* maxCellSize);
   void GenerateNormals(vtkPolyData* output, double* firstNormal, const char* vecName);
 
@@ -452,6 +477,12 @@ protected:
   // Compute streamlines only on surface.
   bool SurfaceStreamlines;
 
+  bool ThreadedIntegration;
+
+  // Set while Integrate() is called concurrently on batches of seeds, in
+  // which case it neither reports progress nor records LastUsedStepSize.
+  bool IntegratingBatches;
+
   vtkAbstractInterpolatedVelocityField* InterpolatorPrototype;
 
   vtkCompositeDataSet* InputData;
@@ -16,12 +16,16 @@
 
 #include "vtkAbstractCellLocator.h"
 #include "vtkCachingInterpolatedVelocityField.h"
+#include "vtkCellLocator.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
 
 #include <vector>
 //------------------------------------------------------------------------------
@@ -105,22 +109,18 @@ void vtkTemporalInterpolatedVelocityField::ClearCache()
 //------------------------------------------------------------------------------
 void vtkTemporalInterpolatedVelocityField::SetCachedCellIds(vtkIdType id[2], int ds[2])
 {
-  if (id[0] != -1)
+  for (int T = 0; T < 2; T++)
   {
-    this->IVF[0]->SetLastCellInfo(id[0], ds[0]);
-  }
-  else
-  {
-    this->IVF[0]->SetLastCellInfo(-1, 0);
-  }
-  //
-  if (id[1] != -1)
-  {
-    this->IVF[1]->SetLastCellInfo(id[1], ds[1]);
-  }
-  else
-  {
-    this->IVF[1]->SetLastCellInfo(-1, 0);
+    const IVFCacheList& cacheList = this->IVF[T]->CacheList;
+    if (id[T] != -1 && ds[T] >= 0 && static_cast<size_t>(ds[T]) < cacheList.size() &&
+      cacheList[ds[T]].DataSet && id[T] < cacheList[ds[T]].DataSet->GetNumberOfCells())
+    {
+      this->IVF[T]->SetLastCellInfo(id[T], ds[T]);
+    }
+    else
+    {
+      this->IVF[T]->SetLastCellInfo(-1, 0);
+    }
   }
 }
 //------------------------------------------------------------------------------
@@ -134,6 +134,73 @@ bool vtkTemporalInterpolatedVelocityField::GetCachedCellIds(vtkIdType id[2], int
   return ((id[0] >= 0) && (id[1] >= 0));
 }
 //------------------------------------------------------------------------------
+void vtkTemporalInterpolatedVelocityField::CopyParameters(
+  vtkTemporalInterpolatedVelocityField* from)
+{
+  this->SetVectorsSelection(from->IVF[0]->GetVectorsSelection());
+  for (int T = 0; T < 2; T++)
+  {
+    const IVFCacheList& cacheList = from->IVF[T]->CacheList;
+    for (size_t i = 0; i < cacheList.size(); i++)
+    {
+      if (cacheList[i].DataSet)
+      {
+        // IVFDataSetInfo::SetDataSet gives each dataset a cell of its own.
+        this->IVF[T]->SetDataSet(static_cast<int>(i), cacheList[i].DataSet,
+          cacheList[i].StaticDataSet, cacheList[i].BSPTree);
+      }
+    }
+    this->IVF[T]->ClearLastCellInfo();
+  }
+  this->Times[0] = from->Times[0];
+  this->Times[1] = from->Times[1];
+  this->ScaleCoeff = from->ScaleCoeff;
+  this->StaticDataSets = from->StaticDataSets;
+}
+//------------------------------------------------------------------------------
+bool vtkTemporalInterpolatedVelocityField::BuildSearchStructures()
+{
+  vtkNew<vtkGenericCell> cell;
+  vtkNew<vtkIdList> cellIds;
+  bool threadSafe = true;
+  for (int T = 0; T < 2; T++)
+  {
+    for (IVFDataSetInfo& info : this->IVF[T]->CacheList)
+    {
+      vtkDataSet* ds = info.DataSet;
+      if (!ds)
+      {
+        continue;
+      }
+      if (ds->GetNumberOfCells() > 0)
+      {
+        ds->GetCell(0, cell);
+      }
+      if (vtkCellLocator* locator = vtkCellLocator::SafeDownCast(info.BSPTree))
+      {
+        // What the first search does with the lazily evaluated locators.
+        locator->BuildLocatorIfNeeded();
+      }
+      else if (info.BSPTree)
+      {
+        info.BSPTree->BuildLocator();
+      }
+      else if (vtkPointSet* ps = vtkPointSet::SafeDownCast(ds))
+      {
+        // vtkPointSet::FindCell walks the cells around the closest points.
+        if (ps->GetNumberOfPoints() > 0)
+        {
+          ps->GetPointCells(0, cellIds);
+          ps->BuildPointLocator();
+        }
+      }
+      threadSafe = threadSafe && (!info.BSPTree || info.BSPTree->IsFindCellThreadSafe());
+      ds->GetLength();
+    }
+  }
+  return threadSafe;
+}
+//------------------------------------------------------------------------------
 void vtkTemporalInterpolatedVelocityField::AdvanceOneTimeStep()
 {
   for (unsigned int i = 0; i < this->IVF[0]->CacheList.size(); i++)
@@ -30,8 +30,8 @@
  * values and computing vorticity etc.
  *
  * @warning
- * vtkTemporalInterpolatedVelocityField is probably not thread safe.
- * A new instance should be created by each thread.
+ * vtkTemporalInterpolatedVelocityField is not thread safe. A new instance
+ * should be created by each thread, see CopyParameters().
  *
  * @warning
  * Datasets are added in lists. The list for T1 must be identical to that for T0
@@ -102,11 +102,27 @@ public:
    */
   void SetDataSetAtTime(int I, int N, double T, vtkDataSet* dataset, bool staticdataset);
 
+  /**
+   * Copy the datasets, the times and the selected vectors of another
+   * interpolator. The cell locators are shared, but not the cached cells,
+   * so that both interpolators can be evaluated concurrently once
+   * BuildSearchStructures() has been called on the other one.
+   */
+  void CopyParameters(vtkTemporalInterpolatedVelocityField* from);
+
+  /**
+   * Build the cell locators, the cell links and the point locators of the
+   * datasets, which are otherwise built by the first evaluations. Return
+   * false if one of the cell locators does not support concurrent searches.
+   */
+  bool BuildSearchStructures();
+
   //@{
   /**
    * Between iterations of the Particle Tracer, Id's of the Cell
    * are stored and then at the start of the next particle the
-   * Ids are set to 'pre-fill' the cache.
+   * Ids are set to 'pre-fill' the cache. Ids that do not match
+   * the current datasets are ignored.
    */
   bool GetCachedCellIds(vtkIdType id[2], int ds[2]);
   void SetCachedCellIds(vtkIdType id[2], int ds[2]);
@@ -0,0 +1,284 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellLocatorsParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the batched queries of the cell locators give the same results
+// as the single queries, and that the locators built in parallel are the
+// same as the ones built serially.
+
+#include "vtkCellLocator.h"
+#include "vtkCellTreeLocator.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkKdTree.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkOBBTree.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+
+namespace
+{
+const vtkIdType NumberOfQueries = 2000;
+
+// A subclass overriding the cell/ray test without a cell, which must still
+// be called by IntersectWithLine().
+class CountingCellTreeLocator : public vtkCellTreeLocator
+{
+public:
+  static CountingCellTreeLocator* New();
+  vtkTypeMacro(CountingCellTreeLocator, vtkCellTreeLocator);
+
+  vtkIdType NumberOfTests = 0;
+
+protected:
+  using vtkCellTreeLocator::IntersectCellInternal;
+  int IntersectCellInternal(vtkIdType cell_ID, const double p1[3], const double p2[3],
+    const double tol, double& t, double ipt[3], double pcoords[3], int& subId) override
+  {
+    ++this->NumberOfTests;
+    return this->Superclass::IntersectCellInternal(cell_ID, p1, p2, tol, t, ipt, pcoords, subId);
+  }
+};
+vtkStandardNewMacro(CountingCellTreeLocator);
+
+void RandomPoints(vtkMinimalStandardRandomSequence* random, double scale, vtkDoubleArray* points)
+{
+  points->SetNumberOfComponents(3);
+  points->SetNumberOfTuples(NumberOfQueries);
+  for (vtkIdType i = 0; i < NumberOfQueries; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      points->SetComponent(i, j, random->GetRangeValue(-scale, scale));
+      random->Next();
+    }
+  }
+}
+
+bool TestFindCells(vtkAbstractCellLocator* locator, vtkDoubleArray* points)
+{
+  vtkNew<vtkIdTypeArray> cellIds;
+  vtkNew<vtkDoubleArray> pcoords;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 4, "STDThread", false },
+    [&]() { locator->FindCells(points, cellIds, pcoords); });
+
+  vtkNew<vtkGenericCell> cell;
+  vtkIdType numFound = 0;
+  for (vtkIdType i = 0; i < NumberOfQueries; ++i)
+  {
+    double x[3], pc[3], weights[8];
+    points->GetTuple(i, x);
+    const vtkIdType cellId = locator->FindCell(x, 0.0, cell, pc, weights);
+    if (cellId != cellIds->GetValue(i) ||
+      (cellId >= 0 &&
+        (pc[0] != pcoords->GetComponent(i, 0) || pc[1] != pcoords->GetComponent(i, 1) ||
+          pc[2] != pcoords->GetComponent(i, 2))))
+    {
+      std::cerr << locator->GetClassName() << ": FindCells differs from FindCell for point " << i
+                << std::endl;
+      return false;
+    }
+    numFound += cellId >= 0 ? 1 : 0;
+  }
+  if (numFound == 0 || numFound == NumberOfQueries)
+  {
+    std::cerr << locator->GetClassName() << ": unexpected number of points found " << numFound
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestIntersectWithLines(vtkAbstractCellLocator* locator, vtkDoubleArray* p1, vtkDoubleArray* p2)
+{
+  vtkNew<vtkIdTypeArray> cellIds;
+  vtkNew<vtkDoubleArray> ts;
+  vtkNew<vtkDoubleArray> xs;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 4, "STDThread", false },
+    [&]() { locator->IntersectWithLines(p1, p2, 0.0, cellIds, ts, xs); });
+
+  vtkNew<vtkGenericCell> cell;
+  vtkIdType numHits = 0;
+  for (vtkIdType i = 0; i < NumberOfQueries; ++i)
+  {
+    double a0[3], a1[3], t, x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId = -1;
+    p1->GetTuple(i, a0);
+    p2->GetTuple(i, a1);
+    if (!locator->IntersectWithLine(a0, a1, 0.0, t, x, pcoords, subId, cellId, cell))
+    {
+      cellId = -1;
+    }
+    if (cellId != cellIds->GetValue(i) ||
+      (cellId >= 0 &&
+        (t != ts->GetValue(i) || x[0] != xs->GetComponent(i, 0) ||
+          x[1] != xs->GetComponent(i, 1) || x[2] != xs->GetComponent(i, 2))))
+    {
+      std::cerr << locator->GetClassName()
+                << ": IntersectWithLines differs from IntersectWithLine for line " << i
+                << std::endl;
+      return false;
+    }
+    numHits += cellId >= 0 ? 1 : 0;
+  }
+  if (numHits == 0 || numHits == NumberOfQueries)
+  {
+    std::cerr << locator->GetClassName() << ": unexpected number of hits " << numHits
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkPolyData> BuildOBBTree(vtkPolyData* input, int numThreads)
+{
+  vtkNew<vtkOBBTree> tree;
+  tree->SetDataSet(input);
+  tree->SetNumberOfCellsPerNode(4);
+  vtkSMPTools::LocalScope(
+    vtkSMPTools::Config{ numThreads, "STDThread", false }, [&]() { tree->BuildLocator(); });
+  vtkSmartPointer<vtkPolyData> representation = vtkSmartPointer<vtkPolyData>::New();
+  tree->GenerateRepresentation(-1, representation);
+  return representation;
+}
+}
+
+int TestCellLocatorsParallel(int, char*[])
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  // Tetrahedra filling [-1, 1]^3, to find cells in.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(16, 16, 16);
+  image->SetOrigin(-1.0, -1.0, -1.0);
+  image->SetSpacing(2.0 / 15, 2.0 / 15, 2.0 / 15);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputData(image);
+  tetrahedralize->Update();
+  vtkUnstructuredGrid* grid = tetrahedralize->GetOutput();
+  vtkNew<vtkDoubleArray> points;
+  RandomPoints(random, 1.2, points);
+
+  // A sphere, to intersect lines with.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  sphere->Update();
+  vtkPolyData* surface = sphere->GetOutput();
+  vtkNew<vtkDoubleArray> p1;
+  vtkNew<vtkDoubleArray> p2;
+  RandomPoints(random, 1.0, p1);
+  RandomPoints(random, 1.0, p2);
+
+  vtkSmartPointer<vtkAbstractCellLocator> locators[4] = {
+    vtkSmartPointer<vtkCellLocator>::New(), vtkSmartPointer<vtkStaticCellLocator>::New(),
+    vtkSmartPointer<vtkCellTreeLocator>::New(), vtkSmartPointer<vtkOBBTree>::New()
+  };
+  for (int i = 0; i < 4; ++i)
+  {
+    // vtkOBBTree only supports line intersections.
+    if (i < 3)
+    {
+      locators[i]->SetDataSet(grid);
+      locators[i]->BuildLocator();
+      if (!TestFindCells(locators[i], points))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+    locators[i]->SetDataSet(surface);
+    locators[i]->BuildLocator();
+    if (!TestIntersectWithLines(locators[i], p1, p2))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The subclass gets its test called, one query at a time.
+  vtkNew<CountingCellTreeLocator> counting;
+  counting->SetDataSet(surface);
+  counting->BuildLocator();
+  if (counting->IsIntersectWithLineThreadSafe() || !TestIntersectWithLines(counting, p1, p2) ||
+    counting->NumberOfTests == 0)
+  {
+    std::cerr << "The cell/ray test of the vtkCellTreeLocator subclass is not used" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The OBB tree built with several threads is the same as the serial one.
+  vtkSmartPointer<vtkPolyData> tree1 = BuildOBBTree(surface, 1);
+  vtkSmartPointer<vtkPolyData> tree4 = BuildOBBTree(surface, 4);
+  if (tree1->GetNumberOfPoints() < 8 || tree1->GetNumberOfPoints() != tree4->GetNumberOfPoints())
+  {
+    std::cerr << "OBB trees differ in size" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (vtkIdType ptId = 0; ptId < tree1->GetNumberOfPoints(); ++ptId)
+  {
+    double x1[3], x4[3];
+    tree1->GetPoint(ptId, x1);
+    tree4->GetPoint(ptId, x4);
+    if (x1[0] != x4[0] || x1[1] != x4[1] || x1[2] != x4[2])
+    {
+      std::cerr << "OBB trees differ at point " << ptId << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The kd tree, built from the cell centers computed in parallel, is the
+  // same as the serial one.
+  vtkNew<vtkKdTree> kdTrees[2];
+  for (int i = 0; i < 2; ++i)
+  {
+    kdTrees[i]->SetDataSet(grid);
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ 1 + 3 * i, "STDThread", false },
+      [&]() { kdTrees[i]->BuildLocator(); });
+  }
+  if (kdTrees[0]->GetNumberOfRegions() < 2 ||
+    kdTrees[0]->GetNumberOfRegions() != kdTrees[1]->GetNumberOfRegions())
+  {
+    std::cerr << "kd trees differ in size" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (int region = 0; region < kdTrees[0]->GetNumberOfRegions(); ++region)
+  {
+    double bounds1[6], bounds4[6];
+    kdTrees[0]->GetRegionBounds(region, bounds1);
+    kdTrees[1]->GetRegionBounds(region, bounds4);
+    for (int j = 0; j < 6; ++j)
+    {
+      if (bounds1[j] != bounds4[j])
+      {
+        std::cerr << "kd trees differ in region " << region << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
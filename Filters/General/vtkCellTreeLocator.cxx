@@ -21,11 +21,13 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <stack>
 #include <vector>
@@ -433,9 +435,36 @@ public:
   void Build(vtkCellTreeLocator* ctl, vtkCellTreeLocator::vtkCellTree& ct, vtkDataSet* ds)
   {
     const vtkIdType size = ds->GetNumberOfCells();
-    double cellBounds[6];
     this->m_pc.resize(size);
 
+    // The bounds of the cells are gathered in parallel. GetCellBounds() is
+    // only thread safe once it has been called from a single thread.
+    double cellBounds[6];
+    ds->GetCellBounds(0, cellBounds);
+    vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+      double bounds[6];
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        this->m_pc[i].Ind = i;
+
+        double* boundsPtr = bounds;
+        if (ctl->CellBounds)
+        {
+          boundsPtr = ctl->CellBounds[i];
+        }
+        else
+        {
+          ds->GetCellBounds(i, boundsPtr);
+        }
+
+        for (int d = 0; d < 3; ++d)
+        {
+          this->m_pc[i].Min[d] = boundsPtr[2 * d + 0];
+          this->m_pc[i].Max[d] = boundsPtr[2 * d + 1];
+        }
+      }
+    });
+
     float min[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
       std::numeric_limits<float>::max() };
 
@@ -445,36 +474,7 @@ public:
       -std::numeric_limits<float>::max(),
     };
 
-    for (vtkIdType i = 0; i < size; ++i)
-    {
-      this->m_pc[i].Ind = i;
-
-      double* boundsPtr = cellBounds;
-      if (ctl->CellBounds)
-      {
-        boundsPtr = ctl->CellBounds[i];
-      }
-      else
-      {
-        ds->GetCellBounds(i, boundsPtr);
-      }
-
-      for (int d = 0; d < 3; ++d)
-      {
-        this->m_pc[i].Min[d] = boundsPtr[2 * d + 0];
-        this->m_pc[i].Max[d] = boundsPtr[2 * d + 1];
-
-        if (this->m_pc[i].Min[d] < min[d])
-        {
-          min[d] = this->m_pc[i].Min[d];
-        }
-
-        if (this->m_pc[i].Max[d] > max[d]) /// This can be m_pc[i].max[d] instead of min
-        {
-          max[d] = this->m_pc[i].Max[d];
-        }
-      }
-    }
+    this->FindMinMax(this->m_pc.data(), this->m_pc.data() + size, min, max);
 
     ct.DataBBox[0] = min[0];
     ct.DataBBox[1] = max[0];
@@ -684,18 +684,13 @@ double _getMinDistNEG_Z(const double origin[3], const double dir[3], const doubl
 typedef std::pair<double, int> Intersection;
 
 int vtkCellTreeLocator::IntersectWithLine(const double p1[3], const double p2[3], double tol,
-  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell)
+  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId)
 {
-  int hit = this->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId);
-  if (hit)
-  {
-    this->DataSet->GetCell(cellId, cell);
-  }
-  return hit;
+  return this->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId, this->GenericCell);
 }
 
 int vtkCellTreeLocator::IntersectWithLine(const double p1[3], const double p2[3], double tol,
-  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellIds)
+  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellIds, vtkGenericCell* cell)
 {
   //
   vtkCellTreeNode *node, *near, *far;
@@ -822,7 +817,7 @@ int vtkCellTreeLocator::IntersectWithLine(const double p1[3], const double p2[3]
       ctmax = _tmax;
       if (this->RayMinMaxT(boundsPtr, p1, ray_vec, ctmin, ctmax))
       {
-        if (this->IntersectCellInternal(cell_ID, p1, p2, tol, t_hit, ipt, pcoords, subId))
+        if (this->IntersectCellInternal(cell_ID, p1, p2, tol, t_hit, ipt, pcoords, subId, cell))
         {
           if (t_hit < closest_intersection)
           {
@@ -841,6 +836,7 @@ int vtkCellTreeLocator::IntersectWithLine(const double p1[3], const double p2[3]
   if (HIT)
   {
     t = closest_intersection;
+    this->DataSet->GetCell(cellIds, cell);
   }
   //
   return HIT;
@@ -1226,6 +1222,26 @@ int vtkCellTreeLocator::IntersectCellInternal(vtkIdType cell_ID, const double p1
     const_cast<double*>(p1), const_cast<double*>(p2), tol, t, ipt, pcoords, subId);
 }
 //------------------------------------------------------------------------------
+int vtkCellTreeLocator::IntersectCellInternal(vtkIdType cell_ID, const double p1[3],
+  const double p2[3], const double tol, double& t, double ipt[3], double pcoords[3], int& subId,
+  vtkGenericCell* cell)
+{
+  // Subclasses get the test they may have overridden, one query at a time
+  // unless they say otherwise.
+  if (strcmp(this->GetClassName(), "vtkCellTreeLocator") != 0)
+  {
+    return this->IntersectCellInternal(cell_ID, p1, p2, tol, t, ipt, pcoords, subId);
+  }
+  this->DataSet->GetCell(cell_ID, cell);
+  return cell->IntersectWithLine(
+    const_cast<double*>(p1), const_cast<double*>(p2), tol, t, ipt, pcoords, subId);
+}
+//------------------------------------------------------------------------------
+bool vtkCellTreeLocator::IsIntersectWithLineThreadSafe()
+{
+  return strcmp(this->GetClassName(), "vtkCellTreeLocator") == 0;
+}
+//------------------------------------------------------------------------------
 void vtkCellTreeLocator::FreeSearchStructure()
 {
   delete this->Tree;
@@ -75,6 +75,19 @@ public:
   int IntersectWithLine(const double a0[3], const double a1[3], double tol, double& t, double x[3],
     double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell) override;
 
+  //@{
+  /**
+   * FindCell() and IntersectWithLine() only read the tree once it is built,
+   * so the queries of FindCells() and IntersectWithLines() run in parallel.
+   * Subclasses may override the cell/ray test of IntersectWithLine() with
+   * code that is not thread safe, so IsIntersectWithLineThreadSafe() is only
+   * true for vtkCellTreeLocator itself. Subclasses whose test is thread safe
+   * override it as well.
+   */
+  bool IsFindCellThreadSafe() override { return true; }
+  bool IsIntersectWithLineThreadSafe() override;
+  //@}
+
   /**
    * Return a list of unique cell ids inside of a given bounding box. The
    * user must provide the vtkIdList to populate. This method returns data
@@ -217,6 +230,12 @@ protected:
   virtual int IntersectCellInternal(vtkIdType cell_ID, const double p1[3], const double p2[3],
     const double tol, double& t, double ipt[3], double pcoords[3], int& subId);
 
+  // The cell/ray test called by IntersectWithLine(), with the cell to use.
+  // In subclasses, it calls the test above, which they may have overridden.
+  virtual int IntersectCellInternal(vtkIdType cell_ID, const double p1[3], const double p2[3],
+    const double tol, double& t, double ipt[3], double pcoords[3], int& subId,
+    vtkGenericCell* cell);
+
   int NumberOfBuckets;
 
   vtkCellTree* Tree;
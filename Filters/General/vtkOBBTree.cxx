@@ -23,13 +23,36 @@
 #include "vtkPlane.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 vtkStandardNewMacro(vtkOBBTree);
 
+namespace
+{
+// Whether the cells of the dataset can be traversed from several threads.
+bool CanBuildInParallel(vtkDataSet* dataSet)
+{
+  if (vtkPolyData* polyData = vtkPolyData::SafeDownCast(dataSet))
+  {
+    return polyData->GetVerts()->IsStorageShareable() &&
+      polyData->GetLines()->IsStorageShareable() && polyData->GetPolys()->IsStorageShareable() &&
+      polyData->GetStrips()->IsStorageShareable();
+  }
+  if (vtkUnstructuredGrid* grid = vtkUnstructuredGrid::SafeDownCast(dataSet))
+  {
+    return grid->GetCells()->IsStorageShareable();
+  }
+  return false;
+}
+}
+
 #define vtkCELLTRIANGLES(CELLPTIDS, TYPE, IDX, PTID0, PTID1, PTID2)                                \
   {                                                                                                \
     switch (TYPE)                                                                                  \
@@ -371,7 +394,8 @@ void vtkOBBTree::ComputeOBB(
       if (this->InsertedPoints[ptIds[j]] != this->OBBCount)
       {
         this->InsertedPoints[ptIds[j]] = this->OBBCount;
-        this->PointsList->InsertNextPoint(this->DataSet->GetPoint(ptIds[j]));
+        this->DataSet->GetPoint(ptIds[j], p);
+        this->PointsList->InsertNextPoint(p);
       }
     } // for all points of this cell
   }   // end foreach cell
@@ -1090,7 +1114,31 @@ void vtkOBBTree::BuildLocator()
   }
   this->Tree = new vtkOBBNode;
   this->Level = 0;
-  this->BuildTree(cellList, this->Tree, 0);
+
+  // With several threads, the top levels of the tree are built serially and
+  // the subtrees below them in parallel. Each subtree only depends on its
+  // cells, so the tree is the same as the one built serially.
+  const int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  int parallelLevel = 0;
+  while ((1 << parallelLevel) < 4 * numThreads)
+  {
+    ++parallelLevel;
+  }
+  if (numThreads > 1 && parallelLevel < this->MaxLevel && ::CanBuildInParallel(this->DataSet))
+  {
+    const int maxLevel = this->MaxLevel;
+    const vtkTypeBool retainCellLists = this->RetainCellLists;
+    this->MaxLevel = parallelLevel;
+    this->RetainCellLists = 1;
+    this->BuildTree(cellList, this->Tree, 0);
+    this->MaxLevel = maxLevel;
+    this->RetainCellLists = retainCellLists;
+    this->BuildSubTreesInParallel(parallelLevel);
+  }
+  else
+  {
+    this->BuildTree(cellList, this->Tree, 0);
+  }
 
   vtkDebugMacro(<< "# Cells: " << numCells << ", Deepest tree level: " << this->Level
                 << ", Created: " << this->OBBCount << " OBB nodes");
@@ -1113,6 +1161,70 @@ void vtkOBBTree::BuildLocator()
   this->BuildTime.Modified();
 }
 
+// Continue the building of the leaves of the tree found at the given level,
+// each subtree in its own thread.
+void vtkOBBTree::BuildSubTreesInParallel(int level)
+{
+  std::vector<std::pair<vtkOBBNode*, vtkIdList*>> subTrees;
+  std::vector<std::pair<vtkOBBNode*, int>> nodes(1, std::make_pair(this->Tree, 0));
+  while (!nodes.empty())
+  {
+    vtkOBBNode* node = nodes.back().first;
+    const int nodeLevel = nodes.back().second;
+    nodes.pop_back();
+    if (node->Kids)
+    {
+      nodes.push_back(std::make_pair(node->Kids[1], nodeLevel + 1));
+      nodes.push_back(std::make_pair(node->Kids[0], nodeLevel + 1));
+    }
+    else if (nodeLevel == level && node->Cells->GetNumberOfIds() > this->NumberOfCellsPerNode)
+    {
+      subTrees.push_back(std::make_pair(node, node->Cells));
+      node->Cells = nullptr;
+    }
+    else if (!this->RetainCellLists)
+    {
+      node->Cells->Delete();
+      node->Cells = nullptr;
+    }
+  }
+
+  // Each thread uses its own tree for the scratch data of BuildTree().
+  const vtkIdType numPts = this->DataSet->GetNumberOfPoints();
+  vtkSMPThreadLocalObject<vtkOBBTree> builders;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(subTrees.size()), 1,
+    [&](vtkIdType subTree, vtkIdType endSubTree) {
+      vtkOBBTree* builder = builders.Local();
+      if (!builder->InsertedPoints)
+      {
+        builder->SetDataSet(this->DataSet);
+        builder->MaxLevel = this->MaxLevel;
+        builder->NumberOfCellsPerNode = this->NumberOfCellsPerNode;
+        builder->RetainCellLists = this->RetainCellLists;
+        builder->InsertedPoints = new int[numPts]();
+        builder->PointsList = vtkPoints::New();
+        builder->PointsList->Allocate(numPts);
+      }
+      for (; subTree < endSubTree; ++subTree)
+      {
+        builder->BuildTree(subTrees[subTree].second, subTrees[subTree].first, level);
+      }
+    });
+
+  for (vtkOBBTree* builder : builders)
+  {
+    this->Level = std::max(this->Level, builder->Level);
+    this->OBBCount += builder->OBBCount;
+    delete[] builder->InsertedPoints;
+    builder->InsertedPoints = nullptr;
+    builder->PointsList->Delete();
+    builder->PointsList = nullptr;
+    builder->SetDataSet(nullptr);
+  }
+  // The roots of the subtrees were counted twice.
+  this->OBBCount -= static_cast<int>(subTrees.size());
+}
+
 // NOTE: for better memory usage this recursive method
 // frees its first argument
 void vtkOBBTree::BuildTree(vtkIdList* cells, vtkOBBNode* OBBptr, int level)
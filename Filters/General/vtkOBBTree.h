@@ -29,6 +29,8 @@
  * is found that (approximately) divides the number cells in half. These are
  * then assigned to the children OBB's. This process then continues until
  * the MaxLevel ivar limits the recursion, or no split plane can be found.
+ * When several threads are available, the subtrees below the first levels
+ * are built in parallel; the tree is the same as the one built serially.
  *
  * A good reference for OBB-trees is Gottschalk & Manocha in Proceedings of
  * Siggraph `96.
@@ -120,6 +122,12 @@ public:
   int IntersectWithLine(const double a0[3], const double a1[3], double tol, double& t, double x[3],
     double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell) override;
 
+  /**
+   * IntersectWithLine() only reads the tree once it is built, so the queries
+   * of IntersectWithLines() run in parallel.
+   */
+  bool IsIntersectWithLineThreadSafe() override { return true; }
+
   /**
    * Compute an OBB from the list of points given. Return the corner point
    * and the three axes defining the orientation of the OBB. Also return
@@ -200,6 +208,7 @@ protected:
 
   vtkOBBNode* Tree;
   void BuildTree(vtkIdList* cells, vtkOBBNode* parent, int level);
+  void BuildSubTreesInParallel(int level);
   vtkPoints* PointsList;
   int* InsertedPoints;
   int OBBCount;
@@ -1311,9 +1311,14 @@ void vtkTableBasedClipperVolumeFromVolume::ConstructDataSet(
 
   //
   // Now construct all the points that are along edges and new and add
-  // them to the points list.
+  // them to the points list. The point data are interpolated along all the
+  // edges at once, at the end.
   //
   int nLists = pt_list.GetNumberOfLists();
+  std::vector<vtkIdType> edges;
+  std::vector<double> edgeWeights;
+  edges.reserve(2 * pt_list.GetTotalNumberOfPoints());
+  edgeWeights.reserve(pt_list.GetTotalNumberOfPoints());
   for (i = 0; i < nLists; i++)
   {
     const TableBasedClipperPointEntry* pe_list = nullptr;
@@ -1361,7 +1366,9 @@ void vtkTableBasedClipperVolumeFromVolume::ConstructDataSet(
       pt[1] = pt1[1] * p + pt2[1] * bp;
       pt[2] = pt1[2] * p + pt2[2] * bp;
       outPts->SetPoint(ptIdx, pt);
-      outPD->InterpolateEdge(inPD, ptIdx, pe.ptIds[0], pe.ptIds[1], bp);
+      edges.push_back(pe.ptIds[0]);
+      edges.push_back(pe.ptIds[1]);
+      edgeWeights.push_back(bp);
 
       if (newOrigNodes)
       {
@@ -1371,6 +1378,8 @@ void vtkTableBasedClipperVolumeFromVolume::ConstructDataSet(
       ptIdx++;
     }
   }
+  outPD->InterpolateEdges(inPD, numUsed, static_cast<vtkIdType>(edgeWeights.size()),
+    edges.data(), edgeWeights.data());
 
   //
   // Now construct the new "centroid" points and add them to the points list.
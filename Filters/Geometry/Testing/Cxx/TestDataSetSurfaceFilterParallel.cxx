@@ -0,0 +1,177 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the parallel extraction of the faces of an unstructured grid
+// gives the same output as the serial hash, used with a single thread.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataComparison.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+
+namespace
+{
+const int Resolution = 6;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + (Resolution + 1) * (j + (Resolution + 1) * k);
+}
+
+// A block of cells of several types. When mixed, some faces do not match
+// their neighbor, some cells are duplicated and some points are hidden.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid(bool mixed)
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= Resolution; ++k)
+  {
+    for (int j = 0; j <= Resolution; ++j)
+    {
+      for (int i = 0; i <= Resolution; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->Allocate(2 * Resolution * Resolution * Resolution);
+
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        const vtkIdType hex[8] = { PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k), PointId(i, j, k + 1),
+          PointId(i + 1, j, k + 1), PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        switch ((i + 2 * j + 3 * k) % (mixed ? 5 : 3))
+        {
+          case 0:
+            grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+            break;
+          case 1:
+          {
+            const vtkIdType voxel[8] = { hex[0], hex[1], hex[3], hex[2], hex[4], hex[5], hex[7],
+              hex[6] };
+            grid->InsertNextCell(VTK_VOXEL, 8, voxel);
+            break;
+          }
+          case 2:
+          {
+            const vtkIdType faces[30] = { 4, hex[0], hex[3], hex[2], hex[1], 4, hex[4], hex[5],
+              hex[6], hex[7], 4, hex[0], hex[1], hex[5], hex[4], 4, hex[1], hex[2], hex[6],
+              hex[5], 4, hex[2], hex[3], hex[7], hex[6], 4, hex[3], hex[0], hex[4], hex[7] };
+            grid->InsertNextCell(VTK_POLYHEDRON, 8, hex, 6, faces);
+            break;
+          }
+          case 3:
+          {
+            const vtkIdType wedge1[6] = { hex[0], hex[1], hex[3], hex[4], hex[5], hex[7] };
+            const vtkIdType wedge2[6] = { hex[1], hex[2], hex[3], hex[5], hex[6], hex[7] };
+            grid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+            grid->InsertNextCell(VTK_WEDGE, 6, wedge2);
+            break;
+          }
+          default:
+          {
+            const vtkIdType tetra[4] = { hex[0], hex[1], hex[3], hex[4] };
+            const vtkIdType pyramid[5] = { hex[1], hex[2], hex[6], hex[5], hex[3] };
+            grid->InsertNextCell(VTK_TETRA, 4, tetra);
+            grid->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+            grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  if (mixed)
+  {
+    const vtkIdType line[2] = { PointId(0, 0, 0), PointId(Resolution, Resolution, Resolution) };
+    grid->InsertNextCell(VTK_LINE, 2, line);
+    const vtkIdType quad[4] = { PointId(0, 0, 0), PointId(1, 0, 0), PointId(1, 1, 0),
+      PointId(0, 1, 0) };
+    grid->InsertNextCell(VTK_QUAD, 4, quad);
+
+    vtkNew<vtkUnsignedCharArray> ghosts;
+    ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+    ghosts->SetNumberOfValues(grid->GetNumberOfPoints());
+    for (vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ++ptId)
+    {
+      ghosts->SetValue(ptId, ptId % 17 == 0 ? vtkDataSetAttributes::HIDDENPOINT : 0);
+    }
+    grid->GetPointData()->AddArray(ghosts);
+  }
+
+  vtkNew<vtkDoubleArray> cellScalars;
+  cellScalars->SetName("CellScalars");
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+  {
+    cellScalars->InsertNextValue(static_cast<double>(cellId));
+  }
+  grid->GetCellData()->SetScalars(cellScalars);
+  return grid;
+}
+
+vtkSmartPointer<vtkPolyData> ExtractSurface(vtkUnstructuredGrid* input, int numThreads)
+{
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(input);
+  surface->PassThroughCellIdsOn();
+  surface->PassThroughPointIdsOn();
+  return vtkPolyData::SafeDownCast(
+    vtkTestDataComparison::UpdateWithThreads(surface.GetPointer(), numThreads));
+}
+}
+
+int TestDataSetSurfaceFilterParallel(int, char*[])
+{
+  for (int mixed = 0; mixed < 2; ++mixed)
+  {
+    vtkSmartPointer<vtkUnstructuredGrid> grid = ConstructGrid(mixed != 0);
+    vtkSmartPointer<vtkPolyData> serial = ExtractSurface(grid, 1);
+    vtkSmartPointer<vtkPolyData> parallel = ExtractSurface(grid, 4);
+
+    // The faces of conforming cells match, only the boundary remains.
+    if (!mixed && serial->GetNumberOfPolys() != 6 * Resolution * Resolution)
+    {
+      std::cerr << "Expected " << 6 * Resolution * Resolution << " faces, got "
+                << serial->GetNumberOfPolys() << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!vtkTestDataComparison::SameDataSets(
+          serial, parallel, mixed ? "Surface of mixed cells" : "Surface of conforming cells"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -41,6 +41,9 @@
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridGeometryFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredData.h"
@@ -57,8 +60,11 @@
 #include "vtkVoxel.h"
 #include "vtkWedge.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 static inline int sizeofFastQuad(int numPts)
 {
@@ -76,6 +82,594 @@ static inline int sizeofFastQuad(int numPts)
   }
 }
 
+namespace
+{
+// Rotates the ids of a quad so that a is the smallest one.
+inline void ReorderQuad(vtkIdType& a, vtkIdType& b, vtkIdType& c, vtkIdType& d)
+{
+  vtkIdType tmp;
+  if (b < a && b < c && b < d)
+  {
+    tmp = a;
+    a = b;
+    b = c;
+    c = d;
+    d = tmp;
+  }
+  else if (c < a && c < b && c < d)
+  {
+    tmp = a;
+    a = c;
+    c = tmp;
+    tmp = b;
+    b = d;
+    d = tmp;
+  }
+  else if (d < a && d < b && d < c)
+  {
+    tmp = a;
+    a = d;
+    d = c;
+    c = b;
+    b = tmp;
+  }
+}
+
+// Rotates the ids of a triangle so that a is the smallest one.
+inline void ReorderTri(vtkIdType& a, vtkIdType& b, vtkIdType& c)
+{
+  vtkIdType tmp;
+  if (b < a && b < c)
+  {
+    tmp = a;
+    a = b;
+    b = c;
+    c = tmp;
+  }
+  else if (c < a && c < b)
+  {
+    tmp = a;
+    a = c;
+    c = b;
+    b = tmp;
+  }
+  // We can't put the second smnallest in b because it might change the order
+  // of the vertices in the final triangle.
+}
+
+// Copies the ids of a polygon into tab, starting from the smallest one.
+inline void ReorderPolygon(const vtkIdType* ids, int numPts, vtkIdType* tab)
+{
+  int offset = 0;
+  for (int i = 0; i < numPts; i++)
+  {
+    if (ids[i] < ids[offset])
+    {
+      offset = i;
+    }
+  }
+  for (int i = 0; i < numPts; i++)
+  {
+    tab[i] = ids[(offset + i) % numPts];
+  }
+}
+
+// The following tell whether a reordered face matches a face already in the
+// same bin, i.e. with the same smallest id.
+inline bool MatchQuad(
+  const vtkIdType* entry, int entryNumPts, vtkIdType b, vtkIdType c, vtkIdType d)
+{
+  // c should be independent of point order. Check both orders for b and d.
+  return entryNumPts == 4 && c == entry[2] &&
+    ((b == entry[1] && d == entry[3]) || (b == entry[3] && d == entry[1]));
+}
+
+inline bool MatchTri(const vtkIdType* entry, int entryNumPts, vtkIdType b, vtkIdType c)
+{
+  return entryNumPts == 3 && ((b == entry[1] && c == entry[2]) || (b == entry[2] && c == entry[1]));
+}
+
+inline bool MatchPolygon(const vtkIdType* tab, int numPts, const vtkIdType* entry, int entryNumPts)
+{
+  if (numPts != entryNumPts || tab[0] != entry[0])
+  {
+    return false;
+  }
+  // if the first two points match loop through forwards checking all points
+  if (numPts > 1 && tab[1] == entry[1])
+  {
+    for (int i = 2; i < numPts; ++i)
+    {
+      if (tab[i] != entry[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  // check if the points go in the opposite direction
+  for (int i = 1; i < numPts; ++i)
+  {
+    if (tab[numPts - i] != entry[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Sends the faces of the 3D cells with a fixed face table to a sink, which
+// provides Quad(), Tri() and Polygon() with the signatures of the
+// Insert*InHash() methods. Returns false for other cell types.
+template <typename SinkT>
+bool InsertFixedCellFaces(int cellType, const vtkIdType* ids, vtkIdType cellId, SinkT& sink)
+{
+  switch (cellType)
+  {
+    case VTK_HEXAHEDRON:
+      sink.Quad(ids[0], ids[1], ids[5], ids[4], cellId);
+      sink.Quad(ids[0], ids[3], ids[2], ids[1], cellId);
+      sink.Quad(ids[0], ids[4], ids[7], ids[3], cellId);
+      sink.Quad(ids[1], ids[2], ids[6], ids[5], cellId);
+      sink.Quad(ids[2], ids[3], ids[7], ids[6], cellId);
+      sink.Quad(ids[4], ids[5], ids[6], ids[7], cellId);
+      return true;
+
+    case VTK_VOXEL:
+      sink.Quad(ids[0], ids[1], ids[5], ids[4], cellId);
+      sink.Quad(ids[0], ids[2], ids[3], ids[1], cellId);
+      sink.Quad(ids[0], ids[4], ids[6], ids[2], cellId);
+      sink.Quad(ids[1], ids[3], ids[7], ids[5], cellId);
+      sink.Quad(ids[2], ids[6], ids[7], ids[3], cellId);
+      sink.Quad(ids[4], ids[5], ids[7], ids[6], cellId);
+      return true;
+
+    case VTK_TETRA:
+      sink.Tri(ids[0], ids[1], ids[3], cellId, 2);
+      sink.Tri(ids[0], ids[2], ids[1], cellId, 3);
+      sink.Tri(ids[0], ids[3], ids[2], cellId, 1);
+      sink.Tri(ids[1], ids[2], ids[3], cellId, 0);
+      return true;
+
+    case VTK_PENTAGONAL_PRISM:
+      sink.Quad(ids[0], ids[1], ids[6], ids[5], cellId);
+      sink.Quad(ids[1], ids[2], ids[7], ids[6], cellId);
+      sink.Quad(ids[2], ids[3], ids[8], ids[7], cellId);
+      sink.Quad(ids[3], ids[4], ids[9], ids[8], cellId);
+      sink.Quad(ids[4], ids[0], ids[5], ids[9], cellId);
+      sink.Polygon(ids, 5, cellId);
+      sink.Polygon(&ids[5], 5, cellId);
+      return true;
+
+    case VTK_HEXAGONAL_PRISM:
+      sink.Quad(ids[0], ids[1], ids[7], ids[6], cellId);
+      sink.Quad(ids[1], ids[2], ids[8], ids[7], cellId);
+      sink.Quad(ids[2], ids[3], ids[9], ids[8], cellId);
+      sink.Quad(ids[3], ids[4], ids[10], ids[9], cellId);
+      sink.Quad(ids[4], ids[5], ids[11], ids[10], cellId);
+      sink.Quad(ids[5], ids[0], ids[6], ids[11], cellId);
+      sink.Polygon(ids, 6, cellId);
+      sink.Polygon(&ids[6], 6, cellId);
+      return true;
+
+    case VTK_PYRAMID:
+      sink.Quad(ids[3], ids[2], ids[1], ids[0], cellId);
+      sink.Tri(ids[0], ids[1], ids[4], cellId);
+      sink.Tri(ids[1], ids[2], ids[4], cellId);
+      sink.Tri(ids[2], ids[3], ids[4], cellId);
+      sink.Tri(ids[3], ids[0], ids[4], cellId);
+      return true;
+
+    case VTK_WEDGE:
+      sink.Quad(ids[0], ids[2], ids[5], ids[3], cellId);
+      sink.Quad(ids[1], ids[0], ids[3], ids[4], cellId);
+      sink.Quad(ids[2], ids[1], ids[4], ids[5], cellId);
+      sink.Tri(ids[0], ids[1], ids[2], cellId);
+      sink.Tri(ids[3], ids[5], ids[4], cellId);
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// Sends the faces of any other 3D cell to a sink. Faces of nonlinear cells
+// are skipped when shared with a neighbor. Returns the number of nonlinear
+// faces of unknown type.
+template <typename SinkT>
+int InsertCellFaces(vtkUnstructuredGridBase* input, vtkCell* cell, vtkIdType cellId,
+  int subdivisionLevel, vtkIdList* pts, vtkPoints* coords, SinkT& sink)
+{
+  int numUnknownFaces = 0;
+  const int numFaces = cell->GetNumberOfFaces();
+  if (cell->IsLinear())
+  {
+    for (int j = 0; j < numFaces; j++)
+    {
+      vtkCell* face = cell->GetFace(j);
+      const int numFacePts = face->GetNumberOfPoints();
+      if (numFacePts == 4)
+      {
+        sink.Quad(face->PointIds->GetId(0), face->PointIds->GetId(1), face->PointIds->GetId(2),
+          face->PointIds->GetId(3), cellId);
+      }
+      else if (numFacePts == 3)
+      {
+        sink.Tri(
+          face->PointIds->GetId(0), face->PointIds->GetId(1), face->PointIds->GetId(2), cellId);
+      }
+      else
+      {
+        sink.Polygon(face->PointIds->GetPointer(0), face->PointIds->GetNumberOfIds(), cellId);
+      }
+    }
+    return numUnknownFaces;
+  }
+
+  vtkNew<vtkIdList> cellIds;
+  for (int j = 0; j < numFaces; j++)
+  {
+    vtkCell* face = cell->GetFace(j);
+    input->GetCellNeighbors(cellId, face->PointIds, cellIds);
+    if (cellIds->GetNumberOfIds() > 0)
+    {
+      continue;
+    }
+    // With subdivision, the face is triangulated once, whatever the level.
+    if (subdivisionLevel >= 1)
+    {
+      face->Triangulate(0, pts, coords);
+      for (vtkIdType i = 0; i < pts->GetNumberOfIds(); i += 3)
+      {
+        sink.Tri(pts->GetId(i), pts->GetId(i + 1), pts->GetId(i + 2), cellId);
+      }
+      continue;
+    }
+    switch (face->GetCellType())
+    {
+      case VTK_QUADRATIC_TRIANGLE:
+      case VTK_LAGRANGE_TRIANGLE:
+      case VTK_BEZIER_TRIANGLE:
+        sink.Tri(
+          face->PointIds->GetId(0), face->PointIds->GetId(1), face->PointIds->GetId(2), cellId);
+        break;
+      case VTK_QUADRATIC_QUAD:
+      case VTK_BIQUADRATIC_QUAD:
+      case VTK_QUADRATIC_LINEAR_QUAD:
+      case VTK_LAGRANGE_QUADRILATERAL:
+      case VTK_BEZIER_QUADRILATERAL:
+        sink.Quad(face->PointIds->GetId(0), face->PointIds->GetId(1), face->PointIds->GetId(2),
+          face->PointIds->GetId(3), cellId);
+        break;
+      default:
+        ++numUnknownFaces;
+        break;
+    }
+  }
+  return numUnknownFaces;
+}
+
+// Faces gathered for the parallel extraction of the surface of an
+// unstructured grid. Their points are reordered the way the hash would store
+// them, so that the first point of a face is its bin in the hash.
+struct SurfaceFaces
+{
+  std::vector<vtkIdType> Points;
+  std::vector<vtkIdType> Offsets; // of the points of each face, plus the end
+  std::vector<vtkIdType> CellIds;
+  std::vector<unsigned char> Kinds; // VTK_QUAD, VTK_TRIANGLE or VTK_POLYGON
+
+  vtkIdType GetNumberOfFaces() const { return static_cast<vtkIdType>(this->CellIds.size()); }
+};
+
+// Face sink reordering the faces like the Insert*InHash() methods, and
+// storing them where the derived class tells.
+template <typename DerivedT>
+struct SurfaceFaceSink
+{
+  void Quad(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d, vtkIdType cellId)
+  {
+    ReorderQuad(a, b, c, d);
+    vtkIdType* pts = static_cast<DerivedT*>(this)->AddFace(VTK_QUAD, 4, cellId);
+    pts[0] = a;
+    pts[1] = b;
+    pts[2] = c;
+    pts[3] = d;
+  }
+
+  void Tri(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType cellId, vtkIdType = -1)
+  {
+    ReorderTri(a, b, c);
+    vtkIdType* pts = static_cast<DerivedT*>(this)->AddFace(VTK_TRIANGLE, 3, cellId);
+    pts[0] = a;
+    pts[1] = b;
+    pts[2] = c;
+  }
+
+  void Polygon(const vtkIdType* ids, int numPts, vtkIdType cellId)
+  {
+    if (numPts > 0)
+    {
+      ReorderPolygon(
+        ids, numPts, static_cast<DerivedT*>(this)->AddFace(VTK_POLYGON, numPts, cellId));
+    }
+  }
+};
+
+// Appends the faces at the end of the arrays, for the cells traversed
+// serially.
+struct SurfaceFaceAppender : public SurfaceFaceSink<SurfaceFaceAppender>
+{
+  SurfaceFaces Faces;
+
+  SurfaceFaceAppender() { this->Faces.Offsets.push_back(0); }
+
+  vtkIdType* AddFace(unsigned char kind, int numPts, vtkIdType cellId)
+  {
+    const size_t offset = this->Faces.Points.size();
+    this->Faces.Points.resize(offset + numPts);
+    this->Faces.Offsets.push_back(static_cast<vtkIdType>(offset + numPts));
+    this->Faces.CellIds.push_back(cellId);
+    this->Faces.Kinds.push_back(kind);
+    return &this->Faces.Points[offset];
+  }
+};
+
+// Writes the faces of a cell at the position computed beforehand.
+struct SurfaceFaceWriter : public SurfaceFaceSink<SurfaceFaceWriter>
+{
+  SurfaceFaces& Faces;
+  vtkIdType FaceId;
+  vtkIdType Offset;
+
+  SurfaceFaceWriter(SurfaceFaces& faces, vtkIdType faceId, vtkIdType offset)
+    : Faces(faces)
+    , FaceId(faceId)
+    , Offset(offset)
+  {
+  }
+
+  vtkIdType* AddFace(unsigned char kind, int numPts, vtkIdType cellId)
+  {
+    this->Faces.Offsets[this->FaceId] = this->Offset;
+    this->Faces.CellIds[this->FaceId] = cellId;
+    this->Faces.Kinds[this->FaceId++] = kind;
+    this->Offset += numPts;
+    return &this->Faces.Points[this->Offset - numPts];
+  }
+};
+
+// Only counts the faces of a cell.
+struct SurfaceFaceCounter
+{
+  vtkIdType NumberOfFaces = 0;
+  vtkIdType NumberOfPoints = 0;
+
+  void Quad(vtkIdType, vtkIdType, vtkIdType, vtkIdType, vtkIdType)
+  {
+    ++this->NumberOfFaces;
+    this->NumberOfPoints += 4;
+  }
+  void Tri(vtkIdType, vtkIdType, vtkIdType, vtkIdType, vtkIdType = -1)
+  {
+    ++this->NumberOfFaces;
+    this->NumberOfPoints += 3;
+  }
+  void Polygon(const vtkIdType*, int numPts, vtkIdType)
+  {
+    if (numPts > 0)
+    {
+      ++this->NumberOfFaces;
+      this->NumberOfPoints += numPts;
+    }
+  }
+};
+
+// Tells whether a face is hidden by a face of the same bin inserted before,
+// as the corresponding Insert*InHash() method would.
+inline bool MatchFace(const SurfaceFaces& faces, vtkIdType faceId, vtkIdType entryId)
+{
+  const vtkIdType* pts = faces.Points.data() + faces.Offsets[faceId];
+  const vtkIdType* entryPts = faces.Points.data() + faces.Offsets[entryId];
+  const int numPts = static_cast<int>(faces.Offsets[faceId + 1] - faces.Offsets[faceId]);
+  const int entryNumPts = static_cast<int>(faces.Offsets[entryId + 1] - faces.Offsets[entryId]);
+  switch (faces.Kinds[faceId])
+  {
+    case VTK_QUAD:
+      return MatchQuad(entryPts, entryNumPts, pts[1], pts[2], pts[3]);
+    case VTK_TRIANGLE:
+      return MatchTri(entryPts, entryNumPts, pts[1], pts[2]);
+    default:
+      return MatchPolygon(pts, numPts, entryPts, entryNumPts);
+  }
+}
+
+// Cells whose faces are gathered in parallel.
+inline bool HasFixedFaces(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+    case VTK_TETRA:
+    case VTK_PENTAGONAL_PRISM:
+    case VTK_HEXAGONAL_PRISM:
+    case VTK_PYRAMID:
+    case VTK_WEDGE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Gathers in parallel the faces of the 3D cells of an unstructured grid with
+// a fixed face table, along with the faces already gathered for the other 3D
+// cells, and returns the external ones in the order of the hash traversal:
+// by bin, then in insertion order. Each bin is matched by a single thread,
+// in insertion order, so a face is hidden by the same face as in the hash.
+void ComputeExternalFaces(vtkUnstructuredGrid* input, const SurfaceFaces& otherFaces,
+  SurfaceFaces& faces, std::vector<vtkIdType>& externalFaces)
+{
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  vtkCellArray* cells = input->GetCells();
+  // Without a copy of the connectivity, direct access to it is thread safe.
+  const bool shareable = cells->IsStorageShareable();
+  vtkSMPThreadLocalObject<vtkIdList> localCellPts;
+  auto getCellPoints = [&](vtkIdType cellId, vtkIdList* cellPts) -> const vtkIdType* {
+    if (shareable)
+    {
+      vtkIdType npts;
+      const vtkIdType* pts;
+      cells->GetCellAtId(cellId, npts, pts);
+      return pts;
+    }
+    cells->GetCellAtId(cellId, cellPts);
+    return cellPts->GetPointer(0);
+  };
+
+  // Count the faces of each cell, then scan to get where they go.
+  std::vector<vtkIdType> faceOffsets(numCells + 1, 0);
+  std::vector<vtkIdType> pointOffsets(numCells + 1, 0);
+  const vtkIdType numOtherFaces = otherFaces.GetNumberOfFaces();
+  for (vtkIdType faceId = 0; faceId < numOtherFaces; ++faceId)
+  {
+    const vtkIdType cellId = otherFaces.CellIds[faceId];
+    ++faceOffsets[cellId];
+    pointOffsets[cellId] += otherFaces.Offsets[faceId + 1] - otherFaces.Offsets[faceId];
+  }
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    vtkIdList* cellPts = localCellPts.Local();
+    for (; cellId < endCellId; ++cellId)
+    {
+      const int cellType = input->GetCellType(cellId);
+      if (HasFixedFaces(cellType))
+      {
+        SurfaceFaceCounter counter;
+        InsertFixedCellFaces(cellType, getCellPoints(cellId, cellPts), cellId, counter);
+        faceOffsets[cellId] = counter.NumberOfFaces;
+        pointOffsets[cellId] = counter.NumberOfPoints;
+      }
+    }
+  });
+  vtkSMPTools::ExclusiveScan(
+    faceOffsets.begin(), faceOffsets.end(), faceOffsets.begin(), vtkIdType(0));
+  vtkSMPTools::ExclusiveScan(
+    pointOffsets.begin(), pointOffsets.end(), pointOffsets.begin(), vtkIdType(0));
+
+  const vtkIdType numFaces = faceOffsets[numCells];
+  faces.Points.resize(pointOffsets[numCells]);
+  faces.Offsets.resize(numFaces + 1);
+  faces.Offsets[numFaces] = pointOffsets[numCells];
+  faces.CellIds.resize(numFaces);
+  faces.Kinds.resize(numFaces);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    vtkIdList* cellPts = localCellPts.Local();
+    for (; cellId < endCellId; ++cellId)
+    {
+      const int cellType = input->GetCellType(cellId);
+      if (HasFixedFaces(cellType))
+      {
+        SurfaceFaceWriter writer(faces, faceOffsets[cellId], pointOffsets[cellId]);
+        InsertFixedCellFaces(cellType, getCellPoints(cellId, cellPts), cellId, writer);
+      }
+    }
+  });
+  // The faces of a cell are contiguous in the other faces.
+  for (vtkIdType otherId = 0; otherId < numOtherFaces;)
+  {
+    const vtkIdType cellId = otherFaces.CellIds[otherId];
+    SurfaceFaceWriter writer(faces, faceOffsets[cellId], pointOffsets[cellId]);
+    for (; otherId < numOtherFaces && otherFaces.CellIds[otherId] == cellId; ++otherId)
+    {
+      const vtkIdType* otherPts = otherFaces.Points.data() + otherFaces.Offsets[otherId];
+      const int numFacePts =
+        static_cast<int>(otherFaces.Offsets[otherId + 1] - otherFaces.Offsets[otherId]);
+      std::copy(otherPts, otherPts + numFacePts,
+        writer.AddFace(otherFaces.Kinds[otherId], numFacePts, cellId));
+    }
+  }
+
+  // Counting sort of the faces by bin. The faces of a bin are then sorted
+  // back in insertion order.
+  const vtkIdType* points = faces.Points.data();
+  const vtkIdType* offsets = faces.Offsets.data();
+  std::unique_ptr<std::atomic<vtkIdType>[]> binCursors(new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType bin, vtkIdType endBin) {
+    for (; bin < endBin; ++bin)
+    {
+      binCursors[bin].store(0, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numFaces, [&](vtkIdType faceId, vtkIdType endFaceId) {
+    for (; faceId < endFaceId; ++faceId)
+    {
+      binCursors[points[offsets[faceId]]].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  std::vector<vtkIdType> binOffsets(numPts + 1, 0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType bin, vtkIdType endBin) {
+    for (; bin < endBin; ++bin)
+    {
+      binOffsets[bin] = binCursors[bin].load(std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::ExclusiveScan(
+    binOffsets.begin(), binOffsets.end(), binOffsets.begin(), vtkIdType(0));
+  vtkSMPTools::For(0, numPts, [&](vtkIdType bin, vtkIdType endBin) {
+    for (; bin < endBin; ++bin)
+    {
+      binCursors[bin].store(binOffsets[bin], std::memory_order_relaxed);
+    }
+  });
+  std::vector<vtkIdType> sortedFaces(numFaces);
+  vtkSMPTools::For(0, numFaces, [&](vtkIdType faceId, vtkIdType endFaceId) {
+    for (; faceId < endFaceId; ++faceId)
+    {
+      sortedFaces[binCursors[points[offsets[faceId]]].fetch_add(1, std::memory_order_relaxed)] =
+        faceId;
+    }
+  });
+
+  // Match the faces of each bin in insertion order: a face matching a face
+  // inserted before hides it, and is discarded.
+  std::vector<unsigned char> visible(numFaces, 0);
+  std::vector<unsigned char> discarded(numFaces, 0);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType bin, vtkIdType endBin) {
+    for (; bin < endBin; ++bin)
+    {
+      const vtkIdType begin = binOffsets[bin];
+      const vtkIdType end = binOffsets[bin + 1];
+      std::sort(sortedFaces.begin() + begin, sortedFaces.begin() + end);
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        visible[i] = 1;
+        for (vtkIdType j = begin; j < i; ++j)
+        {
+          if (!discarded[j] && MatchFace(faces, sortedFaces[i], sortedFaces[j]))
+          {
+            // Hide any face shared by two or more cells.
+            visible[j] = 0;
+            visible[i] = 0;
+            discarded[i] = 1;
+            break;
+          }
+        }
+      }
+    }
+  });
+
+  externalFaces.clear();
+  for (vtkIdType i = 0; i < numFaces; ++i)
+  {
+    if (visible[i])
+    {
+      externalFaces.push_back(sortedFaces[i]);
+    }
+  }
+}
+}
+
 class vtkDataSetSurfaceFilter::vtkEdgeInterpolationMap
 {
 public:
@@ -1536,7 +2130,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet* dataSetInput, v
   vtkIdList* pointIdList;
   vtkIdType* pointIdArray;
   vtkIdType* pointIdArrayEnd;
-  int numFacePts, numCellPts;
+  int numCellPts;
   vtkIdType inPtId, outPtId;
   vtkPointData* inputPD = input->GetPointData();
   vtkCellData* inputCD = input->GetCellData();
@@ -1553,9 +2147,32 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet* dataSetInput, v
   // These are for the default case/
   vtkIdList* pts;
   vtkPoints* coords;
-  vtkCell* face;
   int flag2D = 0;
 
+  // The faces of 3D cells go into the hash, except for grids when several
+  // threads are available: they are then gathered and matched in parallel
+  // once all cells are traversed, with the same result.
+  vtkUnstructuredGrid* grid = vtkSMPTools::GetEstimatedNumberOfThreads() > 1
+    ? vtkUnstructuredGrid::SafeDownCast(input)
+    : nullptr;
+  SurfaceFaceAppender gridFaces;
+  struct HashSink
+  {
+    vtkDataSetSurfaceFilter* Self;
+    void Quad(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d, vtkIdType cellId)
+    {
+      this->Self->InsertQuadInHash(a, b, c, d, cellId);
+    }
+    void Tri(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType cellId, vtkIdType faceId = -1)
+    {
+      this->Self->InsertTriInHash(a, b, c, cellId, faceId);
+    }
+    void Polygon(const vtkIdType* ids, int numPts, vtkIdType cellId)
+    {
+      this->Self->InsertPolygonInHash(ids, numPts, cellId);
+    }
+  } hashSink = { this };
+
   // These are for subdividing quadratic cells
   vtkDoubleArray* parametricCoords;
   vtkDoubleArray* parametricCoords2;
@@ -1707,79 +2324,17 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet* dataSetInput, v
         break;
 
       case VTK_HEXAHEDRON:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[5], ids[4], cellId);
-        this->InsertQuadInHash(ids[0], ids[3], ids[2], ids[1], cellId);
-        this->InsertQuadInHash(ids[0], ids[4], ids[7], ids[3], cellId);
-        this->InsertQuadInHash(ids[1], ids[2], ids[6], ids[5], cellId);
-        this->InsertQuadInHash(ids[2], ids[3], ids[7], ids[6], cellId);
-        this->InsertQuadInHash(ids[4], ids[5], ids[6], ids[7], cellId);
-        break;
-
       case VTK_VOXEL:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[5], ids[4], cellId);
-        this->InsertQuadInHash(ids[0], ids[2], ids[3], ids[1], cellId);
-        this->InsertQuadInHash(ids[0], ids[4], ids[6], ids[2], cellId);
-        this->InsertQuadInHash(ids[1], ids[3], ids[7], ids[5], cellId);
-        this->InsertQuadInHash(ids[2], ids[6], ids[7], ids[3], cellId);
-        this->InsertQuadInHash(ids[4], ids[5], ids[7], ids[6], cellId);
-        break;
-
       case VTK_TETRA:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertTriInHash(ids[0], ids[1], ids[3], cellId, 2);
-        this->InsertTriInHash(ids[0], ids[2], ids[1], cellId, 3);
-        this->InsertTriInHash(ids[0], ids[3], ids[2], cellId, 1);
-        this->InsertTriInHash(ids[1], ids[2], ids[3], cellId, 0);
-        break;
-
       case VTK_PENTAGONAL_PRISM:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[6], ids[5], cellId);
-        this->InsertQuadInHash(ids[1], ids[2], ids[7], ids[6], cellId);
-        this->InsertQuadInHash(ids[2], ids[3], ids[8], ids[7], cellId);
-        this->InsertQuadInHash(ids[3], ids[4], ids[9], ids[8], cellId);
-        this->InsertQuadInHash(ids[4], ids[0], ids[5], ids[9], cellId);
-        this->InsertPolygonInHash(ids, 5, cellId);
-        this->InsertPolygonInHash(&ids[5], 5, cellId);
-        break;
-
       case VTK_HEXAGONAL_PRISM:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[7], ids[6], cellId);
-        this->InsertQuadInHash(ids[1], ids[2], ids[8], ids[7], cellId);
-        this->InsertQuadInHash(ids[2], ids[3], ids[9], ids[8], cellId);
-        this->InsertQuadInHash(ids[3], ids[4], ids[10], ids[9], cellId);
-        this->InsertQuadInHash(ids[4], ids[5], ids[11], ids[10], cellId);
-        this->InsertQuadInHash(ids[5], ids[0], ids[6], ids[11], cellId);
-        this->InsertPolygonInHash(ids, 6, cellId);
-        this->InsertPolygonInHash(&ids[6], 6, cellId);
-        break;
-
       case VTK_PYRAMID:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[3], ids[2], ids[1], ids[0], cellId);
-        this->InsertTriInHash(ids[0], ids[1], ids[4], cellId);
-        this->InsertTriInHash(ids[1], ids[2], ids[4], cellId);
-        this->InsertTriInHash(ids[2], ids[3], ids[4], cellId);
-        this->InsertTriInHash(ids[3], ids[0], ids[4], cellId);
-        break;
-
       case VTK_WEDGE:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[2], ids[5], ids[3], cellId);
-        this->InsertQuadInHash(ids[1], ids[0], ids[3], ids[4], cellId);
-        this->InsertQuadInHash(ids[2], ids[1], ids[4], ids[5], cellId);
-        this->InsertTriInHash(ids[0], ids[1], ids[2], cellId);
-        this->InsertTriInHash(ids[3], ids[5], ids[4], cellId);
+        // The faces of these cells are gathered in parallel for grids.
+        if (!grid)
+        {
+          InsertFixedCellFaces(cellType, cellIter->GetPointIds()->GetPointer(0), cellId, hashSink);
+        }
         break;
 
       case VTK_PIXEL:
@@ -1808,35 +2363,12 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet* dataSetInput, v
         cellIter->GetCell(cell);
         if (cell->IsLinear())
         {
-          if (cell->GetCellDimension() == 3)
-          {
-            int numFaces = cell->GetNumberOfFaces();
-            for (j = 0; j < numFaces; j++)
-            {
-              face = cell->GetFace(j);
-              numFacePts = face->GetNumberOfPoints();
-              if (numFacePts == 4)
-              {
-                this->InsertQuadInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
-                  face->PointIds->GetId(2), face->PointIds->GetId(3), cellId);
-              }
-              else if (numFacePts == 3)
-              {
-                this->InsertTriInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
-                  face->PointIds->GetId(2), cellId);
-              }
-              else
-              {
-                this->InsertPolygonInHash(
-                  face->PointIds->GetPointer(0), face->PointIds->GetNumberOfIds(), cellId);
-              }
-            } // for all cell faces
-          }   // if 3D
-          else
+          if (cell->GetCellDimension() != 3)
           {
             vtkDebugMacro("Missing cell type.");
+            break;
           }
-        }    // a linear cell type
+        }
         else // process nonlinear cells via triangulation
         {
           input->SetCellOrderAndRationalWeights(cellId, cell);
@@ -1855,62 +2387,25 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet* dataSetInput, v
               outPtId = this->GetOutputPointId(inPtId, input, newPts, outputPD);
               newLines->InsertCellPoint(outPtId);
             }
+            break;
           }
           else if (cell->GetCellDimension() == 2)
           {
             vtkWarningMacro(<< "2-D nonlinear cells must be processed with all other 2-D cells.");
+            break;
           }
-          else // 3D nonlinear cell
-          {
-            vtkIdList* cellIds = vtkIdList::New();
-            int numFaces = cell->GetNumberOfFaces();
-            for (j = 0; j < numFaces; j++)
-            {
-              face = cell->GetFace(j);
-              input->GetCellNeighbors(cellId, face->PointIds, cellIds);
-              if (cellIds->GetNumberOfIds() <= 0)
-              {
-                // FIXME: Face could not be consistent. vtkOrderedTriangulator is a better option
-                if (this->NonlinearSubdivisionLevel >= 1)
-                {
-                  // TODO: Handle NonlinearSubdivisionLevel > 1 correctly.
-                  face->Triangulate(0, pts, coords);
-                  for (i = 0; i < pts->GetNumberOfIds(); i += 3)
-                  {
-                    this->InsertTriInHash(
-                      pts->GetId(i), pts->GetId(i + 1), pts->GetId(i + 2), cellId);
-                  }
-                }
-                else
-                {
-                  switch (face->GetCellType())
-                  {
-                    case VTK_QUADRATIC_TRIANGLE:
-                    case VTK_LAGRANGE_TRIANGLE:
-                    case VTK_BEZIER_TRIANGLE:
-                      this->InsertTriInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
-                        face->PointIds->GetId(2), cellId);
-                      break;
-                    case VTK_QUADRATIC_QUAD:
-                    case VTK_BIQUADRATIC_QUAD:
-                    case VTK_QUADRATIC_LINEAR_QUAD:
-                    case VTK_LAGRANGE_QUADRILATERAL:
-                    case VTK_BEZIER_QUADRILATERAL:
-                      this->InsertQuadInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
-                        face->PointIds->GetId(2), face->PointIds->GetId(3), cellId);
-                      break;
-                    default:
-                      vtkWarningMacro(<< "Encountered unknown nonlinear face.");
-                      break;
-                  } // switch cell type
-                }   // subdivision level
-              }     // cell has ids
-            }       // for faces
-            cellIds->Delete();
-          } // 3d cell
-        }   // nonlinear cell
-      }     // default switch case
-    }       // switch(cellType)
+        }
+        // 3D cell, its faces are hashed or gathered in order with the others.
+        int numUnknownFaces = grid ? InsertCellFaces(input, cell, cellId,
+                                       this->NonlinearSubdivisionLevel, pts, coords, gridFaces)
+                                   : InsertCellFaces(input, cell, cellId,
+                                       this->NonlinearSubdivisionLevel, pts, coords, hashSink);
+        if (numUnknownFaces > 0)
+        {
+          vtkWarningMacro(<< "Encountered unknown nonlinear face.");
+        }
+      } // default switch case
+    }   // switch(cellType)
   }         // for all cells.
 
   // It would be possible to add these (except for polygons with 5+ sides)
@@ -2194,6 +2689,42 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet* dataSetInput, v
     }
   } // for all cells.
 
+  if (grid && !abort)
+  {
+    // Transfer the external faces to the output, in the order of the hash.
+    SurfaceFaces faces;
+    std::vector<vtkIdType> externalFaces;
+    ComputeExternalFaces(grid, gridFaces.Faces, faces, externalFaces);
+    for (vtkIdType faceId : externalFaces)
+    {
+      vtkIdType* facePts = faces.Points.data() + faces.Offsets[faceId];
+      const int numFacePts = static_cast<int>(faces.Offsets[faceId + 1] - faces.Offsets[faceId]);
+      const vtkIdType cellId = faces.CellIds[faceId];
+      bool oneHidden = false;
+      for (i = 0; i < numFacePts; i++)
+      {
+        if (ghosts)
+        {
+          unsigned char val = ghosts->GetValue(facePts[i]);
+          if (val & vtkDataSetAttributes::HIDDENPOINT)
+          {
+            oneHidden = true;
+          }
+        }
+
+        facePts[i] = this->GetOutputPointId(facePts[i], input, newPts, outputPD);
+      }
+
+      if (oneHidden)
+      {
+        continue;
+      }
+      newPolys->InsertNextCell(numFacePts, facePts);
+      this->RecordOrigCellId(this->NumberOfNewCells, cellId);
+      outputCD->CopyData(inputCD, cellId, this->NumberOfNewCells++);
+    }
+  }
+
   // Now transfer geometry from hash to output (only triangles and quads).
   this->InitQuadHashTraversal();
   while ((q = this->GetNextVisibleQuadFromHash()))
@@ -2329,35 +2860,10 @@ void vtkDataSetSurfaceFilter::DeleteQuadHash()
 void vtkDataSetSurfaceFilter::InsertQuadInHash(
   vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d, vtkIdType sourceId)
 {
-  vtkIdType tmp;
   vtkFastGeomQuad *quad, **end;
 
   // Reorder to get smallest id in a.
-  if (b < a && b < c && b < d)
-  {
-    tmp = a;
-    a = b;
-    b = c;
-    c = d;
-    d = tmp;
-  }
-  else if (c < a && c < b && c < d)
-  {
-    tmp = a;
-    a = c;
-    c = tmp;
-    tmp = b;
-    b = d;
-    d = tmp;
-  }
-  else if (d < a && d < b && d < c)
-  {
-    tmp = a;
-    a = d;
-    d = c;
-    c = b;
-    b = tmp;
-  }
+  ReorderQuad(a, b, c, d);
 
   // Look for existing quad in the hash;
   end = this->QuadHash + a;
@@ -2366,18 +2872,12 @@ void vtkDataSetSurfaceFilter::InsertQuadInHash(
   {
     end = &(quad->Next);
     // a has to match in this bin.
-    // c should be independent of point order.
-    if (quad->numPts == 4 && c == quad->ptArray[2])
+    if (MatchQuad(quad->ptArray, quad->numPts, b, c, d))
     {
-      // Check both orders for b and d.
-      if ((b == quad->ptArray[1] && d == quad->ptArray[3]) ||
-        (b == quad->ptArray[3] && d == quad->ptArray[1]))
-      {
-        // We have a match.
-        quad->SourceId = -1;
-        // That is all we need to do.  Hide any quad shared by two or more cells.
-        return;
-      }
+      // We have a match.
+      quad->SourceId = -1;
+      // That is all we need to do.  Hide any quad shared by two or more cells.
+      return;
     }
     quad = *end;
   }
@@ -2397,26 +2897,10 @@ void vtkDataSetSurfaceFilter::InsertQuadInHash(
 void vtkDataSetSurfaceFilter::InsertTriInHash(
   vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType sourceId, vtkIdType vtkNotUsed(faceId) /*= -1*/)
 {
-  vtkIdType tmp;
   vtkFastGeomQuad *quad, **end;
 
   // Reorder to get smallest id in a.
-  if (b < a && b < c)
-  {
-    tmp = a;
-    a = b;
-    b = c;
-    c = tmp;
-  }
-  else if (c < a && c < b)
-  {
-    tmp = a;
-    a = c;
-    c = b;
-    b = tmp;
-  }
-  // We can't put the second smnallest in b because it might change the order
-  // of the vertices in the final triangle.
+  ReorderTri(a, b, c);
 
   // Look for existing tri in the hash;
   end = this->QuadHash + a;
@@ -2425,16 +2909,12 @@ void vtkDataSetSurfaceFilter::InsertTriInHash(
   {
     end = &(quad->Next);
     // a has to match in this bin.
-    if (quad->numPts == 3)
+    if (MatchTri(quad->ptArray, quad->numPts, b, c))
     {
-      if ((b == quad->ptArray[1] && c == quad->ptArray[2]) ||
-        (b == quad->ptArray[2] && c == quad->ptArray[1]))
-      {
-        // We have a match.
-        quad->SourceId = -1;
-        // That is all we need to do. Hide any tri shared by two or more cells.
-        return;
-      }
+      // We have a match.
+      quad->SourceId = -1;
+      // That is all we need to do. Hide any tri shared by two or more cells.
+      return;
     }
     quad = *end;
   }
@@ -2465,22 +2945,9 @@ void vtkDataSetSurfaceFilter::InsertPolygonInHash(
   }
   vtkFastGeomQuad *quad, **end;
 
-  // find the index to the smallest id
-  vtkIdType offset = 0;
-  for (int i = 0; i < numPts; i++)
-  {
-    if (ids[i] < ids[offset])
-    {
-      offset = i;
-    }
-  }
-
   // copy ids into ordered array with smallest id first
   vtkIdType* tab = new vtkIdType[numPts];
-  for (int i = 0; i < numPts; i++)
-  {
-    tab[i] = ids[(offset + i) % numPts];
-  }
+  ReorderPolygon(ids, numPts, tab);
 
   // Look for existing hex in the hash;
   end = this->QuadHash + tab[0];
@@ -2489,49 +2956,7 @@ void vtkDataSetSurfaceFilter::InsertPolygonInHash(
   {
     end = &(quad->Next);
     // a has to match in this bin.
-    // first just check the polygon size.
-    bool match = true;
-    if (numPts == quad->numPts)
-    {
-      if (tab[0] == quad->ptArray[0])
-      {
-        // if the first two points match loop through forwards
-        // checking all points
-        if (numPts > 1 && tab[1] == quad->ptArray[1])
-        {
-          for (int i = 2; i < numPts; ++i)
-          {
-            if (tab[i] != quad->ptArray[i])
-            {
-              match = false;
-              break;
-            }
-          }
-        }
-        else
-        {
-          // check if the points go in the opposite direction
-          for (int i = 1; i < numPts; ++i)
-          {
-            if (tab[numPts - i] != quad->ptArray[i])
-            {
-              match = false;
-              break;
-            }
-          }
-        }
-      }
-      else
-      {
-        match = false;
-      }
-    }
-    else
-    {
-      match = false;
-    }
-
-    if (match)
+    if (MatchPolygon(tab, numPts, quad->ptArray, quad->numPts))
     {
       // We have a match.
       quad->SourceId = -1;
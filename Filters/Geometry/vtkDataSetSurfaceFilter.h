@@ -21,6 +21,12 @@
  * vtkGeometryFilter.  It only has one option: whether to use triangle strips
  * when the input type is structured.
  *
+ * When several vtkSMPTools threads are available, the external faces of
+ * vtkUnstructuredGrid inputs are found in parallel: the faces are sorted by
+ * their smallest point id, and each of these bins is matched by one thread.
+ * The output is the same as with the serial hash, whatever the number of
+ * threads. The virtual Insert*InHash() methods are not called in that case.
+ *
  * @sa
  * vtkGeometryFilter vtkStructuredGridGeometryFilter.
  */
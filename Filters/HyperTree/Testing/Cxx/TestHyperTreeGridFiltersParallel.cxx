@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestHyperTreeGridFiltersParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the hyper tree grid filters which process their trees in
+// several threads give the same outputs with one and with four threads, on
+// masked grids with more trees than a chunk.
+
+#include "vtkBitArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSet.h"
+#include "vtkHyperTreeGrid.h"
+#include "vtkHyperTreeGridAlgorithm.h"
+#include "vtkHyperTreeGridContour.h"
+#include "vtkHyperTreeGridGeometry.h"
+#include "vtkHyperTreeGridPlaneCutter.h"
+#include "vtkHyperTreeGridSource.h"
+#include "vtkHyperTreeGridThreshold.h"
+#include "vtkHyperTreeGridToUnstructuredGrid.h"
+#include "vtkNew.h"
+#include "vtkQuadric.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataComparison.h"
+
+#include <iostream>
+
+namespace
+{
+vtkSmartPointer<vtkHyperTreeGrid> MakeGrid(int dimension)
+{
+  vtkNew<vtkHyperTreeGridSource> source;
+  source->SetMaxDepth(4);
+  source->SetDimensions(8, 7, dimension == 3 ? 6 : 1);
+  source->SetGridScale(1.5, 1., .7);
+  source->SetBranchFactor(dimension == 3 ? 3 : 2);
+  source->UseDescriptorOff();
+  source->UseMaskOn();
+  vtkNew<vtkQuadric> quadric;
+  quadric->SetCoefficients(1., 1., 1., 0, 0., 0., 0.0, 0., 0., -25.);
+  source->SetQuadric(quadric);
+  source->Update();
+  vtkSmartPointer<vtkHyperTreeGrid> htg = vtkSmartPointer<vtkHyperTreeGrid>::New();
+  htg->ShallowCopy(source->GetOutput());
+  htg->GetCellData()->SetScalars(htg->GetCellData()->GetArray("Depth"));
+  return htg;
+}
+
+bool SameGrids(vtkHyperTreeGrid* output1, vtkHyperTreeGrid* output2, const char* name)
+{
+  if (output1->GetNumberOfVertices() != output2->GetNumberOfVertices() ||
+    output1->GetNumberOfLeaves() != output2->GetNumberOfLeaves())
+  {
+    std::cerr << name << ": the numbers of vertices or leaves differ" << std::endl;
+    return false;
+  }
+  vtkBitArray* mask1 = output1->GetMask();
+  vtkBitArray* mask2 = output2->GetMask();
+  if (!mask1 || !mask2 || mask1->GetNumberOfTuples() != output1->GetNumberOfVertices())
+  {
+    std::cerr << name << ": wrong mask" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < mask1->GetNumberOfTuples(); ++i)
+  {
+    if (mask1->GetValue(i) != mask2->GetValue(i))
+    {
+      std::cerr << name << ": the masks differ at vertex " << i << std::endl;
+      return false;
+    }
+  }
+  return vtkTestDataComparison::SameFieldData(output1->GetCellData(), output2->GetCellData(), name);
+}
+
+vtkIdType NumberOfMaskedVertices(vtkHyperTreeGrid* grid)
+{
+  vtkBitArray* mask = grid->GetMask();
+  vtkIdType numMasked = 0;
+  for (vtkIdType i = 0; mask && i < mask->GetNumberOfTuples(); ++i)
+  {
+    numMasked += mask->GetValue(i);
+  }
+  return numMasked;
+}
+
+// Compares the outputs with one and four threads, and the number of cells of
+// the data sets, or of masked vertices of the grids, to the serial result.
+bool TestFilter(vtkHyperTreeGridAlgorithm* filter, const char* name, vtkIdType expectedSize)
+{
+  vtkSmartPointer<vtkDataObject> output1 = vtkTestDataComparison::UpdateWithThreads(filter, 1);
+  vtkSmartPointer<vtkDataObject> output4 = vtkTestDataComparison::UpdateWithThreads(filter, 4);
+  vtkHyperTreeGrid* grid1 = vtkHyperTreeGrid::SafeDownCast(output1);
+  vtkDataSet* dataSet1 = vtkDataSet::SafeDownCast(output1);
+  const vtkIdType size = grid1 ? NumberOfMaskedVertices(grid1) : dataSet1->GetNumberOfCells();
+  if (size != expectedSize)
+  {
+    std::cerr << name << ": " << size << " cells or masked vertices instead of " << expectedSize
+              << std::endl;
+    return false;
+  }
+  if (grid1)
+  {
+    return SameGrids(grid1, vtkHyperTreeGrid::SafeDownCast(output4), name);
+  }
+  return vtkTestDataComparison::SameDataSets(dataSet1, vtkDataSet::SafeDownCast(output4), name);
+}
+}
+
+int TestHyperTreeGridFiltersParallel(int, char*[])
+{
+  for (int dimension : { 2, 3 })
+  {
+    vtkSmartPointer<vtkHyperTreeGrid> htg = MakeGrid(dimension);
+    const bool is2D = (dimension == 2);
+
+    vtkNew<vtkHyperTreeGridToUnstructuredGrid> toUnstructured;
+    toUnstructured->SetInputData(htg);
+    if (!TestFilter(toUnstructured, "ToUnstructuredGrid", is2D ? 69 : 36373))
+    {
+      return EXIT_FAILURE;
+    }
+
+    vtkNew<vtkHyperTreeGridGeometry> geometry;
+    geometry->SetInputData(htg);
+    for (bool merging : { false, true })
+    {
+      geometry->SetMerging(merging);
+      if (!TestFilter(geometry, merging ? "Merged geometry" : "Geometry", is2D ? 69 : 61796))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+
+    vtkNew<vtkHyperTreeGridThreshold> threshold;
+    threshold->SetInputData(htg);
+    threshold->SetLowerThreshold(1.);
+    threshold->SetUpperThreshold(2.);
+    for (bool justMask : { false, true })
+    {
+      threshold->SetJustCreateNewMask(justMask);
+      if (!TestFilter(threshold, justMask ? "Threshold mask" : "Threshold", is2D ? 250 : 104651))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+
+    vtkNew<vtkHyperTreeGridContour> contour;
+    contour->SetInputData(htg);
+    contour->SetNumberOfContours(2);
+    contour->SetValue(0, 1.5);
+    contour->SetValue(1, 2.5);
+    if (!TestFilter(contour, "Contour", is2D ? 13 : 350))
+    {
+      return EXIT_FAILURE;
+    }
+
+    if (!is2D)
+    {
+      vtkNew<vtkHyperTreeGridPlaneCutter> cutter;
+      cutter->SetInputData(htg);
+      cutter->SetPlane(1., -.2, .2, 3.);
+      if (!TestFilter(cutter, "Plane cutter", 12))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -38,9 +38,14 @@
 #include "vtkPixel.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkVoxel.h"
 
+#include <algorithm>
+#include <vector>
+
 static const unsigned int MooreCursors1D[2] = { 0, 2 };
 static const unsigned int MooreCursors2D[8] = { 0, 1, 2, 3, 5, 6, 7, 8 };
 static const unsigned int MooreCursors3D[26] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 14, 15,
@@ -364,16 +369,80 @@ int vtkHyperTreeGridContour::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObject
     this->RecursivelyPreProcessTree(cursor);
   } // it
 
-  // Second pass across tree roots: now compute isocontours recursively
-  input->InitializeTreeIterator(it);
-  vtkNew<vtkHyperTreeGridNonOrientedMooreSuperCursor> supercursor;
-  while (it.GetNextTree(index))
+  // Second pass across tree roots: now compute isocontours recursively, by
+  // chunks of trees in several threads when points are merged exactly
+  std::vector<vtkIdType> indices;
+  vtkHyperTreeGridAlgorithm::GetTreeIndices(input, indices);
+  const vtkIdType numTrees = static_cast<vtkIdType>(indices.size());
+  const vtkIdType numChunks = (numTrees + TreeChunkSize - 1) / TreeChunkSize;
+  if (numChunks < 2 || !vtkMergePoints::SafeDownCast(this->Locator))
   {
-    // Initialize new Moore cursor at root of current tree
-    input->InitializeNonOrientedMooreSuperCursor(supercursor, index);
-    // Compute contours recursively
-    this->RecursivelyProcessTree(supercursor);
-  } // it
+    vtkNew<vtkHyperTreeGridNonOrientedMooreSuperCursor> supercursor;
+    for (vtkIdType treeIndex : indices)
+    {
+      // Initialize new Moore cursor at root of current tree
+      input->InitializeNonOrientedMooreSuperCursor(supercursor, treeIndex);
+      // Compute contours recursively
+      this->RecursivelyProcessTree(supercursor);
+    } // treeIndex
+  }
+  else
+  {
+    const double* bounds = input->GetBounds();
+    const vtkIdType chunkSize = std::max(estimatedSize / numChunks, static_cast<vtkIdType>(1024));
+    std::vector<vtkSmartPointer<vtkPolyData>> chunks(numChunks);
+    vtkSMPTools::For(0, numChunks, [&](vtkIdType chunkId, vtkIdType endChunkId) {
+      // Each thread contours its chunks with the selection of the first pass
+      vtkNew<vtkHyperTreeGridContour> worker;
+      worker->ContourValues->DeepCopy(this->ContourValues);
+      worker->SelectedCells = this->SelectedCells;
+      worker->CellSigns = this->CellSigns;
+      worker->InScalars = this->InScalars;
+      worker->InMask = this->InMask;
+      worker->InGhostArray = this->InGhostArray;
+      worker->CellScalars = this->InScalars->NewInstance();
+      worker->CellScalars->SetNumberOfComponents(this->InScalars->GetNumberOfComponents());
+      worker->CellScalars->Allocate(worker->CellScalars->GetNumberOfComponents() * 8);
+      vtkNew<vtkHyperTreeGridNonOrientedMooreSuperCursor> supercursor;
+      for (; chunkId < endChunkId; ++chunkId)
+      {
+        vtkNew<vtkPoints> chunkPoints;
+        chunkPoints->SetDataType(newPts->GetDataType());
+        vtkNew<vtkCellArray> chunkVerts;
+        vtkNew<vtkCellArray> chunkLines;
+        vtkNew<vtkCellArray> chunkPolys;
+        vtkNew<vtkMergePoints> locator;
+        locator->InitPointInsertion(chunkPoints, bounds, chunkSize);
+        vtkSmartPointer<vtkPolyData> chunk = vtkSmartPointer<vtkPolyData>::New();
+        chunk->GetPointData()->CopyAllocate(this->InData);
+        vtkContourHelper helper(locator, chunkVerts, chunkLines, chunkPolys, inPointData,
+          nullptr, chunk->GetPointData(), nullptr, static_cast<int>(chunkSize), true);
+        worker->Helper = &helper;
+        const vtkIdType endTree = std::min((chunkId + 1) * TreeChunkSize, numTrees);
+        for (vtkIdType tree = chunkId * TreeChunkSize; tree < endTree; ++tree)
+        {
+          input->InitializeNonOrientedMooreSuperCursor(supercursor, indices[tree]);
+          worker->RecursivelyProcessTree(supercursor);
+        }
+        worker->Helper = nullptr;
+        chunk->SetPoints(chunkPoints);
+        chunk->SetVerts(chunkVerts);
+        chunk->SetLines(chunkLines);
+        chunk->SetPolys(chunkPolys);
+        chunks[chunkId] = chunk;
+      }
+      worker->CellScalars->Delete();
+      worker->CellScalars = nullptr;
+    });
+
+    // Merge the chunk outputs in order, as the serial contour would have
+    // inserted them
+    for (vtkPolyData* chunk : chunks)
+    {
+      vtkHyperTreeGridAlgorithm::MergeTreeChunk(chunk, this->Locator, newPts, newVerts,
+        newLines, newPolys, this->OutData, nullptr);
+    }
+  }
 
   // Set output
   output->SetPoints(newPts);
@@ -508,7 +577,7 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
   // Retrieve global index of input cursor
   vtkIdType id = supercursor->GetGlobalNodeIndex();
 
-  if (this->InGhostArray && this->InGhostArray->GetTuple1(id))
+  if (this->InGhostArray && this->InGhostArray->GetValue(id))
   {
     return;
   }
@@ -525,7 +594,7 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
     for (vtkIdType c = 0; c < this->ContourValues->GetNumberOfContours() && !selected; ++c)
     {
       // Retrieve sign with respect to contour value at current cursor
-      bool sign = (this->CellSigns[c]->GetTuple1(id) != 0.0);
+      bool sign = (this->CellSigns[c]->GetValue(id) != 0);
 
       // Iterate over all cursors of Von Neumann neighborhood around center
       unsigned int nn = supercursor->GetNumberOfCursors() - 1;
@@ -538,9 +607,9 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
           vtkIdType idN = supercursor->GetGlobalNodeIndex(icursorN);
 
           // Decide whether neighbor was selected or must be retained because of a sign change
-          selected = this->SelectedCells->GetTuple1(idN) == 1 ||
-            ((this->CellSigns[c]->GetTuple1(idN) != 0.0) != sign) ||
-            (this->InGhostArray && this->InGhostArray->GetTuple1(idN));
+          selected = this->SelectedCells->GetValue(idN) == 1 ||
+            ((this->CellSigns[c]->GetValue(idN) != 0) != sign) ||
+            (this->InGhostArray && this->InGhostArray->GetValue(idN));
         }
         else
         {
@@ -563,7 +632,7 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
       }
     }
   }
-  else if ((!this->InMask || !this->InMask->GetTuple1(id)))
+  else if ((!this->InMask || !this->InMask->GetValue(id)))
   {
     // Cell is not masked, iterate over its corners
     unsigned int numLeavesCorners = 1 << dim;
@@ -615,7 +684,7 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
           cell->PointIds->SetId(_cornerIdx, idN);
 
           // Assign scalar value attached to this contour item
-          this->CellScalars->SetTuple(_cornerIdx, this->InScalars->GetTuple(idN));
+          this->CellScalars->SetTuple(_cornerIdx, idN, this->InScalars);
         } // cornerIdx
         // Compute cell isocontour for each isovalue
         for (int c = 0; c < numContours; ++c)
@@ -22,6 +22,9 @@
  * following contour: a cell is considered to be within range if its
  * value for the active scalar is within a specified range (inclusive).
  * The output remains a hyper tree grid.
+ * When points are merged with a vtkMergePoints locator, the default, the
+ * contours are computed by chunks of trees in several threads with
+ * vtkSMPTools, then the chunks are merged in tree order.
  *
  * @sa
  * vtkHyperTreeGrid vtkHyperTreeGridAlgorithm vtkContourFilter
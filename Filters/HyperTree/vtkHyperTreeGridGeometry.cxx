@@ -35,6 +35,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
@@ -286,11 +287,6 @@ int vtkHyperTreeGridGeometry::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObjec
 
   this->BranchFactor = static_cast<int>(input->GetBranchFactor());
 
-  // Initialize output cell data
-  this->InData = input->GetCellData();
-  this->OutData = output->GetCellData();
-  this->OutData->CopyAllocate(this->InData);
-
   // Retrieve material mask
   this->Mask = input->HasMask() ? input->GetMask() : nullptr;
 
@@ -298,6 +294,7 @@ int vtkHyperTreeGridGeometry::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObjec
   this->PureMask = input->GetPureMask();
 
   // Retrieve interface data when relevant
+  this->InData = input->GetCellData();
   this->HasInterface = input->GetHasInterface();
   if (this->HasInterface)
   {
@@ -307,6 +304,99 @@ int vtkHyperTreeGridGeometry::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObjec
       vtkDoubleArray::SafeDownCast(this->InData->GetArray(input->GetInterfaceInterceptsName()));
   } // this->HasInterface
 
+  // Trees are processed by chunks in several threads, each into its own
+  // output, which are then merged in order. Grids with interfaces, whose
+  // points are not merged, are processed serially.
+  double bounds[6];
+  input->GetBounds(bounds);
+  std::vector<vtkIdType> indices;
+  vtkHyperTreeGridAlgorithm::GetTreeIndices(input, indices);
+  const vtkIdType numTrees = static_cast<vtkIdType>(indices.size());
+  const vtkIdType numChunks = (numTrees + TreeChunkSize - 1) / TreeChunkSize;
+  if (this->HasInterface || numChunks < 2)
+  {
+    this->ProcessTreeRange(input, bounds, indices.data(), indices.data() + numTrees, output);
+    return 1;
+  }
+
+  std::vector<vtkSmartPointer<vtkPolyData>> chunks(numChunks);
+  vtkSMPTools::For(0, numChunks, [&](vtkIdType chunkId, vtkIdType endChunkId) {
+    vtkNew<vtkHyperTreeGridGeometry> worker;
+    worker->Dimension = this->Dimension;
+    worker->Orientation = this->Orientation;
+    worker->BranchFactor = this->BranchFactor;
+    worker->Merging = this->Merging;
+    worker->Mask = this->Mask;
+    worker->PureMask = this->PureMask;
+    for (; chunkId < endChunkId; ++chunkId)
+    {
+      const vtkIdType* begin = indices.data() + chunkId * TreeChunkSize;
+      const vtkIdType* end = indices.data() + std::min((chunkId + 1) * TreeChunkSize, numTrees);
+      chunks[chunkId] = vtkSmartPointer<vtkPolyData>::New();
+      worker->ProcessTreeRange(input, bounds, begin, end, chunks[chunkId]);
+    }
+  });
+
+  // Merge the chunk outputs in order, as the serial traversal of the trees
+  // would have created them
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> cells;
+  vtkNew<vtkMergePoints> locator;
+  if (this->Merging)
+  {
+    locator->InitPointInsertion(points, bounds);
+  }
+  this->InData = input->GetCellData();
+  this->OutData = output->GetCellData();
+  this->OutData->CopyAllocate(this->InData);
+  vtkNew<vtkUnsignedCharArray> edgeFlags;
+  vtkCellArray* lines = this->Dimension == 1 ? cells.GetPointer() : nullptr;
+  vtkCellArray* polys = this->Dimension == 1 ? nullptr : cells.GetPointer();
+  for (vtkPolyData* chunk : chunks)
+  {
+    vtkHyperTreeGridAlgorithm::MergeTreeChunk(chunk, this->Merging ? locator.GetPointer() : nullptr,
+      points, nullptr, lines, polys, nullptr, this->OutData);
+
+    // Edge flags are issued by face, whether points are merged or not
+    if (vtkDataArray* chunkFlags = chunk->GetPointData()->GetArray("vtkEdgeFlags"))
+    {
+      if (chunkFlags->GetNumberOfTuples())
+      {
+        edgeFlags->InsertTuples(edgeFlags->GetNumberOfTuples(), chunkFlags->GetNumberOfTuples(),
+          0, chunkFlags);
+      }
+    }
+  }
+
+  // Set output geometry and topology
+  output->SetPoints(points);
+  if (this->Dimension == 1)
+  {
+    output->SetLines(cells);
+  }
+  else
+  {
+    output->SetPolys(cells);
+  }
+  if (this->Dimension == 3)
+  {
+    edgeFlags->SetName("vtkEdgeFlags");
+    vtkPointData* outPointData = output->GetPointData();
+    outPointData->AddArray(edgeFlags);
+    outPointData->SetActiveAttribute(edgeFlags->GetName(), vtkDataSetAttributes::EDGEFLAG);
+  }
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+void vtkHyperTreeGridGeometry::ProcessTreeRange(vtkHyperTreeGrid* input, const double bounds[6],
+  const vtkIdType* begin, const vtkIdType* end, vtkPolyData* output)
+{
+  // Initialize output cell data
+  this->InData = input->GetCellData();
+  this->OutData = output->GetCellData();
+  this->OutData->CopyAllocate(this->InData);
+
   // Create storage for corners of leaf cells
   if (this->Points)
   {
@@ -329,13 +419,10 @@ int vtkHyperTreeGridGeometry::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObjec
       this->Locator->Delete();
     }
     this->Locator = vtkMergePoints::New();
-    this->Locator->InitPointInsertion(this->Points, input->GetBounds());
+    this->Locator->InitPointInsertion(this->Points, bounds);
   }
 
-  // Iterate over all hyper trees
-  vtkIdType index;
-  vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-  input->InitializeTreeIterator(it);
+  // Iterate over the given hyper trees
   if (this->Dimension == 3)
   {
     // Flag used to hide edges when needed
@@ -348,26 +435,26 @@ int vtkHyperTreeGridGeometry::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObjec
     outPointData->SetActiveAttribute(this->EdgeFlags->GetName(), vtkDataSetAttributes::EDGEFLAG);
 
     vtkNew<vtkHyperTreeGridNonOrientedVonNeumannSuperCursor> cursor;
-    while (it.GetNextTree(index))
+    for (const vtkIdType* index = begin; index != end; ++index)
     {
       // Initialize new cursor at root of current tree
       // In 3 dimensions, von Neumann neighborhood information is needed
-      input->InitializeNonOrientedVonNeumannSuperCursor(cursor, index);
+      input->InitializeNonOrientedVonNeumannSuperCursor(cursor, *index);
       // Build geometry recursively
       this->RecursivelyProcessTree3D(cursor, FULL_WORK_FACES);
-    } // it
+    } // index
   }
   else
   {
     vtkNew<vtkHyperTreeGridNonOrientedGeometryCursor> cursor;
-    while (it.GetNextTree(index))
+    for (const vtkIdType* index = begin; index != end; ++index)
     {
       // Initialize new cursor at root of current tree
       // Otherwise, geometric properties of the cells suffice
-      input->InitializeNonOrientedGeometryCursor(cursor, index);
+      input->InitializeNonOrientedGeometryCursor(cursor, *index);
       // Build geometry recursively
       this->RecursivelyProcessTreeNot3D(cursor);
-    } // it
+    } // index
   }   // else
 
   // Set output geometry and topology
@@ -403,7 +490,6 @@ int vtkHyperTreeGridGeometry::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObjec
     this->Locator->Delete();
     this->Locator = nullptr;
   }
-  return 1;
 }
 
 //------------------------------------------------------------------------------
@@ -16,6 +16,10 @@
  * @class   vtkHyperTreeGridGeometry
  * @brief   Hyper tree grid outer surface
  *
+ * The trees are processed by chunks in several threads with vtkSMPTools,
+ * except for grids with interfaces. The surfaces of the chunks are appended
+ * in tree order, or merged in that order when points are merged.
+ *
  * @sa
  * vtkHyperTreeGrid vtkHyperTreeGridAlgorithm
  *
@@ -77,6 +81,12 @@ protected:
    */
   int ProcessTrees(vtkHyperTreeGrid*, vtkDataObject*) override;
 
+  /**
+   * Generate external boundary of the given trees, in order, into output
+   */
+  void ProcessTreeRange(vtkHyperTreeGrid* input, const double bounds[6], const vtkIdType* begin,
+    const vtkIdType* end, vtkPolyData* output);
+
   /**
    * Recursively descend into tree down to leaves
    */
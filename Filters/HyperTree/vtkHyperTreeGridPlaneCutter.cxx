@@ -31,9 +31,13 @@
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 namespace
 {
@@ -333,19 +337,45 @@ int vtkHyperTreeGridPlaneCutter::ProcessTrees(vtkHyperTreeGrid* input, vtkDataOb
     this->OutData = output->GetCellData();
     this->OutData->CopyAllocate(this->InData);
 
-    // Iterate over all hyper trees
-    vtkIdType index;
-    vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-    input->InitializeTreeIterator(it);
-    vtkNew<vtkHyperTreeGridNonOrientedGeometryCursor> cursor;
-    while (it.GetNextTree(index))
+    // Trees are cut by chunks in several threads, each into its own points
+    // and cells, which are then appended in order
+    std::vector<vtkIdType> indices;
+    vtkHyperTreeGridAlgorithm::GetTreeIndices(input, indices);
+    const vtkIdType numTrees = static_cast<vtkIdType>(indices.size());
+    const vtkIdType numChunks = (numTrees + TreeChunkSize - 1) / TreeChunkSize;
+    std::vector<vtkSmartPointer<vtkPolyData>> chunks(numChunks);
+    vtkSMPTools::For(0, numChunks, [&](vtkIdType chunkId, vtkIdType endChunkId) {
+      vtkNew<vtkHyperTreeGridPlaneCutter> worker;
+      std::copy(this->Plane, this->Plane + 4, worker->Plane);
+      worker->AxisAlignment = this->AxisAlignment;
+      worker->InMask = this->InMask;
+      worker->InData = this->InData;
+      vtkNew<vtkHyperTreeGridNonOrientedGeometryCursor> cursor;
+      for (; chunkId < endChunkId; ++chunkId)
+      {
+        worker->Reset();
+        chunks[chunkId] = vtkSmartPointer<vtkPolyData>::New();
+        worker->OutData = chunks[chunkId]->GetCellData();
+        worker->OutData->CopyAllocate(this->InData);
+        const vtkIdType endTree = std::min((chunkId + 1) * TreeChunkSize, numTrees);
+        for (vtkIdType tree = chunkId * TreeChunkSize; tree < endTree; ++tree)
+        {
+          // Initialize new geometric cursor at root of current tree
+          input->InitializeNonOrientedGeometryCursor(cursor, indices[tree]);
+          // Generate leaf cell centers recursively
+          worker->RecursivelyProcessTreePrimal(cursor);
+        }
+        chunks[chunkId]->SetPoints(worker->Points);
+        chunks[chunkId]->SetPolys(worker->Cells);
+      }
+    });
+
+    for (vtkPolyData* chunk : chunks)
     {
-      // Initialize new geometric cursor at root of current tree
-      input->InitializeNonOrientedGeometryCursor(cursor, index);
-      // Generate leaf cell centers recursively
-      this->RecursivelyProcessTreePrimal(cursor);
-    } // it
-  }   // else
+      vtkHyperTreeGridAlgorithm::MergeTreeChunk(
+        chunk, nullptr, this->Points, nullptr, nullptr, this->Cells, nullptr, this->OutData);
+    }
+  } // else
 
   // Set output geometry and topology
   output->SetPoints(this->Points);
@@ -26,6 +26,9 @@
  * connectivity (i.e., mesh conformity in the FE sense) is achieved at the
  * cost of interpolation to the dual of the input AMR mesh, and therefore
  * of missing intersection plane pieces near the primal boundary.
+ * The cut over the original mesh is computed by chunks of trees in several
+ * threads with vtkSMPTools; the output does not depend on the number of
+ * threads.
  *
  * @sa
  * vtkHyperTreeGrid vtkHyperTreeGridAlgorithm
@@ -18,16 +18,69 @@
 #include "vtkCellData.h"
 #include "vtkHyperTree.h"
 #include "vtkHyperTreeGrid.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkUniformHyperTreeGrid.h"
 
 #include "vtkHyperTreeGridNonOrientedCursor.h"
 
+#include <algorithm>
 #include <cmath>
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Number of nodes of the output tree copied from the input one: the children
+// of masked nodes are not.
+vtkIdType CountNodes(vtkHyperTreeGridNonOrientedCursor* cursor, vtkBitArray* mask)
+{
+  vtkIdType numNodes = 1;
+  if ((mask && mask->GetValue(cursor->GetGlobalNodeIndex())) || cursor->IsLeaf())
+  {
+    return numNodes;
+  }
+  int numChildren = cursor->GetNumberOfChildren();
+  for (int ichild = 0; ichild < numChildren; ++ichild)
+  {
+    cursor->ToChild(ichild);
+    numNodes += CountNodes(cursor, mask);
+    cursor->ToParent();
+  }
+  return numNodes;
+}
+
+//------------------------------------------------------------------------------
+// Packs the mask values of the nodes into the bits of the output mask, one
+// byte per thread at a time.
+void SetMaskValues(vtkBitArray* mask, const std::vector<unsigned char>& values)
+{
+  const vtkIdType numValues = static_cast<vtkIdType>(values.size());
+  mask->SetNumberOfTuples(numValues);
+  unsigned char* bytes = mask->GetPointer(0);
+  vtkSMPTools::For(0, (numValues + 7) / 8, [&](vtkIdType byte, vtkIdType endByte) {
+    for (; byte < endByte; ++byte)
+    {
+      unsigned char bits = 0;
+      const vtkIdType endId = std::min(8 * byte + 8, numValues);
+      for (vtkIdType id = 8 * byte; id < endId; ++id)
+      {
+        if (values[id])
+        {
+          bits = static_cast<unsigned char>(bits | (0x80 >> id % 8));
+        }
+      }
+      bytes[byte] = bits;
+    }
+  });
+  mask->Modified();
+}
+}
+
 vtkStandardNewMacro(vtkHyperTreeGridThreshold);
 
 //------------------------------------------------------------------------------
@@ -46,8 +99,8 @@ vtkHyperTreeGridThreshold::vtkHyperTreeGridThreshold()
   // JBL tres rares cas que la creation d'un mask n'aurait pas d'utilite.
   this->OutMask = vtkBitArray::New();
 
-  // Output indices begin at 0
-  this->CurrentId = 0;
+  // Input cells of the output cells are only used during process
+  this->InIds = nullptr;
 
   // Process active point scalars by default
   this->SetInputArrayToProcess(
@@ -78,7 +131,6 @@ void vtkHyperTreeGridThreshold::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "LowerThreshold: " << this->LowerThreshold << endl;
   os << indent << "UpperThreshold: " << this->UpperThreshold << endl;
   os << indent << "OutMask: " << this->OutMask << endl;
-  os << indent << "CurrentId: " << this->CurrentId << endl;
 
   if (this->InScalars)
   {
@@ -135,24 +187,32 @@ int vtkHyperTreeGridThreshold::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObje
   // Retrieve material mask
   this->InMask = input->HasMask() ? input->GetMask() : nullptr;
 
+  // Trees are processed in several threads, the mask values of their nodes
+  // are packed into the output mask once they are all processed
+  std::vector<vtkIdType> indices;
+  vtkHyperTreeGridAlgorithm::GetTreeIndices(input, indices);
+  const vtkIdType numTrees = static_cast<vtkIdType>(indices.size());
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedCursor> localInCursor;
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedCursor> localOutCursor;
+
   if (this->JustCreateNewMask)
   {
     output->ShallowCopy(input);
 
-    this->OutMask->SetNumberOfTuples(output->GetNumberOfVertices());
+    // Nodes below masked ones are not visited and stay masked
+    this->OutMaskValues.assign(output->GetNumberOfVertices(), 1);
 
     // Iterate over all input and output hyper trees
-    vtkIdType outIndex;
-    vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-    output->InitializeTreeIterator(it);
-    vtkNew<vtkHyperTreeGridNonOrientedCursor> outCursor;
-    while (it.GetNextTree(outIndex))
-    {
-      // Initialize new grid cursor at root of current input tree
-      output->InitializeNonOrientedCursor(outCursor, outIndex);
-      // Limit depth recursively
-      this->RecursivelyProcessTreeWithCreateNewMask(outCursor);
-    } // it
+    vtkSMPTools::For(0, numTrees, [&](vtkIdType tree, vtkIdType endTree) {
+      vtkHyperTreeGridNonOrientedCursor* outCursor = localOutCursor.Local();
+      for (; tree < endTree; ++tree)
+      {
+        // Initialize new grid cursor at root of current input tree
+        output->InitializeNonOrientedCursor(outCursor, indices[tree]);
+        // Limit depth recursively
+        this->RecursivelyProcessTreeWithCreateNewMask(outCursor);
+      }
+    });
   }
   else
   {
@@ -165,30 +225,64 @@ int vtkHyperTreeGridThreshold::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObje
     output->SetInterfaceNormalsName(input->GetInterfaceNormalsName());
     output->SetInterfaceInterceptsName(input->GetInterfaceInterceptsName());
 
-    // Initialize output point data
-    this->InData = input->GetCellData();
-    this->OutData = output->GetCellData();
-    this->OutData->CopyAllocate(this->InData);
+    // Count the nodes of each output tree to number them as when iterating
+    // over the trees, whose output is created beforehand
+    std::vector<vtkIdType> nodeOffsets(numTrees + 1, 0);
+    vtkSMPTools::For(0, numTrees, [&](vtkIdType tree, vtkIdType endTree) {
+      vtkHyperTreeGridNonOrientedCursor* inCursor = localInCursor.Local();
+      for (; tree < endTree; ++tree)
+      {
+        input->InitializeNonOrientedCursor(inCursor, indices[tree]);
+        nodeOffsets[tree] = CountNodes(inCursor, this->InMask);
+      }
+    });
+    vtkSMPTools::ExclusiveScan(
+      nodeOffsets.begin(), nodeOffsets.end(), nodeOffsets.begin(), vtkIdType(0));
+    const vtkIdType numNodes = nodeOffsets[numTrees];
+    for (vtkIdType inIndex : indices)
+    {
+      output->GetTree(inIndex, true);
+    }
 
-    // Output indices begin at 0
-    this->CurrentId = 0;
+    this->OutMaskValues.resize(numNodes);
+    this->InIds = vtkIdList::New();
+    this->InIds->SetNumberOfIds(numNodes);
 
     // Iterate over all input and output hyper trees
-    vtkIdType inIndex;
-    vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-    input->InitializeTreeIterator(it);
-    vtkNew<vtkHyperTreeGridNonOrientedCursor> inCursor;
-    vtkNew<vtkHyperTreeGridNonOrientedCursor> outCursor;
-    while (it.GetNextTree(inIndex))
-    {
-      // Initialize new cursor at root of current input tree
-      input->InitializeNonOrientedCursor(inCursor, inIndex);
-      // Initialize new cursor at root of current output tree
-      output->InitializeNonOrientedCursor(outCursor, inIndex, true);
-      // Limit depth recursively
-      this->RecursivelyProcessTree(inCursor, outCursor);
-    } // it
+    vtkSMPTools::For(0, numTrees, [&](vtkIdType tree, vtkIdType endTree) {
+      vtkHyperTreeGridNonOrientedCursor* inCursor = localInCursor.Local();
+      vtkHyperTreeGridNonOrientedCursor* outCursor = localOutCursor.Local();
+      for (; tree < endTree; ++tree)
+      {
+        // Initialize new cursor at root of current input tree
+        input->InitializeNonOrientedCursor(inCursor, indices[tree]);
+        // Initialize new cursor at root of current output tree
+        output->InitializeNonOrientedCursor(outCursor, indices[tree]);
+        // Limit depth recursively
+        vtkIdType outId = nodeOffsets[tree];
+        this->RecursivelyProcessTree(inCursor, outCursor, outId);
+      }
+    });
+
+    // Copy out cell data from that of input cells
+    this->InData = input->GetCellData();
+    this->OutData = output->GetCellData();
+    this->OutData->CopyAllocate(this->InData, numNodes);
+    vtkNew<vtkIdList> outIds;
+    outIds->SetNumberOfIds(numNodes);
+    vtkSMPTools::For(0, numNodes, [&](vtkIdType outId, vtkIdType endOutId) {
+      for (; outId < endOutId; ++outId)
+      {
+        outIds->SetId(outId, outId);
+      }
+    });
+    this->OutData->CopyData(this->InData, this->InIds, outIds);
+    this->InIds->Delete();
+    this->InIds = nullptr;
   }
+  SetMaskValues(this->OutMask, this->OutMaskValues);
+  this->OutMaskValues.clear();
+  this->OutMaskValues.shrink_to_fit();
 
   // Squeeze and set output material mask if necessary
   this->OutMask->Squeeze();
@@ -199,17 +293,17 @@ int vtkHyperTreeGridThreshold::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObje
 }
 
 //------------------------------------------------------------------------------
-bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
-  vtkHyperTreeGridNonOrientedCursor* inCursor, vtkHyperTreeGridNonOrientedCursor* outCursor)
+bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(vtkHyperTreeGridNonOrientedCursor* inCursor,
+  vtkHyperTreeGridNonOrientedCursor* outCursor, vtkIdType& currentId)
 {
   // Retrieve global index of input cursor
   vtkIdType inId = inCursor->GetGlobalNodeIndex();
 
   // Increase index count on output: postfix is intended
-  vtkIdType outId = this->CurrentId++;
+  vtkIdType outId = currentId++;
 
-  // Copy out cell data from that of input cell
-  this->OutData->CopyData(this->InData, inId, outId);
+  // Out cell data is copied from that of input cell
+  this->InIds->SetId(outId, inId);
 
   // Retrieve output tree and set global index of output cursor
   vtkHyperTree* outTree = outCursor->GetTree();
@@ -221,7 +315,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
   if (this->InMask && this->InMask->GetValue(inId))
   {
     // Mask output cell if necessary
-    this->OutMask->InsertTuple1(outId, discard);
+    this->OutMaskValues[outId] = discard;
 
     // Return whether current node is within range
     return discard;
@@ -242,7 +336,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
       // Descend into child in output grid as well
       outCursor->ToChild(ichild);
       // Recurse and keep track of whether some children are kept
-      discard &= this->RecursivelyProcessTree(inCursor, outCursor);
+      discard &= this->RecursivelyProcessTree(inCursor, outCursor, currentId);
       // Return to parent in input grid
       outCursor->ToParent();
       // Return to parent in output grid
@@ -252,7 +346,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
   else
   {
     // Input cursor is at leaf, check whether it is within range
-    double value = this->InScalars->GetTuple1(inId);
+    double value = this->InScalars->GetComponent(inId, 0);
     if (!(this->InMask && this->InMask->GetValue(inId)) && value >= this->LowerThreshold &&
       value <= this->UpperThreshold)
     {
@@ -262,7 +356,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
   } // else
 
   // Mask output cell if necessary
-  this->OutMask->InsertTuple1(outId, discard);
+  this->OutMaskValues[outId] = discard;
 
   // Return whether current node is within range
   return discard;
@@ -281,7 +375,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTreeWithCreateNewMask(
   if (this->InMask && this->InMask->GetValue(outId))
   {
     // Mask output cell if necessary
-    this->OutMask->InsertTuple1(outId, discard);
+    this->OutMaskValues[outId] = discard;
 
     // Return whether current node is within range
     return discard;
@@ -305,12 +399,12 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTreeWithCreateNewMask(
   else
   {
     // Input cursor is at leaf, check whether it is within range
-    double value = this->InScalars->GetTuple1(outId);
+    double value = this->InScalars->GetComponent(outId, 0);
     discard = value < this->LowerThreshold || value > this->UpperThreshold;
   } // else
 
   // Mask output cell if necessary
-  this->OutMask->InsertTuple1(outId, discard);
+  this->OutMaskValues[outId] = discard;
 
   // Return whether current node is within range
   return discard;
@@ -25,6 +25,9 @@
  * JB Un parametre (JustCreateNewMask=true) permet de ne pas faire
  * le choix de la creation d'un nouveau HTG mais
  * de redefinir juste le masque.
+ * The trees are processed in several threads with vtkSMPTools. The nodes
+ * of each output tree are counted first, so that they are numbered as when
+ * the trees are created one after the other.
  *
  * @sa
  * vtkHyperTreeGrid vtkHyperTreeGridAlgorithm vtkThreshold
@@ -43,8 +46,11 @@
 #include "vtkFiltersHyperTreeModule.h" // For export macro
 #include "vtkHyperTreeGridAlgorithm.h"
 
+#include <vector> // For std::vector
+
 class vtkBitArray;
 class vtkHyperTreeGrid;
+class vtkIdList;
 
 class vtkHyperTreeGridNonOrientedCursor;
 
@@ -102,7 +108,7 @@ protected:
    * Recursively descend into tree down to leaves
    */
   bool RecursivelyProcessTree(
-    vtkHyperTreeGridNonOrientedCursor*, vtkHyperTreeGridNonOrientedCursor*);
+    vtkHyperTreeGridNonOrientedCursor*, vtkHyperTreeGridNonOrientedCursor*, vtkIdType&);
   bool RecursivelyProcessTreeWithCreateNewMask(vtkHyperTreeGridNonOrientedCursor*);
 
   /**
@@ -126,9 +132,14 @@ protected:
   vtkBitArray* OutMask;
 
   /**
-   * Keep track of current index in output hyper tree grid
+   * Output material mask values, one per output node
+   */
+  std::vector<unsigned char> OutMaskValues;
+
+  /**
+   * Input cell of each output cell when a new grid is created
    */
-  vtkIdType CurrentId;
+  vtkIdList* InIds;
 
   /**
    * Keep track of selected input scalars
@@ -18,19 +18,52 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkHyperTreeGrid.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include "vtkHyperTreeGridNonOrientedCursor.h"
 #include "vtkHyperTreeGridNonOrientedGeometryCursor.h"
 
+#include <vector>
+
+namespace
+{
+//------------------------------------------------------------------------------
+vtkIdType CountLeaves(vtkHyperTreeGridNonOrientedCursor* cursor)
+{
+  if (cursor->IsMasked())
+  {
+    return 0;
+  }
+  if (cursor->IsLeaf())
+  {
+    return 1;
+  }
+  vtkIdType numLeaves = 0;
+  int numChildren = cursor->GetNumberOfChildren();
+  for (int ichild = 0; ichild < numChildren; ++ichild)
+  {
+    cursor->ToChild(ichild);
+    numLeaves += CountLeaves(cursor);
+    cursor->ToParent();
+  }
+  return numLeaves;
+}
+}
+
 vtkStandardNewMacro(vtkHyperTreeGridToUnstructuredGrid);
 
 //------------------------------------------------------------------------------
 vtkHyperTreeGridToUnstructuredGrid::vtkHyperTreeGridToUnstructuredGrid()
   : Points(nullptr)
   , Cells(nullptr)
+  , InIds(nullptr)
   , Dimension(0)
   , Orientation(0)
   , Axes(nullptr)
@@ -70,30 +103,82 @@ int vtkHyperTreeGridToUnstructuredGrid::ProcessTrees(
   }
 
   // Set instance variables needed for this conversion
-  this->Points = vtkPoints::New();
-  this->Cells = vtkCellArray::New();
   this->Dimension = input->GetDimension();
   this->Orientation = input->GetOrientation();
   this->Axes = input->GetAxes();
+  const vtkIdType numCellPts = static_cast<vtkIdType>(1) << this->Dimension;
+
+  // The trees are converted in several threads: the leaves of each tree are
+  // counted first to know where its cells go, in the order of the iterator.
+  std::vector<vtkIdType> indices;
+  vtkHyperTreeGridAlgorithm::GetTreeIndices(input, indices);
+  const vtkIdType numTrees = static_cast<vtkIdType>(indices.size());
+  std::vector<vtkIdType> cellOffsets(numTrees + 1, 0);
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedCursor> localCursor;
+  vtkSMPTools::For(0, numTrees, [&](vtkIdType tree, vtkIdType endTree) {
+    vtkHyperTreeGridNonOrientedCursor* cursor = localCursor.Local();
+    for (; tree < endTree; ++tree)
+    {
+      input->InitializeNonOrientedCursor(cursor, indices[tree]);
+      cellOffsets[tree] = CountLeaves(cursor);
+    }
+  });
+  vtkSMPTools::ExclusiveScan(
+    cellOffsets.begin(), cellOffsets.end(), cellOffsets.begin(), vtkIdType(0));
+  const vtkIdType numCells = cellOffsets[numTrees];
+
+  // Each leaf has its own 2^d points
+  this->Points = vtkPoints::New();
+  this->Points->SetNumberOfPoints(numCells * numCellPts);
+  this->InIds = vtkIdList::New();
+  this->InIds->SetNumberOfIds(numCells);
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedGeometryCursor> localGeometryCursor;
+  vtkSMPTools::For(0, numTrees, [&](vtkIdType tree, vtkIdType endTree) {
+    vtkHyperTreeGridNonOrientedGeometryCursor* cursor = localGeometryCursor.Local();
+    for (; tree < endTree; ++tree)
+    {
+      // Initialize new geometric cursor at root of current tree
+      input->InitializeNonOrientedGeometryCursor(cursor, indices[tree]);
+
+      // Convert hyper tree into unstructured mesh recursively
+      vtkIdType outId = cellOffsets[tree];
+      this->RecursivelyProcessTree(cursor, outId);
+    }
+  });
+
+  // The points of each cell follow those of the previous one
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numCells + 1);
+  vtkNew<vtkIdTypeArray> conn;
+  conn->SetNumberOfValues(numCells * numCellPts);
+  vtkSMPTools::For(0, numCells + 1, [&](vtkIdType cellId, vtkIdType endCellId) {
+    for (; cellId < endCellId; ++cellId)
+    {
+      offsets->SetValue(cellId, cellId * numCellPts);
+    }
+  });
+  vtkSMPTools::For(0, numCells * numCellPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    for (; ptId < endPtId; ++ptId)
+    {
+      conn->SetValue(ptId, ptId);
+    }
+  });
+  this->Cells = vtkCellArray::New();
+  this->Cells->SetData(offsets, conn);
 
-  // Initialize output cell data
+  // Copy output cell data from input
   this->InData = input->GetCellData();
   this->OutData = output->GetCellData();
-  this->OutData->CopyAllocate(this->InData);
-
-  // Iterate over all hyper trees
-  vtkIdType index;
-  vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-  input->InitializeTreeIterator(it);
-  vtkNew<vtkHyperTreeGridNonOrientedGeometryCursor> cursor;
-  while (it.GetNextTree(index))
-  {
-    // Initialize new geometric cursor at root of current tree
-    input->InitializeNonOrientedGeometryCursor(cursor, index);
-
-    // Convert hyper tree into unstructured mesh recursively
-    this->RecursivelyProcessTree(cursor);
-  } // it
+  this->OutData->CopyAllocate(this->InData, numCells);
+  vtkNew<vtkIdList> outIds;
+  outIds->SetNumberOfIds(numCells);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    for (; cellId < endCellId; ++cellId)
+    {
+      outIds->SetId(cellId, cellId);
+    }
+  });
+  this->OutData->CopyData(this->InData, this->InIds, outIds);
 
   // Set output geometry and topology
   output->SetPoints(this->Points);
@@ -117,15 +202,17 @@ int vtkHyperTreeGridToUnstructuredGrid::ProcessTrees(
 
   this->Points->FastDelete();
   this->Cells->FastDelete();
+  this->InIds->FastDelete();
   this->Points = nullptr;
   this->Cells = nullptr;
+  this->InIds = nullptr;
 
   return 1;
 }
 
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridToUnstructuredGrid::RecursivelyProcessTree(
-  vtkHyperTreeGridNonOrientedGeometryCursor* cursor)
+  vtkHyperTreeGridNonOrientedGeometryCursor* cursor, vtkIdType& outId)
 {
   // If leaf is masked, skip it
   if (cursor->IsMasked())
@@ -140,7 +227,7 @@ void vtkHyperTreeGridToUnstructuredGrid::RecursivelyProcessTree(
     vtkIdType id = cursor->GetGlobalNodeIndex();
 
     // Create cell
-    this->AddCell(id, cursor->GetOrigin(), cursor->GetSize());
+    this->AddCell(id, outId++, cursor->GetOrigin(), cursor->GetSize());
   } // if ( cursor->IsLeaf() )
   else
   {
@@ -150,28 +237,29 @@ void vtkHyperTreeGridToUnstructuredGrid::RecursivelyProcessTree(
     {
       cursor->ToChild(ichild);
       // Recurse
-      this->RecursivelyProcessTree(cursor);
+      this->RecursivelyProcessTree(cursor, outId);
       cursor->ToParent();
     } // child
   }   // else
 }
 
 //------------------------------------------------------------------------------
-void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin, double* size)
+void vtkHyperTreeGridToUnstructuredGrid::AddCell(
+  vtkIdType inId, vtkIdType outId, double* origin, double* size)
 {
   // Storage for point coordinates
   double pt[] = { 0., 0., 0. };
 
-  // Storage for cell vertex IDs
-  vtkIdType ids[8];
+  // Keep track of the input cell, its data is copied once all cells are created
+  this->InIds->SetId(outId, inId);
 
-  // Storage for cell ID
-  vtkIdType outId;
+  // The cell vertices are stored after those of the previous cells
+  vtkIdType firstId = outId << this->Dimension;
 
   // First cell vertex is always at origin of cursor
   // Add vertex #0 : (0,0)
   memcpy(pt, origin, 3 * sizeof(double));
-  ids[0] = this->Points->InsertNextPoint(pt);
+  this->Points->SetPoint(firstId, pt);
 
   // Create remaining 2^d - 1 vertices depending on dimension
   switch (this->Dimension)
@@ -182,10 +270,7 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
 
       // In 1D there is only one other vertex
       pt[0] = origin[this->Orientation] + size[this->Orientation];
-      ids[1] = this->Points->InsertNextPoint(pt);
-
-      // Insert next line
-      outId = this->Cells->InsertNextCell(2, ids);
+      this->Points->SetPoint(firstId + 1, pt);
       break;
     }
     case 2:
@@ -196,20 +281,17 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
       // Add vertex #1 : (1,0)
       pt[axis1] = origin[axis1] + size[axis1];
       pt[axis2] = origin[axis2];
-      ids[1] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(firstId + 1, pt);
 
       // Add vertex #2 : (0,1)
       pt[axis1] = origin[axis1];
       pt[axis2] = origin[axis2] + size[axis2];
-      ids[2] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(firstId + 2, pt);
 
       // Add vertex #3 : (1,1)
       pt[axis1] = origin[axis1] + size[axis1];
       pt[axis2] = origin[axis2] + size[axis2];
-      ids[3] = this->Points->InsertNextPoint(pt);
-
-      // Insert next quadrangle
-      outId = this->Cells->InsertNextCell(4, ids);
+      this->Points->SetPoint(firstId + 3, pt);
       break;
     }
     case 3:
@@ -220,17 +302,17 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
       // Add vertex #1 : (1,0,0)
       pt[0] = origin[0] + size[0];
       pt[1] = origin[1];
-      ids[1] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(firstId + 1, pt);
 
       // Add vertex #2 : (0,1,0)
       pt[0] = origin[0];
       pt[1] = origin[1] + size[1];
-      ids[2] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(firstId + 2, pt);
 
       // Add vertex #3 : (1,1,0)
       pt[0] = origin[0] + size[0];
       pt[1] = origin[1] + size[1];
-      ids[3] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(firstId + 3, pt);
 
       // z=1 plane
       pt[2] = origin[2] + size[2];
@@ -238,25 +320,22 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
       // Add vertex #4 : (0,0,1)
       pt[0] = origin[0];
       pt[1] = origin[1];
-      ids[4] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(firstId + 4, pt);
 
       // Add vertex #5 : (1,0,1)
       pt[0] = origin[0] + size[0];
       pt[1] = origin[1];
-      ids[5] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(firstId + 5, pt);
 
       // Add vertex #6 : (0,1,1)
       pt[0] = origin[0];
       pt[1] = origin[1] + size[1];
-      ids[6] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(firstId + 6, pt);
 
       // Add vertex #7 : (1,1,1)
       pt[0] = origin[0] + size[0];
       pt[1] = origin[1] + size[1];
-      ids[7] = this->Points->InsertNextPoint(pt);
-
-      // Insert next voxel
-      outId = this->Cells->InsertNextCell(8, ids);
+      this->Points->SetPoint(firstId + 7, pt);
       break;
     }
     default:
@@ -265,6 +344,4 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
     }
   } // switch ( this->Dimension )
 
-  // Copy output data from input
-  this->OutData->CopyData(this->InData, inId, outId);
 }
@@ -23,6 +23,9 @@
  * Produces segments in 1D, rectangles in 2D, right hexahedra in 3D.
  * NB: The output will contain superimposed inter-element boundaries and pending
  * nodes as a result of T-junctions.
+ * The trees are converted in several threads with vtkSMPTools. The leaves
+ * of each tree are counted first, so that its cells are written where the
+ * serial traversal of the trees would put them.
  *
  * @sa
  * vtkHyperTreeGrid vtkHyperTreeGridAlgorithm
@@ -46,6 +49,7 @@
 class vtkBitArray;
 class vtkCellArray;
 class vtkHyperTreeGrid;
+class vtkIdList;
 class vtkPoints;
 class vtkUnstructuredGrid;
 class vtkHyperTreeGridNonOrientedGeometryCursor;
@@ -73,14 +77,15 @@ protected:
   int ProcessTrees(vtkHyperTreeGrid*, vtkDataObject*) override;
 
   /**
-   * Recursively descend into tree down to leaves
+   * Recursively descend into tree down to leaves, numbering the output cells
+   * from the given index
    */
-  void RecursivelyProcessTree(vtkHyperTreeGridNonOrientedGeometryCursor*);
+  void RecursivelyProcessTree(vtkHyperTreeGridNonOrientedGeometryCursor*, vtkIdType&);
 
   /**
-   * Helper method to generate a 2D or 3D cell
+   * Helper method to generate a 2D or 3D cell at the given output index
    */
-  void AddCell(vtkIdType, double*, double*);
+  void AddCell(vtkIdType, vtkIdType, double*, double*);
 
   /**
    * Storage for points of output unstructured mesh
@@ -92,6 +97,11 @@ protected:
    */
   vtkCellArray* Cells;
 
+  /**
+   * Input cell of each output cell
+   */
+  vtkIdList* InIds;
+
   /**
    * Storage of underlying tree
    */
@@ -99,6 +99,14 @@ public:
   virtual void SetCompressionLevel(int compressionLevel) = 0;
   virtual int GetCompressionLevel() = 0;
 
+  /**
+   * Return true if Compress and Uncompress may be called from several
+   * threads at once, as long as the settings of the compressor do not
+   * change meanwhile. vtkXMLWriter and vtkXMLDataParser then process
+   * several blocks concurrently. The default implementation returns false.
+   */
+  virtual bool IsThreadSafe() { return false; }
+
 protected:
   vtkDataCompressor();
   ~vtkDataCompressor() override;
@@ -56,6 +56,11 @@ public:
   // Compression level getter required by vtkDataCompressor.
   int GetCompressionLevel() override;
 
+  /**
+   * Compression and decompression are thread safe.
+   */
+  bool IsThreadSafe() override { return true; }
+
 protected:
   vtkLZMADataCompressor();
   ~vtkLZMADataCompressor() override;
@@ -0,0 +1,339 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkZFPDataCompressor.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkZFPDataCompressor.h"
+#include "vtkByteSwap.h"
+#include "vtkObjectFactory.h"
+#include "vtkZLibDataCompressor.h"
+#include "vtk_zfp.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+vtkStandardNewMacro(vtkZFPDataCompressor);
+
+// A compressed block starts with a header, in little-endian order:
+//
+//   uint8  dataType;           // VTK_VOID for zlib, VTK_FLOAT or VTK_DOUBLE
+//   uint8  reserved[3];
+//
+// With zlib, the zlib stream follows. With ZFP, the header goes on with:
+//
+//   uint32 numberOfComponents;
+//   uint64 zfpMode;            // encoding of the ZFP parameters
+//   uint64 componentSizes[numberOfComponents];
+//
+// followed by the ZFP stream of each component, as little-endian 64-bit words.
+
+namespace
+{
+const size_t TypeHeaderSize = 4;
+const size_t ZFPHeaderSize = TypeHeaderSize + 4 + 8;
+
+void WriteUInt32(vtkTypeUInt32 value, unsigned char* ptr)
+{
+  vtkByteSwap::Swap4LE(&value);
+  memcpy(ptr, &value, sizeof(value));
+}
+
+void WriteUInt64(vtkTypeUInt64 value, unsigned char* ptr)
+{
+  vtkByteSwap::Swap8LE(&value);
+  memcpy(ptr, &value, sizeof(value));
+}
+
+vtkTypeUInt32 ReadUInt32(unsigned char const* ptr)
+{
+  vtkTypeUInt32 value;
+  memcpy(&value, ptr, sizeof(value));
+  vtkByteSwap::Swap4LE(&value);
+  return value;
+}
+
+vtkTypeUInt64 ReadUInt64(unsigned char const* ptr)
+{
+  vtkTypeUInt64 value;
+  memcpy(&value, ptr, sizeof(value));
+  vtkByteSwap::Swap8LE(&value);
+  return value;
+}
+
+zfp_type GetZFPType(int dataType)
+{
+  return dataType == VTK_FLOAT ? zfp_type_float : zfp_type_double;
+}
+
+// Number of values of the given component in interleaved data.
+size_t GetNumberOfComponentValues(size_t numValues, size_t numComps, size_t comp)
+{
+  return comp < numValues ? (numValues - comp + numComps - 1) / numComps : 0;
+}
+
+// Strided view of the values of one component, as a one-dimensional field.
+zfp_field* NewComponentField(
+  void* data, int dataType, size_t numValues, size_t numComps, size_t comp)
+{
+  const size_t valueSize = dataType == VTK_FLOAT ? sizeof(float) : sizeof(double);
+  void* start = data ? static_cast<unsigned char*>(data) + comp * valueSize : nullptr;
+  zfp_field* field = zfp_field_1d(start, GetZFPType(dataType),
+    static_cast<unsigned int>(GetNumberOfComponentValues(numValues, numComps, comp)));
+  zfp_field_set_stride_1d(field, static_cast<int>(numComps));
+  return field;
+}
+
+zfp_stream* NewStream(int mode, double rate, double tolerance, int dataType)
+{
+  zfp_stream* zfp = zfp_stream_open(nullptr);
+  switch (mode)
+  {
+    case vtkZFPDataCompressor::FIXED_RATE:
+      zfp_stream_set_rate(zfp, rate, GetZFPType(dataType), 1, 0);
+      break;
+    case vtkZFPDataCompressor::FIXED_ACCURACY:
+      zfp_stream_set_accuracy(zfp, tolerance);
+      break;
+    default:
+      zfp_stream_set_reversible(zfp);
+      break;
+  }
+  return zfp;
+}
+}
+
+//------------------------------------------------------------------------------
+vtkZFPDataCompressor::vtkZFPDataCompressor()
+{
+  this->Mode = FIXED_RATE;
+  this->Rate = 12.0;
+  this->Tolerance = 1e-6;
+  this->DataType = VTK_VOID;
+  this->NumberOfComponents = 1;
+  this->CompressionLevel = 5;
+  this->ZLibCompressor = vtkZLibDataCompressor::New();
+  this->ZLibCompressor->SetCompressionLevel(this->CompressionLevel);
+}
+
+//------------------------------------------------------------------------------
+vtkZFPDataCompressor::~vtkZFPDataCompressor()
+{
+  this->ZLibCompressor->Delete();
+}
+
+//------------------------------------------------------------------------------
+void vtkZFPDataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Mode: " << this->Mode << endl;
+  os << indent << "Rate: " << this->Rate << endl;
+  os << indent << "Tolerance: " << this->Tolerance << endl;
+  os << indent << "DataType: " << this->DataType << endl;
+  os << indent << "NumberOfComponents: " << this->NumberOfComponents << endl;
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
+}
+
+//------------------------------------------------------------------------------
+bool vtkZFPDataCompressor::UseZFP(size_t uncompressedSize) const
+{
+  if (this->DataType != VTK_FLOAT && this->DataType != VTK_DOUBLE)
+  {
+    return false;
+  }
+  const size_t valueSize = this->DataType == VTK_FLOAT ? sizeof(float) : sizeof(double);
+  return uncompressedSize > 0 && uncompressedSize % valueSize == 0 &&
+    uncompressedSize / valueSize <= VTK_UNSIGNED_INT_MAX;
+}
+
+//------------------------------------------------------------------------------
+size_t vtkZFPDataCompressor::CompressBuffer(unsigned char const* uncompressedData,
+  size_t uncompressedSize, unsigned char* compressedData, size_t compressionSpace)
+{
+  if (compressionSpace < ZFPHeaderSize)
+  {
+    vtkErrorMacro("Not enough space to compress data.");
+    return 0;
+  }
+  memset(compressedData, 0, TypeHeaderSize);
+
+  if (!this->UseZFP(uncompressedSize))
+  {
+    compressedData[0] = VTK_VOID;
+    const size_t zlibSize = this->ZLibCompressor->Compress(uncompressedData, uncompressedSize,
+      compressedData + TypeHeaderSize, compressionSpace - TypeHeaderSize);
+    return zlibSize ? TypeHeaderSize + zlibSize : 0;
+  }
+
+  const int dataType = this->DataType;
+  const size_t numValues = uncompressedSize / (dataType == VTK_FLOAT ? 4 : 8);
+  const size_t numComps = std::min(static_cast<size_t>(this->NumberOfComponents), numValues);
+  size_t offset = ZFPHeaderSize + 8 * numComps;
+  if (compressionSpace < offset)
+  {
+    vtkErrorMacro("Not enough space to compress data.");
+    return 0;
+  }
+
+  zfp_stream* zfp = NewStream(this->Mode, this->Rate, this->Tolerance, dataType);
+  compressedData[0] = static_cast<unsigned char>(dataType);
+  WriteUInt32(static_cast<vtkTypeUInt32>(numComps), compressedData + TypeHeaderSize);
+  WriteUInt64(zfp_stream_mode(zfp), compressedData + TypeHeaderSize + 4);
+
+  // The bit stream is written in whole words, so compress to an aligned
+  // buffer before copying to the output.
+  std::vector<vtkTypeUInt64> words;
+  bool success = true;
+  for (size_t comp = 0; success && comp < numComps; ++comp)
+  {
+    zfp_field* field = NewComponentField(
+      const_cast<unsigned char*>(uncompressedData), dataType, numValues, numComps, comp);
+    const size_t maxSize = zfp_stream_maximum_size(zfp, field);
+    words.resize((maxSize + 7) / 8);
+    bitstream* stream = stream_open(words.data(), words.size() * 8);
+    zfp_stream_set_bit_stream(zfp, stream);
+    zfp_stream_rewind(zfp);
+    const size_t size = zfp_compress(zfp, field);
+    stream_close(stream);
+    zfp_field_free(field);
+
+    if (size == 0 || size % 8 != 0 || offset + size > compressionSpace)
+    {
+      vtkErrorMacro("ZFP error while compressing data.");
+      success = false;
+      break;
+    }
+    vtkByteSwap::Swap8LERange(words.data(), size / 8);
+    memcpy(compressedData + offset, words.data(), size);
+    WriteUInt64(size, compressedData + ZFPHeaderSize + 8 * comp);
+    offset += size;
+  }
+  zfp_stream_close(zfp);
+  return success ? offset : 0;
+}
+
+//------------------------------------------------------------------------------
+size_t vtkZFPDataCompressor::UncompressBuffer(unsigned char const* compressedData,
+  size_t compressedSize, unsigned char* uncompressedData, size_t uncompressedSize)
+{
+  if (compressedSize < TypeHeaderSize)
+  {
+    vtkErrorMacro("ZFP error while uncompressing data: truncated header.");
+    return 0;
+  }
+
+  const int dataType = compressedData[0];
+  if (dataType == VTK_VOID)
+  {
+    return this->ZLibCompressor->Uncompress(compressedData + TypeHeaderSize,
+      compressedSize - TypeHeaderSize, uncompressedData, uncompressedSize);
+  }
+
+  const size_t valueSize = dataType == VTK_FLOAT ? 4 : 8;
+  if ((dataType != VTK_FLOAT && dataType != VTK_DOUBLE) || compressedSize < ZFPHeaderSize ||
+    uncompressedSize % valueSize != 0)
+  {
+    vtkErrorMacro("ZFP error while uncompressing data: invalid header.");
+    return 0;
+  }
+  const size_t numValues = uncompressedSize / valueSize;
+  const size_t numComps = ReadUInt32(compressedData + TypeHeaderSize);
+  size_t offset = ZFPHeaderSize + 8 * numComps;
+  if (numComps == 0 || numComps > numValues || compressedSize < offset)
+  {
+    vtkErrorMacro("ZFP error while uncompressing data: invalid header.");
+    return 0;
+  }
+
+  zfp_stream* zfp = zfp_stream_open(nullptr);
+  bool success =
+    zfp_stream_set_mode(zfp, ReadUInt64(compressedData + TypeHeaderSize + 4)) != zfp_mode_null;
+
+  std::vector<vtkTypeUInt64> words;
+  for (size_t comp = 0; success && comp < numComps; ++comp)
+  {
+    const size_t size = ReadUInt64(compressedData + ZFPHeaderSize + 8 * comp);
+    if (size % 8 != 0 || size > compressedSize - offset)
+    {
+      success = false;
+      break;
+    }
+    words.resize(size / 8);
+    memcpy(words.data(), compressedData + offset, size);
+    vtkByteSwap::Swap8LERange(words.data(), words.size());
+
+    zfp_field* field = NewComponentField(uncompressedData, dataType, numValues, numComps, comp);
+    bitstream* stream = stream_open(words.data(), size);
+    zfp_stream_set_bit_stream(zfp, stream);
+    zfp_stream_rewind(zfp);
+    success = zfp_decompress(zfp, field) != 0;
+    stream_close(stream);
+    zfp_field_free(field);
+    offset += size;
+  }
+  zfp_stream_close(zfp);
+
+  if (!success)
+  {
+    vtkErrorMacro("ZFP error while uncompressing data.");
+    return 0;
+  }
+  return uncompressedSize;
+}
+
+//------------------------------------------------------------------------------
+int vtkZFPDataCompressor::GetCompressionLevel()
+{
+  return this->CompressionLevel;
+}
+
+//------------------------------------------------------------------------------
+void vtkZFPDataCompressor::SetCompressionLevel(int compressionLevel)
+{
+  int min = 1;
+  int max = 9;
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting CompressionLevel to "
+                << compressionLevel);
+  compressionLevel = std::max(min, std::min(max, compressionLevel));
+  this->ZLibCompressor->SetCompressionLevel(compressionLevel);
+  // Level 1 keeps 20 bits per value, level 9 keeps 4.
+  if (this->CompressionLevel != compressionLevel)
+  {
+    this->CompressionLevel = compressionLevel;
+    this->Rate = 2.0 * (11 - compressionLevel);
+    this->Modified();
+  }
+}
+
+//------------------------------------------------------------------------------
+size_t vtkZFPDataCompressor::GetMaximumCompressionSpace(size_t size)
+{
+  if (!this->UseZFP(size))
+  {
+    return TypeHeaderSize + this->ZLibCompressor->GetMaximumCompressionSpace(size);
+  }
+
+  const int dataType = this->DataType;
+  const size_t numValues = size / (dataType == VTK_FLOAT ? 4 : 8);
+  const size_t numComps = std::min(static_cast<size_t>(this->NumberOfComponents), numValues);
+  size_t space = ZFPHeaderSize + 8 * numComps;
+  zfp_stream* zfp = NewStream(this->Mode, this->Rate, this->Tolerance, dataType);
+  for (size_t comp = 0; comp < numComps; ++comp)
+  {
+    zfp_field* field = NewComponentField(nullptr, dataType, numValues, numComps, comp);
+    space += (zfp_stream_maximum_size(zfp, field) + 7) / 8 * 8;
+    zfp_field_free(field);
+  }
+  zfp_stream_close(zfp);
+  return space;
+}
@@ -0,0 +1,164 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkZFPDataCompressor.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkZFPDataCompressor
+ * @brief   Data compression using ZFP.
+ *
+ * vtkZFPDataCompressor provides a concrete vtkDataCompressor class
+ * using the ZFP floating-point compressor. Unless it is in reversible
+ * mode, ZFP is lossy: it is meant for float and double fields for which
+ * a bounded error is acceptable.
+ *
+ * Since a compressor only sees bytes, the type and the number of
+ * components of the data must be set with SetDataType and
+ * SetNumberOfComponents before compressing. vtkXMLWriter does so for
+ * each array it writes. The values of each component are compressed as
+ * a separate one-dimensional field. Data that is neither float nor
+ * double is compressed losslessly with zlib. Decompression does not
+ * depend on these settings, which are stored in each compressed block.
+ *
+ * Three modes are available:
+ * - FIXED_RATE: each value is stored with Rate bits. The compression
+ *   level sets the rate, from 20 bits at level 1 to 4 bits at level 9.
+ * - FIXED_ACCURACY: the absolute error of each value is at most Tolerance.
+ * - REVERSIBLE: the data is compressed losslessly.
+ *
+ * @warning
+ * ZFP does not support non-finite values in the lossy modes.
+ *
+ * @sa
+ * vtkXMLWriter
+ */
+
+#ifndef vtkZFPDataCompressor_h
+#define vtkZFPDataCompressor_h
+
+#include "vtkDataCompressor.h"
+#include "vtkIOCoreModule.h" // For export macro
+
+class vtkZLibDataCompressor;
+
+class VTKIOCORE_EXPORT vtkZFPDataCompressor : public vtkDataCompressor
+{
+public:
+  vtkTypeMacro(vtkZFPDataCompressor, vtkDataCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+  static vtkZFPDataCompressor* New();
+
+  enum Modes
+  {
+    FIXED_RATE,
+    FIXED_ACCURACY,
+    REVERSIBLE
+  };
+
+  //@{
+  /**
+   * Set/Get the compression mode. Default is FIXED_RATE.
+   */
+  vtkSetClampMacro(Mode, int, FIXED_RATE, REVERSIBLE);
+  vtkGetMacro(Mode, int);
+  void SetModeToFixedRate() { this->SetMode(FIXED_RATE); }
+  void SetModeToFixedAccuracy() { this->SetMode(FIXED_ACCURACY); }
+  void SetModeToReversible() { this->SetMode(REVERSIBLE); }
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of bits per value in FIXED_RATE mode. Default is
+   * 12, which is the rate of compression level 5.
+   */
+  vtkSetClampMacro(Rate, double, 1.0, 64.0);
+  vtkGetMacro(Rate, double);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the maximum absolute error in FIXED_ACCURACY mode. Default is
+   * 1e-6.
+   */
+  vtkSetClampMacro(Tolerance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Tolerance, double);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the type of the values to compress. Only VTK_FLOAT and
+   * VTK_DOUBLE are compressed with ZFP. Default is VTK_VOID, for which the
+   * data is compressed with zlib.
+   */
+  vtkSetMacro(DataType, int);
+  vtkGetMacro(DataType, int);
+  //@}
+
+  //@{
+  /**
+   * Set/Get the number of interleaved components of the values to
+   * compress. Default is 1.
+   */
+  vtkSetClampMacro(NumberOfComponents, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfComponents, int);
+  //@}
+
+  /**
+   *  Get the maximum space that may be needed to store data of the
+   *  given uncompressed size after compression, with the current data
+   *  type and number of components.
+   */
+  size_t GetMaximumCompressionSpace(size_t size) override;
+
+  //@{
+  /**
+   *  Get/Set the compression level. In FIXED_RATE mode, it sets the rate.
+   */
+  int GetCompressionLevel() override;
+  void SetCompressionLevel(int compressionLevel) override;
+  //@}
+
+  /**
+   * Compression and decompression are thread safe.
+   */
+  bool IsThreadSafe() override { return true; }
+
+protected:
+  vtkZFPDataCompressor();
+  ~vtkZFPDataCompressor() override;
+
+  int Mode;
+  double Rate;
+  double Tolerance;
+  int DataType;
+  int NumberOfComponents;
+  int CompressionLevel;
+
+  // Lossless compressor of the data that ZFP does not handle.
+  vtkZLibDataCompressor* ZLibCompressor;
+
+  // Compression method required by vtkDataCompressor.
+  size_t CompressBuffer(unsigned char const* uncompressedData, size_t uncompressedSize,
+    unsigned char* compressedData, size_t compressionSpace) override;
+  // Decompression method required by vtkDataCompressor.
+  size_t UncompressBuffer(unsigned char const* compressedData, size_t compressedSize,
+    unsigned char* uncompressedData, size_t uncompressedSize) override;
+
+  // Whether the data is compressed with ZFP, given the current settings.
+  bool UseZFP(size_t uncompressedSize) const;
+
+private:
+  vtkZFPDataCompressor(const vtkZFPDataCompressor&) = delete;
+  void operator=(const vtkZFPDataCompressor&) = delete;
+};
+
+#endif
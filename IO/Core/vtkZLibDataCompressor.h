@@ -52,6 +52,11 @@ public:
   void SetCompressionLevel(int compressionLevel) override;
   //@}
 
+  /**
+   * Compression and decompression are thread safe.
+   */
+  bool IsThreadSafe() override { return true; }
+
 protected:
   vtkZLibDataCompressor();
   ~vtkZLibDataCompressor() override;
@@ -0,0 +1,215 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOBJReaderParsing.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks the values and indices read by vtkOBJReader, whose vertex values
+// are parsed in parallel, on a file with all the formats of face vertices,
+// relative indices, continuation lines, points and lines.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkOBJReader.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkTestUtilities.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const int GridSize = 60;
+
+int PointId(int i, int j)
+{
+  return i + GridSize * j;
+}
+
+bool CheckCell(vtkCellArray* cells, vtkIdType cellId, const std::vector<vtkIdType>& expected)
+{
+  vtkNew<vtkIdList> ids;
+  cells->GetCellAtId(cellId, ids);
+  if (ids->GetNumberOfIds() != static_cast<vtkIdType>(expected.size()))
+  {
+    std::cerr << "Wrong size of cell " << cellId << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+  {
+    if (ids->GetId(i) != expected[i])
+    {
+      std::cerr << "Wrong point " << i << " of cell " << cellId << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestOBJReaderParsing(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string fileName = std::string(tempDir) + "/TestOBJReaderParsing.obj";
+  delete[] tempDir;
+
+  // a grid of points with the same normal and tcoord indices, whose values
+  // are exact in floating point. The tcoords of the points that are not used
+  // with a tcoord index are (-1, -1).
+  const vtkIdType last = GridSize * GridSize;
+  std::vector<std::vector<vtkIdType>> polys;
+  std::vector<bool> textured(last + 2, false);
+  {
+    std::ofstream file(fileName.c_str());
+    file << "# grid\n";
+    for (int j = 0; j < GridSize; ++j)
+    {
+      for (int i = 0; i < GridSize; ++i)
+      {
+        file << "v " << 0.5 * i << " " << 0.25 * j << "  " << -0.125 * (i % 3) << "\n";
+        file << "vn 0 " << (j % 2) << " 1\n";
+        file << "vt\t" << i / 64.0 << " " << j / 64.0 << "\n";
+      }
+    }
+    file << "g grid\n";
+    for (int j = 0; j + 1 < GridSize; ++j)
+    {
+      for (int i = 0; i + 1 < GridSize; ++i)
+      {
+        const int a = PointId(i, j) + 1, b = PointId(i + 1, j) + 1, c = PointId(i, j + 1) + 1;
+        switch ((i + j) % 3)
+        {
+          case 0:
+            file << "f " << a << "/" << a << "/" << a << " " << b << "/" << b << "/" << b << " "
+                 << c << "/" << c << "/" << c << "\n";
+            textured[a - 1] = textured[b - 1] = textured[c - 1] = true;
+            break;
+          case 1:
+            file << "f " << a << "//" << a << " " << b << "//" << b << " " << c << "//" << c
+                 << "\n";
+            break;
+          default:
+            file << "f " << a << "/" << a << " " << b << "/" << b << " \\\n"
+                 << "  " << c << "/" << c << "\n";
+            textured[a - 1] = textured[b - 1] = textured[c - 1] = true;
+            break;
+        }
+        polys.push_back({ a - 1, b - 1, c - 1 });
+      }
+    }
+    // relative indices, after one more point
+    file << "g last\n";
+    file << "v 1e-3 -2.5E2 3\n";
+    file << "vn 0 0 -1\n";
+    file << "vt 0.5 0.5\n";
+    file << "f -1 -2 \\\n -3 -4\n";
+    polys.push_back({ last, last - 1, last - 2, last - 3 });
+    file << "l 1/1 -1/-1 2\n";
+    file << "p 3 -2\n";
+    // values missing after the end of a line or a value that is not a number
+    // are the ones of the previous line
+    file << "v 2 x 5\n";
+    file << "vn 0.5\n";
+    file << "vt 0.25\n";
+  }
+
+  vtkNew<vtkOBJReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkPolyData* output = reader->GetOutput();
+
+  const vtkIdType numPoints = last + 2;
+  if (output->GetNumberOfPoints() != numPoints ||
+    output->GetNumberOfPolys() != static_cast<vtkIdType>(polys.size()) ||
+    output->GetNumberOfLines() != 1 || output->GetNumberOfVerts() != 1)
+  {
+    std::cerr << "Wrong numbers of points or cells" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (std::string(reader->GetComment()) != "grid")
+  {
+    std::cerr << "Wrong comment " << reader->GetComment() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkDataArray* normals = output->GetPointData()->GetNormals();
+  vtkDataArray* tcoords = output->GetPointData()->GetTCoords();
+  if (!normals || !tcoords || normals->GetNumberOfTuples() != numPoints ||
+    tcoords->GetNumberOfTuples() != numPoints)
+  {
+    std::cerr << "Wrong normals or tcoords" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (int j = 0; j < GridSize; ++j)
+  {
+    for (int i = 0; i < GridSize; ++i)
+    {
+      const vtkIdType id = PointId(i, j);
+      double x[3];
+      output->GetPoint(id, x);
+      const double* n = normals->GetTuple3(id);
+      const double* t = tcoords->GetTuple2(id);
+      const double u = textured[id] ? i / 64.0 : -1.0;
+      const double v = textured[id] ? j / 64.0 : -1.0;
+      if (x[0] != 0.5 * i || x[1] != 0.25 * j || x[2] != -0.125 * (i % 3) || n[0] != 0.0 ||
+        n[1] != (j % 2) || n[2] != 1.0 || t[0] != u || t[1] != v)
+      {
+        std::cerr << "Wrong values for point " << id << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  double x[3];
+  output->GetPoint(last, x);
+  if (x[0] != 1e-3f || x[1] != -250.0 || x[2] != 3.0 || normals->GetComponent(last, 2) != -1.0)
+  {
+    std::cerr << "Wrong values for the last point" << std::endl;
+    return EXIT_FAILURE;
+  }
+  output->GetPoint(last + 1, x);
+  const double* n = normals->GetTuple3(last + 1);
+  if (x[0] != 2.0 || x[1] != 0.0 || x[2] != -1.0 || n[0] != 0.5 || n[1] != 0.0 || n[2] != -1.0)
+  {
+    std::cerr << "Wrong values for the point with missing values" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (vtkIdType i = 0; i < static_cast<vtkIdType>(polys.size()); ++i)
+  {
+    if (!CheckCell(output->GetPolys(), i, polys[i]))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  if (!CheckCell(output->GetLines(), 0, { 0, last, 1 }) ||
+    !CheckCell(output->GetVerts(), 0, { 2, last - 1 }))
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkDataArray* groups = output->GetCellData()->GetArray("GroupIds");
+  if (!groups || groups->GetComponent(0, 0) != 0.0 ||
+    groups->GetComponent(static_cast<vtkIdType>(polys.size()) - 1, 0) != 1.0)
+  {
+    std::cerr << "Wrong group ids" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
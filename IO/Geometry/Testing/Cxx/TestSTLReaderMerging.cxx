@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSTLReaderMerging.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the parallel merging of the points done by default by
+// vtkSTLReader gives the same output as merging with a vtkMergePoints locator,
+// on binary and ASCII files with coincident points, signed zeros and
+// degenerate triangles.
+
+#include "vtkCellArray.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSTLReader.h"
+#include "vtkSTLWriter.h"
+#include "vtkSphereSource.h"
+#include "vtkTestDataComparison.h"
+#include "vtkTestUtilities.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+void MakeInput(vtkPolyData* input)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(300);
+  sphere->SetPhiResolution(200);
+  sphere->Update();
+  input->DeepCopy(sphere->GetOutput());
+
+  // points at the origin with signed zeros, and degenerate triangles
+  vtkPoints* points = input->GetPoints();
+  const vtkIdType zero = points->InsertNextPoint(0.0, 0.0, 0.0);
+  const vtkIdType negativeZero = points->InsertNextPoint(-0.0, 0.0, -0.0);
+  const vtkIdType corner = points->InsertNextPoint(1.0, 1.0, 1.0);
+  vtkCellArray* polys = input->GetPolys();
+  const vtkIdType triangles[][3] = { { zero, corner, 0 }, { negativeZero, 1, corner },
+    { zero, negativeZero, corner }, { 2, 2, 3 }, { corner, 4, 5 } };
+  for (const auto& triangle : triangles)
+  {
+    polys->InsertNextCell(3, triangle);
+  }
+}
+
+bool TestFile(const std::string& fileName, bool scalarTags)
+{
+  vtkNew<vtkSTLReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetScalarTags(scalarTags);
+  reader->Update();
+
+  vtkNew<vtkSTLReader> referenceReader;
+  referenceReader->SetFileName(fileName.c_str());
+  referenceReader->SetScalarTags(scalarTags);
+  vtkNew<vtkMergePoints> locator;
+  referenceReader->SetLocator(locator);
+  referenceReader->Update();
+
+  vtkNew<vtkSTLReader> unmergedReader;
+  unmergedReader->SetFileName(fileName.c_str());
+  unmergedReader->MergingOff();
+  unmergedReader->Update();
+
+  vtkPolyData* unmerged = unmergedReader->GetOutput();
+  if (unmerged->GetNumberOfPoints() != 3 * unmerged->GetNumberOfPolys())
+  {
+    std::cerr << fileName << ": the triangles do not have their own points" << std::endl;
+    return false;
+  }
+  return vtkTestDataComparison::SameDataSets(
+    reader->GetOutput(), referenceReader->GetOutput(), fileName.c_str());
+}
+}
+
+int TestSTLReaderMerging(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+  {
+    std::cout << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+  }
+  const std::string testDirectory = tempDir;
+  delete[] tempDir;
+
+  vtkNew<vtkPolyData> input;
+  MakeInput(input);
+
+  vtkNew<vtkSTLWriter> writer;
+  writer->SetInputData(input);
+  const std::string binaryFileName = testDirectory + "/TestSTLReaderMergingBinary.stl";
+  writer->SetFileName(binaryFileName.c_str());
+  writer->SetFileTypeToBinary();
+  writer->Write();
+  const std::string asciiFileName = testDirectory + "/TestSTLReaderMergingASCII.stl";
+  writer->SetFileName(asciiFileName.c_str());
+  writer->SetFileTypeToASCII();
+  writer->Write();
+
+  if (!TestFile(binaryFileName, false) || !TestFile(asciiFileName, false) ||
+    !TestFile(asciiFileName, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -21,9 +21,15 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include <algorithm>
 #include <cctype>
-#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <locale>
 #include <unordered_map>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 #include "vtkCellData.h"
@@ -31,6 +37,170 @@
 
 vtkStandardNewMacro(vtkOBJReader);
 
+namespace
+{
+// The contents of the file, read at once. GetLine() copies the next line
+// like fgets() does.
+class OBJFileBuffer
+{
+public:
+  bool Read(FILE* file, size_t fileLength)
+  {
+    this->Data.resize(fileLength + 1);
+    size_t size = 0;
+    size_t numRead;
+    while ((numRead = fread(&this->Data[size], 1, this->Data.size() - size, file)) > 0)
+    {
+      size += numRead;
+      if (size == this->Data.size())
+      {
+        this->Data.resize(2 * size);
+      }
+    }
+    this->Data.resize(size);
+    this->Position = 0;
+    return !ferror(file);
+  }
+
+  bool GetLine(char* line, size_t maxLength)
+  {
+    if (this->Position >= this->Data.size())
+    {
+      return false;
+    }
+    this->LineStart = this->Position;
+    const char* begin = this->Data.data() + this->Position;
+    const size_t available = std::min(this->Data.size() - this->Position, maxLength - 1);
+    const char* newline = static_cast<const char*>(memchr(begin, '\n', available));
+    const size_t length = newline ? static_cast<size_t>(newline - begin) + 1 : available;
+    memcpy(line, begin, length);
+    line[length] = '\0';
+    this->Position += length;
+    return true;
+  }
+
+  bool AtEnd() const { return this->Position >= this->Data.size(); }
+  void Rewind() { this->Position = 0; }
+
+  // The offset in the file of the last line read.
+  size_t GetLineStart() const { return this->LineStart; }
+  const char* GetData() const { return this->Data.data(); }
+
+private:
+  std::vector<char> Data;
+  size_t Position = 0;
+  size_t LineStart = 0;
+};
+
+// The values of "v", "vn" and "vt" lines, as ranges of the file, are parsed
+// in parallel once the file is read.
+using OBJRanges = std::vector<std::pair<size_t, size_t>>;
+
+// A stream on a range of the file, which is parsed with the classic locale.
+class OBJRangeBuffer : public std::streambuf
+{
+public:
+  void SetRange(const char* begin, const char* end)
+  {
+    this->setg(const_cast<char*>(begin), const_cast<char*>(begin), const_cast<char*>(end));
+  }
+};
+
+// Parses the values of each range, and stores how many were extracted. The
+// extraction stops at the end of the range, or after a value that is not a
+// number, which the stream reads as 0.
+void ParseValues(const OBJFileBuffer& buffer, const OBJRanges& ranges, int numComps, float* values,
+  std::vector<unsigned char>& counts)
+{
+  counts.resize(ranges.size());
+  vtkSMPTools::For(0, static_cast<vtkIdType>(ranges.size()), [&](vtkIdType begin, vtkIdType end) {
+    OBJRangeBuffer range;
+    std::istream stream(&range);
+    stream.imbue(std::locale::classic());
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      range.SetRange(buffer.GetData() + ranges[i].first, buffer.GetData() + ranges[i].second);
+      stream.clear();
+      float* x = values + numComps * i;
+      int count = 0;
+      while (count < numComps && (stream >> std::ws).good())
+      {
+        stream >> x[count++];
+        if (stream.fail())
+        {
+          break;
+        }
+      }
+      counts[i] = static_cast<unsigned char>(count);
+    }
+  });
+}
+
+// The values of the previous "v", "vn" or "vt" line, which a line with
+// fewer values keeps for the others, as when every line was extracted into
+// the same variables.
+class OBJPreviousValues
+{
+public:
+  void Fill(float* x, int numComps, int count)
+  {
+    std::copy(this->Values + count, this->Values + numComps, x + count);
+    std::copy(x, x + numComps, this->Values);
+  }
+
+private:
+  float Values[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+// Reads an index like sscanf("%d"), returns the end of the index, or nullptr
+// if there is none.
+const char* ParseIndex(const char* text, int& index)
+{
+  char* end;
+  const long value = strtol(text, &end, 10);
+  if (end == text)
+  {
+    return nullptr;
+  }
+  index = static_cast<int>(value);
+  return end;
+}
+
+enum OBJFaceIndices
+{
+  NoIndices,
+  VertexIndex,
+  VertexTCoordIndices,
+  VertexNormalIndices,
+  AllIndices
+};
+
+// Reads the indices of a face vertex, "v/t/n", "v//n", "v/t" or "v", taking
+// the first of these formats that sscanf would match.
+OBJFaceIndices ParseFaceIndices(const char* text, int& iVert, int& iTCoord, int& iNormal)
+{
+  const char* end = ParseIndex(text, iVert);
+  if (!end)
+  {
+    return NoIndices;
+  }
+  if (end[0] != '/')
+  {
+    return VertexIndex;
+  }
+  if (end[1] == '/')
+  {
+    return ParseIndex(end + 2, iNormal) ? VertexNormalIndices : VertexIndex;
+  }
+  end = ParseIndex(end + 1, iTCoord);
+  if (!end)
+  {
+    return VertexIndex;
+  }
+  return (end[0] == '/' && ParseIndex(end + 1, iNormal)) ? AllIndices : VertexTCoordIndices;
+}
+}
+
 //------------------------------------------------------------------------------
 vtkOBJReader::vtkOBJReader()
 {
@@ -132,10 +302,20 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
 
   vtkDebugMacro(<< "Reading file");
 
+  // the file is parsed twice, from memory
+  OBJFileBuffer buffer;
+  const bool readOk = buffer.Read(in, vtksys::SystemTools::FileLength(this->FileName));
+  fclose(in);
+  if (!readOk)
+  {
+    vtkErrorMacro(<< "Error reading file " << this->FileName);
+    return 0;
+  }
+
   // initialize some structures to store the file contents in
   vtkPoints* points = vtkPoints::New();
   std::unordered_map<std::string, vtkFloatArray*> tcoords_map;
-  std::vector<std::pair<float, float>> verticesTextureList;
+  std::vector<float> verticesTextureList; // (u, v) pairs
   vtkFloatArray* normals = vtkFloatArray::New();
   normals->SetNumberOfComponents(3);
   normals->SetName("Normals");
@@ -178,7 +358,13 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
     const int MAX_LINE = 1024 * 256;
     char rawLine[MAX_LINE];
     char tcoordsName[100];
-    float xyz[3];
+    OBJRanges tcoordRanges;
+    OBJRanges pointRanges;
+    OBJRanges normalRanges;
+    std::vector<unsigned char> tcoordCounts;
+    std::vector<unsigned char> pointCounts;
+    std::vector<unsigned char> normalCounts;
+    OBJPreviousValues previousValues;
     int numPoints = 0;
     int numTCoords = 0;
     int numNormals = 0;
@@ -187,13 +373,13 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
     bool readingFirstComment = true;
     std::string firstComment;
     int lineNr = 0;
-    while (everything_ok && fgets(rawLine, MAX_LINE, in) != nullptr)
+    while (everything_ok && buffer.GetLine(rawLine, MAX_LINE))
     {
       ++lineNr;
       char* pLine = rawLine;
       char* pEnd = rawLine + strlen(rawLine);
 
-      if (*(pEnd - 1) != '\n' && !feof(in))
+      if (*(pEnd - 1) != '\n' && !buffer.AtEnd())
       {
         vtkErrorMacro(<< "Line longer than " << MAX_LINE << ": " << pLine);
         everything_ok = false;
@@ -263,22 +449,18 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
       else if (strcmp(cmd, "vt") == 0)
       {
         // this is a tcoord, expect two floats, separated by whitespace:
-        std::stringstream dataStream;
-        dataStream.imbue(std::locale::classic());
-        dataStream << pLine;
-
-        try
-        {
-          dataStream >> xyz[0] >> xyz[1];
-          verticesTextureList.emplace_back(xyz[0], xyz[1]);
-        }
-        catch (const std::exception&)
-        {
-          vtkErrorMacro(<< "Error reading 'vt' at line " << lineNr);
-        }
+        tcoordRanges.emplace_back(
+          buffer.GetLineStart() + (pLine - rawLine), buffer.GetLineStart() + (pEnd - rawLine));
       }
     } // (end of first while loop)
 
+    verticesTextureList.resize(2 * tcoordRanges.size());
+    ParseValues(buffer, tcoordRanges, 2, verticesTextureList.data(), tcoordCounts);
+    for (size_t i = 0; i < tcoordRanges.size(); ++i)
+    {
+      previousValues.Fill(&verticesTextureList[2 * i], 2, tcoordCounts[i]);
+    }
+
     // Comment lines include newline characters.
     // Keep newlines between lines of multi-line comment, but
     // remove the last newline to have a clean string when comment is single-line.
@@ -300,7 +482,7 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
 
     // Initialize every texture array with (-1, -1)
     {
-      const vtkIdType nTuples = static_cast<vtkIdType>(verticesTextureList.size());
+      const vtkIdType nTuples = static_cast<vtkIdType>(tcoordRanges.size());
 
       for (const auto& iter : tcoords_map)
       {
@@ -316,8 +498,8 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
 
     // Second loop to parse points, faces, texture coordinates, normals...
     lineNr = 0;
-    fseek(in, 0, SEEK_SET);
-    while (everything_ok && fgets(rawLine, MAX_LINE, in) != nullptr)
+    buffer.Rewind();
+    while (everything_ok && buffer.GetLine(rawLine, MAX_LINE))
     {
       ++lineNr;
       char* pLine = rawLine;
@@ -354,21 +536,9 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
       else if (strcmp(cmd, "v") == 0)
       {
         // vertex definition, expect three floats, separated by whitespace:
-        std::stringstream dataStream;
-        dataStream.imbue(std::locale::classic());
-        dataStream << pLine;
-
-        try
-        {
-          dataStream >> xyz[0] >> xyz[1] >> xyz[2];
-          points->InsertNextPoint(xyz);
-          numPoints++;
-        }
-        catch (const std::exception&)
-        {
-          vtkErrorMacro(<< "Error reading 'v' at line " << lineNr);
-          everything_ok = false;
-        }
+        pointRanges.emplace_back(
+          buffer.GetLineStart() + (pLine - rawLine), buffer.GetLineStart() + (pEnd - rawLine));
+        numPoints++;
       }
       else if (strcmp(cmd, "usemtl") == 0)
       {
@@ -395,22 +565,10 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
       else if (strcmp(cmd, "vn") == 0)
       {
         // vertex normal, expect three floats, separated by whitespace:
-        std::stringstream dataStream;
-        dataStream.imbue(std::locale::classic());
-        dataStream << pLine;
-
-        try
-        {
-          dataStream >> xyz[0] >> xyz[1] >> xyz[2];
-          normals->InsertNextTuple(xyz);
-          hasNormals = true;
-          numNormals++;
-        }
-        catch (const std::exception&)
-        {
-          vtkErrorMacro(<< "Error reading 'vn' at line " << lineNr);
-          everything_ok = false;
-        }
+        normalRanges.emplace_back(
+          buffer.GetLineStart() + (pLine - rawLine), buffer.GetLineStart() + (pEnd - rawLine));
+        hasNormals = true;
+        numNormals++;
       }
       else if (strcmp(cmd, "p") == 0)
       {
@@ -430,7 +588,7 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
           if (pLine < pEnd) // there is still data left on this line
           {
             int iVert;
-            if (sscanf(pLine, "%d", &iVert) == 1)
+            if (ParseIndex(pLine, iVert))
             {
               if (iVert < 0)
               {
@@ -445,7 +603,7 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
             else if (strcmp(pLine, "\\\n") == 0)
             {
               // handle backslash-newline continuation
-              if (fgets(rawLine, MAX_LINE, in) != nullptr)
+              if (buffer.GetLine(rawLine, MAX_LINE))
               {
                 lineNr++;
                 pLine = rawLine;
@@ -499,8 +657,8 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
 
           if (pLine < pEnd) // there is still data left on this line
           {
-            int iVert, dummyInt;
-            if (sscanf(pLine, "%d/%d", &iVert, &dummyInt) == 2)
+            int iVert;
+            if (ParseIndex(pLine, iVert))
             {
               // we simply ignore texture information
               if (iVert < 0)
@@ -513,22 +671,10 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
               }
               nVerts++;
             }
-            else if (sscanf(pLine, "%d", &iVert) == 1)
-            {
-              if (iVert < 0)
-              {
-                lineElems->InsertCellPoint(numPoints + iVert);
-              }
-              else
-              {
-                lineElems->InsertCellPoint(iVert - 1);
-              }
-              nVerts++;
-            }
             else if (strcmp(pLine, "\\\n") == 0)
             {
               // handle backslash-newline continuation
-              if (fgets(rawLine, MAX_LINE, in) != nullptr)
+              if (buffer.GetLine(rawLine, MAX_LINE))
               {
                 lineNr++;
                 pLine = rawLine;
@@ -586,7 +732,8 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
           if (pLine < pEnd) // there is still data left on this line
           {
             int iVert, iTCoord, iNormal;
-            if (sscanf(pLine, "%d/%d/%d", &iVert, &iTCoord, &iNormal) == 3)
+            const OBJFaceIndices indices = ParseFaceIndices(pLine, iVert, iTCoord, iNormal);
+            if (indices == AllIndices)
             {
               if (iVert < 0)
               {
@@ -604,10 +751,10 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
 
               // Set the current texture array with the value corresponding to the
               // iTcoords read
-              const auto& currentTCoord = verticesTextureList[iTCoordAbs];
+              const float* currentTCoord = &verticesTextureList[2 * iTCoordAbs];
               auto iter = tcoords_map.find(tcoordsName);
               vtkFloatArray* tcArray = iter->second;
-              tcArray->SetTuple2(iTCoordAbs, currentTCoord.first, currentTCoord.second);
+              tcArray->SetTuple2(iTCoordAbs, currentTCoord[0], currentTCoord[1]);
 
               nTCoords++;
 
@@ -630,7 +777,7 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
                 normals_same_as_verts = false;
               }
             }
-            else if (sscanf(pLine, "%d//%d", &iVert, &iNormal) == 2)
+            else if (indices == VertexNormalIndices)
             {
               if (iVert < 0)
               {
@@ -655,7 +802,7 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
               if (iNormal != iVert)
                 normals_same_as_verts = false;
             }
-            else if (sscanf(pLine, "%d/%d", &iVert, &iTCoord) == 2)
+            else if (indices == VertexTCoordIndices)
             {
               if (iVert < 0)
               {
@@ -673,9 +820,8 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
 
               // Set the current texture array with the value corresponding to the
               // iTcoords read
-              const auto& currentTCoord = verticesTextureList[iTCoordAbs];
-              tcoords_map[tcoordsName]->SetTuple2(
-                iTCoordAbs, currentTCoord.first, currentTCoord.second);
+              const float* currentTCoord = &verticesTextureList[2 * iTCoordAbs];
+              tcoords_map[tcoordsName]->SetTuple2(iTCoordAbs, currentTCoord[0], currentTCoord[1]);
 
               nTCoords++;
               if (iTCoord != iVert)
@@ -683,7 +829,7 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
                 tcoords_same_as_verts = false;
               }
             }
-            else if (sscanf(pLine, "%d", &iVert) == 1)
+            else if (indices == VertexIndex)
             {
               if (iVert < 0)
               {
@@ -698,7 +844,7 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
             else if (strcmp(pLine, "\\\n") == 0)
             {
               // handle backslash-newline continuation
-              if (fgets(rawLine, MAX_LINE, in) != nullptr)
+              if (buffer.GetLine(rawLine, MAX_LINE))
               {
                 lineNr++;
                 pLine = rawLine;
@@ -765,10 +911,34 @@ int vtkOBJReader::RequestData(vtkInformation* vtkNotUsed(request),
 
     } // (end of while loop)
 
-  } // (end of local scope section)
+    if (everything_ok)
+    {
+      points->SetNumberOfPoints(numPoints);
+      float* pointValues = vtkArrayDownCast<vtkFloatArray>(points->GetData())->GetPointer(0);
+      ParseValues(buffer, pointRanges, 3, pointValues, pointCounts);
+      normals->SetNumberOfTuples(numNormals);
+      float* normalValues = normals->GetPointer(0);
+      ParseValues(buffer, normalRanges, 3, normalValues, normalCounts);
+
+      // the missing values are taken from the previous line in file order
+      size_t iNormal = 0;
+      for (size_t iPoint = 0; iPoint <= pointRanges.size(); ++iPoint)
+      {
+        for (; iNormal < normalRanges.size() &&
+             (iPoint == pointRanges.size() ||
+               normalRanges[iNormal].first < pointRanges[iPoint].first);
+             ++iNormal)
+        {
+          previousValues.Fill(normalValues + 3 * iNormal, 3, normalCounts[iNormal]);
+        }
+        if (iPoint < pointRanges.size())
+        {
+          previousValues.Fill(pointValues + 3 * iPoint, 3, pointCounts[iPoint]);
+        }
+      }
+    }
 
-  // we have finished with the file
-  fclose(in);
+  } // (end of local scope section)
 
   const bool hasGroups = (groupId >= 0);
   const bool hasMaterials = (matcnt > 0);
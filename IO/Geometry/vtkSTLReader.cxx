@@ -25,15 +25,22 @@
 #include "vtkMergePoints.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkIdTypeArray.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <numeric>
 #include <string>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 vtkStandardNewMacro(vtkSTLReader);
@@ -44,6 +51,186 @@ vtkStandardNewMacro(vtkSTLReader);
 vtkCxxSetObjectMacro(vtkSTLReader, Locator, vtkIncrementalPointLocator);
 vtkCxxSetObjectMacro(vtkSTLReader, BinaryHeader, vtkUnsignedCharArray);
 
+namespace
+{
+// Number of triangles decoded or merged by one task.
+const vtkIdType STLBlockSize = 1 << 16;
+
+// Calls functor(block, begin, end) on the blocks of [0, n) in parallel.
+template <typename Functor>
+void ForEachBlock(vtkIdType n, Functor&& functor)
+{
+  const vtkIdType numBlocks = (n + STLBlockSize - 1) / STLBlockSize;
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType block = begin; block < end; ++block)
+    {
+      functor(block, block * STLBlockSize, std::min(n, (block + 1) * STLBlockSize));
+    }
+  });
+}
+
+// Replaces the counts of the blocks by their exclusive prefix sum, and
+// returns the total.
+vtkIdType PrefixSum(std::vector<vtkIdType>& counts)
+{
+  vtkIdType total = 0;
+  for (vtkIdType& count : counts)
+  {
+    const vtkIdType blockCount = count;
+    count = total;
+    total += blockCount;
+  }
+  return total;
+}
+
+// Sort key of a point: the bits of its coordinates, with -0 read as 0 since
+// they compare equal. Points with a NaN coordinate are never merged.
+struct PointKey
+{
+  uint32_t Bits[3];
+  bool NaN;
+
+  PointKey(const float* x)
+    : NaN(false)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      const float value = x[i] == 0.0f ? 0.0f : x[i];
+      std::memcpy(this->Bits + i, &value, sizeof(float));
+      this->NaN |= x[i] != x[i];
+    }
+  }
+
+  bool operator==(const PointKey& other) const
+  {
+    return !this->NaN && !other.NaN && this->Bits[0] == other.Bits[0] &&
+      this->Bits[1] == other.Bits[1] && this->Bits[2] == other.Bits[2];
+  }
+
+  bool operator<(const PointKey& other) const
+  {
+    return std::lexicographical_compare(
+      this->Bits, this->Bits + 3, other.Bits, other.Bits + 3);
+  }
+};
+
+// Merges the exactly coincident points of the triangles read, as
+// vtkMergePoints does, but with a parallel sort of the points instead of
+// incremental insertions in a hash table. The reader stores the three points
+// of each triangle one after the other, so that the points are numbered in
+// the order of their first use, as with the locator, and the triangles using
+// a point twice are removed.
+void MergePoints(vtkFloatArray* coords, vtkFloatArray* scalars, vtkPoints* mergedPts,
+  vtkCellArray* mergedPolys, vtkFloatArray* mergedScalars)
+{
+  const vtkIdType numPts = coords->GetNumberOfTuples();
+  const vtkIdType numTris = numPts / 3;
+  const float* x = coords->GetPointer(0);
+
+  // sort the points by coordinates, then by id
+  std::vector<vtkIdType> order(numPts);
+  std::iota(order.begin(), order.end(), 0);
+  vtkSMPTools::Sort(order.begin(), order.end(), [x](vtkIdType a, vtkIdType b) {
+    const PointKey keyA(x + 3 * a);
+    const PointKey keyB(x + 3 * b);
+    return keyA < keyB || (!(keyB < keyA) && a < b);
+  });
+
+  // each point is represented by the first of the points equal to it
+  std::vector<vtkIdType> representatives(numPts);
+  ForEachBlock(numPts, [&](vtkIdType, vtkIdType begin, vtkIdType end) {
+    vtkIdType first = begin;
+    while (first > 0 && PointKey(x + 3 * order[first - 1]) == PointKey(x + 3 * order[begin]))
+    {
+      --first;
+    }
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (i > first && !(PointKey(x + 3 * order[i]) == PointKey(x + 3 * order[i - 1])))
+      {
+        first = i;
+      }
+      representatives[order[i]] = order[first];
+    }
+  });
+  std::vector<vtkIdType>().swap(order);
+
+  // number the representatives in the order of the points
+  const vtkIdType numPtBlocks = (numPts + STLBlockSize - 1) / STLBlockSize;
+  std::vector<vtkIdType> blockPts(numPtBlocks, 0);
+  ForEachBlock(numPts, [&](vtkIdType block, vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      blockPts[block] += representatives[i] == i ? 1 : 0;
+    }
+  });
+  const vtkIdType numMergedPts = PrefixSum(blockPts);
+  std::vector<vtkIdType> pointMap(numPts);
+  mergedPts->SetNumberOfPoints(numMergedPts);
+  float* mergedX = vtkArrayDownCast<vtkFloatArray>(mergedPts->GetData())->GetPointer(0);
+  ForEachBlock(numPts, [&](vtkIdType block, vtkIdType begin, vtkIdType end) {
+    vtkIdType ptId = blockPts[block];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (representatives[i] == i)
+      {
+        std::copy(x + 3 * i, x + 3 * i + 3, mergedX + 3 * ptId);
+        pointMap[i] = ptId++;
+      }
+    }
+  });
+  ForEachBlock(numPts, [&](vtkIdType, vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      pointMap[i] = pointMap[representatives[i]];
+    }
+  });
+  std::vector<vtkIdType>().swap(representatives);
+
+  // keep the triangles with three different points
+  auto isValid = [&pointMap](vtkIdType tri) {
+    const vtkIdType* nodes = pointMap.data() + 3 * tri;
+    return nodes[0] != nodes[1] && nodes[0] != nodes[2] && nodes[1] != nodes[2];
+  };
+  const vtkIdType numTriBlocks = (numTris + STLBlockSize - 1) / STLBlockSize;
+  std::vector<vtkIdType> blockTris(numTriBlocks, 0);
+  ForEachBlock(numTris, [&](vtkIdType block, vtkIdType begin, vtkIdType end) {
+    for (vtkIdType tri = begin; tri < end; ++tri)
+    {
+      blockTris[block] += isValid(tri) ? 1 : 0;
+    }
+  });
+  const vtkIdType numMergedTris = PrefixSum(blockTris);
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numMergedTris + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(3 * numMergedTris);
+  if (scalars)
+  {
+    mergedScalars->SetNumberOfValues(numMergedTris);
+  }
+  ForEachBlock(numTris, [&](vtkIdType block, vtkIdType begin, vtkIdType end) {
+    vtkIdType cellId = blockTris[block];
+    for (vtkIdType tri = begin; tri < end; ++tri)
+    {
+      if (isValid(tri))
+      {
+        offsets->SetValue(cellId, 3 * cellId);
+        std::copy(pointMap.data() + 3 * tri, pointMap.data() + 3 * tri + 3,
+          connectivity->GetPointer(3 * cellId));
+        if (scalars)
+        {
+          mergedScalars->SetValue(cellId, scalars->GetValue(tri));
+        }
+        ++cellId;
+      }
+    }
+  });
+  offsets->SetValue(numMergedTris, 3 * numMergedTris);
+  mergedPolys->SetData(offsets, connectivity);
+}
+}
+
 //------------------------------------------------------------------------------
 // Construct object with merging set to true.
 vtkSTLReader::vtkSTLReader()
@@ -159,44 +346,58 @@ int vtkSTLReader::RequestData(vtkInformation* vtkNotUsed(request),
   if (this->Merging)
   {
     mergedPts = vtkSmartPointer<vtkPoints>::New();
-    mergedPts->Allocate(newPts->GetNumberOfPoints() / 2);
     mergedPolys = vtkSmartPointer<vtkCellArray>::New();
-    mergedPolys->AllocateCopy(newPolys);
     if (newScalars)
     {
       mergedScalars = vtkSmartPointer<vtkFloatArray>::New();
-      mergedScalars->Allocate(newPolys->GetNumberOfCells());
     }
 
-    vtkSmartPointer<vtkIncrementalPointLocator> locator = this->Locator;
-    if (this->Locator == nullptr)
+    // The default merging of exactly coincident points is done in parallel,
+    // with the same result as vtkMergePoints.
+    vtkFloatArray* coords = vtkArrayDownCast<vtkFloatArray>(newPts->GetData());
+    if (this->Locator == nullptr && coords &&
+      newPolys->GetNumberOfConnectivityIds() == newPts->GetNumberOfPoints())
     {
-      locator.TakeReference(this->NewDefaultLocator());
+      MergePoints(coords, newScalars, mergedPts, mergedPolys, mergedScalars);
     }
-    locator->InitPointInsertion(mergedPts, newPts->GetBounds());
-
-    int nextCell = 0;
-    const vtkIdType* pts = nullptr;
-    vtkIdType npts;
-    for (newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);)
+    else
     {
-      vtkIdType nodes[3];
-      for (int i = 0; i < 3; i++)
+      vtkSmartPointer<vtkIncrementalPointLocator> locator = this->Locator;
+      if (this->Locator == nullptr)
       {
-        double x[3];
-        newPts->GetPoint(pts[i], x);
-        locator->InsertUniquePoint(x, nodes[i]);
+        locator.TakeReference(this->NewDefaultLocator());
       }
+      mergedPts->Allocate(newPts->GetNumberOfPoints() / 2);
+      mergedPolys->AllocateCopy(newPolys);
+      if (newScalars)
+      {
+        mergedScalars->Allocate(newPolys->GetNumberOfCells());
+      }
+      locator->InitPointInsertion(mergedPts, newPts->GetBounds());
 
-      if (nodes[0] != nodes[1] && nodes[0] != nodes[2] && nodes[1] != nodes[2])
+      int nextCell = 0;
+      const vtkIdType* pts = nullptr;
+      vtkIdType npts;
+      for (newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);)
       {
-        mergedPolys->InsertNextCell(3, nodes);
-        if (newScalars)
+        vtkIdType nodes[3];
+        for (int i = 0; i < 3; i++)
         {
-          mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+          double x[3];
+          newPts->GetPoint(pts[i], x);
+          locator->InsertUniquePoint(x, nodes[i]);
         }
+
+        if (nodes[0] != nodes[1] && nodes[0] != nodes[2] && nodes[1] != nodes[2])
+        {
+          mergedPolys->InsertNextCell(3, nodes);
+          if (newScalars)
+          {
+            mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+          }
+        }
+        nextCell++;
       }
-      nextCell++;
     }
 
     vtkDebugMacro(<< "Merged to: " << mergedPts->GetNumberOfPoints() << " points, "
@@ -225,13 +426,6 @@ int vtkSTLReader::RequestData(vtkInformation* vtkNotUsed(request),
 //------------------------------------------------------------------------------
 bool vtkSTLReader::ReadBinarySTL(FILE* fp, vtkPoints* newPts, vtkCellArray* newPolys)
 {
-  struct facet_t_t
-  {
-    float n[3], v1[3], v2[3], v3[3];
-    unsigned short junk;
-  };
-  using facet_t = struct facet_t_t;
-
   vtkDebugMacro(<< "Reading BINARY STL file");
 
   //  File is read to obtain raw information as well as bounding box
@@ -284,41 +478,54 @@ bool vtkSTLReader::ReadBinarySTL(FILE* fp, vtkPoints* newPts, vtkCellArray* newP
   }
 
   // now we can allocate the memory we need for this STL file
-  newPts->Allocate(numTris * 3);
-  newPolys->AllocateEstimate(numTris, 3);
-
-  facet_t facet;
-  for (int i = 0; fread(&facet, 50, 1, fp) > 0; i++)
+  vtkFloatArray* coords = vtkArrayDownCast<vtkFloatArray>(newPts->GetData());
+  coords->SetNumberOfTuples(3 * static_cast<vtkIdType>(std::max(numTris, 0)));
+
+  // Read the facets in chunks of about 3 MB, whose points are decoded in
+  // parallel. The buffer is not larger than the file.
+  const int facetSize = 50; // twelve 32-bit floats and the attribute byte count
+  const size_t maxChunkSize =
+    static_cast<size_t>(std::max<vtkIdType>(std::min<vtkIdType>(numTris, STLBlockSize), 1));
+  std::unique_ptr<unsigned char[]> facets(new unsigned char[facetSize * maxChunkSize]);
+  vtkIdType numRead = 0;
+  size_t chunkSize;
+  while ((chunkSize = fread(facets.get(), facetSize, maxChunkSize, fp)) > 0)
   {
-    vtkByteSwap::Swap4LE(facet.n);
-    vtkByteSwap::Swap4LE(facet.n + 1);
-    vtkByteSwap::Swap4LE(facet.n + 2);
-
-    vtkByteSwap::Swap4LE(facet.v1);
-    vtkByteSwap::Swap4LE(facet.v1 + 1);
-    vtkByteSwap::Swap4LE(facet.v1 + 2);
-
-    vtkByteSwap::Swap4LE(facet.v2);
-    vtkByteSwap::Swap4LE(facet.v2 + 1);
-    vtkByteSwap::Swap4LE(facet.v2 + 2);
-
-    vtkByteSwap::Swap4LE(facet.v3);
-    vtkByteSwap::Swap4LE(facet.v3 + 1);
-    vtkByteSwap::Swap4LE(facet.v3 + 2);
-
-    vtkIdType pts[3];
-    pts[0] = newPts->InsertNextPoint(facet.v1);
-    pts[1] = newPts->InsertNextPoint(facet.v2);
-    pts[2] = newPts->InsertNextPoint(facet.v3);
-
-    newPolys->InsertNextCell(3, pts);
-
-    if ((i % 100000) == 0 && i != 0)
+    const vtkIdType numChunkTris = static_cast<vtkIdType>(chunkSize);
+    if (3 * (numRead + numChunkTris) > coords->GetNumberOfTuples())
     {
-      vtkDebugMacro(<< "triangle# " << i);
-      this->UpdateProgress(static_cast<double>(i) / numTris);
+      coords->Resize(3 * (numRead + numChunkTris));
+      coords->SetNumberOfTuples(3 * (numRead + numChunkTris));
     }
+    float* x = coords->GetPointer(9 * numRead);
+    vtkSMPTools::For(0, numChunkTris, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        // skip the normal
+        std::memcpy(x + 9 * i, facets.get() + facetSize * i + 12, 9 * sizeof(float));
+        vtkByteSwap::Swap4LERange(x + 9 * i, 9);
+      }
+    });
+    numRead += numChunkTris;
+
+    vtkDebugMacro(<< "triangle# " << numRead);
+    this->UpdateProgress(static_cast<double>(numRead) / std::max(numTris, 1));
   }
+  coords->SetNumberOfTuples(3 * numRead);
+
+  // the triangles use the points in order
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numRead + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(3 * numRead);
+  vtkSMPTools::For(0, numRead + 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      offsets->SetValue(i, 3 * i);
+    }
+  });
+  std::iota(connectivity->GetPointer(0), connectivity->GetPointer(0) + 3 * numRead, 0);
+  newPolys->SetData(offsets, connectivity);
 
   return true;
 }
@@ -0,0 +1,261 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLegacyASCIIParsing.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks the values read by the legacy reader, which parses ASCII blocks in
+// parallel and byte swaps binary arrays in parallel: points, cells and field
+// arrays larger than a block, all the white spaces, tokens in every format
+// operator>> accepts, and tokens which operator>> splits in several values.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkFieldData.h"
+#include "vtkIdList.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataReader.h"
+#include "vtkPolyDataWriter.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const vtkIdType NumberOfPoints = 150000;
+const vtkIdType NumberOfTriangles = 100000;
+const char* Spaces[] = { " ", "\n", "\t", "  ", "\r\n", " \n" };
+
+struct Values
+{
+  std::vector<double> Points;
+  std::vector<int> Triangles;
+  std::vector<float> Scalars;
+  std::vector<long long> Int64s;
+  std::vector<short> Shorts;
+};
+
+Values MakeValues()
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  Values values;
+  for (vtkIdType i = 0; i < 3 * NumberOfPoints; i++)
+  {
+    random->Next();
+    values.Points.push_back(random->GetRangeValue(-1.0e3, 1.0e3));
+  }
+  for (vtkIdType i = 0; i < 3 * NumberOfTriangles; i++)
+  {
+    random->Next();
+    values.Triangles.push_back(static_cast<int>(random->GetRangeValue(0, NumberOfPoints)));
+  }
+  for (vtkIdType i = 0; i < NumberOfPoints; i++)
+  {
+    random->Next();
+    values.Scalars.push_back(static_cast<float>(random->GetRangeValue(-1.0, 1.0) * 1.0e-20));
+    random->Next();
+    values.Int64s.push_back(static_cast<long long>(random->GetRangeValue(-1.0e18, 1.0e18)));
+    values.Shorts.push_back(static_cast<short>(i % 65536 - 32768));
+  }
+  values.Int64s[0] = std::numeric_limits<long long>::min();
+  values.Int64s[1] = std::numeric_limits<long long>::max();
+  return values;
+}
+
+template <typename T>
+void WriteValues(std::ostream& os, const std::vector<T>& values)
+{
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    os << values[i] << Spaces[i % 6];
+  }
+}
+
+std::string MakeFile(const Values& values, const std::vector<std::string>& special,
+  const std::string& splitInts)
+{
+  std::ostringstream os;
+  os << "# vtk DataFile Version 4.2\nTest\nASCII\nDATASET POLYDATA\n";
+  os << "POINTS " << NumberOfPoints << " double\n" << std::setprecision(17);
+  WriteValues(os, values.Points);
+  os << "\nPOLYGONS " << NumberOfTriangles << " " << 4 * NumberOfTriangles << "\n";
+  for (vtkIdType i = 0; i < NumberOfTriangles; i++)
+  {
+    os << "3 " << values.Triangles[3 * i] << "\t" << values.Triangles[3 * i + 1] << " "
+       << values.Triangles[3 * i + 2] << "\r\n";
+  }
+  os << "POINT_DATA " << NumberOfPoints << "\nSCALARS scalars float 1\nLOOKUP_TABLE default\n"
+     << std::setprecision(9);
+  WriteValues(os, values.Scalars);
+  os << "\nFIELD FieldData 4\nint64s 1 " << NumberOfPoints << " vtktypeint64\n";
+  WriteValues(os, values.Int64s);
+  os << "\nshorts 2 " << NumberOfPoints / 2 << " short\n";
+  WriteValues(os, values.Shorts);
+  os << "\nspecial 1 " << special.size() << " double\n";
+  WriteValues(os, special);
+  os << "\nsplit 1 5 int\n" << splitInts << "\n";
+  return os.str();
+}
+
+vtkSmartPointer<vtkPolyData> Read(const std::string& file, int numThreads)
+{
+  vtkNew<vtkPolyDataReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(file);
+  reader->ReadAllFieldsOn();
+  reader->ReadAllScalarsOn();
+  vtkSMPTools::LocalScope(
+    vtkSMPTools::Config{ numThreads, "STDThread", false }, [&]() { reader->Update(); });
+  return reader->GetOutput();
+}
+
+template <typename T>
+bool CheckArray(vtkDataArray* array, const std::vector<T>& values, const char* name)
+{
+  if (!array || array->GetNumberOfValues() != static_cast<vtkIdType>(values.size()))
+  {
+    std::cerr << name << ": wrong array" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < array->GetNumberOfValues(); i++)
+  {
+    const int numComps = array->GetNumberOfComponents();
+    if (static_cast<T>(array->GetComponent(i / numComps, i % numComps)) != values[i])
+    {
+      std::cerr << name << ": wrong value " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CheckInt64s(vtkDataArray* array, const std::vector<long long>& values)
+{
+  if (!array || array->GetNumberOfValues() != static_cast<vtkIdType>(values.size()))
+  {
+    std::cerr << "int64s: wrong array" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < array->GetNumberOfValues(); i++)
+  {
+    if (array->GetVariantValue(i).ToTypeInt64() != values[i])
+    {
+      std::cerr << "int64s: wrong value " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CheckOutput(vtkPolyData* output, const Values& values, const std::vector<double>& special,
+  const std::vector<int>& split)
+{
+  if (output->GetNumberOfPoints() != NumberOfPoints ||
+    !CheckArray(output->GetPoints()->GetData(), values.Points, "points"))
+  {
+    std::cerr << "Wrong points" << std::endl;
+    return false;
+  }
+  if (output->GetNumberOfPolys() != NumberOfTriangles)
+  {
+    std::cerr << "Wrong number of triangles" << std::endl;
+    return false;
+  }
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType i = 0; i < NumberOfTriangles; i++)
+  {
+    output->GetCellPoints(i, ptIds);
+    if (ptIds->GetNumberOfIds() != 3 || ptIds->GetId(0) != values.Triangles[3 * i] ||
+      ptIds->GetId(1) != values.Triangles[3 * i + 1] ||
+      ptIds->GetId(2) != values.Triangles[3 * i + 2])
+    {
+      std::cerr << "Wrong triangle " << i << std::endl;
+      return false;
+    }
+  }
+  vtkPointData* pointData = output->GetPointData();
+  vtkFieldData* fieldData = output->GetFieldData();
+  if (!CheckArray(pointData->GetArray("scalars"), values.Scalars, "scalars"))
+  {
+    return false;
+  }
+  vtkDataArray* int64s = pointData->GetArray("int64s");
+  vtkDataArray* shorts = pointData->GetArray("shorts");
+  vtkDataArray* specialArray = pointData->GetArray("special");
+  vtkDataArray* splitArray = pointData->GetArray("split");
+  if (!int64s)
+  {
+    int64s = fieldData->GetArray("int64s");
+    shorts = fieldData->GetArray("shorts");
+    specialArray = fieldData->GetArray("special");
+    splitArray = fieldData->GetArray("split");
+  }
+  return CheckInt64s(int64s, values.Int64s) && CheckArray(shorts, values.Shorts, "shorts") &&
+    CheckArray(specialArray, special, "special") && CheckArray(splitArray, split, "split");
+}
+}
+
+int TestLegacyASCIIParsing(int, char*[])
+{
+  const Values values = MakeValues();
+
+  // tokens in all the formats operator>> reads, and their values
+  const std::vector<std::string> specialTokens = { "1e5", ".5", "+3", "-0", "5.", "1E-3",
+    "007", "-2.5e+2", "4.9406564584124654e-324", "1.7976931348623157e308" };
+  std::vector<double> special;
+  for (const std::string& token : specialTokens)
+  {
+    std::istringstream is(token);
+    is.imbue(std::locale::classic());
+    double value;
+    is >> value;
+    special.push_back(value);
+  }
+  // operator>> reads "1-2" as two values, which the parallel parser leaves to it
+  const std::string splitInts = "3 4 1-2 5";
+  const std::vector<int> split = { 3, 4, 1, -2, 5 };
+
+  const std::string file = MakeFile(values, specialTokens, splitInts);
+  for (int numThreads : { 1, 4 })
+  {
+    vtkSmartPointer<vtkPolyData> output = Read(file, numThreads);
+    if (!CheckOutput(output, values, special, split))
+    {
+      std::cerr << "ASCII file read with " << numThreads << " threads" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // the same data in binary
+    vtkNew<vtkPolyDataWriter> writer;
+    writer->SetInputData(output);
+    writer->SetFileTypeToBinary();
+    writer->WriteToOutputStringOn();
+    writer->Write();
+    vtkSmartPointer<vtkPolyData> binaryOutput = Read(writer->GetOutputStdString(), numThreads);
+    if (!CheckOutput(binaryOutput, values, special, split))
+    {
+      std::cerr << "Binary file read with " << numThreads << " threads" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
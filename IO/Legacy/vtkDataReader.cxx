@@ -41,10 +41,12 @@
 #include "vtkLegacyReaderVersion.h"
 #include "vtkLongArray.h"
 #include "vtkLookupTable.h"
+#include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkShortArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
@@ -61,9 +63,16 @@
 #include "vtksys/FStream.hxx"
 #include <vtksys/SystemTools.hxx>
 
+// clang-format off
+#include "vtk_doubleconversion.h"
+#include VTK_DOUBLECONVERSION_HEADER(double-conversion.h)
+// clang-format on
+
 #include <algorithm>
 #include <cctype>
+#include <limits>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 // I need a safe way to read a line of arbitrary length.  It exists on
@@ -1490,12 +1499,262 @@ int vtkReadBinaryData(istream* IS, T* data, vtkIdType numTuples, vtkIdType numCo
   return 1;
 }
 
+namespace
+{
+// Size of the blocks of text read at once when parsing ASCII values.
+constexpr std::streamsize ASCIIBlockSize = 1 << 22;
+// Size of the pieces of a block parsed by one task.
+constexpr size_t ASCIIPieceSize = 1 << 16;
+
+// The white space of the classic locale.
+inline bool IsSpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+// Locale independent conversion of a token to an integral value. It fails
+// whenever operator>> would not read the whole token as the same value, e.g.
+// on overflow.
+template <typename T>
+bool ParseValue(const char* begin, const char* end, T& value, std::true_type)
+{
+  bool negative = false;
+  if (begin != end && (*begin == '-' || *begin == '+'))
+  {
+    negative = *begin == '-';
+    ++begin;
+  }
+  if (begin == end || (negative && std::is_unsigned<T>::value))
+  {
+    return false;
+  }
+  const unsigned long long maxMagnitude = static_cast<unsigned long long>(
+                                            std::numeric_limits<T>::max()) +
+    (negative ? 1 : 0);
+  unsigned long long magnitude = 0;
+  for (; begin != end; ++begin)
+  {
+    const unsigned int digit = static_cast<unsigned int>(*begin - '0');
+    if (digit > 9 || magnitude > (maxMagnitude - digit) / 10)
+    {
+      return false;
+    }
+    magnitude = 10 * magnitude + digit;
+  }
+  value = static_cast<T>(negative ? 0 - magnitude : magnitude);
+  return true;
+}
+
+// Locale independent, correctly rounded conversion of a token to a floating
+// point value, as operator>> does. Infinite values, which make operator>>
+// fail, fail here too.
+template <typename T>
+bool ParseValue(const char* begin, const char* end, T& value, std::false_type)
+{
+  static const double_conversion::StringToDoubleConverter converter(
+    double_conversion::StringToDoubleConverter::NO_FLAGS, 0.0, vtkMath::Nan(), nullptr, nullptr);
+  const int length = static_cast<int>(end - begin);
+  int processed = 0;
+  if (std::is_same<T, float>::value)
+  {
+    value = static_cast<T>(converter.StringToFloat(begin, length, &processed));
+  }
+  else
+  {
+    value = static_cast<T>(converter.StringToDouble(begin, length, &processed));
+  }
+  return processed == length && vtkMath::IsFinite(value);
+}
+
+// vtkDataReader::Read() reads chars as ints.
+template <typename T>
+struct ASCIIValueType
+{
+  using Type = T;
+};
+template <>
+struct ASCIIValueType<char>
+{
+  using Type = int;
+};
+template <>
+struct ASCIIValueType<unsigned char>
+{
+  using Type = int;
+};
+
+template <typename T>
+bool ParseValue(const char* begin, const char* end, T& value)
+{
+  using ValueType = typename ASCIIValueType<T>::Type;
+  ValueType parsed;
+  if (!ParseValue(begin, end, parsed, std::is_integral<ValueType>()))
+  {
+    return false;
+  }
+  value = static_cast<T>(parsed);
+  return true;
+}
+
+// Reads numValues white space separated values from the stream, in blocks of
+// text split in pieces which are parsed in parallel. The stream is left after
+// the last value, as with operator>>. Returns false, with the stream back at
+// its initial position, when the stream cannot seek or when a token is not
+// read as a single value, so that the caller reads the values with
+// operator>> and reports the errors.
+template <typename T>
+bool ReadASCIIValues(istream* is, T* data, vtkIdType numValues)
+{
+  const std::streampos start = is->tellg();
+  if (start == std::streampos(-1))
+  {
+    return false;
+  }
+
+  std::vector<char> text;
+  std::streamoff textOffset = 0; // offset of text[0] in the stream from start
+  std::streamoff endOffset = 0;  // offset of the end of the last value
+  vtkIdType numRead = 0;
+  bool success = numValues <= 0;
+  while (numRead < numValues)
+  {
+    // read a block after the end of the previous one
+    const size_t carry = text.size();
+    const vtkIdType numRemaining = numValues - numRead;
+    const std::streamsize blockSize = std::min(
+      ASCIIBlockSize, static_cast<std::streamsize>(std::max<vtkIdType>(4096, 32 * numRemaining)));
+    text.resize(carry + static_cast<size_t>(blockSize));
+    is->read(text.data() + carry, blockSize);
+    const std::streamsize numChars = is->gcount();
+    text.resize(carry + static_cast<size_t>(numChars));
+    const bool atEnd = numChars < blockSize;
+
+    // parse up to the last white space, the last token may continue in the
+    // next block
+    size_t end = text.size();
+    if (!atEnd)
+    {
+      while (end > 0 && !IsSpace(text[end - 1]))
+      {
+        --end;
+      }
+    }
+
+    // pieces starting at white spaces, and the index of their first value
+    std::vector<size_t> pieces(1, 0);
+    for (size_t next = ASCIIPieceSize; next < end; next += ASCIIPieceSize)
+    {
+      while (next < end && !IsSpace(text[next]))
+      {
+        ++next;
+      }
+      if (next < end)
+      {
+        pieces.push_back(next);
+      }
+    }
+    pieces.push_back(end);
+    const vtkIdType numPieces = static_cast<vtkIdType>(pieces.size()) - 1;
+    std::vector<vtkIdType> firstValues(numPieces + 1, 0);
+    const char* chars = text.data();
+    vtkSMPTools::For(0, numPieces, [&](vtkIdType begin, vtkIdType last) {
+      for (vtkIdType piece = begin; piece < last; ++piece)
+      {
+        vtkIdType count = 0;
+        bool inToken = false;
+        for (size_t i = pieces[piece]; i < pieces[piece + 1]; ++i)
+        {
+          const bool space = IsSpace(chars[i]);
+          count += (!space && !inToken) ? 1 : 0;
+          inToken = !space;
+        }
+        firstValues[piece + 1] = count;
+      }
+    });
+    firstValues[0] = numRead;
+    for (vtkIdType piece = 0; piece < numPieces; ++piece)
+    {
+      firstValues[piece + 1] += firstValues[piece];
+    }
+
+    // parse the values, up to the last one needed
+    std::vector<char> failed(numPieces, 0);
+    std::vector<size_t> lastEnds(numPieces, 0);
+    vtkSMPTools::For(0, numPieces, [&](vtkIdType begin, vtkIdType last) {
+      for (vtkIdType piece = begin; piece < last; ++piece)
+      {
+        vtkIdType valueId = firstValues[piece];
+        size_t i = pieces[piece];
+        while (valueId < numValues && valueId < firstValues[piece + 1])
+        {
+          while (IsSpace(chars[i]))
+          {
+            ++i;
+          }
+          const size_t tokenStart = i;
+          while (i < pieces[piece + 1] && !IsSpace(chars[i]))
+          {
+            ++i;
+          }
+          if (!ParseValue(chars + tokenStart, chars + i, data[valueId]))
+          {
+            failed[piece] = 1;
+            break;
+          }
+          ++valueId;
+        }
+        lastEnds[piece] = i;
+      }
+    });
+
+    const vtkIdType numParsed = std::min(firstValues[numPieces], numValues);
+    if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+    {
+      break;
+    }
+    if (numParsed == numValues)
+    {
+      const auto piece = std::upper_bound(firstValues.begin(), firstValues.end(), numValues - 1) -
+        firstValues.begin() - 1;
+      endOffset = textOffset + static_cast<std::streamoff>(lastEnds[piece]);
+      success = true;
+      break;
+    }
+    if (atEnd)
+    {
+      break;
+    }
+    numRead = numParsed;
+    text.erase(text.begin(), text.begin() + end);
+    textOffset += static_cast<std::streamoff>(end);
+  }
+
+  is->clear();
+  is->seekg(success ? start + endOffset : start);
+  return success;
+}
+
+// Byte swaps big endian values in parallel.
+template <typename T>
+void ParallelSwapBERange(T* data, vtkIdType numValues)
+{
+  vtkSMPTools::For(0, numValues, 65536, [data](vtkIdType begin, vtkIdType end) {
+    vtkByteSwap::SwapBERange(data + begin, static_cast<size_t>(end - begin));
+  });
+}
+}
+
 // General templated function to read data of various types.
 template <class T>
 int vtkReadASCIIData(vtkDataReader* self, T* data, vtkIdType numTuples, vtkIdType numComp)
 {
   vtkIdType i, j;
 
+  if (ReadASCIIValues(self->GetIStream(), data, numTuples * numComp))
+  {
+    return 1;
+  }
+
   for (i = 0; i < numTuples; i++)
   {
     for (j = 0; j < numComp; j++)
@@ -1606,7 +1865,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap2BERange(ptr, numTuples * numComp);
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
     else
     {
@@ -1622,7 +1881,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap2BERange((short*)ptr, numTuples * numComp);
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
     else
     {
@@ -1639,7 +1898,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, buffer.data(), numTuples, numComp);
-      vtkByteSwap::Swap4BERange(buffer.data(), numTuples * numComp);
+      ParallelSwapBERange(buffer.data(), numTuples * numComp);
     }
     else
     {
@@ -1660,7 +1919,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap4BERange(ptr, numTuples * numComp);
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
     else
     {
@@ -1676,7 +1935,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap4BERange((int*)ptr, numTuples * numComp);
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
     else
     {
@@ -1695,11 +1954,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-#if VTK_SIZEOF_LONG == 4
-      vtkByteSwap::Swap4BERange(ptr, numTuples * numComp);
-#else // VTK_SIZEOF_LONG == 8
-      vtkByteSwap::Swap8BERange(ptr, numTuples * numComp);
-#endif
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
 
     else
@@ -1716,11 +1971,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-#if VTK_SIZEOF_LONG == 4
-      vtkByteSwap::Swap4BERange(ptr, numTuples * numComp);
-#else // VTK_SIZEOF_LONG == 8
-      vtkByteSwap::Swap8BERange(ptr, numTuples * numComp);
-#endif
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
     else
     {
@@ -1736,7 +1987,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap8BERange(ptr, numTuples * numComp);
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
 
     else
@@ -1753,7 +2004,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap8BERange(ptr, numTuples * numComp);
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
 
     else
@@ -1770,7 +2021,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap4BERange(ptr, numTuples * numComp);
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
     else
     {
@@ -1786,7 +2037,7 @@ vtkAbstractArray* vtkDataReader::ReadArray(
     if (this->FileType == VTK_BINARY)
     {
       vtkReadBinaryData(this->IS, ptr, numTuples, numComp);
-      vtkByteSwap::Swap8BERange(ptr, numTuples * numComp);
+      ParallelSwapBERange(ptr, numTuples * numComp);
     }
     else
     {
@@ -3219,9 +3470,9 @@ int vtkDataReader::ReadCellsLegacy(vtkIdType size, int* data)
                     << " for file: " << (fname ? fname : "(Null FileName)"));
       return 0;
     }
-    vtkByteSwap::Swap4BERange(data, size);
+    ParallelSwapBERange(data, size);
   }
-  else // ascii
+  else if (!ReadASCIIValues(this->IS, data, size)) // ascii
   {
     for (i = 0; i < size; i++)
     {
@@ -3270,7 +3521,7 @@ int vtkDataReader::ReadCellsLegacy(vtkIdType size, int* data, int skip1, int rea
                     << " for file: " << (fname ? fname : "(Null FileName)"));
       return 0;
     }
-    vtkByteSwap::Swap4BERange(tmp, size);
+    ParallelSwapBERange(tmp, size);
     if (tmp == data)
     {
       return 1;
@@ -3297,7 +3548,7 @@ int vtkDataReader::ReadCellsLegacy(vtkIdType size, int* data, int skip1, int rea
       --read2;
     }
   }
-  else // ascii
+  else if (skip1 != 0 || skip3 != 0 || !ReadASCIIValues(this->IS, data, size)) // ascii
   {
     // skip cells before the piece
     for (i = 0; i < skip1; i++)
@@ -0,0 +1,121 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCompressionParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the blocks compressed and uncompressed concurrently by the XML
+// writers and readers give the same files and the same data as the serial
+// ones, with each of the compressors.
+
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataComparison.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace
+{
+void ConstructImage(vtkImageData* image)
+{
+  image->SetDimensions(40, 40, 40);
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(image->GetNumberOfPoints());
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  ids->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    image->GetPoint(ptId, x);
+    vectors->SetTuple3(ptId, std::sin(0.2 * x[0]), std::cos(0.1 * x[1]), x[2]);
+    ids->SetValue(ptId, static_cast<int>(ptId % 1000));
+  }
+  image->GetPointData()->AddArray(vectors);
+  image->GetPointData()->AddArray(ids);
+}
+
+std::string Write(vtkImageData* image, int compressorType, int dataMode, int numThreads)
+{
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetInputData(image);
+  writer->SetCompressorType(compressorType);
+  writer->SetDataMode(dataMode);
+  writer->SetBlockSize(4096);
+  writer->WriteToOutputStringOn();
+  vtkSMPTools::LocalScope(
+    vtkSMPTools::Config{ numThreads, "STDThread", false }, [&]() { writer->Write(); });
+  return writer->GetOutputString();
+}
+
+vtkSmartPointer<vtkImageData> Read(const std::string& input, int numThreads)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(input);
+  return vtkImageData::SafeDownCast(
+    vtkTestDataComparison::UpdateWithThreads(reader.GetPointer(), numThreads));
+}
+}
+
+int TestXMLCompressionParallel(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  ConstructImage(image);
+  // The first write caches the ranges of the arrays, which are written from
+  // then on.
+  Write(image, vtkXMLWriter::NONE, vtkXMLWriter::Appended, 1);
+
+  const int compressorTypes[4] = { vtkXMLWriter::ZLIB, vtkXMLWriter::LZ4, vtkXMLWriter::LZMA,
+    vtkXMLWriter::ZFP };
+  const int dataModes[2] = { vtkXMLWriter::Appended, vtkXMLWriter::Binary };
+  for (int compressorType : compressorTypes)
+  {
+    for (int dataMode : dataModes)
+    {
+      const std::string output1 = Write(image, compressorType, dataMode, 1);
+      const std::string output4 = Write(image, compressorType, dataMode, 4);
+      if (output1 != output4)
+      {
+        std::cerr << "Compressor " << compressorType << " in data mode " << dataMode
+                  << ": the files written with 1 and 4 threads differ" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // ZFP is lossy in its default mode.
+      vtkSmartPointer<vtkImageData> image1 = Read(output1, 1);
+      vtkSmartPointer<vtkImageData> image4 = Read(output1, 4);
+      const std::string name = "Compressor " + std::to_string(compressorType) +
+        " in data mode " + std::to_string(dataMode);
+      if (!vtkTestDataComparison::SameDataSets(image1, image4, name.c_str()) ||
+        (compressorType != vtkXMLWriter::ZFP &&
+          !vtkTestDataComparison::SameDataSets(image, image4, name.c_str())))
+      {
+        std::cerr << "Compressor " << compressorType << " in data mode " << dataMode
+                  << ": the data read with 4 threads differ" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
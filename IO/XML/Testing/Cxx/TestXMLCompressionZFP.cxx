@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCompressionZFP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Writes and reads back image data compressed with vtkZFPDataCompressor in
+// each of its modes, and checks the errors of the values read.
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkZFPDataCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace
+{
+const int Dimension = 32;
+
+void ConstructImage(vtkImageData* image)
+{
+  image->SetDimensions(Dimension, Dimension, Dimension);
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(image->GetNumberOfPoints());
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("Ids");
+  ids->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < image->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    image->GetPoint(ptId, x);
+    // Components of very different magnitudes, to check that they are
+    // compressed separately.
+    vectors->SetTuple3(ptId, std::sin(0.2 * x[0]), 1000.0 * std::cos(0.1 * x[1]), 0.001 * x[2]);
+    scalars->SetValue(ptId, std::exp(-0.01 * (x[0] * x[0] + x[1] * x[1] + x[2] * x[2])));
+    ids->SetValue(ptId, static_cast<int>(ptId * 7919 % 1000003));
+  }
+  image->GetPointData()->AddArray(vectors);
+  image->GetPointData()->AddArray(scalars);
+  image->GetPointData()->AddArray(ids);
+}
+
+double MaximumError(vtkDataArray* array1, vtkDataArray* array2, int comp)
+{
+  double error = 0.0;
+  for (vtkIdType i = 0; i < array1->GetNumberOfTuples(); ++i)
+  {
+    error =
+      std::max(error, std::fabs(array1->GetComponent(i, comp) - array2->GetComponent(i, comp)));
+  }
+  return error;
+}
+
+bool TestMode(vtkImageData* image, int mode, int dataMode)
+{
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetInputData(image);
+  writer->SetCompressorTypeToZFP();
+  writer->SetDataMode(dataMode);
+  // Blocks that do not hold whole tuples of the vectors.
+  writer->SetBlockSize(4000);
+  writer->WriteToOutputStringOn();
+  vtkZFPDataCompressor* compressor = vtkZFPDataCompressor::SafeDownCast(writer->GetCompressor());
+  compressor->SetMode(mode);
+  compressor->SetTolerance(1e-4);
+  writer->Write();
+  const std::string output = writer->GetOutputString();
+
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(output);
+  reader->Update();
+  vtkPointData* pointData1 = image->GetPointData();
+  vtkPointData* pointData2 = reader->GetOutput()->GetPointData();
+  if (pointData2->GetNumberOfArrays() != 3)
+  {
+    std::cerr << "Mode " << mode << ": cannot read arrays" << std::endl;
+    return false;
+  }
+
+  // The integer ids are compressed losslessly in any mode.
+  if (MaximumError(pointData1->GetArray("Ids"), pointData2->GetArray("Ids"), 0) != 0.0)
+  {
+    std::cerr << "Mode " << mode << ": ids differ" << std::endl;
+    return false;
+  }
+
+  // Maximum errors allowed for the components of the vectors and the scalars.
+  double maxErrors[4] = { 0.0, 0.0, 0.0, 0.0 };
+  if (mode == vtkZFPDataCompressor::FIXED_RATE)
+  {
+    // 12 bits per value leave about 8 significant bits.
+    maxErrors[0] = 1.0 / 64;
+    maxErrors[1] = 1000.0 / 64;
+    maxErrors[2] = 0.032 / 64;
+    maxErrors[3] = 1.0 / 64;
+  }
+  else if (mode == vtkZFPDataCompressor::FIXED_ACCURACY)
+  {
+    maxErrors[0] = maxErrors[1] = maxErrors[2] = maxErrors[3] = 1e-4;
+  }
+  const char* names[4] = { "Vectors", "Vectors", "Vectors", "Scalars" };
+  for (int i = 0; i < 4; ++i)
+  {
+    const double error =
+      MaximumError(pointData1->GetArray(names[i]), pointData2->GetArray(names[i]), i % 3);
+    if (error > maxErrors[i])
+    {
+      std::cerr << "Mode " << mode << ": error " << error << " of " << names[i] << " component "
+                << i % 3 << " is larger than " << maxErrors[i] << std::endl;
+      return false;
+    }
+  }
+
+  // Compare with the size written with the default zlib compressor.
+  if (mode == vtkZFPDataCompressor::FIXED_RATE && dataMode == vtkXMLWriter::Appended)
+  {
+    writer->SetCompressorTypeToZLib();
+    writer->Write();
+    const size_t zlibSize = writer->GetOutputString().size();
+    std::cout << "Size with ZFP: " << output.size() << ", with zlib: " << zlibSize << std::endl;
+    if (output.size() >= zlibSize)
+    {
+      std::cerr << "ZFP does not compress better than zlib" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestXMLCompressionZFP(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  ConstructImage(image);
+
+  for (int mode = vtkZFPDataCompressor::FIXED_RATE; mode <= vtkZFPDataCompressor::REVERSIBLE;
+       ++mode)
+  {
+    if (!TestMode(image, mode, vtkXMLWriter::Appended) ||
+      !TestMode(image, mode, vtkXMLWriter::Binary))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
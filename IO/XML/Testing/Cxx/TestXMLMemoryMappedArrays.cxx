@@ -0,0 +1,173 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLMemoryMappedArrays.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the XML readers give the same data with and without memory
+// mapping of the raw appended arrays, that the mapped arrays can be modified
+// and resized without changing the file, and that they outlive the reader.
+
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestDataComparison.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+void AddArrays(vtkDataSetAttributes* attributes, vtkIdType numTuples)
+{
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numTuples);
+  // an odd number of bytes, which misaligns the arrays written after it
+  vtkNew<vtkUnsignedCharArray> bytes;
+  bytes->SetName("bytes");
+  bytes->SetNumberOfTuples(numTuples);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(numTuples);
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("ids");
+  ids->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; i++)
+  {
+    vectors->SetTuple3(i, 0.5 * i, -1.0 * i, 0.25 * i);
+    bytes->SetValue(i, static_cast<unsigned char>(i % 251));
+    scalars->SetValue(i, 1.0 / (i + 1));
+    ids->SetValue(i, static_cast<int>(i));
+  }
+  attributes->AddArray(vectors);
+  attributes->AddArray(ids);
+  attributes->AddArray(bytes);
+  attributes->AddArray(scalars);
+}
+
+template <typename ReaderT>
+vtkSmartPointer<vtkDataSet> Read(const std::string& fileName, bool memoryMap)
+{
+  vtkNew<ReaderT> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetMemoryMapRawAppendedData(memoryMap);
+  reader->Update();
+  return reader->GetOutputAsDataSet();
+}
+
+template <typename ReaderT>
+bool TestFile(vtkDataSet* input, const std::string& fileName)
+{
+  vtkSmartPointer<vtkDataSet> mapped = Read<ReaderT>(fileName, true);
+  vtkSmartPointer<vtkDataSet> read = Read<ReaderT>(fileName, false);
+  if (!vtkTestDataComparison::SameDataSets(input, mapped, fileName.c_str()) ||
+    !vtkTestDataComparison::SameDataSets(read, mapped, fileName.c_str()))
+  {
+    std::cerr << "Wrong data read from " << fileName << std::endl;
+    return false;
+  }
+
+  // the changes to the arrays are not written to the file
+  vtkDataArray* scalars = mapped->GetPointData()->GetArray("scalars");
+  scalars->SetComponent(0, 0, -1.0);
+  vtkDataArray* vectors = mapped->GetPointData()->GetArray("vectors");
+  const vtkIdType numTuples = vectors->GetNumberOfTuples();
+  vectors->InsertNextTuple3(1.0, 2.0, 3.0);
+  if (vectors->GetComponent(numTuples, 2) != 3.0 ||
+    vectors->GetComponent(numTuples - 1, 2) != 0.25 * (numTuples - 1))
+  {
+    std::cerr << "Wrong values after resizing a mapped array" << std::endl;
+    return false;
+  }
+  vtkSmartPointer<vtkDataSet> reread = Read<ReaderT>(fileName, true);
+  if (!vtkTestDataComparison::SameFieldData(
+        read->GetPointData(), reread->GetPointData(), fileName.c_str()))
+  {
+    std::cerr << "The file was changed through a mapped array" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestXMLMemoryMappedArrays(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string testDirectory(tempDir);
+  delete[] tempDir;
+
+  // structured data
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(31, 31, 31);
+  AddArrays(image->GetPointData(), image->GetNumberOfPoints());
+  AddArrays(image->GetCellData(), image->GetNumberOfCells());
+  const std::string imageFileName = testDirectory + "/TestXMLMemoryMappedArrays.vti";
+  vtkNew<vtkXMLImageDataWriter> imageWriter;
+  imageWriter->SetInputData(image);
+  imageWriter->SetFileName(imageFileName.c_str());
+  imageWriter->SetDataModeToAppended();
+  imageWriter->EncodeAppendedDataOff();
+  imageWriter->SetCompressorTypeToNone();
+  imageWriter->Write();
+  if (!TestFile<vtkXMLImageDataReader>(image, imageFileName))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // unstructured data, whose points and cells are mapped too
+  vtkNew<vtkUnstructuredGrid> grid;
+  vtkNew<vtkPoints> points;
+  const vtkIdType numPoints = 20001;
+  for (vtkIdType i = 0; i < numPoints; i++)
+  {
+    points->InsertNextPoint(0.5 * i, 0.25 * (i % 7), 0.0);
+  }
+  grid->SetPoints(points);
+  grid->Allocate(numPoints - 1);
+  for (vtkIdType i = 0; i + 1 < numPoints; i++)
+  {
+    const vtkIdType line[2] = { i, i + 1 };
+    grid->InsertNextCell(VTK_LINE, 2, line);
+  }
+  AddArrays(grid->GetPointData(), grid->GetNumberOfPoints());
+  AddArrays(grid->GetCellData(), grid->GetNumberOfCells());
+  const std::string gridFileName = testDirectory + "/TestXMLMemoryMappedArrays.vtu";
+  vtkNew<vtkXMLUnstructuredGridWriter> gridWriter;
+  gridWriter->SetInputData(grid);
+  gridWriter->SetFileName(gridFileName.c_str());
+  gridWriter->SetDataModeToAppended();
+  gridWriter->EncodeAppendedDataOff();
+  gridWriter->SetCompressorTypeToNone();
+  gridWriter->Write();
+  if (!TestFile<vtkXMLUnstructuredGridReader>(grid, gridFileName))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
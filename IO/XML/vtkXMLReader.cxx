@@ -43,6 +43,7 @@
 #include "vtkXMLDataParser.h"
 #include "vtkXMLFileReadTester.h"
 #include "vtkXMLReaderVersion.h"
+#include "vtkZFPDataCompressor.h"
 #include "vtkZLibDataCompressor.h"
 
 #include "vtksys/Encoding.hxx"
@@ -138,6 +139,7 @@ vtkXMLReader::vtkXMLReader()
   this->StringStream = nullptr;
   this->ReadFromInputString = 0;
   this->InputString = "";
+  this->MemoryMapRawAppendedData = false;
   this->XMLParser = nullptr;
   this->ReaderErrorObserver = nullptr;
   this->ParserErrorObserver = nullptr;
@@ -225,6 +227,7 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "PointDataArraySelection: " << this->PointDataArraySelection << "\n";
   os << indent << "ColumnArraySelection: " << this->PointDataArraySelection << "\n";
   os << indent << "TimeDataStringArray: " << this->TimeDataStringArray << "\n";
+  os << indent << "MemoryMapRawAppendedData: " << this->MemoryMapRawAppendedData << "\n";
   if (this->Stream)
   {
     os << indent << "Stream: " << this->Stream << "\n";
@@ -458,6 +461,10 @@ void vtkXMLReader::SetupCompressor(const char* type)
     {
       compressor = vtkLZMADataCompressor::New();
     }
+    else if (strcmp(type, "vtkZFPDataCompressor") == 0)
+    {
+      compressor = vtkZFPDataCompressor::New();
+    }
   }
 
   if (!compressor)
@@ -858,6 +865,31 @@ int vtkXMLDataReaderReadArrayValues(vtkXMLDataElement* da, vtkXMLDataParser* xml
 
 }
 
+//------------------------------------------------------------------------------
+int vtkXMLReader::MapArrayValues(vtkXMLDataElement* da, vtkAbstractArray* array)
+{
+  vtkDataArray* dataArray = vtkArrayDownCast<vtkDataArray>(array);
+  if (!this->MemoryMapRawAppendedData || !this->FileStream || this->Stream != this->FileStream ||
+    !da->GetAttribute("offset") || !dataArray ||
+    dataArray->GetArrayType() != vtkAbstractArray::AoSDataArrayTemplate ||
+    dataArray->GetNumberOfValues() == 0)
+  {
+    return 0;
+  }
+  vtkTypeInt64 offset = 0;
+  da->GetScalarAttribute("offset", offset);
+  void* data = this->XMLParser->MapAppendedData(this->FileName, offset,
+    static_cast<size_t>(dataArray->GetNumberOfValues()), dataArray->GetDataType());
+  if (!data)
+  {
+    return 0;
+  }
+  dataArray->SetVoidArray(data, dataArray->GetNumberOfValues(), 0,
+    vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  dataArray->SetArrayFreeFunction(vtkXMLDataParser::ReleaseMappedData);
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 int vtkXMLReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex,
   vtkAbstractArray* array, vtkIdType startIndex, vtkIdType numValues, FieldType fieldType)
@@ -876,12 +908,21 @@ int vtkXMLReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex,
                                << arrayIndex + numValues << " were requested to be read");
     return 0;
   }
-  switch (array->GetDataType())
+  if (arrayIndex == 0 && startIndex == 0 && numValues == array->GetNumberOfValues() &&
+    this->MapArrayValues(da, array))
   {
-    vtkArrayIteratorTemplateMacro(result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
-                                    arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
-    default:
-      result = 0;
+    result = 1;
+  }
+  else
+  {
+    switch (array->GetDataType())
+    {
+      vtkArrayIteratorTemplateMacro(
+        result = vtkXMLDataReaderReadArrayValues(
+          da, this->XMLParser, arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
+      default:
+        result = 0;
+    }
   }
   if (iter)
   {
@@ -73,6 +73,22 @@ public:
   void SetInputString(const std::string& s) { this->InputString = s; }
   //@}
 
+  //@{
+  /**
+   * Enable memory mapping of the arrays stored uncompressed, with the native
+   * byte order, in the raw appended data of a file. Arrays read whole, e.g.
+   * those of a single piece read entirely, then use a private mapping of the
+   * file instead of memory filled when reading, and their values are only
+   * read from the file when first touched. The file must not be modified or
+   * truncated while the arrays are in use, and changes made to the arrays
+   * are never written to the file. Default is off. Not supported on Windows,
+   * where the arrays are read as usual.
+   */
+  vtkSetMacro(MemoryMapRawAppendedData, bool);
+  vtkGetMacro(MemoryMapRawAppendedData, bool);
+  vtkBooleanMacro(MemoryMapRawAppendedData, bool);
+  //@}
+
   /**
    * Test whether the file (type) with the given name can be read by this
    * reader. If the file has a newer version than the reader, we still say
@@ -297,6 +313,11 @@ protected:
   virtual int ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex, vtkAbstractArray* array,
     vtkIdType startIndex, vtkIdType numValues, FieldType type = OTHER);
 
+  // Replace the storage of the array by a mapping of its values in the raw
+  // appended data, see MemoryMapRawAppendedData. Returns 1 when the array
+  // is mapped, 0 when it has to be read.
+  int MapArrayValues(vtkXMLDataElement* da, vtkAbstractArray* array);
+
   // Setup the data array selections for the input's set of arrays.
   void SetDataArraySelections(vtkXMLDataElement* eDSA, vtkDataArraySelection* sel);
 
@@ -334,6 +355,9 @@ protected:
   // The input string.
   std::string InputString;
 
+  // Whether raw appended arrays are memory mapped.
+  bool MemoryMapRawAppendedData;
+
   // The array selections.
   vtkDataArraySelection* PointDataArraySelection;
   vtkDataArraySelection* CellDataArraySelection;
@@ -45,9 +45,11 @@
 #include "vtkOutputStream.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
+#include "vtkZFPDataCompressor.h"
 #include "vtkZLibDataCompressor.h"
 #define vtkXMLOffsetsManager_DoNotInclude
 #include "vtkXMLOffsetsManager.h"
@@ -68,6 +70,7 @@
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #if !defined(_WIN32) || defined(__CYGWIN__)
 #include <unistd.h> /* unlink */
@@ -443,6 +446,22 @@ static int vtkXMLWriterWriteBinaryDataBlocks(vtkXMLWriter* writer,
 } // end anon namespace
 //*****************************************************************************
 
+// Uncompressed blocks queued by vtkXMLWriter::WriteCompressionBlock, to be
+// compressed concurrently by vtkXMLWriter::FlushCompressionBlocks.
+class vtkXMLWriterPendingBlocks
+{
+public:
+  void Clear()
+  {
+    this->Data.clear();
+    this->Sizes.clear();
+  }
+
+  std::vector<unsigned char> Data;
+  std::vector<size_t> Sizes;
+  std::vector<unsigned char> CompressedData;
+};
+
 vtkCxxSetObjectMacro(vtkXMLWriter, Compressor, vtkDataCompressor);
 //------------------------------------------------------------------------------
 vtkXMLWriter::vtkXMLWriter()
@@ -473,6 +492,7 @@ vtkXMLWriter::vtkXMLWriter()
   this->BlockSize = 32768; // 2^15
   this->Compressor = vtkZLibDataCompressor::New();
   this->CompressionHeader = nullptr;
+  this->PendingCompressionBlocks = new vtkXMLWriterPendingBlocks;
   this->Int32IdTypeBuffer = nullptr;
   this->ByteSwapBuffer = nullptr;
 
@@ -509,6 +529,7 @@ vtkXMLWriter::~vtkXMLWriter()
   this->OutStringStream = nullptr;
   delete this->FieldDataOM;
   delete[] this->NumberOfTimeValues;
+  delete this->PendingCompressionBlocks;
 }
 
 //------------------------------------------------------------------------------
@@ -553,6 +574,16 @@ void vtkXMLWriter::SetCompressorType(int compressorType)
     this->Compressor->SetCompressionLevel(this->CompressionLevel);
     this->Modified();
   }
+  else if (compressorType == ZFP)
+  {
+    if (this->Compressor && !this->Compressor->IsTypeOf("vtkZFPDataCompressor"))
+    {
+      this->Compressor->Delete();
+    }
+    this->Compressor = vtkZFPDataCompressor::New();
+    this->Compressor->SetCompressionLevel(this->CompressionLevel);
+    this->Modified();
+  }
   else
   {
     vtkWarningMacro("Invalid compressorType:" << compressorType);
@@ -1295,20 +1326,49 @@ int vtkXMLWriter::WriteBinaryData(vtkAbstractArray* a)
 
   if (this->Compressor)
   {
+    // ZFP compresses the components of floating-point data separately, so
+    // it needs the layout of the array, and blocks made of whole tuples.
+    const size_t blockSize = this->BlockSize;
+    if (vtkZFPDataCompressor* zfp = vtkZFPDataCompressor::SafeDownCast(this->Compressor))
+    {
+      // Byte-swapped values are compressed losslessly.
+      size_t outWordSize = this->GetOutputWordTypeSize(wordType);
+#ifdef VTK_WORDS_BIGENDIAN
+      bool swap = this->ByteOrder != vtkXMLWriter::BigEndian;
+#else
+      bool swap = this->ByteOrder != vtkXMLWriter::LittleEndian;
+#endif
+      bool lossy = !swap && (wordType == VTK_FLOAT || wordType == VTK_DOUBLE);
+      zfp->SetDataType(lossy ? wordType : VTK_VOID);
+      zfp->SetNumberOfComponents(a->GetNumberOfComponents());
+      size_t tupleSize = outWordSize * a->GetNumberOfComponents();
+      if (lossy && tupleSize <= this->BlockSize)
+      {
+        this->BlockSize -= this->BlockSize % tupleSize;
+      }
+    }
+
     // Need to compress the data.  Create compression header.  This
     // reserves enough space in the output.
     if (!this->CreateCompressionHeader(dataSize))
     {
+      this->BlockSize = blockSize;
       return 0;
     }
     // Start writing the data.
     int result = this->DataStream->StartWriting();
 
-    // Process the actual data.
+    // Process the actual data, and the blocks still waiting to be
+    // compressed.
     if (result && !this->WriteBinaryDataInternal(a))
     {
       result = 0;
     }
+    if (result && !this->FlushCompressionBlocks())
+    {
+      result = 0;
+    }
+    this->PendingCompressionBlocks->Clear();
 
     // Finish writing the data.
     if (result && !this->DataStream->EndWriting())
@@ -1326,6 +1386,7 @@ int vtkXMLWriter::WriteBinaryData(vtkAbstractArray* a)
     delete this->CompressionHeader;
     this->CompressionHeader = nullptr;
 
+    this->BlockSize = blockSize;
     return result;
   }
   else
@@ -1672,8 +1733,23 @@ int vtkXMLWriter::CreateCompressionHeader(size_t size)
 //------------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionBlock(unsigned char* data, size_t size)
 {
+  // When the compressor is thread safe, queue the blocks to compress a few
+  // of them per thread at once.
+  const size_t numThreads = static_cast<size_t>(vtkSMPTools::GetEstimatedNumberOfThreads());
+  if (numThreads > 1 && this->Compressor->IsThreadSafe())
+  {
+    vtkXMLWriterPendingBlocks* pending = this->PendingCompressionBlocks;
+    pending->Data.insert(pending->Data.end(), data, data + size);
+    pending->Sizes.push_back(size);
+    return pending->Sizes.size() < 4 * numThreads ? 1 : this->FlushCompressionBlocks();
+  }
+
   // Compress the data.
   vtkUnsignedCharArray* outputArray = this->Compressor->Compress(data, size);
+  if (!outputArray)
+  {
+    return 0;
+  }
 
   // Find the compressed size.
   size_t outputSize = outputArray->GetNumberOfTuples();
@@ -1695,6 +1771,57 @@ int vtkXMLWriter::WriteCompressionBlock(unsigned char* data, size_t size)
   return result;
 }
 
+//------------------------------------------------------------------------------
+int vtkXMLWriter::FlushCompressionBlocks()
+{
+  vtkXMLWriterPendingBlocks* pending = this->PendingCompressionBlocks;
+  const vtkIdType numBlocks = static_cast<vtkIdType>(pending->Sizes.size());
+  if (numBlocks == 0)
+  {
+    return 1;
+  }
+
+  // Find where each block starts, and where its compressed data may go.
+  std::vector<size_t> offsets(numBlocks + 1, 0);
+  std::vector<size_t> spaces(numBlocks + 1, 0);
+  for (vtkIdType i = 0; i < numBlocks; ++i)
+  {
+    offsets[i + 1] = offsets[i] + pending->Sizes[i];
+    spaces[i + 1] = spaces[i] + this->Compressor->GetMaximumCompressionSpace(pending->Sizes[i]);
+  }
+  pending->CompressedData.resize(spaces[numBlocks]);
+
+  // Compress the blocks concurrently.
+  std::vector<size_t> compressedSizes(numBlocks);
+  vtkDataCompressor* compressor = this->Compressor;
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      compressedSizes[i] = compressor->Compress(&pending->Data[offsets[i]], pending->Sizes[i],
+        &pending->CompressedData[spaces[i]], spaces[i + 1] - spaces[i]);
+    }
+  });
+  pending->Clear();
+
+  // Write them in order.
+  for (vtkIdType i = 0; i < numBlocks; ++i)
+  {
+    if (!compressedSizes[i] ||
+      !this->DataStream->Write(&pending->CompressedData[spaces[i]], compressedSizes[i]))
+    {
+      return 0;
+    }
+    this->CompressionHeader->Set(3 + this->CompressionBlockNumber++, compressedSizes[i]);
+  }
+  this->Stream->flush();
+  if (this->Stream->fail())
+  {
+    this->SetErrorCode(vtkErrorCode::GetLastSystemError());
+    return 0;
+  }
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionHeader()
 {
@@ -52,6 +52,7 @@ class vtkPointData;
 class vtkPoints;
 class vtkFieldData;
 class vtkXMLDataHeader;
+class vtkXMLWriterPendingBlocks;
 
 class vtkStdString;
 class OffsetsManager;      // one per piece/per time
@@ -173,7 +174,8 @@ public:
     NONE,
     ZLIB,
     LZ4,
-    LZMA
+    LZMA,
+    ZFP
   };
 
   //@{
@@ -185,6 +187,7 @@ public:
   void SetCompressorTypeToLZ4() { this->SetCompressorType(LZ4); }
   void SetCompressorTypeToZLib() { this->SetCompressorType(ZLIB); }
   void SetCompressorTypeToLZMA() { this->SetCompressorType(LZMA); }
+  void SetCompressorTypeToZFP() { this->SetCompressorType(ZFP); }
 
   void SetCompressionLevel(int compressorLevel);
   vtkGetMacro(CompressionLevel, int);
@@ -342,6 +345,8 @@ protected:
   // Compression Level for vtkDataCompressor objects
   // 1 (worst compression, fastest) ... 9 (best compression, slowest)
   int CompressionLevel = 5;
+  // Blocks waiting to be compressed concurrently and written.
+  vtkXMLWriterPendingBlocks* PendingCompressionBlocks;
 
   // The output stream used to write binary and appended data.  May
   // transparently encode the data.
@@ -462,6 +467,7 @@ protected:
   void PerformByteSwap(void* data, size_t numWords, size_t wordSize);
   int CreateCompressionHeader(size_t size);
   int WriteCompressionBlock(unsigned char* data, size_t size);
+  int FlushCompressionBlocks();
   int WriteCompressionHeader();
   size_t GetWordTypeSize(int dataType);
   const char* GetWordTypeName(int dataType);
@@ -21,6 +21,7 @@
 #include "vtkEndian.h"
 #include "vtkInputStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkXMLDataElement.h"
 #define vtkXMLDataHeaderPrivate_DoNotInclude
 #include "vtkXMLDataHeaderPrivate.h"
@@ -29,10 +30,19 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <vector>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "vtkXMLUtilities.h"
 
 vtkStandardNewMacro(vtkXMLDataParser);
@@ -639,6 +649,52 @@ unsigned char* vtkXMLDataParser::ReadBlock(vtkTypeUInt64 block)
   return decompressBuffer;
 }
 
+//------------------------------------------------------------------------------
+int vtkXMLDataParser::ReadBlocks(
+  vtkTypeUInt64 firstBlock, size_t numBlocks, unsigned char* buffer)
+{
+  // The blocks are complete and stored one after the other, so their
+  // compressed data are read at once and uncompressed concurrently.
+  if (numBlocks == 1 || !this->Compressor->IsThreadSafe())
+  {
+    for (size_t i = 0; i < numBlocks; ++i)
+    {
+      if (!this->ReadBlock(firstBlock + i, buffer + i * this->BlockUncompressedSize))
+      {
+        return 0;
+      }
+    }
+    return 1;
+  }
+
+  std::vector<size_t> offsets(numBlocks + 1, 0);
+  for (size_t i = 0; i < numBlocks; ++i)
+  {
+    offsets[i + 1] = offsets[i] + this->BlockCompressedSizes[firstBlock + i];
+  }
+  if (!this->DataStream->Seek(this->BlockStartOffsets[firstBlock]))
+  {
+    return 0;
+  }
+  std::vector<unsigned char> readBuffer(offsets[numBlocks]);
+  if (this->DataStream->Read(readBuffer.data(), readBuffer.size()) < readBuffer.size())
+  {
+    return 0;
+  }
+
+  std::vector<size_t> results(numBlocks);
+  vtkDataCompressor* compressor = this->Compressor;
+  const size_t blockSize = this->BlockUncompressedSize;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numBlocks), [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      results[i] = compressor->Uncompress(&readBuffer[offsets[i]], offsets[i + 1] - offsets[i],
+        buffer + i * blockSize, blockSize);
+    }
+  });
+  return std::find(results.begin(), results.end(), 0) == results.end();
+}
+
 //------------------------------------------------------------------------------
 size_t vtkXMLDataParser::ReadUncompressedData(
   unsigned char* data, vtkTypeUInt64 startWord, size_t numWords, size_t wordSize)
@@ -811,21 +867,26 @@ size_t vtkXMLDataParser::ReadCompressedData(
     // Report progress.
     this->UpdateProgress(float(outputPointer - data) / length);
 
-    unsigned int currentBlock = firstBlock + 1;
-    for (; currentBlock != lastBlock && !this->Abort; ++currentBlock)
+    // Read the complete blocks a few per thread at once, so that they can
+    // be uncompressed concurrently.
+    const vtkTypeUInt64 batchSize = 4 * vtkSMPTools::GetEstimatedNumberOfThreads();
+    vtkTypeUInt64 currentBlock = firstBlock + 1;
+    while (currentBlock < lastBlock && !this->Abort)
     {
-      // Read this block.
-      if (!this->ReadBlock(currentBlock, outputPointer))
+      // Read these blocks.
+      const size_t numBlocks = static_cast<size_t>(std::min(lastBlock - currentBlock, batchSize));
+      if (!this->ReadBlocks(currentBlock, numBlocks, outputPointer))
       {
         return 0;
       }
 
-      // Byte swap this block.  Note that blockSize will always be an
+      // Byte swap these blocks.  Note that blockSize will always be an
       // integer multiple of the word size.
-      this->PerformByteSwap(outputPointer, blockSize / wordSize, wordSize);
+      this->PerformByteSwap(outputPointer, numBlocks * blockSize / wordSize, wordSize);
 
       // Advance the pointer to the beginning of the next block.
-      outputPointer += this->FindBlockSize(currentBlock);
+      outputPointer += numBlocks * blockSize;
+      currentBlock += numBlocks;
 
       // Report progress.
       this->UpdateProgress(float(outputPointer - data) / length);
@@ -973,6 +1034,128 @@ size_t vtkXMLDataParser::ReadAppendedData(
   return this->ReadBinaryData(buffer, startWord, numWords, wordType);
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+// The mappings of the data returned by MapAppendedData(), by data pointer.
+struct vtkXMLMappedData
+{
+  void* Address;
+  size_t Length;
+};
+
+std::mutex& GetMappedDataMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<void*, vtkXMLMappedData>& GetMappedData()
+{
+  static std::map<void*, vtkXMLMappedData> mappedData;
+  return mappedData;
+}
+}
+
+//------------------------------------------------------------------------------
+void* vtkXMLDataParser::MapAppendedData(
+  const char* fileName, vtkTypeInt64 offset, size_t numWords, int wordType)
+{
+#if defined(_WIN32)
+  (void)fileName;
+  (void)offset;
+  (void)numWords;
+  (void)wordType;
+  return nullptr;
+#else
+#ifdef VTK_WORDS_BIGENDIAN
+  const int nativeByteOrder = vtkXMLDataParser::BigEndian;
+#else
+  const int nativeByteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  if (this->Abort || this->Compressor || this->ByteOrder != nativeByteOrder || !fileName ||
+    numWords == 0 || wordType == VTK_BIT || this->AppendedDataStream->IsA("vtkBase64InputStream"))
+  {
+    return nullptr;
+  }
+
+  // Read the length of the data.
+  std::unique_ptr<vtkXMLDataHeader> uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+  size_t const headerSize = uh->DataSize();
+  this->DataStream = this->AppendedDataStream;
+  this->SeekG(this->AppendedDataPosition + offset);
+  this->DataStream->SetStream(this->Stream);
+  this->DataStream->StartReading();
+  size_t r = this->DataStream->Read(uh->Data(), headerSize);
+  this->DataStream->EndReading();
+  if (r < headerSize)
+  {
+    return nullptr;
+  }
+  this->PerformByteSwap(uh->Data(), uh->WordCount(), uh->WordSize());
+  size_t const wordSize = this->GetWordTypeSize(wordType);
+  size_t const length = numWords * wordSize;
+  if (uh->Get(0) < length)
+  {
+    return nullptr;
+  }
+
+  // Mappings start at a page boundary, the words must be aligned in the file.
+  vtkTypeInt64 const dataOffset = this->AppendedDataPosition + offset + headerSize;
+  vtkTypeInt64 const pageSize = sysconf(_SC_PAGESIZE);
+  if (dataOffset % static_cast<vtkTypeInt64>(wordSize) != 0 || pageSize <= 0)
+  {
+    return nullptr;
+  }
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+  struct stat fileStat;
+  vtkTypeInt64 const mapOffset = dataOffset - dataOffset % pageSize;
+  size_t const mapLength = static_cast<size_t>(dataOffset - mapOffset) + length;
+  void* address = MAP_FAILED;
+  if (fstat(fd, &fileStat) == 0 &&
+    static_cast<vtkTypeInt64>(fileStat.st_size) >= dataOffset + static_cast<vtkTypeInt64>(length))
+  {
+    address = mmap(
+      nullptr, mapLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(mapOffset));
+  }
+  close(fd);
+  if (address == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  void* data = static_cast<char*>(address) + (dataOffset - mapOffset);
+  std::lock_guard<std::mutex> lock(GetMappedDataMutex());
+  GetMappedData()[data] = vtkXMLMappedData{ address, mapLength };
+  return data;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void vtkXMLDataParser::ReleaseMappedData(void* data)
+{
+#if !defined(_WIN32)
+  vtkXMLMappedData mapping;
+  {
+    std::lock_guard<std::mutex> lock(GetMappedDataMutex());
+    auto found = GetMappedData().find(data);
+    if (found == GetMappedData().end())
+    {
+      return;
+    }
+    mapping = found->second;
+    GetMappedData().erase(found);
+  }
+  munmap(mapping.Address, mapping.Length);
+#else
+  (void)data;
+#endif
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 // Define a parsing function template.  The extra "long" argument is used
@@ -81,6 +81,24 @@ public:
     return this->ReadAppendedData(offset, buffer, startWord, numWords, VTK_CHAR);
   }
 
+  /**
+   * Map the uncompressed words of raw appended data starting at the given
+   * appended data offset from the file with the given name, which must be
+   * the file being parsed. The mapping is private, its pages are read from
+   * the file when first touched. Returns a pointer to the numWords words,
+   * to be released with ReleaseMappedData(), or nullptr when the data is
+   * compressed, encoded, byte swapped, misaligned or shorter than numWords
+   * words, or cannot be mapped on this platform.
+   */
+  void* MapAppendedData(
+    const char* fileName, vtkTypeInt64 offset, size_t numWords, int wordType);
+
+  /**
+   * Release data returned by MapAppendedData(). Its signature makes it
+   * usable as the free function of a data array.
+   */
+  static void ReleaseMappedData(void* data);
+
   /**
    * Read from an ascii data section starting at the current position in
    * the stream.  Returns the number of words read.
@@ -186,6 +204,7 @@ protected:
   size_t FindBlockSize(vtkTypeUInt64 block);
   int ReadBlock(vtkTypeUInt64 block, unsigned char* buffer);
   unsigned char* ReadBlock(vtkTypeUInt64 block);
+  int ReadBlocks(vtkTypeUInt64 firstBlock, size_t numBlocks, unsigned char* buffer);
   size_t ReadUncompressedData(
     unsigned char* data, vtkTypeUInt64 startWord, size_t numWords, size_t wordSize);
   size_t ReadCompressedData(
@@ -0,0 +1,139 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageEuclideanDistance.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks the distances of vtkImageEuclideanDistance against the closest zero
+// voxels, and that Felzenszwalb's and Saito's algorithms agree, with an
+// anisotropic spacing and with float outputs.
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkImageEuclideanDistance.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+vtkSmartPointer<vtkImageData> MakeImage(int maxValue)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(23, 17, 11);
+  image->SetSpacing(0.5, 1.0, 1.5);
+  image->AllocateScalars(VTK_SHORT, 1);
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+  {
+    // about 2% of zeros
+    random->Next();
+    scalars->SetComponent(
+      i, 0, random->GetValue() < 0.02 ? 0 : 1 + static_cast<int>(random->GetValue() * maxValue));
+  }
+  return image;
+}
+
+vtkDataArray* Distances(vtkImageEuclideanDistance* edt, vtkImageData* image, int algorithm)
+{
+  edt->SetInputData(image);
+  edt->SetAlgorithm(algorithm);
+  edt->Update();
+  return edt->GetOutput()->GetPointData()->GetScalars();
+}
+
+bool SameDistances(vtkDataArray* distances1, vtkDataArray* distances2, const char* name)
+{
+  for (vtkIdType i = 0; i < distances1->GetNumberOfTuples(); ++i)
+  {
+    const double d1 = distances1->GetComponent(i, 0);
+    const double d2 = distances2->GetComponent(i, 0);
+    if (std::abs(d1 - d2) > 1e-6 * (1.0 + d1))
+    {
+      std::cerr << name << ": distance " << i << " is " << d2 << " instead of " << d1 << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestImageEuclideanDistance(int, char*[])
+{
+  vtkSmartPointer<vtkImageData> image = MakeImage(1);
+
+  // the squared distances to the closest zero voxels
+  vtkNew<vtkImageData> expected;
+  expected->CopyStructure(image);
+  expected->AllocateScalars(VTK_DOUBLE, 1);
+  vtkDataArray* expectedDistances = expected->GetPointData()->GetScalars();
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    image->GetPoint(i, x);
+    double distance = VTK_INT_MAX;
+    for (vtkIdType j = 0; j < image->GetNumberOfPoints(); ++j)
+    {
+      if (scalars->GetComponent(j, 0) == 0)
+      {
+        double y[3];
+        image->GetPoint(j, y);
+        distance = std::min(distance,
+          (x[0] - y[0]) * (x[0] - y[0]) + (x[1] - y[1]) * (x[1] - y[1]) +
+            (x[2] - y[2]) * (x[2] - y[2]));
+      }
+    }
+    expectedDistances->SetComponent(i, 0, distance);
+  }
+
+  vtkNew<vtkImageEuclideanDistance> edt;
+  for (int algorithm : { VTK_EDT_FELZENSZWALB, VTK_EDT_SAITO, VTK_EDT_SAITO_CACHED })
+  {
+    if (!SameDistances(expectedDistances, Distances(edt, image, algorithm), "Distances"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // a float output
+  edt->SetOutputScalarTypeToFloat();
+  vtkDataArray* floatDistances = Distances(edt, image, VTK_EDT_FELZENSZWALB);
+  if (floatDistances->GetDataType() != VTK_FLOAT ||
+    !SameDistances(expectedDistances, floatDistances, "Float"))
+  {
+    std::cerr << "Wrong float output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  edt->SetOutputScalarTypeToDouble();
+
+  // the input values as initial squared distances, with a maximum distance
+  image = MakeImage(50);
+  edt->InitializeOff();
+  edt->SetMaximumDistance(30.0);
+  edt->ConsiderAnisotropyOff();
+  vtkNew<vtkDoubleArray> saito;
+  saito->DeepCopy(Distances(edt, image, VTK_EDT_SAITO));
+  if (!SameDistances(saito, Distances(edt, image, VTK_EDT_FELZENSZWALB), "Initialize off"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageFFT.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks vtkImageFFT and vtkImageRFFT against a direct discrete Fourier
+// transform, for real and complex inputs with odd and prime sizes, with
+// vtkSMPTools and with one piece per thread.
+
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkImageFFT.h"
+#include "vtkImageRFFT.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+vtkSmartPointer<vtkImageData> MakeImage(const int dims[3], int numComps)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(dims[0], dims[1], dims[2]);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetNumberOfComponents(numComps);
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < scalars->GetNumberOfValues(); ++i)
+  {
+    scalars->SetValue(i, std::sin(0.37 * i) + std::cos(1.3 * i * i));
+  }
+  image->GetPointData()->SetScalars(scalars);
+  return image;
+}
+
+// The direct transform of the image, one axis after the other.
+std::vector<std::complex<double>> Transform(vtkImageData* image, double sign)
+{
+  int dims[3];
+  image->GetDimensions(dims);
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  std::vector<std::complex<double>> values(scalars->GetNumberOfTuples());
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+  {
+    values[i] = std::complex<double>(scalars->GetComponent(i, 0),
+      scalars->GetNumberOfComponents() > 1 ? scalars->GetComponent(i, 1) : 0.0);
+  }
+  const vtkIdType increments[3] = { 1, dims[0], dims[0] * dims[1] };
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    const int N = dims[axis];
+    std::vector<std::complex<double>> transformed(values.size());
+    for (vtkIdType i = 0; i < static_cast<vtkIdType>(values.size()); ++i)
+    {
+      const int k = static_cast<int>((i / increments[axis]) % N);
+      const vtkIdType first = i - k * increments[axis];
+      std::complex<double> sum = 0.0;
+      for (int n = 0; n < N; ++n)
+      {
+        sum += values[first + n * increments[axis]] *
+          std::polar(1.0, sign * 2.0 * vtkMath::Pi() * k * n / N);
+      }
+      transformed[i] = sign > 0.0 ? sum / static_cast<double>(N) : sum;
+    }
+    values.swap(transformed);
+  }
+  return values;
+}
+
+bool SameValues(
+  vtkImageData* image, const std::vector<std::complex<double>>& values, const char* name)
+{
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  if (scalars->GetNumberOfComponents() != 2 ||
+    scalars->GetNumberOfTuples() != static_cast<vtkIdType>(values.size()))
+  {
+    std::cerr << name << ": wrong output size" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+  {
+    if (std::abs(std::complex<double>(scalars->GetComponent(i, 0), scalars->GetComponent(i, 1)) -
+          values[i]) > 1e-9 * (1.0 + std::abs(values[i])))
+    {
+      std::cerr << name << ": wrong value at " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestImage(vtkImageData* image, bool smp, const char* name)
+{
+  vtkNew<vtkImageFFT> fft;
+  fft->SetInputData(image);
+  fft->SetEnableSMP(smp);
+  fft->SetNumberOfThreads(3);
+  fft->Update();
+  if (!SameValues(fft->GetOutput(), Transform(image, -1.0), name))
+  {
+    return false;
+  }
+
+  vtkNew<vtkImageRFFT> rfft;
+  rfft->SetInputData(image);
+  rfft->SetEnableSMP(smp);
+  rfft->SetNumberOfThreads(3);
+  rfft->Update();
+  if (!SameValues(rfft->GetOutput(), Transform(image, 1.0), name))
+  {
+    return false;
+  }
+
+  // back to the input
+  rfft->SetInputConnection(fft->GetOutputPort());
+  rfft->Update();
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  std::vector<std::complex<double>> values(scalars->GetNumberOfTuples());
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+  {
+    values[i] = std::complex<double>(scalars->GetComponent(i, 0),
+      scalars->GetNumberOfComponents() > 1 ? scalars->GetComponent(i, 1) : 0.0);
+  }
+  return SameValues(rfft->GetOutput(), values, name);
+}
+}
+
+int TestImageFFT(int, char*[])
+{
+  const int sizes[][3] = { { 16, 12, 1 }, { 10, 7, 5 }, { 9, 17, 3 } };
+  // The filters run with vtkSMPTools on the STDThread backend, and with one
+  // piece per thread of vtkMultiThreader on the Sequential backend.
+  for (bool smp : { true, false })
+  {
+    bool success = true;
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ smp ? "STDThread" : "Sequential" }, [&]() {
+      for (const auto& dims : sizes)
+      {
+        success = success && TestImage(MakeImage(dims, 1), smp, "Real") &&
+          TestImage(MakeImage(dims, 2), smp, "Complex");
+      }
+    });
+    if (!success)
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,241 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageFusedExecution.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that pointwise imaging filters give the same outputs when their
+// pieces are fused with the ones of the next filter, with vtkSMPTools and
+// with one piece per thread, and that the outputs of the intermediate
+// filters are complete when they are updated alone.
+
+#include "vtkDataArray.h"
+#include "vtkImageCast.h"
+#include "vtkImageData.h"
+#include "vtkImageMapToColors.h"
+#include "vtkImageShiftScale.h"
+#include "vtkLookupTable.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+bool SameImages(vtkImageData* image1, vtkImageData* image2, const char* name)
+{
+  int extent1[6], extent2[6];
+  image1->GetExtent(extent1);
+  image2->GetExtent(extent2);
+  vtkDataArray* scalars1 = image1->GetPointData()->GetScalars();
+  vtkDataArray* scalars2 = image2->GetPointData()->GetScalars();
+  if (!std::equal(extent1, extent1 + 6, extent2) || !scalars1 || !scalars2 ||
+    scalars1->GetDataType() != scalars2->GetDataType() ||
+    scalars1->GetNumberOfValues() != scalars2->GetNumberOfValues())
+  {
+    std::cerr << name << ": the images differ in extent or type" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < scalars1->GetNumberOfValues(); ++i)
+  {
+    const int numComps = scalars1->GetNumberOfComponents();
+    if (scalars1->GetComponent(i / numComps, static_cast<int>(i % numComps)) !=
+      scalars2->GetComponent(i / numComps, static_cast<int>(i % numComps)))
+    {
+      std::cerr << name << ": the images differ at value " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// RTAnalytic -> ShiftScale -> MapToColors -> Cast, and the images of the
+// three filters.
+struct Chain
+{
+  vtkNew<vtkRTAnalyticSource> Source;
+  vtkNew<vtkImageShiftScale> ShiftScale;
+  vtkNew<vtkLookupTable> Table;
+  vtkNew<vtkImageMapToColors> Colors;
+  vtkNew<vtkImageCast> Cast;
+
+  Chain(bool fused, bool smp)
+  {
+    this->Source->SetWholeExtent(-40, 40, -40, 40, -20, 20);
+    this->ShiftScale->SetInputConnection(this->Source->GetOutputPort());
+    this->ShiftScale->SetShift(-37.0);
+    this->ShiftScale->SetScale(0.9);
+    this->Table->SetRange(0.0, 250.0);
+    this->Colors->SetInputConnection(this->ShiftScale->GetOutputPort());
+    this->Colors->SetLookupTable(this->Table);
+    this->Cast->SetInputConnection(this->Colors->GetOutputPort());
+    this->Cast->SetOutputScalarTypeToFloat();
+    for (vtkThreadedImageAlgorithm* filter :
+      { static_cast<vtkThreadedImageAlgorithm*>(this->ShiftScale),
+        static_cast<vtkThreadedImageAlgorithm*>(this->Colors),
+        static_cast<vtkThreadedImageAlgorithm*>(this->Cast) })
+    {
+      filter->SetFusedExtentExecution(fused);
+      filter->SetEnableSMP(smp);
+      filter->SetNumberOfThreads(4);
+    }
+  }
+
+  bool Same(Chain& other, const char* name)
+  {
+    return SameImages(this->ShiftScale->GetOutput(), other.ShiftScale->GetOutput(), name) &&
+      SameImages(this->Colors->GetOutput(), other.Colors->GetOutput(), name) &&
+      SameImages(this->Cast->GetOutput(), other.Cast->GetOutput(), name);
+  }
+};
+
+bool TestChains(Chain& reference, bool smp)
+{
+  const char* name = smp ? "SMP" : "Threads";
+  Chain unfused(false, smp);
+  unfused.Cast->Update();
+  Chain fused(true, smp);
+  fused.Cast->Update();
+  if (!reference.Same(unfused, name) || !reference.Same(fused, name))
+  {
+    return false;
+  }
+
+  // an update extent smaller than the whole extent
+  Chain piece(false, smp);
+  Chain fusedPiece(true, smp);
+  const int extent[6] = { -10, 30, -40, 0, 5, 12 };
+  piece.Cast->UpdateExtent(extent);
+  fusedPiece.Cast->UpdateExtent(extent);
+  if (!piece.Same(fusedPiece, name))
+  {
+    return false;
+  }
+
+  // a second consumer of the shift scale output, which is not fused with
+  // the next filters
+  Chain branched(true, smp);
+  vtkNew<vtkImageCast> cast;
+  cast->SetInputConnection(branched.ShiftScale->GetOutputPort());
+  cast->SetFusedExtentExecution(true);
+  branched.Cast->Update();
+  cast->Update();
+  if (!reference.Same(branched, name))
+  {
+    return false;
+  }
+
+  // the input of the shift scale is released once it executes
+  Chain released(true, smp);
+  released.Source->ReleaseDataFlagOn();
+  released.Cast->Update();
+  if (!reference.Same(released, name))
+  {
+    return false;
+  }
+
+  // a change in the middle of the chain
+  fused.Colors->SetOutputFormatToRGB();
+  fused.Cast->Update();
+  unfused.Colors->SetOutputFormatToRGB();
+  unfused.Cast->Update();
+  if (!unfused.Same(fused, name))
+  {
+    return false;
+  }
+
+  // the intermediate filters updated alone, before and after the last one
+  Chain intermediate(true, smp);
+  intermediate.ShiftScale->Update();
+  if (!SameImages(reference.ShiftScale->GetOutput(), intermediate.ShiftScale->GetOutput(), name))
+  {
+    return false;
+  }
+  intermediate.Colors->Update();
+  if (!SameImages(reference.Colors->GetOutput(), intermediate.Colors->GetOutput(), name))
+  {
+    return false;
+  }
+  intermediate.Source->Modified();
+  intermediate.Colors->Update();
+  if (!SameImages(reference.ShiftScale->GetOutput(), intermediate.ShiftScale->GetOutput(), name) ||
+    !SameImages(reference.Colors->GetOutput(), intermediate.Colors->GetOutput(), name))
+  {
+    return false;
+  }
+  intermediate.Source->Modified();
+  intermediate.Cast->Update();
+  intermediate.ShiftScale->SetScale(0.5);
+  intermediate.ShiftScale->Update();
+  Chain scaled(false, smp);
+  scaled.ShiftScale->SetScale(0.5);
+  scaled.Cast->Update();
+  if (!SameImages(scaled.ShiftScale->GetOutput(), intermediate.ShiftScale->GetOutput(), name))
+  {
+    return false;
+  }
+  intermediate.Cast->Update();
+  if (!scaled.Same(intermediate, name))
+  {
+    return false;
+  }
+
+  // a change of the chain between two updates, the map to colors is
+  // removed and then put back
+  Chain rewired(true, smp);
+  rewired.Cast->Update();
+  rewired.Cast->SetInputConnection(rewired.ShiftScale->GetOutputPort());
+  rewired.Cast->Update();
+  Chain shortened(false, smp);
+  shortened.Cast->SetInputConnection(shortened.ShiftScale->GetOutputPort());
+  shortened.Cast->Update();
+  if (!SameImages(shortened.ShiftScale->GetOutput(), rewired.ShiftScale->GetOutput(), name) ||
+    !SameImages(shortened.Cast->GetOutput(), rewired.Cast->GetOutput(), name))
+  {
+    return false;
+  }
+  rewired.Cast->SetInputConnection(rewired.Colors->GetOutputPort());
+  rewired.ShiftScale->Modified();
+  rewired.Cast->Update();
+  if (!reference.Same(rewired, name))
+  {
+    return false;
+  }
+
+  return true;
+}
+}
+
+int TestImageFusedExecution(int, char*[])
+{
+  Chain reference(false, true);
+  reference.Cast->Update();
+
+  // The filters run with vtkSMPTools on the STDThread backend, and with one
+  // piece per thread of vtkMultiThreader on the Sequential backend.
+  for (bool smp : { true, false })
+  {
+    bool success = false;
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ smp ? "STDThread" : "Sequential" },
+      [&]() { success = TestChains(reference, smp); });
+    if (!success)
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
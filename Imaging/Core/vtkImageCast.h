@@ -85,6 +85,8 @@ protected:
 
   void ThreadedExecute(vtkImageData* inData, vtkImageData* outData, int ext[6], int id) override;
 
+  bool CanFuseExtent() override { return true; }
+
 private:
   vtkImageCast(const vtkImageCast&) = delete;
   void operator=(const vtkImageCast&) = delete;
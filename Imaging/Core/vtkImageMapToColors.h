@@ -106,6 +106,9 @@ protected:
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
     vtkInformationVector* outputVector) override;
 
+  // the data is passed instead of mapped without lookup table
+  bool CanFuseExtent() override { return this->LookupTable != nullptr; }
+
   vtkScalarsToColors* LookupTable;
   int OutputFormat;
 
@@ -98,6 +98,8 @@ protected:
   void ThreadedRequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*,
     vtkImageData*** inData, vtkImageData** outData, int outExt[6], int threadId) override;
 
+  bool CanFuseExtent() override { return true; }
+
 private:
   vtkImageShiftScale(const vtkImageShiftScale&) = delete;
   void operator=(const vtkImageShiftScale&) = delete;
@@ -20,10 +20,12 @@
  * can have real or complex data in any components and data types, but
  * the output is always complex doubles with real values in component0, and
  * imaginary values in component1.  The filter is fastest for images that
- * have power of two sizes.  The filter uses a butterfly diagram for each
- * prime factor of the dimension.  This makes images with prime number dimensions
- * (i.e. 17x17) much slower to compute.  Multi dimensional (i.e volumes)
- * FFT's are decomposed so that each axis executes serially.
+ * have sizes made of the factors 2, 3 and 5.  The filter uses kissfft, with a
+ * butterfly diagram for each prime factor of the dimension.  This makes images
+ * with prime number dimensions (i.e. 17x17) much slower to compute.  Multi
+ * dimensional (i.e volumes) FFT's are decomposed so that each axis executes
+ * serially, the rows of an axis being transformed in parallel.  Real inputs
+ * are transformed two rows at a time.
  */
 
 #ifndef vtkImageFFT_h
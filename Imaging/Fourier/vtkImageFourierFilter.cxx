@@ -14,8 +14,254 @@
 =========================================================================*/
 #include "vtkImageFourierFilter.h"
 
+#include "vtkImageData.h"
 #include "vtkMath.h"
+
+// clang-format off
+#include "vtk_kissfft.h"
+#include VTK_KISSFFT_HEADER(kiss_fft.h)
+// clang-format on
+
+#include <algorithm>
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// The kissfft plans of the filter, built once for each size and direction.
+// kiss_fft only reads its plan, so that the threads and the axes share them.
+class vtkImageFourierFilterPlans
+{
+public:
+  ~vtkImageFourierFilterPlans()
+  {
+    for (auto& plan : this->Plans)
+    {
+      kiss_fft_free(plan.second);
+    }
+  }
+
+  kiss_fft_cfg Get(int N, int fb)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    kiss_fft_cfg& plan = this->Plans[std::make_pair(N, fb)];
+    if (!plan)
+    {
+      plan = kiss_fft_alloc(N, fb == -1, nullptr, nullptr);
+    }
+    return plan;
+  }
+
+private:
+  std::mutex Mutex;
+  std::map<std::pair<int, int>, kiss_fft_cfg> Plans;
+};
+
+//------------------------------------------------------------------------------
+// kiss_fft_cpx has the layout of vtkImageComplex when kissfft is built with
+// doubles, as it is in VTK. Other builds go through a copy.
+template <typename TScalar>
+struct vtkImageFourierFilterKiss
+{
+  static void Fft(kiss_fft_cfg plan, const vtkImageComplex* in, vtkImageComplex* out, int N)
+  {
+    std::vector<kiss_fft_cpx> fin(N);
+    std::vector<kiss_fft_cpx> fout(N);
+    for (int i = 0; i < N; ++i)
+    {
+      fin[i].r = static_cast<TScalar>(in[i].Real);
+      fin[i].i = static_cast<TScalar>(in[i].Imag);
+    }
+    kiss_fft(plan, fin.data(), fout.data());
+    for (int i = 0; i < N; ++i)
+    {
+      out[i].Real = static_cast<double>(fout[i].r);
+      out[i].Imag = static_cast<double>(fout[i].i);
+    }
+  }
+};
+
+template <>
+struct vtkImageFourierFilterKiss<double>
+{
+  static void Fft(kiss_fft_cfg plan, const vtkImageComplex* in, vtkImageComplex* out, int)
+  {
+    kiss_fft(plan, reinterpret_cast<const kiss_fft_cpx*>(in), reinterpret_cast<kiss_fft_cpx*>(out));
+  }
+};
+
+//------------------------------------------------------------------------------
+// This function calculates the fft (or rfft) of the rows, with the plan
+// of their size and direction.
+// (fb = 1) => fft, (fb = -1) => rfft;
+static void vtkImageFourierFilterTransformRows(kiss_fft_cfg plan, const vtkImageComplex* in,
+  vtkImageComplex* out, int N, int numberOfRows, int fb, bool realPairs)
+{
+  for (int row = 0; row < numberOfRows; ++row)
+  {
+    vtkImageComplex* a = out + static_cast<vtkIdType>(realPairs ? 2 * row : row) * N;
+    vtkImageFourierFilterKiss<kiss_fft_scalar>::Fft(
+      plan, in + static_cast<vtkIdType>(row) * N, a, N);
+    if (realPairs)
+    {
+      // The transform Z = A + iB of two real arrays gives their transforms
+      // A[k] = (Z[k] + conj(Z[N-k])) / 2 and B[k] = (Z[k] - conj(Z[N-k])) / 2i.
+      vtkImageComplex* b = a + N;
+      for (int k = 0; 2 * k <= N; ++k)
+      {
+        const int j = (N - k) % N;
+        const vtkImageComplex zk = a[k];
+        const vtkImageComplex zj = a[j];
+        vtkImageComplexEuclidSet(a[k], 0.5 * (zk.Real + zj.Real), 0.5 * (zk.Imag - zj.Imag));
+        vtkImageComplexEuclidSet(b[k], 0.5 * (zk.Imag + zj.Imag), 0.5 * (zj.Real - zk.Real));
+        vtkImageComplexEuclidSet(a[j], 0.5 * (zj.Real + zk.Real), 0.5 * (zj.Imag - zk.Imag));
+        vtkImageComplexEuclidSet(b[j], 0.5 * (zj.Imag + zk.Imag), 0.5 * (zk.Real - zj.Real));
+      }
+    }
+  }
+
+  // If this is a reverse transform (scale accordingly).
+  if (fb == -1)
+  {
+    vtkImageComplex* p = out;
+    for (vtkIdType idx = 0; idx < static_cast<vtkIdType>(realPairs ? 2 : 1) * numberOfRows * N;
+         ++idx)
+    {
+      p->Real = p->Real / N;
+      p->Imag = p->Imag / N;
+      ++p;
+    }
+  }
+}
+
+// The number of rows transformed in one batch.
+static const int vtkImageFourierFilterBatchSize = 16;
+
+//------------------------------------------------------------------------------
+// This templated execute method handles any type input, but the output
+// is always doubles.
+template <class T>
+void vtkImageFourierFilterExecuteAxis(vtkImageFourierFilter* self, kiss_fft_cfg plan,
+  vtkImageData* inData, int inExt[6], T* inPtr, vtkImageData* outData, int outExt[6],
+  double* outPtr, int fb, int id)
+{
+  int inMin0, inMax0, inMin1, inMax1, inMin2, inMax2;
+  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
+  vtkIdType inInc0, inInc1, inInc2;
+  vtkIdType outInc0, outInc1, outInc2;
+
+  // Reorder axes
+  self->PermuteExtent(inExt, inMin0, inMax0, inMin1, inMax1, inMin2, inMax2);
+  self->PermuteExtent(outExt, outMin0, outMax0, outMin1, outMax1, outMin2, outMax2);
+  self->PermuteIncrements(inData->GetIncrements(), inInc0, inInc1, inInc2);
+  self->PermuteIncrements(outData->GetIncrements(), outInc0, outInc1, outInc2);
+
+  const int inSize0 = inMax0 - inMin0 + 1;
+
+  // Input has to have real components at least.
+  const int numberOfComponents = inData->GetNumberOfScalarComponents();
+  if (numberOfComponents < 1)
+  {
+    vtkGenericWarningMacro("No real components");
+    return;
+  }
+  // Real rows are transformed two at a time, one in the real parts and one
+  // in the imaginary parts of a complex row.
+  const bool real = (numberOfComponents == 1);
+
+  // Allocate the arrays of complex numbers of a batch
+  std::vector<vtkImageComplex> inComplex(
+    static_cast<size_t>(inSize0) * vtkImageFourierFilterBatchSize);
+  std::vector<vtkImageComplex> outComplex(inComplex.size());
+
+  const double startProgress =
+    self->GetIteration() / static_cast<double>(self->GetNumberOfIterations());
+  unsigned long count = 0;
+  unsigned long target = static_cast<unsigned long>(
+    (outMax2 - outMin2 + 1) * (outMax1 - outMin1 + 1) * self->GetNumberOfIterations() / 50.0);
+  target++;
+
+  // loop over other axes
+  for (int idx2 = outMin2; idx2 <= outMax2; ++idx2)
+  {
+    T* inPtr1 = inPtr + (idx2 - outMin2) * inInc2;
+    double* outPtr1 = outPtr + (idx2 - outMin2) * outInc2;
+    int numberOfRows;
+    for (int idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; idx1 += numberOfRows)
+    {
+      numberOfRows = std::min(vtkImageFourierFilterBatchSize, outMax1 - idx1 + 1);
+      if (!id)
+      {
+        if (count / target != (count + numberOfRows) / target)
+        {
+          self->UpdateProgress(count / (50.0 * target) + startProgress);
+        }
+        count += numberOfRows;
+      }
+
+      // copy into complex numbers, with the rows of the batch side by side
+      // so that the axes other than X are read in order.
+      for (int idx0 = 0; idx0 < inSize0; ++idx0)
+      {
+        T* inPtr0 = inPtr1 + idx0 * inInc0;
+        for (int row = 0; row < numberOfRows; ++row)
+        {
+          if (real)
+          {
+            vtkImageComplex& c = inComplex[(row / 2) * inSize0 + idx0];
+            if (row % 2)
+            {
+              c.Imag = static_cast<double>(*inPtr0);
+            }
+            else
+            {
+              vtkImageComplexEuclidSet(c, static_cast<double>(*inPtr0), 0.0);
+            }
+          }
+          else
+          { // yes we have an imaginary input
+            vtkImageComplexEuclidSet(inComplex[row * inSize0 + idx0],
+              static_cast<double>(*inPtr0), static_cast<double>(inPtr0[1]));
+          }
+          inPtr0 += inInc1;
+        }
+      }
+
+      vtkImageFourierFilterTransformRows(plan, inComplex.data(), outComplex.data(), inSize0,
+        real ? (numberOfRows + 1) / 2 : numberOfRows, fb, real);
+
+      // copy into output
+      for (int idx0 = outMin0; idx0 <= outMax0; ++idx0)
+      {
+        double* outPtr0 = outPtr1 + (idx0 - outMin0) * outInc0;
+        const vtkImageComplex* pComplex = outComplex.data() + (idx0 - inMin0);
+        for (int row = 0; row < numberOfRows; ++row)
+        {
+          *outPtr0 = pComplex->Real;
+          outPtr0[1] = pComplex->Imag;
+          outPtr0 += outInc1;
+          pComplex += inSize0;
+        }
+      }
+      inPtr1 += numberOfRows * inInc1;
+      outPtr1 += numberOfRows * outInc1;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkImageFourierFilter::vtkImageFourierFilter()
+  : Plans(new vtkImageFourierFilterPlans)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkImageFourierFilter::~vtkImageFourierFilter()
+{
+  delete this->Plans;
+}
 
 /*=========================================================================
         Vectors of complex numbers.
@@ -203,20 +449,45 @@ void vtkImageFourierFilter::ExecuteFftForwardBackward(
 
 //------------------------------------------------------------------------------
 // This function calculates the whole fft of an array.
-// The contents of the input array are changed.
-// (It is engineered for no decimation)
 void vtkImageFourierFilter::ExecuteFft(vtkImageComplex* in, vtkImageComplex* out, int N)
 {
-  this->ExecuteFftForwardBackward(in, out, N, 1);
+  this->ExecuteFftRows(in, out, N, 1, 1, false);
 }
 
 //------------------------------------------------------------------------------
-// This function calculates the whole fft of an array.
-// The contents of the input array are changed.
-// (It is engineered for no decimation)
+// This function calculates the whole rfft of an array.
 void vtkImageFourierFilter::ExecuteRfft(vtkImageComplex* in, vtkImageComplex* out, int N)
 {
-  this->ExecuteFftForwardBackward(in, out, N, -1);
+  this->ExecuteFftRows(in, out, N, 1, -1, false);
+}
+
+//------------------------------------------------------------------------------
+void vtkImageFourierFilter::ExecuteFftRows(
+  vtkImageComplex* in, vtkImageComplex* out, int N, int numberOfRows, int fb, bool realPairs)
+{
+  vtkImageFourierFilterTransformRows(
+    this->Plans->Get(N, fb), in, out, N, numberOfRows, fb, realPairs);
+}
+
+//------------------------------------------------------------------------------
+void vtkImageFourierFilter::ExecuteFftAxis(vtkImageData* inData, int inExt[6],
+  vtkImageData* outData, int outExt[6], int fb, int threadId)
+{
+  void* inPtr = inData->GetScalarPointerForExtent(inExt);
+  double* outPtr = static_cast<double*>(outData->GetScalarPointerForExtent(outExt));
+  int inMin0, inMax0, inMin1, inMax1, inMin2, inMax2;
+  this->PermuteExtent(inExt, inMin0, inMax0, inMin1, inMax1, inMin2, inMax2);
+  kiss_fft_cfg plan = this->Plans->Get(inMax0 - inMin0 + 1, fb);
+
+  // choose which templated function to call.
+  switch (inData->GetScalarType())
+  {
+    vtkTemplateMacro(vtkImageFourierFilterExecuteAxis(this, plan, inData, inExt,
+      static_cast<VTK_TT*>(inPtr), outData, outExt, outPtr, fb, threadId));
+    default:
+      vtkErrorMacro(<< "Execute: Unknown ScalarType");
+      return;
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -83,6 +83,9 @@ using vtkImageComplex = struct vtkImageComplex_t;
 
 /******************* End of COMPLEX number stuff ********************/
 
+class vtkImageData;
+class vtkImageFourierFilterPlans;
+
 class VTKIMAGINGFOURIER_EXPORT vtkImageFourierFilter : public vtkImageDecomposeFilter
 {
 public:
@@ -92,21 +95,39 @@ public:
 
   /**
    * This function calculates the whole fft of an array.
-   * The contents of the input array are changed.
-   * (It is engineered for no decimation)
+   * In and out cannot be the same array.
    */
   void ExecuteFft(vtkImageComplex* in, vtkImageComplex* out, int N);
 
   /**
-   * This function calculates the whole fft of an array.
-   * The contents of the input array are changed.
-   * (It is engineered for no decimation)
+   * This function calculates the whole rfft of an array.
+   * In and out cannot be the same array.
    */
   void ExecuteRfft(vtkImageComplex* in, vtkImageComplex* out, int N);
 
+  /**
+   * This function calculates the fft (fb = 1) or the rfft (fb = -1) of
+   * numberOfRows arrays of N complex numbers, stored one after the other.
+   * When realPairs is true, each input array holds two real arrays, one in
+   * its real parts and one in its imaginary parts, and out receives the
+   * 2 * numberOfRows transforms of these real arrays.
+   * The kissfft plan of each size is built once, and shared by the threads
+   * and the axes.
+   */
+  void ExecuteFftRows(
+    vtkImageComplex* in, vtkImageComplex* out, int N, int numberOfRows, int fb, bool realPairs);
+
 protected:
-  vtkImageFourierFilter() = default;
-  ~vtkImageFourierFilter() override = default;
+  vtkImageFourierFilter();
+  ~vtkImageFourierFilter() override;
+
+  /**
+   * Transform the rows of inExt along the axis of the current iteration,
+   * forward (fb = 1) or backward (fb = -1), into outExt. The rows are gathered
+   * in batches, and the real rows are transformed two at a time.
+   */
+  void ExecuteFftAxis(vtkImageData* inData, int inExt[6], vtkImageData* outData, int outExt[6],
+    int fb, int threadId);
 
   void ExecuteFftStep2(vtkImageComplex* p_in, vtkImageComplex* p_out, int N, int bsize, int fb);
   void ExecuteFftStepN(
@@ -120,6 +141,8 @@ protected:
     vtkInformationVector* outputVector) override;
 
 private:
+  vtkImageFourierFilterPlans* Plans;
+
   vtkImageFourierFilter(const vtkImageFourierFilter&) = delete;
   void operator=(const vtkImageFourierFilter&) = delete;
 };
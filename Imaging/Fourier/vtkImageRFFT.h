@@ -20,10 +20,11 @@
  * can have real or complex data in any components and data types, but
  * the output is always complex doubles with real values in component0, and
  * imaginary values in component1.  The filter is fastest for images that
- * have power of two sizes.  The filter uses butterfly filters for each
- * prime factor of the dimension.  This makes images with prime number dimensions
- * (i.e. 17x17) much slower to compute.  Multi dimensional (i.e volumes)
- * FFT's are decomposed so that each axis executes in series.
+ * have sizes made of the factors 2, 3 and 5.  The filter uses kissfft, with
+ * butterfly filters for each prime factor of the dimension.  This makes images
+ * with prime number dimensions (i.e. 17x17) much slower to compute.  Multi
+ * dimensional (i.e volumes) FFT's are decomposed so that each axis executes in
+ * series, the rows of an axis being transformed in parallel.
  * In most cases the RFFT will produce an image whose imaginary values are all
  * zero's. In this case vtkImageExtractComponents can be used to remove
  * this imaginary components leaving only the real image.
@@ -18,9 +18,12 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <cmath>
+#include <limits>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageEuclideanDistance);
 
@@ -31,7 +34,8 @@ vtkImageEuclideanDistance::vtkImageEuclideanDistance()
   this->MaximumDistance = VTK_INT_MAX;
   this->Initialize = 1;
   this->ConsiderAnisotropy = 1;
-  this->Algorithm = VTK_EDT_SAITO;
+  this->Algorithm = VTK_EDT_FELZENSZWALB;
+  this->OutputScalarType = VTK_DOUBLE;
 }
 
 //------------------------------------------------------------------------------
@@ -39,7 +43,7 @@ vtkImageEuclideanDistance::vtkImageEuclideanDistance()
 int vtkImageEuclideanDistance::IterativeRequestInformation(
   vtkInformation* vtkNotUsed(input), vtkInformation* output)
 {
-  vtkDataObject::SetPointDataActiveScalarInfo(output, VTK_DOUBLE, 1);
+  vtkDataObject::SetPointDataActiveScalarInfo(output, this->OutputScalarType, 1);
   return 1;
 }
 
@@ -57,17 +61,17 @@ int vtkImageEuclideanDistance::IterativeRequestUpdateExtent(
 
 //------------------------------------------------------------------------------
 // This templated execute method handles any type input, but the output
-// is always doubles.
-template <class TT>
+// is always doubles or floats.
+template <class TT, class TOut>
 void vtkImageEuclideanDistanceCopyData(vtkImageEuclideanDistance* self, vtkImageData* inData,
-  TT* inPtr, vtkImageData* outData, int outExt[6], double* outPtr)
+  TT* inPtr, vtkImageData* outData, int outExt[6], TOut* outPtr)
 {
   vtkIdType inInc0, inInc1, inInc2;
   TT *inPtr0, *inPtr1, *inPtr2;
 
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  TOut *outPtr0, *outPtr1, *outPtr2;
 
   int idx0, idx1, idx2;
 
@@ -103,17 +107,17 @@ void vtkImageEuclideanDistanceCopyData(vtkImageEuclideanDistance* self, vtkImage
 
 //------------------------------------------------------------------------------
 // This templated execute method handles any type input, but the output
-// is always doubles.
-template <class T>
+// is always doubles or floats.
+template <class T, class TOut>
 void vtkImageEuclideanDistanceInitialize(vtkImageEuclideanDistance* self, vtkImageData* inData,
-  T* inPtr, vtkImageData* outData, int outExt[6], double* outPtr)
+  T* inPtr, vtkImageData* outData, int outExt[6], TOut* outPtr)
 {
   vtkIdType inInc0, inInc1, inInc2;
   T *inPtr0, *inPtr1, *inPtr2;
 
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  TOut *outPtr0, *outPtr1, *outPtr2;
 
   int idx0, idx1, idx2;
   double maxDist;
@@ -166,8 +170,7 @@ void vtkImageEuclideanDistanceInitialize(vtkImageEuclideanDistance* self, vtkIma
   else
   // No initialization required. We just copy inData to outData.
   {
-    vtkImageEuclideanDistanceCopyData(
-      self, inData, static_cast<T*>(inPtr), outData, outExt, static_cast<double*>(outPtr));
+    vtkImageEuclideanDistanceCopyData(self, inData, inPtr, outData, outExt, outPtr);
   }
 }
 
@@ -180,13 +183,14 @@ void vtkImageEuclideanDistanceInitialize(vtkImageEuclideanDistance* self, vtkIma
 //
 // Notations stay as close as possible to those used in the paper.
 //
-static void vtkImageEuclideanDistanceExecuteSaito(
-  vtkImageEuclideanDistance* self, vtkImageData* outData, int outExt[6], double* outPtr)
+template <class T>
+void vtkImageEuclideanDistanceExecuteSaito(
+  vtkImageEuclideanDistance* self, vtkImageData* outData, int outExt[6], T* outPtr)
 {
 
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  T *outPtr0, *outPtr1, *outPtr2;
   int idx0, idx1, idx2, inSize0;
   double maxDist;
   double* sq;
@@ -391,13 +395,15 @@ static void vtkImageEuclideanDistanceExecuteSaito(
 //------------------------------------------------------------------------------
 // Execute Saito's algorithm, modified for Cache Efficiency
 //
-static void vtkImageEuclideanDistanceExecuteSaitoCached(
-  vtkImageEuclideanDistance* self, vtkImageData* outData, int outExt[6], double* outPtr)
+template <class T>
+void vtkImageEuclideanDistanceExecuteSaitoCached(
+  vtkImageEuclideanDistance* self, vtkImageData* outData, int outExt[6], T* outPtr)
 {
 
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
   vtkIdType outInc0, outInc1, outInc2;
-  double *outPtr0, *outPtr1, *outPtr2;
+  T *outPtr0, *outPtr1, *outPtr2;
+  double* tempPtr;
   //
   int idx0, idx1, idx2, inSize0;
 
@@ -513,8 +519,8 @@ static void vtkImageEuclideanDistanceExecuteSaitoCached(
         // forward scan
         a = 0;
         buffer = buff[outMin0];
-        outPtr0 = temp;
-        outPtr0++;
+        tempPtr = temp;
+        tempPtr++;
 
         for (idx0 = outMin0 + 1; idx0 <= outMax0; ++idx0)
         {
@@ -538,9 +544,9 @@ static void vtkImageEuclideanDistanceExecuteSaitoCached(
               {
                 n = b;
               }
-              else if (m < *(outPtr0 + n))
+              else if (m < *(tempPtr + n))
               {
-                *(outPtr0 + n) = m;
+                *(tempPtr + n) = m;
               }
             }
             a = b;
@@ -551,11 +557,11 @@ static void vtkImageEuclideanDistanceExecuteSaitoCached(
           }
 
           buffer = buff[idx0];
-          outPtr0++;
+          tempPtr++;
         }
 
         // backward scan
-        outPtr0 -= 2;
+        tempPtr -= 2;
         a = 0;
         buffer = buff[outMax0];
 
@@ -578,9 +584,9 @@ static void vtkImageEuclideanDistanceExecuteSaitoCached(
               {
                 n = b;
               }
-              else if (m < *(outPtr0 - n))
+              else if (m < *(tempPtr - n))
               {
-                *(outPtr0 - n) = m;
+                *(tempPtr - n) = m;
               }
             }
             a = b;
@@ -590,7 +596,7 @@ static void vtkImageEuclideanDistanceExecuteSaitoCached(
             a = 0;
           }
           buffer = buff[idx0];
-          outPtr0--;
+          tempPtr--;
         }
 
         // Unbuffer current values
@@ -611,6 +617,220 @@ static void vtkImageEuclideanDistanceExecuteSaitoCached(
   free(temp);
   free(sq);
 }
+
+//------------------------------------------------------------------------------
+// Execute Felzenszwalb's algorithm on the lines of the current axis, in
+// parallel.
+//
+// P. F. Felzenszwalb and D. P. Huttenlocher. Distance Transforms of Sampled
+// Functions. Theory of Computing, 8(19). pp. 415--428, 2012.
+//
+// The first axis only looks for the zeros of each line, as Saito's algorithm
+// does, so that both give the same distances when Initialize is off.
+template <class T>
+class vtkImageEuclideanDistanceFelzenszwalbFunctor
+{
+public:
+  vtkImageEuclideanDistanceFelzenszwalbFunctor(
+    vtkImageEuclideanDistance* self, vtkImageData* outData, int outExt[6], T* outPtr)
+    : OutPtr(outPtr)
+  {
+    int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
+    self->PermuteExtent(outExt, outMin0, outMax0, outMin1, outMax1, outMin2, outMax2);
+    self->PermuteIncrements(outData->GetIncrements(), this->Inc0, this->Inc1, this->Inc2);
+    this->Size0 = outMax0 - outMin0 + 1;
+    this->Size1 = outMax1 - outMin1 + 1;
+    this->NumberOfLines = static_cast<vtkIdType>(this->Size1) * (outMax2 - outMin2 + 1);
+    this->FirstAxis = (self->GetIteration() == 0);
+    this->MaximumDistance = self->GetMaximumDistance();
+
+    // Anisotropy is handled here by using Spacing information
+    double spacing = 1.0;
+    if (self->GetConsiderAnisotropy())
+    {
+      spacing = outData->GetSpacing()[self->GetIteration()];
+    }
+    this->Spacing2 = spacing * spacing;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const int n = this->Size0;
+    std::vector<double> f(n);
+    std::vector<double> d(n);
+    std::vector<int> v(n);
+    std::vector<double> z(n + 1);
+    for (vtkIdType line = begin; line < end; ++line)
+    {
+      T* outPtr0 =
+        this->OutPtr + (line / this->Size1) * this->Inc2 + (line % this->Size1) * this->Inc1;
+      for (int q = 0; q < n; ++q)
+      {
+        f[q] = outPtr0[q * this->Inc0];
+      }
+
+      const double* result = d.data();
+      if (this->FirstAxis)
+      {
+        this->ScanZeros(f.data());
+        result = f.data();
+      }
+      else
+      {
+        this->LowerEnvelope(f.data(), d.data(), v.data(), z.data());
+      }
+
+      for (int q = 0; q < n; ++q)
+      {
+        outPtr0[q * this->Inc0] = static_cast<T>(result[q]);
+      }
+    }
+  }
+
+  vtkIdType GetNumberOfLines() const { return this->NumberOfLines; }
+
+private:
+  // The distance to the closest zero of the line, or MaximumDistance.
+  void ScanZeros(double* f) const
+  {
+    const int n = this->Size0;
+    int df = -1;
+    for (int q = 0; q < n; ++q)
+    {
+      this->ScanZeros(f[q], df);
+    }
+    df = -1;
+    for (int q = n - 1; q >= 0; --q)
+    {
+      this->ScanZeros(f[q], df);
+    }
+  }
+
+  void ScanZeros(double& value, int& df) const
+  {
+    if (value != 0)
+    {
+      double sq = this->MaximumDistance;
+      if (df >= 0)
+      {
+        ++df;
+        sq = df * static_cast<double>(df) * this->Spacing2;
+      }
+      if (sq < value)
+      {
+        value = sq;
+      }
+    }
+    else
+    {
+      df = 0;
+    }
+  }
+
+  // The minimum d[p] of f[q] + (p - q)^2 for each p, as the lower envelope of
+  // the parabolas rooted at each q.
+  void LowerEnvelope(const double* f, double* d, int* v, double* z) const
+  {
+    const int n = this->Size0;
+    int k = 0;
+    v[0] = 0;
+    z[0] = -std::numeric_limits<double>::infinity();
+    z[1] = std::numeric_limits<double>::infinity();
+    for (int q = 1; q < n; ++q)
+    {
+      double s = this->Intersection(f, q, v[k]);
+      while (s <= z[k])
+      {
+        --k;
+        s = this->Intersection(f, q, v[k]);
+      }
+      ++k;
+      v[k] = q;
+      z[k] = s;
+      z[k + 1] = std::numeric_limits<double>::infinity();
+    }
+
+    k = 0;
+    for (int q = 0; q < n; ++q)
+    {
+      while (z[k + 1] < q)
+      {
+        ++k;
+      }
+      d[q] = f[v[k]] + (q - v[k]) * static_cast<double>(q - v[k]) * this->Spacing2;
+    }
+  }
+
+  // The intersection of the parabolas rooted at q and r, in voxels.
+  double Intersection(const double* f, int q, int r) const
+  {
+    const double q2 = q * static_cast<double>(q);
+    const double r2 = r * static_cast<double>(r);
+    return ((f[q] - f[r]) / this->Spacing2 + q2 - r2) / (2.0 * (q - r));
+  }
+
+  T* OutPtr;
+  vtkIdType Inc0, Inc1, Inc2;
+  int Size0, Size1;
+  vtkIdType NumberOfLines;
+  bool FirstAxis;
+  double MaximumDistance;
+  double Spacing2;
+};
+
+template <class T>
+void vtkImageEuclideanDistanceExecuteFelzenszwalb(
+  vtkImageEuclideanDistance* self, vtkImageData* outData, int outExt[6], T* outPtr)
+{
+  vtkImageEuclideanDistanceFelzenszwalbFunctor<T> functor(self, outData, outExt, outPtr);
+  vtkSMPTools::For(0, functor.GetNumberOfLines(), functor);
+}
+
+//------------------------------------------------------------------------------
+// Initialize the output with the input on the first axis, and run the
+// algorithm on the current axis.
+template <class TOut>
+void vtkImageEuclideanDistanceExecute(vtkImageEuclideanDistance* self, vtkImageData* inData,
+  void* inPtr, vtkImageData* outData, int outExt[6], TOut* outPtr)
+{
+  if (self->GetIteration() == 0)
+  {
+    switch (inData->GetScalarType())
+    {
+      vtkTemplateMacro(vtkImageEuclideanDistanceInitialize(
+        self, inData, static_cast<VTK_TT*>(inPtr), outData, outExt, outPtr));
+      default:
+        vtkErrorWithObjectMacro(self, << "Execute: Unknown ScalarType");
+        return;
+    }
+  }
+  else
+  {
+    if (inData != outData)
+      switch (inData->GetScalarType())
+      {
+        vtkTemplateMacro(vtkImageEuclideanDistanceCopyData(
+          self, inData, static_cast<VTK_TT*>(inPtr), outData, outExt, outPtr));
+      }
+  }
+
+  // Call the specific algorithms.
+  switch (self->GetAlgorithm())
+  {
+    case VTK_EDT_SAITO:
+      vtkImageEuclideanDistanceExecuteSaito(self, outData, outExt, outPtr);
+      break;
+    case VTK_EDT_SAITO_CACHED:
+      vtkImageEuclideanDistanceExecuteSaitoCached(self, outData, outExt, outPtr);
+      break;
+    case VTK_EDT_FELZENSZWALB:
+      vtkImageEuclideanDistanceExecuteFelzenszwalb(self, outData, outExt, outPtr);
+      break;
+    default:
+      vtkErrorWithObjectMacro(self, << "Execute: Unknown Algorithm");
+  }
+}
+
 //------------------------------------------------------------------------------
 void vtkImageEuclideanDistance::AllocateOutputScalars(
   vtkImageData* outData, int outExt[6], vtkInformation* outInfo)
@@ -632,6 +852,9 @@ int vtkImageEuclideanDistance::IterativeRequestData(vtkInformation* vtkNotUsed(r
 
   int outExt[6];
   outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), outExt);
+  // The outputs of the first iterations are not given the spacing of the
+  // pipeline by the executive, while ConsiderAnisotropy needs it.
+  outData->CopyInformationFromPipeline(outInfo);
   this->AllocateOutputScalars(outData, outExt, outInfo);
 
   void* inPtr;
@@ -660,13 +883,6 @@ int vtkImageEuclideanDistance::IterativeRequestData(vtkInformation* vtkNotUsed(r
     }
   }
 
-  // this filter expects that the output be doubles.
-  if (outData->GetScalarType() != VTK_DOUBLE)
-  {
-    vtkErrorMacro(<< "Execute: Output must be type double.");
-    return 1;
-  }
-
   // this filter expects input to have 1 components
   if (outData->GetNumberOfScalarComponents() != 1)
   {
@@ -674,39 +890,20 @@ int vtkImageEuclideanDistance::IterativeRequestData(vtkInformation* vtkNotUsed(r
     return 1;
   }
 
-  if (this->GetIteration() == 0)
-  {
-    switch (inData->GetScalarType())
-    {
-      vtkTemplateMacro(vtkImageEuclideanDistanceInitialize(
-        this, inData, static_cast<VTK_TT*>(inPtr), outData, outExt, static_cast<double*>(outPtr)));
-      default:
-        vtkErrorMacro(<< "Execute: Unknown ScalarType");
-        return 1;
-    }
-  }
-  else
-  {
-    if (inData != outData)
-      switch (inData->GetScalarType())
-      {
-        vtkTemplateMacro(vtkImageEuclideanDistanceCopyData(this, inData,
-          static_cast<VTK_TT*>(inPtr), outData, outExt, static_cast<double*>(outPtr)));
-      }
-  }
-
-  // Call the specific algorithms.
-  switch (this->GetAlgorithm())
+  // this filter expects that the output be doubles or floats.
+  switch (outData->GetScalarType())
   {
-    case VTK_EDT_SAITO:
-      vtkImageEuclideanDistanceExecuteSaito(this, outData, outExt, static_cast<double*>(outPtr));
+    case VTK_DOUBLE:
+      vtkImageEuclideanDistanceExecute(
+        this, inData, inPtr, outData, outExt, static_cast<double*>(outPtr));
       break;
-    case VTK_EDT_SAITO_CACHED:
-      vtkImageEuclideanDistanceExecuteSaitoCached(
-        this, outData, outExt, static_cast<double*>(outPtr));
+    case VTK_FLOAT:
+      vtkImageEuclideanDistanceExecute(
+        this, inData, inPtr, outData, outExt, static_cast<float*>(outPtr));
       break;
     default:
-      vtkErrorMacro(<< "Execute: Unknown Algorithm");
+      vtkErrorMacro(<< "Execute: Output must be type double or float.");
+      return 1;
   }
 
   this->UpdateProgress((this->GetIteration() + 1.0) / 3.0);
@@ -731,8 +928,14 @@ void vtkImageEuclideanDistance::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << "Saito\n";
   }
+  else if (this->Algorithm == VTK_EDT_FELZENSZWALB)
+  {
+    os << "Felzenszwalb\n";
+  }
   else
   {
     os << "Saito Cached\n";
   }
+  os << indent << "Output Scalar Type: " << vtkImageScalarTypeNameMacro(this->OutputScalarType)
+     << "\n";
 }
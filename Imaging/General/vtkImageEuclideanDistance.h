@@ -17,13 +17,16 @@
  * @brief   computes 3D Euclidean DT
  *
  * vtkImageEuclideanDistance implements the Euclidean DT using
- * Saito's algorithm. The distance map produced contains the square of the
- * Euclidean distance values.
+ * Felzenszwalb's or Saito's algorithm. The distance map produced contains the
+ * square of the Euclidean distance values.
  *
- * The algorithm has a o(n^(D+1)) complexity over nxnx...xn images in D
- * dimensions. It is very efficient on relatively small images. Cuisenaire's
- * algorithms should be used instead if n >> 500. These are not implemented
- * yet.
+ * Felzenszwalb's algorithm, the default, computes the lower envelope of the
+ * parabolas of each line, with a o(n^D) complexity over nxnx...xn images in D
+ * dimensions. The lines of an axis are processed in parallel with
+ * vtkSMPTools.
+ *
+ * Saito's algorithm has a o(n^(D+1)) complexity. It is very efficient on
+ * relatively small images.
  *
  * For the special case of images where the slice-size is a multiple of
  * 2^N with a large N (typically for 256x256 slices), Saito's algorithm
@@ -33,6 +36,9 @@
  *
  * References:
  *
+ * P. F. Felzenszwalb and D. P. Huttenlocher. Distance Transforms of Sampled
+ * Functions. Theory of Computing, 8(19). pp. 415--428, 2012.
+ *
  * T. Saito and J.I. Toriwaki. New algorithms for Euclidean distance
  * transformations of an n-dimensional digitised picture with applications.
  * Pattern Recognition, 27(11). pp. 1551--1565, 1994.
@@ -50,6 +56,7 @@
 
 #define VTK_EDT_SAITO_CACHED 0
 #define VTK_EDT_SAITO 1
+#define VTK_EDT_FELZENSZWALB 2
 
 class VTKIMAGINGGENERAL_EXPORT vtkImageEuclideanDistance : public vtkImageDecomposeFilter
 {
@@ -94,12 +101,25 @@ public:
    * Selects a Euclidean DT algorithm.
    * 1. Saito
    * 2. Saito-cached
-   * More algorithms will be added later on.
+   * 3. Felzenszwalb (default)
    */
   vtkSetMacro(Algorithm, int);
   vtkGetMacro(Algorithm, int);
   void SetAlgorithmToSaito() { this->SetAlgorithm(VTK_EDT_SAITO); }
   void SetAlgorithmToSaitoCached() { this->SetAlgorithm(VTK_EDT_SAITO_CACHED); }
+  void SetAlgorithmToFelzenszwalb() { this->SetAlgorithm(VTK_EDT_FELZENSZWALB); }
+  //@}
+
+  //@{
+  /**
+   * Set the scalar type of the output, VTK_DOUBLE (the default) or VTK_FLOAT.
+   * A float output halves the memory of the distance map, and keeps exact
+   * squared distances up to 2^24 in spacing units.
+   */
+  vtkSetMacro(OutputScalarType, int);
+  vtkGetMacro(OutputScalarType, int);
+  void SetOutputScalarTypeToFloat() { this->SetOutputScalarType(VTK_FLOAT); }
+  void SetOutputScalarTypeToDouble() { this->SetOutputScalarType(VTK_DOUBLE); }
   //@}
 
   int IterativeRequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
@@ -112,6 +132,7 @@ protected:
   vtkTypeBool Initialize;
   vtkTypeBool ConsiderAnisotropy;
   int Algorithm;
+  int OutputScalarType;
 
   // Replaces "EnlargeOutputUpdateExtent"
   virtual void AllocateOutputScalars(vtkImageData* outData, int outExt[6], vtkInformation* outInfo);
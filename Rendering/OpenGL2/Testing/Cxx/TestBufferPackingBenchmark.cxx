@@ -0,0 +1,99 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBufferPackingBenchmark.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// This test is intended to benchmark the packing of the index and vertex
+// buffers of a large triangle mesh, with one thread and with the default
+// number of threads. The buffers are packed on the CPU only, so that no
+// OpenGL context is needed. Pass the mesh resolution as the first argument
+// to benchmark larger meshes.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkNew.h"
+#include "vtkOpenGLIndexBufferObject.h"
+#include "vtkOpenGLVertexBufferObject.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
+#include "vtkTriangleFilter.h"
+
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+double PackBuffers(vtkPolyData* polyData)
+{
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+
+  std::vector<unsigned int> triangles;
+  vtkOpenGLIndexBufferObject::AppendTriangleIndexBuffer(
+    triangles, polyData->GetPolys(), polyData->GetPoints(), 0, nullptr, nullptr);
+  std::vector<unsigned int> lines;
+  vtkOpenGLIndexBufferObject::AppendTriangleLineIndexBuffer(lines, polyData->GetPolys(), 0);
+
+  vtkNew<vtkOpenGLVertexBufferObject> points;
+  points->SetDataType(VTK_FLOAT);
+  points->SetShift(0.5, 0.5, 0.0);
+  points->SetScale(2.0, 2.0, 1.0);
+  points->AppendDataArray(polyData->GetPoints()->GetData());
+  vtkNew<vtkOpenGLVertexBufferObject> normals;
+  normals->SetDataType(VTK_FLOAT);
+  normals->AppendDataArray(polyData->GetPointData()->GetNormals());
+
+  timer->StopTimer();
+  return timer->GetElapsedTime();
+}
+}
+
+//------------------------------------------------------------------------------
+int TestBufferPackingBenchmark(int argc, char* argv[])
+{
+  cout << "CTEST_FULL_OUTPUT (Avoid ctest truncation of output)" << endl;
+
+  int resolution = 500;
+  if (argc > 1 && std::atoi(argv[1]) > 0)
+  {
+    resolution = std::atoi(argv[1]);
+  }
+
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(resolution, resolution);
+  vtkNew<vtkTriangleFilter> triangles;
+  triangles->SetInputConnection(plane->GetOutputPort());
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputConnection(triangles->GetOutputPort());
+  normals->SplittingOff();
+  normals->Update();
+  vtkPolyData* polyData = normals->GetOutput();
+  cout << "Triangles: " << polyData->GetNumberOfPolys() << endl;
+
+  double serial = 0.0;
+  vtkSMPTools::LocalScope(
+    vtkSMPTools::Config{ 1, "STDThread", false }, [&]() { serial = PackBuffers(polyData); });
+  cout << "Packing time with 1 thread: " << serial << endl;
+  double threaded = 0.0;
+  int numThreads = 0;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 0, "STDThread", false }, [&]() {
+    threaded = PackBuffers(polyData);
+    numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  });
+  cout << "Packing time with " << numThreads << " threads: " << threaded << endl;
+
+  return EXIT_SUCCESS;
+}
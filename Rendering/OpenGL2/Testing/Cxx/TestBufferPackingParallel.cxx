@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBufferPackingParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks the index and vertex buffers packed concurrently against the
+// serially built ones. No OpenGL context is needed to pack the buffers.
+
+#include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkOpenGLIndexBufferObject.h"
+#include "vtkOpenGLVertexBufferObject.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSOADataArrayTemplate.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+// The triangles of the polygons, without the degenerate ones, as the index
+// buffer builds them serially.
+void ReferenceTriangles(vtkCellArray* cells, vtkPoints* points, vtkUnsignedCharArray* edgeFlags,
+  std::vector<unsigned int>& indices, std::vector<unsigned char>& edges)
+{
+  auto same = [points](vtkIdType id1, vtkIdType id2) {
+    double p1[3], p2[3];
+    points->GetPoint(id1, p1);
+    points->GetPoint(id2, p2);
+    return p1[0] == p2[0] && p1[1] == p2[1] && p1[2] == p2[2];
+  };
+  auto iter = vtk::TakeSmartPointer(cells->NewIterator());
+  for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
+  {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    iter->GetCurrentCell(npts, pts);
+    for (vtkIdType i = 1; i < npts - 1; i++)
+    {
+      if (same(pts[0], pts[i]) || same(pts[0], pts[i + 1]) || same(pts[i], pts[i + 1]))
+      {
+        continue;
+      }
+      indices.push_back(static_cast<unsigned int>(pts[0]));
+      indices.push_back(static_cast<unsigned int>(pts[i]));
+      indices.push_back(static_cast<unsigned int>(pts[i + 1]));
+      const int val = npts == 3 ? 7 : i == 1 ? 3 : i == npts - 2 ? 6 : 2;
+      const int mask = edgeFlags->GetValue(pts[0]) + edgeFlags->GetValue(pts[i]) * 2 +
+        edgeFlags->GetValue(pts[i + 1]) * 4;
+      edges.push_back(static_cast<unsigned char>(val & mask));
+    }
+  }
+}
+
+bool TestIndexBuffers(vtkPolyData* polyData, const char* name)
+{
+  vtkUnsignedCharArray* edgeFlags =
+    vtkUnsignedCharArray::SafeDownCast(polyData->GetPointData()->GetArray("EdgeFlags"));
+  std::vector<unsigned int> expected(1, 42);
+  std::vector<unsigned char> expectedEdges(1, 1);
+  ReferenceTriangles(polyData->GetPolys(), polyData->GetPoints(), edgeFlags, expected,
+    expectedEdges);
+  std::vector<unsigned int> expectedLines(1, 42);
+  auto iter = vtk::TakeSmartPointer(polyData->GetPolys()->NewIterator());
+  for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
+  {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    iter->GetCurrentCell(npts, pts);
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      expectedLines.push_back(static_cast<unsigned int>(pts[i]));
+      expectedLines.push_back(static_cast<unsigned int>(pts[i < npts - 1 ? i + 1 : 0]));
+    }
+  }
+
+  for (int numThreads : { 1, 4 })
+  {
+    // the buffers already hold a value, to check that the cells are appended
+    std::vector<unsigned int> indices(1, 42);
+    std::vector<unsigned char> edges(1, 1);
+    std::vector<unsigned int> lines(1, 42);
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ numThreads, "STDThread", false }, [&]() {
+      vtkOpenGLIndexBufferObject::AppendTriangleIndexBuffer(
+        indices, polyData->GetPolys(), polyData->GetPoints(), 0, &edges, edgeFlags);
+      vtkOpenGLIndexBufferObject::AppendTriangleLineIndexBuffer(lines, polyData->GetPolys(), 0);
+    });
+    if (indices != expected || edges != expectedEdges)
+    {
+      std::cerr << name << ": the triangles built with " << numThreads << " threads differ"
+                << std::endl;
+      return false;
+    }
+    if (lines != expectedLines)
+    {
+      std::cerr << name << ": the lines built with " << numThreads << " threads differ"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename DestType>
+bool TestVertexBuffer(vtkDataArray* array, int dataType, bool shiftScale, const char* name)
+{
+  const int numComps = array->GetNumberOfComponents();
+  const int padding = ((4 - (numComps * static_cast<int>(sizeof(DestType))) % 4) % 4) /
+    static_cast<int>(sizeof(DestType));
+  const std::vector<double> shift(numComps, 0.5);
+  const std::vector<double> scale(numComps, 2.0);
+  std::vector<float> packed[2];
+  for (int numThreads : { 1, 4 })
+  {
+    vtkNew<vtkOpenGLVertexBufferObject> vbo;
+    vbo->SetDataType(dataType);
+    if (shiftScale)
+    {
+      vbo->SetShift(shift);
+      vbo->SetScale(scale);
+    }
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ numThreads, "STDThread", false }, [&]() {
+      vbo->AppendDataArray(array);
+      vbo->AppendDataArray(array);
+    });
+    packed[numThreads == 1 ? 0 : 1] = vbo->GetPackedVBO();
+  }
+  if (packed[0] != packed[1])
+  {
+    std::cerr << name << ": the vertex buffers packed with 1 and 4 threads differ" << std::endl;
+    return false;
+  }
+
+  const DestType* values = reinterpret_cast<const DestType*>(packed[0].data());
+  for (int copy = 0; copy < 2; copy++)
+  {
+    for (vtkIdType i = 0; i < array->GetNumberOfTuples(); i++)
+    {
+      for (int j = 0; j < numComps; j++)
+      {
+        double value = array->GetComponent(i, j);
+        if (shiftScale)
+        {
+          value = (value - shift[j]) * scale[j];
+        }
+        if (*values++ != static_cast<DestType>(value))
+        {
+          std::cerr << name << ": tuple " << i << " is not packed as expected" << std::endl;
+          return false;
+        }
+      }
+      values += padding;
+    }
+  }
+  return true;
+}
+}
+
+int TestBufferPackingParallel(int, char*[])
+{
+  // a grid of quads, large enough to be split in several chunks, with
+  // polygons of 6 points and degenerate triangles
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(300, 300);
+  plane->Update();
+  vtkPolyData* polyData = plane->GetOutput();
+  vtkPoints* points = polyData->GetPoints();
+  for (vtkIdType ptId = 0; ptId + 1 < points->GetNumberOfPoints(); ptId += 13)
+  {
+    points->SetPoint(ptId, points->GetPoint(ptId + 1));
+  }
+  vtkNew<vtkCellArray> polys;
+  auto iter = vtk::TakeSmartPointer(polyData->GetPolys()->NewIterator());
+  for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
+  {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    iter->GetCurrentCell(npts, pts);
+    if (iter->GetCurrentCellId() % 7 == 0)
+    {
+      const vtkIdType hexagon[6] = { pts[0], pts[1], pts[1], pts[2], pts[3], pts[3] };
+      polys->InsertNextCell(6, hexagon);
+    }
+    else
+    {
+      polys->InsertNextCell(npts, pts);
+    }
+  }
+  polyData->SetPolys(polys);
+  vtkNew<vtkUnsignedCharArray> edgeFlags;
+  edgeFlags->SetName("EdgeFlags");
+  edgeFlags->SetNumberOfTuples(points->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ptId++)
+  {
+    edgeFlags->SetValue(ptId, ptId % 3 ? 1 : 0);
+  }
+  polyData->GetPointData()->AddArray(edgeFlags);
+
+  if (!TestIndexBuffers(polyData, "Float points"))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkDoubleArray> doublePoints;
+  doublePoints->DeepCopy(points->GetData());
+  points->SetData(doublePoints);
+  polys->ConvertTo32BitStorage();
+  if (!TestIndexBuffers(polyData, "Double points and 32 bit cells"))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkSOADataArrayTemplate<float>> soaPoints;
+  soaPoints->DeepCopy(points->GetData());
+  points->SetData(soaPoints);
+  if (!TestIndexBuffers(polyData, "Points in a structure of arrays"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkDoubleArray> normals;
+  normals->SetNumberOfComponents(3);
+  normals->SetNumberOfTuples(points->GetNumberOfPoints());
+  vtkNew<vtkUnsignedCharArray> colors;
+  colors->SetNumberOfComponents(3);
+  colors->SetNumberOfTuples(points->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ptId++)
+  {
+    normals->SetTuple3(ptId, 0.001 * ptId, -0.5, 0.25 * (ptId % 5));
+    colors->SetTuple3(ptId, ptId % 256, (3 * ptId) % 256, 255);
+  }
+  if (!TestVertexBuffer<float>(normals, VTK_FLOAT, false, "Double normals") ||
+    !TestVertexBuffer<float>(normals, VTK_FLOAT, true, "Shifted and scaled normals") ||
+    !TestVertexBuffer<float>(soaPoints, VTK_FLOAT, true, "Points in a structure of arrays") ||
+    !TestVertexBuffer<unsigned char>(colors, VTK_UNSIGNED_CHAR, false, "Padded colors"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCompositePolyDataMapper2Batched.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Checks that the blocks drawn in batched mode, and the blocks updated in
+// place once modified, give the same image as the ones built from scratch.
+
+#include "vtkActor.h"
+#include "vtkCompositeDataDisplayAttributes.h"
+#include "vtkCompositePolyDataMapper2.h"
+#include "vtkImageData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkWindowToImageFilter.h"
+
+#include <iostream>
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> MakeSphere(double x, double y, int resolution)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetCenter(x, y, 0.0);
+  sphere->SetRadius(0.4);
+  sphere->SetThetaResolution(resolution);
+  sphere->SetPhiResolution(resolution);
+  sphere->Update();
+  return sphere->GetOutput();
+}
+
+vtkSmartPointer<vtkImageData> Capture(vtkRenderWindow* renWin)
+{
+  renWin->Render();
+  vtkNew<vtkWindowToImageFilter> capture;
+  capture->SetInput(renWin);
+  capture->Update();
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->DeepCopy(capture->GetOutput());
+  return image;
+}
+
+bool SameImages(vtkImageData* image1, vtkImageData* image2, const char* name)
+{
+  vtkUnsignedCharArray* pixels1 =
+    vtkArrayDownCast<vtkUnsignedCharArray>(image1->GetPointData()->GetScalars());
+  vtkUnsignedCharArray* pixels2 =
+    vtkArrayDownCast<vtkUnsignedCharArray>(image2->GetPointData()->GetScalars());
+  if (!pixels1 || !pixels2 || pixels1->GetNumberOfValues() != pixels2->GetNumberOfValues())
+  {
+    std::cerr << name << ": the images differ in size" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < pixels1->GetNumberOfValues(); ++i)
+  {
+    if (pixels1->GetValue(i) != pixels2->GetValue(i))
+    {
+      std::cerr << name << ": the images differ at value " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestCompositePolyDataMapper2Batched(int, char*[])
+{
+  vtkNew<vtkMultiBlockDataSet> blocks;
+  const int size = 8;
+  blocks->SetNumberOfBlocks(size * size);
+  for (int j = 0; j < size; ++j)
+  {
+    for (int i = 0; i < size; ++i)
+    {
+      blocks->SetBlock(j * size + i, MakeSphere(i, j, 12));
+    }
+  }
+
+  vtkNew<vtkCompositeDataDisplayAttributes> attributes;
+  vtkNew<vtkCompositePolyDataMapper2> mapper;
+  mapper->SetInputDataObject(blocks);
+  mapper->SetCompositeDataDisplayAttributes(attributes);
+  // some blocks break the batches
+  mapper->SetBlockColor(10, 1.0, 0.0, 0.0);
+  mapper->SetBlockColor(11, 1.0, 0.0, 0.0);
+  mapper->SetBlockVisibility(20, false);
+  mapper->SetBlockOpacity(30, 0.5);
+
+  vtkNew<vtkActor> actor;
+  actor->SetMapper(mapper);
+  vtkNew<vtkRenderer> renderer;
+  renderer->AddActor(actor);
+  vtkNew<vtkRenderWindow> renWin;
+  renWin->SetSize(300, 300);
+  renWin->AddRenderer(renderer);
+  renderer->ResetCamera();
+
+  vtkSmartPointer<vtkImageData> reference = Capture(renWin);
+  mapper->BatchedBlockRenderingOn();
+  if (!SameImages(reference, Capture(renWin), "Batched draws"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Moving the points of a block keeps the layout of the buffers.
+  for (unsigned int block : { 5u, 42u })
+  {
+    vtkPolyData* sphere = vtkPolyData::SafeDownCast(blocks->GetBlock(block));
+    vtkPoints* points = sphere->GetPoints();
+    for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+    {
+      double x[3];
+      points->GetPoint(ptId, x);
+      points->SetPoint(ptId, x[0] + 0.1, x[1] + 0.2, x[2]);
+    }
+    points->Modified();
+    vtkSmartPointer<vtkImageData> updated = Capture(renWin);
+
+    // the same blocks built from scratch
+    mapper->ReleaseGraphicsResources(renWin);
+    if (!SameImages(Capture(renWin), updated, "Moved block"))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // A finer block does not.
+  vtkPolyData* sphere = vtkPolyData::SafeDownCast(blocks->GetBlock(50));
+  sphere->ShallowCopy(MakeSphere(2.0, 6.0, 24));
+  vtkSmartPointer<vtkImageData> rebuilt = Capture(renWin);
+  mapper->ReleaseGraphicsResources(renWin);
+  if (!SameImages(Capture(renWin), rebuilt, "Refined block"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
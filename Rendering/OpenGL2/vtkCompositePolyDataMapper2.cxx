@@ -54,6 +54,7 @@
 #include "vtkUnsignedIntArray.h"
 
 #include <algorithm>
+#include <iterator>
 #include <sstream>
 
 #include "vtkCompositePolyDataMapper2Internal.h"
@@ -93,30 +94,8 @@ void vtkCompositeMapperHelper2::SetShaderValues(
   }
 
   // If requested, color partial / missing arrays with NaN color.
-  bool useNanColor = false;
   double nanColor[4] = { -1., -1., -1., -1 };
-  if (this->Parent->GetColorMissingArraysWithNanColor() && this->GetScalarVisibility())
-  {
-    int cellFlag = 0;
-    vtkAbstractArray* scalars = vtkAbstractMapper::GetAbstractScalars(hdata->Data, this->ScalarMode,
-      this->ArrayAccessMode, this->ArrayId, this->ArrayName, cellFlag);
-    if (scalars == nullptr)
-    {
-      vtkLookupTable* lut = vtkLookupTable::SafeDownCast(this->GetLookupTable());
-      vtkColorTransferFunction* ctf =
-        lut ? nullptr : vtkColorTransferFunction::SafeDownCast(this->GetLookupTable());
-      if (lut)
-      {
-        lut->GetNanColor(nanColor);
-        useNanColor = true;
-      }
-      else if (ctf)
-      {
-        ctf->GetNanColor(nanColor);
-        useNanColor = true;
-      }
-    }
-  }
+  bool useNanColor = this->GetNanColor(hdata, nanColor);
 
   // override the opacity and color
   prog->SetUniformf("opacityUniform", hdata->Opacity);
@@ -157,6 +136,34 @@ void vtkCompositeMapperHelper2::SetShaderValues(
   }
 }
 
+bool vtkCompositeMapperHelper2::GetNanColor(
+  vtkCompositeMapperHelperData* hdata, double nanColor[4])
+{
+  if (this->Parent->GetColorMissingArraysWithNanColor() && this->GetScalarVisibility())
+  {
+    int cellFlag = 0;
+    vtkAbstractArray* scalars = vtkAbstractMapper::GetAbstractScalars(hdata->Data, this->ScalarMode,
+      this->ArrayAccessMode, this->ArrayId, this->ArrayName, cellFlag);
+    if (scalars == nullptr)
+    {
+      vtkLookupTable* lut = vtkLookupTable::SafeDownCast(this->GetLookupTable());
+      vtkColorTransferFunction* ctf =
+        lut ? nullptr : vtkColorTransferFunction::SafeDownCast(this->GetLookupTable());
+      if (lut)
+      {
+        lut->GetNanColor(nanColor);
+        return true;
+      }
+      else if (ctf)
+      {
+        ctf->GetNanColor(nanColor);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void vtkCompositeMapperHelper2::UpdateShaders(
   vtkOpenGLHelper& cellBO, vtkRenderer* ren, vtkActor* act)
 {
@@ -371,17 +378,25 @@ void vtkCompositeMapperHelper2::DrawIBO(vtkRenderer* ren, vtkActor* actor, int p
 
     bool selecting = (this->CurrentSelector ? true : false);
     bool tpass = actor->IsRenderingTranslucentPolygonalGeometry();
+    auto shouldDraw = [&](vtkCompositeMapperHelperData* hdata) {
+      return hdata->Visibility                // must be visible
+        && (!selecting || hdata->Pickability) // and pickable when selecting
+        && (((selecting || hdata->IsOpaque || actor->GetForceOpaque()) &&
+              !tpass) // opaque during opaque or when selecting
+             || ((!hdata->IsOpaque || actor->GetForceTranslucent()) && tpass &&
+                  !selecting)); // translucent during translucent and never selecting
+    };
+
+    // in batched mode, the blocks drawn with the same values are
+    // drawn together when their indices follow each other
+    bool batching = this->Parent->GetBatchedBlockRendering() && !selecting &&
+      !this->DrawingSelection && !this->PrimIDUsed;
 
     for (dataIter it = this->Data.begin(); it != this->Data.end(); ++it)
     {
       vtkCompositeMapperHelperData* starthdata = it->second;
-      bool shouldDraw = starthdata->Visibility     // must be visible
-        && (!selecting || starthdata->Pickability) // and pickable when selecting
-        && (((selecting || starthdata->IsOpaque || actor->GetForceOpaque()) &&
-              !tpass) // opaque during opaque or when selecting
-             || ((!starthdata->IsOpaque || actor->GetForceTranslucent()) && tpass &&
-                  !selecting)); // translucent during translucent and never selecting
-      if (shouldDraw && starthdata->NextIndex[primType] > starthdata->StartIndex[primType])
+      if (shouldDraw(starthdata) &&
+        starthdata->NextIndex[primType] > starthdata->StartIndex[primType])
       {
         // compilers think this can exceed the bounds so we also
         // test against primType even though we should not need to
@@ -391,13 +406,41 @@ void vtkCompositeMapperHelper2::DrawIBO(vtkRenderer* ren, vtkActor* actor, int p
             prog, starthdata, starthdata->CellCellMap->GetPrimitiveOffsets()[primType]);
         }
 
+        unsigned int startVertex = starthdata->StartVertex;
+        unsigned int nextVertex = starthdata->NextVertex;
+        unsigned int nextIndex = starthdata->NextIndex[primType];
+        double nanColor[4];
+        const bool startNanColor = batching && this->GetNanColor(starthdata, nanColor);
+        for (dataIter next = std::next(it); batching && next != this->Data.end(); ++next)
+        {
+          vtkCompositeMapperHelperData* hdata = next->second;
+          if (hdata->StartIndex[primType] != nextIndex)
+          {
+            break;
+          }
+          if (hdata->NextIndex[primType] > hdata->StartIndex[primType])
+          {
+            if (!shouldDraw(hdata) || hdata->Opacity != starthdata->Opacity ||
+              hdata->AmbientColor != starthdata->AmbientColor ||
+              hdata->DiffuseColor != starthdata->DiffuseColor ||
+              hdata->OverridesColor != starthdata->OverridesColor ||
+              this->GetNanColor(hdata, nanColor) != startNanColor)
+            {
+              break;
+            }
+            startVertex = std::min(startVertex, hdata->StartVertex);
+            nextVertex = std::max(nextVertex, hdata->NextVertex);
+            nextIndex = hdata->NextIndex[primType];
+          }
+          it = next;
+        }
+
         unsigned int count = this->DrawingSelection
           ? static_cast<unsigned int>(CellBO.IBO->IndexCount)
-          : starthdata->NextIndex[primType] - starthdata->StartIndex[primType];
+          : nextIndex - starthdata->StartIndex[primType];
 
-        glDrawRangeElements(mode, static_cast<GLuint>(starthdata->StartVertex),
-          static_cast<GLuint>(starthdata->NextVertex > 0 ? starthdata->NextVertex - 1 : 0), count,
-          GL_UNSIGNED_INT,
+        glDrawRangeElements(mode, static_cast<GLuint>(startVertex),
+          static_cast<GLuint>(nextVertex > 0 ? nextVertex - 1 : 0), count, GL_UNSIGNED_INT,
           reinterpret_cast<const GLvoid*>(starthdata->StartIndex[primType] * sizeof(GLuint)));
       }
     }
@@ -481,9 +524,38 @@ vtkCompositeMapperHelperData* vtkCompositeMapperHelper2::AddData(
   return found->second;
 }
 
+//------------------------------------------------------------------------------
+bool vtkCompositeMapperHelper2::GetNeedToRebuildBufferObjects(vtkRenderer* ren, vtkActor* act)
+{
+  if (this->Superclass::GetNeedToRebuildBufferObjects(ren, act))
+  {
+    return true;
+  }
+
+  // only the current input is checked otherwise
+  if (this->Parent->GetBatchedBlockRendering())
+  {
+    for (dataIter it = this->Data.begin(); it != this->Data.end(); ++it)
+    {
+      if (it->second->Data->GetMTime() > it->second->DataMTime)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 //------------------------------------------------------------------------------
 void vtkCompositeMapperHelper2::BuildBufferObjects(vtkRenderer* ren, vtkActor* act)
 {
+  // in batched mode, try to upload the modified blocks only
+  if (this->Parent->GetBatchedBlockRendering() && this->UpdateModifiedBlocks(ren, act))
+  {
+    this->VBOBuildTime.Modified();
+    return;
+  }
+
   // render using the composite data attributes
 
   // create the cell scalar array adjusted for ogl Cells
@@ -493,6 +565,7 @@ void vtkCompositeMapperHelper2::BuildBufferObjects(vtkRenderer* ren, vtkActor* a
   dataIter iter;
   this->VBOs->ClearAllVBOs();
 
+  this->BlockUpdatesAllowed = false;
   if (this->Data.begin() == this->Data.end())
   {
     this->VBOBuildTime.Modified();
@@ -501,6 +574,11 @@ void vtkCompositeMapperHelper2::BuildBufferObjects(vtkRenderer* ren, vtkActor* a
 
   this->EdgeValues.clear();
 
+  // the ranges of the blocks can be updated in place later as long as
+  // they do not share vertices nor need cell textures
+  bool blockUpdatesAllowed = true;
+  unsigned int numberOfVertices = 0;
+
   vtkBoundingBox bbox;
   double bounds[6];
   this->Data.begin()->second->Data->GetPoints()->GetBounds(bounds);
@@ -528,6 +606,13 @@ void vtkCompositeMapperHelper2::BuildBufferObjects(vtkRenderer* ren, vtkActor* a
     {
       hdata->NextIndex[i] = static_cast<unsigned int>(this->IndexArray[i].size());
     }
+    hdata->DataMTime = hdata->Data->GetMTime();
+    if (this->HaveCellScalars || this->HaveCellNormals ||
+      (hdata->NextVertex > hdata->StartVertex && hdata->StartVertex != numberOfVertices))
+    {
+      blockUpdatesAllowed = false;
+    }
+    numberOfVertices = std::max(numberOfVertices, hdata->NextVertex);
     prevhdata = hdata;
   }
 
@@ -657,9 +742,106 @@ void vtkCompositeMapperHelper2::BuildBufferObjects(vtkRenderer* ren, vtkActor* a
     }
   }
 
+  this->BlockUpdatesAllowed = blockUpdatesAllowed && this->EdgeValues.empty();
+  this->BlockUpdateState.Clear();
+  this->BlockUpdateState.Append(act->GetProperty()->GetMTime(), "actor mtime");
+  this->BlockUpdateState.Append(
+    act->GetTexture() ? act->GetTexture()->GetMTime() : 0, "texture mtime");
+
   this->VBOBuildTime.Modified();
 }
 
+//------------------------------------------------------------------------------
+bool vtkCompositeMapperHelper2::UpdateModifiedBlocks(vtkRenderer* ren, vtkActor* act)
+{
+  // the layout of the buffers changes with the blocks and the mapper values
+  this->TempState.Clear();
+  this->TempState.Append(act->GetProperty()->GetMTime(), "actor mtime");
+  this->TempState.Append(act->GetTexture() ? act->GetTexture()->GetMTime() : 0, "texture mtime");
+  if (!this->BlockUpdatesAllowed || this->BlockUpdateState != this->TempState ||
+    this->VBOBuildTime < this->GetMTime())
+  {
+    return false;
+  }
+
+  bool updated = true;
+  for (dataIter it = this->Data.begin(); updated && it != this->Data.end(); ++it)
+  {
+    vtkCompositeMapperHelperData* hdata = it->second;
+    if (hdata->Data->GetMTime() > hdata->DataMTime)
+    {
+      updated = this->UpdateOneBufferObject(ren, act, hdata);
+      hdata->DataMTime = hdata->Data->GetMTime();
+    }
+  }
+
+  // clear color cache
+  for (auto& c : this->ColorArrayMap)
+  {
+    c.second->Delete();
+  }
+  this->ColorArrayMap.clear();
+
+  return updated;
+}
+
+//------------------------------------------------------------------------------
+bool vtkCompositeMapperHelper2::UpdateOneBufferObject(
+  vtkRenderer* ren, vtkActor* act, vtkCompositeMapperHelperData* hdata)
+{
+  vtkPolyData* poly = hdata->Data;
+  vtkIdType numPts = poly->GetPoints() ? poly->GetPoints()->GetNumberOfPoints() : 0;
+  if (numPts != static_cast<vtkIdType>(hdata->NextVertex - hdata->StartVertex))
+  {
+    return false;
+  }
+  if (numPts == 0)
+  {
+    return true;
+  }
+
+  // append the block alone, as the group has no data array left from the
+  // last build, and upload its values where they were packed
+  std::vector<unsigned char> newColors;
+  std::vector<float> newNorms;
+  vtkIdType voffset = 0;
+  vtkIdType finalOffset = hdata->CellCellMap->GetFinalOffset();
+  size_t numEdgeValues = this->EdgeValues.size();
+  this->AppendOneBufferObject(ren, act, hdata, voffset, newColors, newNorms);
+
+  bool updated = !this->HaveCellScalars && !this->HaveCellNormals &&
+    this->EdgeValues.size() == numEdgeValues &&
+    hdata->CellCellMap->GetFinalOffset() == finalOffset;
+  for (int i = 0; updated && i < vtkOpenGLPolyDataMapper::PrimitiveEnd; i++)
+  {
+    updated = this->IndexArray[i].size() == hdata->NextIndex[i] - hdata->StartIndex[i];
+  }
+  if (updated)
+  {
+    updated = this->VBOs->UpdateAllVBOs(hdata->StartVertex);
+  }
+  else
+  {
+    this->VBOs->ClearAllDataArrays();
+  }
+
+  for (int i = vtkOpenGLPolyDataMapper::PrimitiveStart; i < vtkOpenGLPolyDataMapper::PrimitiveEnd;
+       i++)
+  {
+    std::vector<unsigned int>& indices = this->IndexArray[i];
+    if (updated && !indices.empty())
+    {
+      for (auto& index : indices)
+      {
+        index += hdata->StartVertex;
+      }
+      updated = this->Primitives[i].IBO->UploadRange(indices, hdata->StartIndex[i]);
+    }
+    indices.resize(0);
+  }
+  return updated;
+}
+
 //------------------------------------------------------------------------------
 void vtkCompositeMapperHelper2::BuildSelectionIBO(vtkPolyData* vtkNotUsed(poly),
   std::vector<unsigned int> (&indices)[4], vtkIdType vtkNotUsed(offset))
@@ -1243,6 +1425,7 @@ vtkCompositePolyDataMapper2::vtkCompositePolyDataMapper2()
 {
   this->CurrentFlatIndex = 0;
   this->ColorMissingArraysWithNanColor = false;
+  this->BatchedBlockRendering = false;
 }
 
 //------------------------------------------------------------------------------
@@ -1621,6 +1804,7 @@ vtkCompositeDataDisplayAttributes* vtkCompositePolyDataMapper2::GetCompositeData
 void vtkCompositePolyDataMapper2::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "BatchedBlockRendering: " << this->BatchedBlockRendering << "\n";
 }
 
 void vtkCompositePolyDataMapper2::CopyMapperValuesToHelper(vtkCompositeMapperHelper2* helper)
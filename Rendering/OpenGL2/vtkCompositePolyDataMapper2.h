@@ -109,6 +109,21 @@ public:
   vtkBooleanMacro(ColorMissingArraysWithNanColor, bool);
   /**@}*/
 
+  /**
+   * In batched mode, only the ranges of the shared buffer objects that hold
+   * the blocks modified since the last render are uploaded again, as long as
+   * the blocks keep their numbers of points and primitives. Consecutive
+   * blocks drawn with the same opacity and colors are also drawn with a
+   * single call. Blocks with cell scalars or normals, blocks that share their
+   * point arrays and surfaces drawn with edges are always rebuilt.
+   * Default is false.
+   * @{
+   */
+  vtkSetMacro(BatchedBlockRendering, bool);
+  vtkGetMacro(BatchedBlockRendering, bool);
+  vtkBooleanMacro(BatchedBlockRendering, bool);
+  /**@}*/
+
   /**
    * Release any graphics resources that are being consumed by this mapper.
    * The parameter window could be used to determine which graphic
@@ -234,6 +249,11 @@ protected:
    */
   bool ColorMissingArraysWithNanColor;
 
+  /**
+   * Upload only the modified blocks and merge the draw calls of the blocks.
+   */
+  bool BatchedBlockRendering;
+
   std::vector<vtkPolyData*> RenderedList;
 
 private:
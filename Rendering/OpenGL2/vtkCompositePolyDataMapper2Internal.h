@@ -52,6 +52,9 @@ public:
 
   // stores the mapping from vtk cells to gl_PrimitiveId
   vtkNew<vtkOpenGLCellToVTKCellMap> CellCellMap;
+
+  // the data mtime when its buffer ranges were last built
+  vtkMTimeType DataMTime = 0;
 };
 
 //===================================================================
@@ -102,7 +105,11 @@ protected:
   // handle updating shift scale based on pose changes
   void UpdateCameraShiftScale(vtkRenderer* ren, vtkActor* actor) override;
 
-  vtkCompositeMapperHelper2() { this->Parent = nullptr; };
+  vtkCompositeMapperHelper2()
+  {
+    this->Parent = nullptr;
+    this->BlockUpdatesAllowed = false;
+  };
   ~vtkCompositeMapperHelper2() override;
 
   void DrawIBO(vtkRenderer* ren, vtkActor* actor, int primType, vtkOpenGLHelper& CellBO,
@@ -111,6 +118,13 @@ protected:
   virtual void SetShaderValues(
     vtkShaderProgram* prog, vtkCompositeMapperHelperData* hdata, size_t primOffset);
 
+  /**
+   * Returns whether the block is drawn with the NaN color of the lookup
+   * table, given in nanColor, because it lacks the scalars colored with
+   * ColorMissingArraysWithNanColor on.
+   */
+  bool GetNanColor(vtkCompositeMapperHelperData* hdata, double nanColor[4]);
+
   /**
    * Make sure appropriate shaders are defined, compiled and bound.  This method
    * orchistrates the process, much of the work is done in other methods
@@ -124,6 +138,12 @@ protected:
   void ReplaceShaderColor(
     std::map<vtkShader::Type, vtkShader*> shaders, vtkRenderer* ren, vtkActor* act) override;
 
+  /**
+   * Does the VBO/IBO need to be rebuilt. In batched mode, the blocks
+   * modified since the last build are checked too.
+   */
+  bool GetNeedToRebuildBufferObjects(vtkRenderer* ren, vtkActor* act) override;
+
   /**
    * Build the VBO/IBO, called by UpdateBufferObjects
    */
@@ -132,6 +152,19 @@ protected:
     vtkCompositeMapperHelperData* hdata, vtkIdType& flat_index, std::vector<unsigned char>& colors,
     std::vector<float>& norms);
 
+  /**
+   * Upload the ranges of the VBO/IBO of the blocks modified since the last
+   * build, in batched mode. Returns false when the buffers cannot keep their
+   * layout, in which case they have to be rebuilt.
+   */
+  virtual bool UpdateModifiedBlocks(vtkRenderer* ren, vtkActor* act);
+  bool UpdateOneBufferObject(vtkRenderer* ren, vtkActor* act, vtkCompositeMapperHelperData* hdata);
+
+  // can the ranges of the blocks be updated in place, and the state
+  // of the last build they depend on
+  bool BlockUpdatesAllowed;
+  vtkStateStorage BlockUpdateState;
+
   /**
    * Build the selection IBOs, called by UpdateBufferObjects
    */
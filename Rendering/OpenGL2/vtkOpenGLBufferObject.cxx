@@ -44,9 +44,11 @@ struct vtkOpenGLBufferObject::Private
   {
     this->Handle = 0;
     this->Type = GL_ARRAY_BUFFER;
+    this->Size = 0;
   }
   GLenum Type;
   GLuint Handle;
+  size_t Size;
 };
 
 vtkOpenGLBufferObject::vtkOpenGLBufferObject()
@@ -72,6 +74,7 @@ void vtkOpenGLBufferObject::ReleaseGraphicsResources()
     glBindBuffer(this->Internal->Type, 0);
     glDeleteBuffers(1, &this->Internal->Handle);
     this->Internal->Handle = 0;
+    this->Internal->Size = 0;
   }
 }
 
@@ -146,10 +149,27 @@ bool vtkOpenGLBufferObject::UploadInternal(
 
   glBindBuffer(this->Internal->Type, this->Internal->Handle);
   glBufferData(this->Internal->Type, size, static_cast<const GLvoid*>(buffer), GL_STATIC_DRAW);
+  this->Internal->Size = size;
   this->Dirty = false;
   return true;
 }
 
+//------------------------------------------------------------------------------
+bool vtkOpenGLBufferObject::UploadRangeInternal(
+  const void* buffer, size_t size, size_t byteOffset)
+{
+  if (this->Dirty || this->Internal->Handle == 0 || byteOffset + size > this->Internal->Size)
+  {
+    this->Error = "Trying to upload a range outside of the buffer.";
+    return false;
+  }
+
+  glBindBuffer(this->Internal->Type, this->Internal->Handle);
+  glBufferSubData(this->Internal->Type, static_cast<GLintptr>(byteOffset),
+    static_cast<GLsizeiptr>(size), static_cast<const GLvoid*>(buffer));
+  return true;
+}
+
 //------------------------------------------------------------------------------
 void vtkOpenGLBufferObject::PrintSelf(ostream& os, vtkIndent indent)
 {
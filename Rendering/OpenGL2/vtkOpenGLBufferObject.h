@@ -75,6 +75,19 @@ public:
   template <class T>
   bool Upload(const T* array, size_t numElements, ObjectType type);
 
+  /**
+   * Replace the values of the buffer object that start at the element
+   * @a offset with the values of @a array, keeping its size. The buffer
+   * object must have been uploaded before, with enough values to hold the
+   * range.
+   */
+  template <class T>
+  bool UploadRange(const T& array, size_t offset);
+
+  // non vector version
+  template <class T>
+  bool UploadRange(const T* array, size_t numElements, size_t offset);
+
   /**
    * Bind the buffer object ready for rendering.
    * @note Only one ARRAY_BUFFER and one ELEMENT_ARRAY_BUFFER may be bound at
@@ -103,6 +116,7 @@ protected:
   std::string Error;
 
   bool UploadInternal(const void* buffer, size_t size, ObjectType objectType);
+  bool UploadRangeInternal(const void* buffer, size_t size, size_t byteOffset);
 
 private:
   vtkOpenGLBufferObject(const vtkOpenGLBufferObject&) = delete;
@@ -136,4 +150,29 @@ inline bool vtkOpenGLBufferObject::Upload(
   return this->UploadInternal(array, numElements * sizeof(T), objectType);
 }
 
+template <class T>
+inline bool vtkOpenGLBufferObject::UploadRange(const T& array, size_t offset)
+{
+  if (array.empty())
+  {
+    this->Error = "Refusing to upload empty array.";
+    return false;
+  }
+
+  using ValueType = typename T::value_type;
+  return this->UploadRangeInternal(
+    &array[0], array.size() * sizeof(ValueType), offset * sizeof(ValueType));
+}
+
+template <class T>
+inline bool vtkOpenGLBufferObject::UploadRange(const T* array, size_t numElements, size_t offset)
+{
+  if (!array)
+  {
+    this->Error = "Refusing to upload empty array.";
+    return false;
+  }
+  return this->UploadRangeInternal(array, numElements * sizeof(T), offset * sizeof(T));
+}
+
 #endif
@@ -22,10 +22,12 @@
 #include "vtkPoints.h"
 #include "vtkPolygon.h"
 #include "vtkProperty.h"
+#include "vtkSMPTools.h"
 #include "vtkUnsignedCharArray.h"
 
 #include "vtk_glew.h"
 
+#include <algorithm>
 #include <set>
 
 vtkStandardNewMacro(vtkOpenGLIndexBufferObject);
@@ -40,6 +42,116 @@ vtkOpenGLIndexBufferObject::~vtkOpenGLIndexBufferObject() = default;
 
 namespace
 {
+// The cells are split in chunks of this many cells, whose primitives are
+// built concurrently. Smaller cell arrays are processed serially.
+const vtkIdType CellsPerChunk = 65536;
+
+// Appends the triangles of the polygons to the index array, skipping the
+// triangles that isValid rejects. The triangles of each chunk of cells are
+// gathered concurrently, then concatenated in the order of the cells.
+struct AppendTrianglesImpl
+{
+  template <typename CellStateT, typename TriangleCheck>
+  void operator()(CellStateT& state, const TriangleCheck& isValid,
+    std::vector<unsigned int>& indexArray, std::vector<unsigned char>* edgeArray,
+    const unsigned char* edgeFlags, vtkIdType vOffset)
+  {
+    auto appendCells = [&](vtkIdType begin, vtkIdType end, std::vector<unsigned int>& indices,
+                         std::vector<unsigned char>* edges) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const auto cell = state.GetCellRange(cellId);
+        const int cellSize = static_cast<int>(cell.size());
+        if (cellSize < 3)
+        {
+          continue;
+        }
+        const vtkIdType id1 = static_cast<vtkIdType>(cell[0]);
+        for (int i = 1; i < cellSize - 1; i++)
+        {
+          const vtkIdType id2 = static_cast<vtkIdType>(cell[i]);
+          const vtkIdType id3 = static_cast<vtkIdType>(cell[i + 1]);
+          if (!isValid(id1, id2, id3))
+          {
+            continue;
+          }
+          indices.push_back(static_cast<unsigned int>(id1 + vOffset));
+          indices.push_back(static_cast<unsigned int>(id2 + vOffset));
+          indices.push_back(static_cast<unsigned int>(id3 + vOffset));
+          if (edges)
+          {
+            int val = cellSize == 3 ? 7 : i == 1 ? 3 : i == cellSize - 2 ? 6 : 2;
+            if (edgeFlags)
+            {
+              int mask = 0;
+              mask = edgeFlags[id1] + edgeFlags[id2] * 2 + edgeFlags[id3] * 4;
+              edges->push_back(val & mask);
+            }
+            else
+            {
+              edges->push_back(val);
+            }
+          }
+        }
+      }
+    };
+
+    const vtkIdType numCells = state.GetNumberOfCells();
+    const vtkIdType numChunks = (numCells + CellsPerChunk - 1) / CellsPerChunk;
+    if (numChunks < 2)
+    {
+      appendCells(0, numCells, indexArray, edgeArray);
+      return;
+    }
+
+    std::vector<std::vector<unsigned int>> chunkIndices(numChunks);
+    std::vector<std::vector<unsigned char>> chunkEdges(edgeArray ? numChunks : 0);
+    vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType first, vtkIdType last) {
+      for (vtkIdType chunk = first; chunk < last; ++chunk)
+      {
+        const vtkIdType begin = chunk * CellsPerChunk;
+        const vtkIdType end = std::min(begin + CellsPerChunk, numCells);
+        const vtkIdType numConnectivityIds =
+          state.GetEndOffset(end - 1) - state.GetBeginOffset(begin);
+        if (numConnectivityIds > 2 * (end - begin))
+        {
+          chunkIndices[chunk].reserve(3 * (numConnectivityIds - 2 * (end - begin)));
+        }
+        appendCells(begin, end, chunkIndices[chunk], edgeArray ? &chunkEdges[chunk] : nullptr);
+      }
+    });
+
+    // prefix sums of the chunk sizes give where each chunk is copied
+    std::vector<size_t> indexOffsets(numChunks + 1, indexArray.size());
+    std::vector<size_t> edgeOffsets(numChunks + 1, edgeArray ? edgeArray->size() : 0);
+    for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+    {
+      indexOffsets[chunk + 1] = indexOffsets[chunk] + chunkIndices[chunk].size();
+      if (edgeArray)
+      {
+        edgeOffsets[chunk + 1] = edgeOffsets[chunk] + chunkEdges[chunk].size();
+      }
+    }
+    indexArray.resize(indexOffsets[numChunks]);
+    if (edgeArray)
+    {
+      edgeArray->resize(edgeOffsets[numChunks]);
+    }
+    vtkSMPTools::For(0, numChunks, 1, [&](vtkIdType first, vtkIdType last) {
+      for (vtkIdType chunk = first; chunk < last; ++chunk)
+      {
+        std::copy(chunkIndices[chunk].begin(), chunkIndices[chunk].end(),
+          indexArray.begin() + indexOffsets[chunk]);
+        if (edgeArray)
+        {
+          std::copy(chunkEdges[chunk].begin(), chunkEdges[chunk].end(),
+            edgeArray->begin() + edgeOffsets[chunk]);
+        }
+      }
+    });
+  }
+};
+
 // A worker functor. The calculation is implemented in the function template
 // for operator().
 struct AppendTrianglesWorker
@@ -54,51 +166,17 @@ struct AppendTrianglesWorker
   template <typename ValueType>
   void operator()(vtkAOSDataArrayTemplate<ValueType>* src)
   {
-    ValueType* points = src->Begin();
-
-    auto cellIter = vtk::TakeSmartPointer(cells->NewIterator());
-
-    for (cellIter->GoToFirstCell(); !cellIter->IsDoneWithTraversal(); cellIter->GoToNextCell())
-    {
-      vtkIdType cellSize;
-      const vtkIdType* cell;
-      cellIter->GetCurrentCell(cellSize, cell);
-
-      if (cellSize >= 3)
-      {
-        vtkIdType id1 = cell[0];
-        ValueType* p1 = points + id1 * 3;
-        for (int i = 1; i < cellSize - 1; i++)
-        {
-          vtkIdType id2 = cell[i];
-          vtkIdType id3 = cell[i + 1];
-          ValueType* p2 = points + id2 * 3;
-          ValueType* p3 = points + id3 * 3;
-          if ((p1[0] != p2[0] || p1[1] != p2[1] || p1[2] != p2[2]) &&
-            (p3[0] != p2[0] || p3[1] != p2[1] || p3[2] != p2[2]) &&
-            (p3[0] != p1[0] || p3[1] != p1[1] || p3[2] != p1[2]))
-          {
-            indexArray->push_back(static_cast<unsigned int>(id1 + vOffset));
-            indexArray->push_back(static_cast<unsigned int>(id2 + vOffset));
-            indexArray->push_back(static_cast<unsigned int>(id3 + vOffset));
-            if (edgeArray)
-            {
-              int val = cellSize == 3 ? 7 : i == 1 ? 3 : i == cellSize - 2 ? 6 : 2;
-              if (edgeFlags)
-              {
-                int mask = 0;
-                mask = edgeFlags[id1] + edgeFlags[id2] * 2 + edgeFlags[id3] * 4;
-                edgeArray->push_back(val & mask);
-              }
-              else
-              {
-                edgeArray->push_back(val);
-              }
-            }
-          }
-        }
-      }
-    }
+    const ValueType* points = src->Begin();
+    auto isValid = [points](vtkIdType id1, vtkIdType id2, vtkIdType id3) {
+      const ValueType* p1 = points + id1 * 3;
+      const ValueType* p2 = points + id2 * 3;
+      const ValueType* p3 = points + id3 * 3;
+      return (p1[0] != p2[0] || p1[1] != p2[1] || p1[2] != p2[2]) &&
+        (p3[0] != p2[0] || p3[1] != p2[1] || p3[2] != p2[2]) &&
+        (p3[0] != p1[0] || p3[1] != p1[1] || p3[2] != p1[2]);
+    };
+    this->cells->Visit(
+      AppendTrianglesImpl{}, isValid, *indexArray, edgeArray, edgeFlags, vOffset);
   }
 
   // Generic API, on VS13 Rel this is about 80% slower than
@@ -107,36 +185,39 @@ struct AppendTrianglesWorker
   void operator()(PointArray* pointArray)
   {
     const auto points = vtk::DataArrayTupleRange<3>(pointArray);
+    auto isValid = [&points](vtkIdType id1, vtkIdType id2, vtkIdType id3) {
+      const auto pt1 = points[id1];
+      const auto pt2 = points[id2];
+      const auto pt3 = points[id3];
+      return pt1 != pt2 && pt1 != pt3 && pt2 != pt3;
+    };
+    this->cells->Visit(
+      AppendTrianglesImpl{}, isValid, *indexArray, edgeArray, edgeFlags, vOffset);
+  }
+};
 
-    auto cellIter = vtk::TakeSmartPointer(cells->NewIterator());
-
-    for (cellIter->GoToFirstCell(); !cellIter->IsDoneWithTraversal(); cellIter->GoToNextCell())
-    {
-      vtkIdType cellSize;
-      const vtkIdType* cell;
-      cellIter->GetCurrentCell(cellSize, cell);
-
-      if (cellSize >= 3)
+// Appends two indices per edge of each cell. The output position of a cell
+// follows from its offset in the connectivity, so that the chunks of cells
+// are written concurrently.
+struct AppendTriangleLinesImpl
+{
+  template <typename CellStateT>
+  void operator()(CellStateT& state, unsigned int* output, vtkIdType vOffset)
+  {
+    const vtkIdType numCells = state.GetNumberOfCells();
+    vtkSMPTools::For(0, numCells, CellsPerChunk, [&](vtkIdType begin, vtkIdType end) {
+      unsigned int* out = output + 2 * state.GetBeginOffset(begin);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
       {
-        const vtkIdType id1 = cell[0];
-        for (int i = 1; i < cellSize - 1; i++)
+        const auto cell = state.GetCellRange(cellId);
+        const vtkIdType npts = cell.size();
+        for (vtkIdType i = 0; i < npts; ++i)
         {
-          const vtkIdType id2 = cell[i];
-          const vtkIdType id3 = cell[i + 1];
-
-          const auto pt1 = points[id1];
-          const auto pt2 = points[id2];
-          const auto pt3 = points[id3];
-
-          if (pt1 != pt2 && pt1 != pt3 && pt2 != pt3)
-          {
-            indexArray->push_back(static_cast<unsigned int>(id1 + vOffset));
-            indexArray->push_back(static_cast<unsigned int>(id2 + vOffset));
-            indexArray->push_back(static_cast<unsigned int>(id3 + vOffset));
-          }
+          *out++ = static_cast<unsigned int>(cell[i] + vOffset);
+          *out++ = static_cast<unsigned int>(cell[i < npts - 1 ? i + 1 : 0] + vOffset);
         }
       }
-    }
+    });
   }
 };
 
@@ -251,9 +332,8 @@ size_t vtkOpenGLIndexBufferObject::CreatePointIndexBuffer(vtkCellArray* cells)
 void vtkOpenGLIndexBufferObject::AppendTriangleLineIndexBuffer(
   std::vector<unsigned int>& indexArray, vtkCellArray* cells, vtkIdType vOffset)
 {
-  const vtkIdType* indices(nullptr);
-  vtkIdType npts(0);
-  size_t targetSize = indexArray.size() + 2 * cells->GetNumberOfConnectivityIds();
+  const size_t size = indexArray.size();
+  size_t targetSize = size + 2 * cells->GetNumberOfConnectivityIds();
   if (targetSize > indexArray.capacity())
   {
     if (targetSize < indexArray.capacity() * 1.5)
@@ -263,13 +343,10 @@ void vtkOpenGLIndexBufferObject::AppendTriangleLineIndexBuffer(
     indexArray.reserve(targetSize);
   }
 
-  for (cells->InitTraversal(); cells->GetNextCell(npts, indices);)
+  indexArray.resize(size + 2 * cells->GetNumberOfConnectivityIds());
+  if (cells->GetNumberOfCells())
   {
-    for (int i = 0; i < npts; ++i)
-    {
-      indexArray.push_back(static_cast<unsigned int>(indices[i] + vOffset));
-      indexArray.push_back(static_cast<unsigned int>(indices[i < npts - 1 ? i + 1 : 0] + vOffset));
-    }
+    cells->Visit(AppendTriangleLinesImpl{}, indexArray.data() + size, vOffset);
   }
 }
 
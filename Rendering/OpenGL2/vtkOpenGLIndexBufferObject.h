@@ -40,7 +40,8 @@ public:
     std::vector<unsigned char>* edgeArray, vtkDataArray* edgeFlags);
 
   // Description:
-  // used to create an IBO for triangle primitives
+  // used to create an IBO for triangle primitives. The triangles of large
+  // cell arrays are built concurrently with vtkSMPTools, in the cells order.
   static void AppendTriangleIndexBuffer(std::vector<unsigned int>& indexArray, vtkCellArray* cells,
     vtkPoints* points, vtkIdType vertexOffset, std::vector<unsigned char>* edgeArray,
     vtkDataArray* edgeFlags);
@@ -59,7 +60,8 @@ public:
   size_t CreateLineIndexBuffer(vtkCellArray* cells);
 
   // Description:
-  // create a IBO for wireframe polys/tris
+  // create a IBO for wireframe polys/tris. The lines of large cell arrays
+  // are built concurrently with vtkSMPTools, in the cells order.
   static void AppendTriangleLineIndexBuffer(
     std::vector<unsigned int>& indexArray, vtkCellArray* cells, vtkIdType vertexOffset);
 
@@ -21,6 +21,7 @@
 #include "vtkOpenGLVertexBufferObjectCache.h"
 #include "vtkPoints.h"
 #include "vtkProp3D.h"
+#include "vtkSMPTools.h"
 
 #include "vtk_glew.h"
 
@@ -224,6 +225,9 @@ const std::vector<double>& vtkOpenGLVertexBufferObject::GetScale()
 namespace
 {
 
+// Arrays of fewer tuples are packed serially.
+const vtkIdType TuplesPerChunk = 65536;
+
 template <typename destType>
 class vtkAppendVBOWorker
 {
@@ -266,45 +270,52 @@ void vtkAppendVBOWorker<destType>::operator()(vtkAOSDataArrayTemplate<ValueType>
 
   destType* VBOit = reinterpret_cast<destType*>(&this->VBO->GetPackedVBO()[this->Offset]);
 
-  ValueType* input = src->Begin();
-  unsigned int numComps = this->VBO->GetNumberOfComponents();
-  unsigned int numTuples = src->GetNumberOfTuples();
+  const ValueType* input = src->Begin();
+  const unsigned int numComps = this->VBO->GetNumberOfComponents();
+  const vtkIdType numTuples = src->GetNumberOfTuples();
 
   // compute extra padding required
   int bytesNeeded = this->VBO->GetDataTypeSize() * this->VBO->GetNumberOfComponents();
   int extraComponents = ((4 - (bytesNeeded % 4)) % 4) / this->VBO->GetDataTypeSize();
 
-  // If not shift & scale
-  if (!this->VBO->GetCoordShiftAndScaleEnabled())
+  // if no padding, no type conversion and no shift & scale then memcpy
+  if (!this->VBO->GetCoordShiftAndScaleEnabled() && extraComponents == 0 &&
+    src->GetDataType() == this->VBO->GetDataType())
   {
-    // if no padding and no type conversion then memcpy
-    if (extraComponents == 0 && src->GetDataType() == this->VBO->GetDataType())
-    {
-      memcpy(VBOit, input, this->VBO->GetDataTypeSize() * numComps * numTuples);
-    }
-    else
+    memcpy(VBOit, input, this->VBO->GetDataTypeSize() * numComps * numTuples);
+    return;
+  }
+
+  // the tuples are packed concurrently, each at its place in the VBO
+  const bool shiftScale = this->VBO->GetCoordShiftAndScaleEnabled();
+  const std::vector<double>& shift = this->Shift;
+  const std::vector<double>& scale = this->Scale;
+  vtkSMPTools::For(0, numTuples, TuplesPerChunk, [&](vtkIdType begin, vtkIdType end) {
+    const ValueType* in = input + begin * numComps;
+    destType* out = VBOit + begin * (numComps + extraComponents);
+    if (!shiftScale)
     {
-      for (unsigned int i = 0; i < numTuples; ++i)
+      for (vtkIdType i = begin; i < end; ++i)
       {
         for (unsigned int j = 0; j < numComps; j++)
         {
-          *(VBOit++) = *(input++);
+          *(out++) = *(in++);
         }
-        VBOit += extraComponents;
+        out += extraComponents;
       }
     }
-  }
-  else
-  {
-    for (unsigned int i = 0; i < numTuples; ++i)
+    else
     {
-      for (unsigned int j = 0; j < numComps; j++)
+      for (vtkIdType i = begin; i < end; ++i)
       {
-        *(VBOit++) = (*(input++) - this->Shift.at(j)) * this->Scale.at(j);
+        for (unsigned int j = 0; j < numComps; j++)
+        {
+          *(out++) = (*(in++) - shift.at(j)) * scale.at(j);
+        }
+        out += extraComponents;
       }
-      VBOit += extraComponents;
     }
-  } // end if shift*scale
+  });
 }
 
 template <typename destType>
@@ -320,32 +331,40 @@ void vtkAppendVBOWorker<destType>::operator()(DataArray* array)
 
   destType* VBOit = reinterpret_cast<destType*>(&this->VBO->GetPackedVBO()[this->Offset]);
 
-  const auto dataRange = vtk::DataArrayTupleRange(array);
+  const int numComps = array->GetNumberOfComponents();
 
   // compute extra padding required
   int bytesNeeded = this->VBO->GetDataTypeSize() * this->VBO->GetNumberOfComponents();
   int extraComponents = ((4 - (bytesNeeded % 4)) % 4) / this->VBO->GetDataTypeSize();
 
-  // If not shift & scale
-  if (!this->VBO->GetCoordShiftAndScaleEnabled())
-  {
-    for (const auto tuple : dataRange)
-    {
-      VBOit = std::copy(tuple.cbegin(), tuple.cend(), VBOit);
-      VBOit += extraComponents;
-    }
-  }
-  else
-  {
-    for (const auto tuple : dataRange)
-    {
-      for (int j = 0; j < tuple.size(); ++j)
+  // the tuples are packed concurrently, each at its place in the VBO
+  const bool shiftScale = this->VBO->GetCoordShiftAndScaleEnabled();
+  const std::vector<double>& shift = this->Shift;
+  const std::vector<double>& scale = this->Scale;
+  vtkSMPTools::For(
+    0, array->GetNumberOfTuples(), TuplesPerChunk, [&](vtkIdType begin, vtkIdType end) {
+      const auto dataRange = vtk::DataArrayTupleRange(array, begin, end);
+      destType* out = VBOit + begin * (numComps + extraComponents);
+      if (!shiftScale)
       {
-        *(VBOit++) = (tuple[j] - this->Shift[j]) * this->Scale[j];
+        for (const auto tuple : dataRange)
+        {
+          out = std::copy(tuple.cbegin(), tuple.cend(), out);
+          out += extraComponents;
+        }
       }
-      VBOit += extraComponents;
-    }
-  } // end if shift*scale
+      else
+      {
+        for (const auto tuple : dataRange)
+        {
+          for (int j = 0; j < tuple.size(); ++j)
+          {
+            *(out++) = (tuple[j] - shift[j]) * scale[j];
+          }
+          out += extraComponents;
+        }
+      }
+    });
 }
 
 } // end anon namespace
@@ -641,6 +660,56 @@ void vtkOpenGLVertexBufferObject::AppendDataArray(vtkDataArray* array)
   this->Modified();
 }
 
+//------------------------------------------------------------------------------
+bool vtkOpenGLVertexBufferObject::UpdateDataArray(vtkDataArray* array, vtkIdType firstTuple)
+{
+  if (array == nullptr || array->GetNumberOfTuples() == 0 || this->Stride == 0 ||
+    static_cast<int>(this->NumberOfComponents) != array->GetNumberOfComponents() ||
+    firstTuple < 0 ||
+    firstTuple + array->GetNumberOfTuples() > static_cast<vtkIdType>(this->NumberOfTuples))
+  {
+    return false;
+  }
+
+  const size_t offset = static_cast<size_t>(firstTuple) * this->Stride / sizeof(float);
+  const size_t size = static_cast<size_t>(array->GetNumberOfTuples()) * this->Stride / sizeof(float);
+
+  // can we use the fast path and just upload the raw array?
+  if (!this->GetCoordShiftAndScaleEnabled() && this->DataType == array->GetDataType() &&
+    this->NumberOfComponents * this->DataTypeSize == this->Stride)
+  {
+    return this->UploadRange(reinterpret_cast<float*>(array->GetVoidPointer(0)), size, offset);
+  }
+
+  // otherwise pack the tuples the way AppendDataArray does
+  this->PackedVBO.resize(size);
+  typedef vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::AllTypes> Dispatcher;
+  switch (this->DataType)
+  {
+    case VTK_FLOAT:
+    {
+      vtkAppendVBOWorker<float> worker(this, 0, this->GetShift(), this->GetScale());
+      if (!Dispatcher::Execute(array, worker))
+      {
+        worker(array);
+      }
+      break;
+    }
+    case VTK_UNSIGNED_CHAR:
+    {
+      vtkAppendVBOWorker<unsigned char> worker(this, 0, this->GetShift(), this->GetScale());
+      if (!Dispatcher::Execute(array, worker))
+      {
+        worker(array);
+      }
+      break;
+    }
+  }
+  const bool uploaded = this->UploadRange(this->PackedVBO, offset);
+  this->PackedVBO.resize(0);
+  return uploaded;
+}
+
 //------------------------------------------------------------------------------
 void vtkOpenGLVertexBufferObject::UploadVBO()
 {
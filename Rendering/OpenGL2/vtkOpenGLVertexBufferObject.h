@@ -50,9 +50,17 @@ public:
   void UploadDataArray(vtkDataArray* array);
 
   // append a data array to this VBO, always
-  // copies the data from the data array
+  // copies the data from the data array. The tuples
+  // of large arrays are packed concurrently.
   void AppendDataArray(vtkDataArray* array);
 
+  // replace the tuples of this uploaded VBO that start at
+  // firstTuple with the ones of the data array, converted
+  // with the current data type, shift and scale. Only these
+  // tuples are uploaded. Returns false if the array does not
+  // match the VBO components or does not fit in the VBO.
+  bool UpdateDataArray(vtkDataArray* array, vtkIdType firstTuple);
+
   // Get the mtime when this VBO was loaded
   vtkGetMacro(UploadTime, vtkTimeStamp);
 
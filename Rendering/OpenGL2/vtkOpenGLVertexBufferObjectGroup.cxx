@@ -381,6 +381,21 @@ void vtkOpenGLVertexBufferObjectGroup::BuildAllVBOs(vtkOpenGLVertexBufferObjectC
   this->ClearAllDataArrays();
 }
 
+//------------------------------------------------------------------------------
+bool vtkOpenGLVertexBufferObjectGroup::UpdateAllVBOs(vtkIdType firstTuple)
+{
+  bool updated = this->UsedDataArrays.size() == this->UsedVBOs.size();
+  for (arrayIter i = this->UsedDataArrays.begin(); updated && i != this->UsedDataArrays.end(); ++i)
+  {
+    vboIter viter = this->UsedVBOs.find(i->first);
+    updated = viter != this->UsedVBOs.end() && i->second.size() == 1 &&
+      viter->second->UpdateDataArray(i->second[0], firstTuple);
+  }
+
+  this->ClearAllDataArrays();
+  return updated;
+}
+
 //------------------------------------------------------------------------------
 vtkMTimeType vtkOpenGLVertexBufferObjectGroup::GetMTime()
 {
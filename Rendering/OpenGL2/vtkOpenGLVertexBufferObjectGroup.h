@@ -150,6 +150,16 @@ public:
   void BuildAllVBOs(vtkOpenGLVertexBufferObjectCache*);
   void BuildAllVBOs(vtkViewport*);
 
+  /**
+   * using the data arrays in this group, one per attribute,
+   * replace the tuples of the built VBOs that start at
+   * firstTuple instead of building them. Returns false if
+   * an attribute has no built VBO or no data array, in which
+   * case the VBOs have to be built again. The reference to the
+   * data arrays are freed in both cases.
+   */
+  bool UpdateAllVBOs(vtkIdType firstTuple);
+
   /**
    * Force all the VBOs to be freed from this group.
    * Call this prior to starting appending operations.
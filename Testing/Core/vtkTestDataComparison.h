@@ -0,0 +1,195 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTestDataComparison.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkTestDataComparison
+ * @brief   Comparison of data sets and arrays for regression testing.
+ *
+ * vtkTestDataComparison checks that two outputs are identical, value for
+ * value, e.g. the outputs of a filter run with one and with several threads
+ * of vtkSMPTools. A relative tolerance can be given for the values of the
+ * arrays. The first difference found is printed to std::cerr, prefixed by the
+ * name given to the comparison.
+ */
+
+#ifndef vtkTestDataComparison_h
+#define vtkTestDataComparison_h
+
+#include "vtkAbstractArray.h"
+#include "vtkAlgorithm.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataObject.h"
+#include "vtkDataSet.h"
+#include "vtkFieldData.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkVariant.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+struct vtkTestDataComparison
+{
+  /**
+   * Returns true if the arrays have the same type, numbers of tuples and
+   * components, and the same values, NaN being equal to NaN. The values of
+   * data arrays may differ by the relative tolerance, e.g. for the rounding
+   * errors of another order of the operations.
+   */
+  static inline bool SameArrays(vtkAbstractArray* array1, vtkAbstractArray* array2,
+    const char* name, double tolerance = 0.0);
+
+  /**
+   * Returns true if the field data have the same number of arrays, and if
+   * each array of the first one has the same values as the array with the
+   * same name in the second one.
+   */
+  static inline bool SameFieldData(
+    vtkFieldData* data1, vtkFieldData* data2, const char* name, double tolerance = 0.0);
+
+  /**
+   * Returns true if the data sets have the same points, the same cells with
+   * the same point ids, and the same point and cell data. The tolerance only
+   * applies to the point and cell data.
+   */
+  static inline bool SameDataSets(
+    vtkDataSet* output1, vtkDataSet* output2, const char* name, double tolerance = 0.0);
+
+  /**
+   * Updates the algorithm with the given number of threads of the STDThread
+   * backend of vtkSMPTools, so that the update runs in parallel whatever the
+   * default backend, and returns a copy of its first output.
+   */
+  static inline vtkSmartPointer<vtkDataObject> UpdateWithThreads(
+    vtkAlgorithm* algorithm, int numThreads);
+};
+
+inline bool vtkTestDataComparison::SameArrays(
+  vtkAbstractArray* array1, vtkAbstractArray* array2, const char* name, double tolerance)
+{
+  if (!array1 || !array2 || array1->GetDataType() != array2->GetDataType() ||
+    array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+    array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    std::cerr << name << ": array " << (array1 && array1->GetName() ? array1->GetName() : "")
+              << " differs in type or size" << std::endl;
+    return false;
+  }
+  vtkDataArray* dataArray1 = vtkDataArray::SafeDownCast(array1);
+  vtkDataArray* dataArray2 = vtkDataArray::SafeDownCast(array2);
+  const int numComps = array1->GetNumberOfComponents();
+  for (vtkIdType i = 0; i < array1->GetNumberOfValues(); ++i)
+  {
+    bool same;
+    if (dataArray1)
+    {
+      const double value1 = dataArray1->GetComponent(i / numComps, static_cast<int>(i % numComps));
+      const double value2 = dataArray2->GetComponent(i / numComps, static_cast<int>(i % numComps));
+      same = value1 == value2 || (std::isnan(value1) && std::isnan(value2)) ||
+        std::abs(value1 - value2) <= tolerance * std::max(1.0, std::abs(value1));
+    }
+    else
+    {
+      same = array1->GetVariantValue(i) == array2->GetVariantValue(i);
+    }
+    if (!same)
+    {
+      std::cerr << name << ": array " << (array1->GetName() ? array1->GetName() : "")
+                << " differs at value " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+inline bool vtkTestDataComparison::SameFieldData(
+  vtkFieldData* data1, vtkFieldData* data2, const char* name, double tolerance)
+{
+  if (data1->GetNumberOfArrays() != data2->GetNumberOfArrays())
+  {
+    std::cerr << name << ": the numbers of arrays differ" << std::endl;
+    return false;
+  }
+  for (int i = 0; i < data1->GetNumberOfArrays(); ++i)
+  {
+    vtkAbstractArray* array1 = data1->GetAbstractArray(i);
+    vtkAbstractArray* array2 =
+      array1->GetName() ? data2->GetAbstractArray(array1->GetName()) : data2->GetAbstractArray(i);
+    if (!vtkTestDataComparison::SameArrays(array1, array2, name, tolerance))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline bool vtkTestDataComparison::SameDataSets(
+  vtkDataSet* output1, vtkDataSet* output2, const char* name, double tolerance)
+{
+  if (!output1 || !output2 || output1->GetNumberOfPoints() != output2->GetNumberOfPoints() ||
+    output1->GetNumberOfCells() != output2->GetNumberOfCells())
+  {
+    std::cerr << name << ": the numbers of points or cells differ" << std::endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < output1->GetNumberOfPoints(); ++ptId)
+  {
+    double x1[3], x2[3];
+    output1->GetPoint(ptId, x1);
+    output2->GetPoint(ptId, x2);
+    if (!std::equal(x1, x1 + 3, x2))
+    {
+      std::cerr << name << ": point " << ptId << " differs" << std::endl;
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> ptIds1;
+  vtkNew<vtkIdList> ptIds2;
+  for (vtkIdType cellId = 0; cellId < output1->GetNumberOfCells(); ++cellId)
+  {
+    output1->GetCellPoints(cellId, ptIds1);
+    output2->GetCellPoints(cellId, ptIds2);
+    if (output1->GetCellType(cellId) != output2->GetCellType(cellId) ||
+      ptIds1->GetNumberOfIds() != ptIds2->GetNumberOfIds() ||
+      !std::equal(ptIds1->begin(), ptIds1->end(), ptIds2->begin()))
+    {
+      std::cerr << name << ": cell " << cellId << " differs" << std::endl;
+      return false;
+    }
+  }
+  return vtkTestDataComparison::SameFieldData(
+           output1->GetPointData(), output2->GetPointData(), name, tolerance) &&
+    vtkTestDataComparison::SameFieldData(
+      output1->GetCellData(), output2->GetCellData(), name, tolerance);
+}
+
+inline vtkSmartPointer<vtkDataObject> vtkTestDataComparison::UpdateWithThreads(
+  vtkAlgorithm* algorithm, int numThreads)
+{
+  algorithm->Modified();
+  vtkSMPTools::LocalScope(
+    vtkSMPTools::Config{ numThreads, "STDThread", false }, [&]() { algorithm->Update(); });
+  vtkDataObject* output = algorithm->GetOutputDataObject(0);
+  vtkSmartPointer<vtkDataObject> copy = vtkSmartPointer<vtkDataObject>::Take(output->NewInstance());
+  copy->DeepCopy(output);
+  return copy;
+}
+
+#endif // vtkTestDataComparison_h
+// VTK-HeaderTest-Exclude: vtkTestDataComparison.h